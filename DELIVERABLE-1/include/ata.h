@@ -0,0 +1,70 @@
+/*!
+ * \file            ata.h
+ * \date            2026-10-18
+ * \author          Mirko Lana [lana.mirko@icloud.com]
+ *
+ * \brief           Fused A^T * (A * x) product of a CSR matrix (normal equations).
+ *
+ * \details         Least-squares solvers on the normal equations (CGNR, CGLS)
+ *                  need y = A^T * A * x every iteration. Done as two SpMVs it
+ *                  streams A twice, the second time through its transpose. Here
+ *                  each row a_i is read once: its dot product t_i = a_i * x is
+ *                  computed and t_i * a_i is scattered into y right away, while
+ *                  the row is still in the L1 cache.
+ *
+ *                  Rows are split in nnz-balanced parts. The first thread
+ *                  scatters into y, the others into their own buffer of n items,
+ *                  then every thread sums a slice of the buffers into y and
+ *                  clears it for the next call. The buffers fit in the caches
+ *                  for tall-skinny matrices (few columns), where the fusion
+ *                  pays off most.
+ *
+ *                  Only real matrices are supported.
+ *
+ * \warning         Memory management is handled via an arena allocator; ensure
+ *                  that the arena is properly initialized and destroyed.
+ */
+
+#ifndef ATA_H
+#define ATA_H
+
+#include "arena.h"
+#include "csr.h"
+#include "vec.h"
+
+/*!
+ * \brief           Structure representing the scratch area of the fused product of a matrix.
+ */
+struct AtaPlan {
+    const struct CsrMatrix *mtx; /*< Matrix A */
+    int threads;                 /*< Number of threads (one buffer each, but the first) */
+    int stride;                  /*< Items between two buffers (n rounded up to a cache line) */
+    struct ArenaObj buffers;     /*< Per-thread partial products (threads - 1 buffers of doubles, zeroed between calls) */
+};
+
+/*!
+ * \brief           Initialize the fused product of a matrix.
+ *
+ * \details         Uses the current thread count of the parallel backend.
+ *
+ * \param[out]      plan: Pointer to the plan to initialize.
+ * \param[in]       mtx: Pointer to the real CSR matrix.
+ * \param[out]      arena: Pointer to the arena handler for memory allocation.
+ * \return          RC_OK on success, an error code otherwise:
+ *                   - RC_INVALID_ARG_ERR if any argument is invalid or the matrix is not real.
+ *                   - RC_MEM_ALLOC_ERR if memory allocation fails.
+ */
+int ata_init(struct AtaPlan *plan, const struct CsrMatrix *mtx, struct ArenaHandler *arena);
+
+/*!
+ * \brief           Compute result = A^T * (A * vec) reading A once.
+ *
+ * \param[in,out]   plan: Pointer to the plan of A.
+ * \param[in]       vec: Pointer to the vector (n items, real).
+ * \param[out]      result: Pointer to the result vector (n items, real).
+ * \return          RC_OK on success, an error code otherwise:
+ *                   - RC_INVALID_ARG_ERR if any argument is invalid.
+ */
+int ata_mul_vec(struct AtaPlan *plan, const struct Vec *vec, struct Vec *result);
+
+#endif /*! ATA_H */
@@ -0,0 +1,58 @@
+/*!
+ * \file            barrier.h
+ * \date            2026-10-18
+ * \author          Mirko Lana [lana.mirko@icloud.com]
+ *
+ * \brief           Lightweight sense-reversing spin barrier.
+ *
+ * \details         Used by threads that stay inside one parallel region across
+ *                  many SpMVs. Waiting threads spin on a shared flag and only
+ *                  yield the CPU after CONFIG_BARRIER_SPINS failed polls, so
+ *                  the barrier costs a few cache-line transfers instead of a
+ *                  runtime call.
+ */
+
+#ifndef BARRIER_H
+#define BARRIER_H
+
+#include <stdatomic.h>
+
+/*!
+ * \brief           Structure representing a spin barrier.
+ */
+struct SpinBarrier {
+    atomic_int count; /*< Number of threads still to arrive in the current phase */
+    atomic_int sense; /*< Global sense, flipped by the last thread of each phase */
+    int threads;      /*< Number of participating threads */
+};
+
+/*!
+ * \brief           Hint the CPU that the thread is spinning.
+ */
+static inline void barrier_cpu_relax(void) {
+#if defined(__x86_64__) || defined(__i386__)
+    __builtin_ia32_pause();
+#elif defined(__aarch64__)
+    __asm__ __volatile__("yield");
+#endif
+}
+
+/*!
+ * \brief           Initialize a spin barrier.
+ *
+ * \param[out]      barrier: Pointer to the barrier to initialize.
+ * \param[in]       threads: Number of participating threads (>= 1).
+ * \return          RC_OK on success, an error code otherwise:
+ *                   - RC_INVALID_ARG_ERR if any argument is invalid.
+ */
+int barrier_init(struct SpinBarrier *barrier, int threads);
+
+/*!
+ * \brief           Wait until all threads reached the barrier.
+ *
+ * \param[in,out]   barrier: Pointer to the barrier.
+ * \param[in,out]   local_sense: Pointer to the thread-private sense, initialized to 0.
+ */
+void barrier_wait(struct SpinBarrier *barrier, int *local_sense);
+
+#endif /*! BARRIER_H */
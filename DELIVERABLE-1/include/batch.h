@@ -0,0 +1,103 @@
+/*!
+ * \file            batch.h
+ * \date            2026-10-18
+ * \author          Mirko Lana [lana.mirko@icloud.com]
+ *
+ * \brief           Batches of many small CSR matrices multiplied in one call.
+ *
+ * \details         Per-element operators and similar workloads are thousands
+ *                  of matrices of tens to hundreds of rows, each one far too
+ *                  small for a parallel region of its own. A batch packs them
+ *                  in contiguous arrays: the rows of all the matrices follow
+ *                  each other in one row pointer array, and two offset tables
+ *                  give the first row and the first column of each matrix.
+ *
+ *                  The input and result of a batched SpMV are the
+ *                  concatenation of those of the matrices: matrix b reads the
+ *                  items of x from col_off[b] and writes those of y from
+ *                  row_off[b]. One call computes them all, the threads taking
+ *                  nnz-balanced ranges of whole matrices and each row being
+ *                  vectorized, so the cost of the parallel region and of the
+ *                  checks is paid once per batch.
+ *
+ *                  A batch is reserved once with the totals of its matrices
+ *                  (batch_init) and then filled (batch_add), which does not
+ *                  allocate: the source matrices may live in the arena.
+ *
+ * \warning         Memory management is handled via an arena allocator; ensure
+ *                  that the arena is properly initialized and destroyed.
+ */
+
+#ifndef BATCH_H
+#define BATCH_H
+
+#include "arena.h"
+#include "csr.h"
+#include "vec.h"
+
+#include <stdbool.h>
+
+/*!
+ * \brief           Structure representing a batch of CSR matrices.
+ */
+struct CsrBatch {
+    int count;               /*< Number of matrices added */
+    int m;                   /*< Rows of the matrices added (items of the result) */
+    int n;                   /*< Columns of the matrices added (items of the input) */
+    int nz;                  /*< Non-zeros of the matrices added */
+    int max_count;           /*< Number of matrices reserved */
+    int max_m;               /*< Rows reserved */
+    int max_n;               /*< Columns reserved */
+    int max_nz;              /*< Non-zeros reserved */
+    bool is_real;            /*< Flag indicating if the matrices hold real (true) or integer (false) values */
+    struct ArenaObj row_off; /*< First row of each matrix, max_count + 1 ints */
+    struct ArenaObj col_off; /*< First column of each matrix, max_count + 1 ints */
+    struct ArenaObj row;     /*< Row pointers of all the matrices into col and val, max_m + 1 ints */
+    struct ArenaObj col;     /*< Column indexes, local to their matrix, max_nz ints */
+    struct ArenaObj val;     /*< Values, max_nz doubles or int32_t */
+};
+
+/*!
+ * \brief           Reserve an empty batch.
+ *
+ * \param[out]      batch: Pointer to the batch to initialize.
+ * \param[in]       count: Number of matrices (>= 1).
+ * \param[in]       m: Total number of rows of the matrices.
+ * \param[in]       n: Total number of columns of the matrices.
+ * \param[in]       nz: Total number of non-zeros of the matrices.
+ * \param[in]       is_real: Flag indicating if the matrices hold real (true) or integer (false) values.
+ * \param[out]      arena: Pointer to the arena handler for memory allocation.
+ * \return          RC_OK on success, an error code otherwise:
+ *                   - RC_INVALID_ARG_ERR if any argument is invalid.
+ *                   - RC_MEM_ALLOC_ERR if memory allocation fails.
+ */
+int batch_init(struct CsrBatch *batch, int count, int m, int n, int nz, bool is_real, struct ArenaHandler *arena);
+
+/*!
+ * \brief           Append a copy of a matrix to a batch.
+ *
+ * \details         Integer values are widened to int32. Does not allocate.
+ *
+ * \param[in,out]   batch: Pointer to the batch.
+ * \param[in]       mtx: Pointer to the matrix, of the value type of the batch.
+ * \return          RC_OK on success, an error code otherwise:
+ *                   - RC_INVALID_ARG_ERR if any argument is invalid or the value types differ.
+ *                   - RC_IDX_OUT_OF_BOUNDS_ERR if the matrix exceeds what was reserved.
+ */
+int batch_add(struct CsrBatch *batch, const struct CsrMatrix *mtx);
+
+/*!
+ * \brief           Multiply every matrix of a batch with its part of a vector.
+ *
+ * \details         Integer sums are accumulated in int64 and saturated to
+ *                  int32. Runs serially with a single thread.
+ *
+ * \param[in]       batch: Pointer to the batch.
+ * \param[in]       vec: Pointer to the input vector (n items, the inputs of the matrices one after the other).
+ * \param[out]      result: Pointer to the result vector (m items, the results of the matrices one after the other).
+ * \return          RC_OK on success, an error code otherwise:
+ *                   - RC_INVALID_ARG_ERR if any argument is invalid.
+ */
+int batch_mul_vec(const struct CsrBatch *batch, const struct Vec *vec, struct Vec *result);
+
+#endif /*! BATCH_H */
@@ -10,46 +10,189 @@
 #define BENCH_H
 
 #include "arena.h"
+#include "csr.h"
+#include "vec.h"
+#include "partition.h"
+#include "ws.h"
+#include "helper.h"
+#include "dist.h"
+#include "shm.h"
+#include "chunk.h"
+#include "bench_spgemm.h"
+#include "bench_ata.h"
+#include "bench_mpk.h"
+#include "bench_poly.h"
+#include "bench_dist.h"
+#include "bench_gpart.h"
+#include "bench_quant.h"
+#include "bench_throughput.h"
+#include "bench_batch.h"
+#include "bench_chunk.h"
+#include "bench_helper.h"
 
+#include <stdbool.h>
 #include <stdint.h>
 
+/*!
+ * \brief           Benchmark execution modes.
+ */
+enum BenchMode {
+    BENCH_MODE_CALL,       /*!< One csr_matrix_mul_vec call (and parallel region) per run. */
+    BENCH_MODE_PERSISTENT, /*!< One parallel region for all runs, threads meet at a spin barrier. */
+    BENCH_MODE_ADAPTIVE,   /*!< Persistent mode with parts resized from the measured per-thread throughput. */
+    BENCH_MODE_WS,         /*!< One SpMV per run scheduled by the work-stealing row-block scheduler. */
+    BENCH_MODE_HELPER,     /*!< One SpMV per run, each compute thread paired with an SMT helper thread loading x ahead. */
+    BENCH_MODE_SPGEMM,     /*!< One SpGEMM per run: A * A for square matrices, A * A^T otherwise. */
+    BENCH_MODE_ATA,        /*!< One fused A^T * (A * x) per run, reading the matrix once (real matrices). */
+    BENCH_MODE_MPK,        /*!< One matrix-powers kernel [A x, ..., A^s x] per run (square matrices). */
+    BENCH_MODE_POLY,       /*!< One Chebyshev polynomial p(A) x per run, fused recurrence (real square matrices). */
+    BENCH_MODE_DIST,       /*!< One SpMV per run over the MPI ranks, rows partitioned and halo exchanged (make MPI=1). */
+    BENCH_MODE_GPART,      /*!< One SpMV per run of the matrix renumbered part by part by the graph partitioner (square matrices). */
+    BENCH_MODE_THROUGHPUT, /*!< Independent SpMV streams side by side, one per core group; one SpMV of every stream per run. */
+    BENCH_MODE_BATCHED,    /*!< One batched SpMV of many small matrices per run, copies of the input matrices. */
+    BENCH_MODE_CHUNKED,    /*!< SpMV delivering y in row chunks to a consumer as they complete. */
+    BENCH_MODE_COUNT,      /*!< Number of modes. */
+};
+
 /*!
  * \brief           Structure containing the configuration for a benchmark.
  */
 struct BenchConfig {
-    char *filename;             /*!< The name of the Matrix Market file to be used. */
-    int thread_count;           /*!< The number of threads to use. */
-    int warmup_iters;           /*!< The number of warmup iterations to perform. */
-    int runs;                   /*!< The number of benchmark runs to perform. */
-    struct ArenaHandler *arena; /*!< The arena handler to use for memory management. */
+    char *filename;                 /*!< The name of the Matrix Market file to be used. */
+    const struct CsrMatrix *matrix; /*!< The matrix of filename, already loaded in arena (see sweep.h), NULL to load it. */
+    char *const *filenames;         /*!< The Matrix Market files of the streams, filename first (throughput and batched modes). */
+    int matrices;                   /*!< The number of files of the streams (throughput and batched modes). */
+    int groups;                     /*!< The number of core groups, 0 to pick it from the thread policy (throughput mode). */
+    int batch_count;                /*!< The number of matrices of the batch (batched mode). */
+    int chunk_rows;                 /*!< Rows per chunk, 0 for the automatic size (chunked mode). */
+    enum ChunkOrder chunk_order;    /*!< Delivery order of the chunks (chunked mode). */
+    int thread_count;               /*!< The number of threads to use (CONFIG_THREADS_AUTO to pick it per matrix). */
+    int cpus;                       /*!< The CPUs the thread policy may use, 0 for all the online ones. */
+    int warmup_iters;               /*!< The number of warmup iterations to perform. */
+    int runs;                       /*!< The number of benchmark runs to perform. */
+    enum BenchMode mode;            /*!< The execution mode. */
+    enum CsrKernel kernel;          /*!< The SpMV kernel. */
+    int quant_bits;                 /*!< Bits of the quantized values, 0 for the exact SpMV (call mode only). */
+    bool compress;                  /*!< Compress the values losslessly when worth it (call mode only). */
+    int mpk_steps;                  /*!< The number of powers computed per run (mpk mode). */
+    int poly_degree;                /*!< The degree of the polynomial (poly mode). */
+    int gpart_parts;                /*!< The number of parts of the graph partition (gpart mode). */
+    bool shared;                    /*!< Load the matrix through the shared-memory store (see shm.h). */
+    const char *x_file;             /*!< File holding the input vector (see vecio.h), NULL for random values. */
+    const char *y_file;             /*!< File receiving the result of the last run (see vecio.h), NULL to drop it. */
+    struct ArenaHandler *arena;     /*!< The arena handler to use for memory management. */
+};
+
+/*!
+ * \brief           Structure containing the state of a benchmark: its matrix, vectors and mode plan.
+ *
+ * \details         Owned by the caller, so that several of them can coexist
+ *                  (the streams of the throughput mode are handlers too).
+ */
+struct BenchHandler {
+    struct CsrMatrix mtx;       /*!< Input matrix. */
+    struct Vec vec;             /*!< Input vector. */
+    struct Vec result;          /*!< Result matrix. */
+    int thread_count;           /*!< Number of threads */
+    const char *policy;         /*!< Reason of the thread count choice. */
+    int warmup_iters;           /*!< Number of warmup iterations. */
+    int runs;                   /*!< Number of benchmark runs. */
+    enum BenchMode mode;        /*!< Execution mode. */
+    struct Partition part;      /*!< Static row partition (persistent and adaptive modes). */
+    struct ArenaObj part_ns;    /*!< Per-part accumulated time, one cache line apart (adaptive mode). */
+    struct ArenaObj part_times; /*!< Per-part time handed to the rebalancer (adaptive mode). */
+    int rebalances;             /*!< Number of rebalances done (adaptive mode). */
+    struct WsScheduler ws;      /*!< Work-stealing scheduler (ws mode). */
+    struct HelperTeam helper;   /*!< Compute and helper thread pairs (helper mode). */
+    struct BenchSpgemm spgemm;  /*!< SpGEMM state (spgemm mode). */
+    struct BenchAta ata;        /*!< Fused product state (ata mode). */
+    struct BenchMpk mpk;        /*!< Matrix powers state (mpk mode). */
+    struct BenchPoly poly;      /*!< Polynomial state (poly mode). */
+    struct DistMatrix dist;     /*!< Rows of the rank and their halo exchange (dist mode). */
+    const char *filename;       /*!< Matrix Market file, reloaded whole to check the result (dist mode). */
+    struct BenchGpart gpart;    /*!< Graph partition state (gpart mode). */
+    bool shared;                /*!< Flag indicating that the matrix was loaded through the shared-memory store. */
+    struct ShmStore shm;        /*!< Attachment to the shared-memory store (shared set). */
+    struct BenchQuant quant;    /*!< Quantized or compressed values of the matrix (call mode). */
+    struct BenchThroughput tp;  /*!< Core groups running the streams (throughput mode). */
+    int streams;                /*!< Number of independent SpMV streams (throughput mode), of input files (batched mode). */
+    struct ArenaObj stream_bh;  /*!< Handler of each stream, streams struct BenchHandler (throughput and batched modes). */
+    struct BenchBatch batch;    /*!< Batch of the input matrices (batched mode). */
+    struct BenchChunk chunk;    /*!< Chunk delivery and consumer (chunked mode). */
+    const char *x_file;         /*!< File the input vector was read from, NULL if random. */
+    const char *y_file;         /*!< File receiving the result of the last run, NULL to drop it. */
 };
 
 /*!
  * \brief           Structure containing the results of a benchmark.
  */
 struct BenchResults {
-    int warmup_iters;        /*!< The number of warmups done. */
-    int runs;                /*!< The number of runs. */
-    struct ArenaObj samples; /*!< The array containing the times of each run. */
-    uint64_t mean;           /*!< The mean time of all runs. */
-    uint64_t stddev;         /*!< The standard deviation of all runs. */
-    uint64_t min;            /*!< The minimum time of all runs. */
-    uint64_t max;            /*!< The maximum time of all runs. */
+    int warmup_iters;                 /*!< The number of warmups done. */
+    int runs;                         /*!< The number of runs. */
+    enum BenchMode mode;              /*!< The execution mode. */
+    int rebalances;                   /*!< The number of partition rebalances (adaptive mode). */
+    long steals;                      /*!< The number of stolen row blocks, warmup included (ws mode). */
+    double load_ms;                   /*!< Time spent loading the matrix, -1 if not measured (see sweep.h). */
+    double load_wait_ms;              /*!< Time the benchmark waited for the matrix to be loaded (see sweep.h). */
+    const char *x_file;               /*!< File the input vector was read from, NULL if random. */
+    const char *y_file;               /*!< File the result of the last run was written to, NULL if dropped. */
+    double y_save_ms;                 /*!< Time spent writing the result (y_file set). */
+    const char *shm;                  /*!< How the matrix was loaded: "off", "published", "attached" or "private" (shared store). */
+    int thread_count;                 /*!< The number of threads used. */
+    const char *thread_policy;        /*!< Reason of the thread count choice. */
+    const char *isa;                  /*!< Instruction set the kernels were dispatched to. */
+    enum CsrKernel kernel;            /*!< SpMV kernel used (after fallback). */
+    struct BenchQuantResults quant;   /*!< Quantized and compressed values (call mode). */
+    struct ArenaObj samples;          /*!< The array containing the times of each run. */
+    uint64_t mean;                    /*!< The mean time of all runs. */
+    uint64_t stddev;                  /*!< The standard deviation of all runs. */
+    uint64_t min;                     /*!< The minimum time of all runs. */
+    uint64_t max;                     /*!< The maximum time of all runs. */
+    struct BenchSpgemmResults spgemm; /*!< Results of the spgemm mode. */
+    struct BenchAtaResults ata;       /*!< Results of the ata mode. */
+    struct BenchMpkResults mpk;       /*!< Results of the mpk mode. */
+    struct BenchPolyResults poly;     /*!< Results of the poly mode. */
+    struct BenchDistResults dist;     /*!< Results of the dist mode. */
+    struct BenchGpartResults gpart;   /*!< Results of the gpart mode. */
+    struct BenchThroughputResults tp; /*!< Results of the throughput mode. */
+    struct BenchBatchResults batch;   /*!< Results of the batched mode. */
+    struct BenchChunkResults chunk;   /*!< Results of the chunked mode. */
+    struct BenchHelperResults helper; /*!< Results of the helper mode. */
 };
 
 /*!
- * \brief           Initialize the benchmark module with the given configuration.
+ * \brief           Parse a benchmark mode name.
+ *
+ * \param[in]       str: The mode name (e.g. "call", "persistent", "adaptive", "ws").
+ * \param[out]      mode: Pointer to store the parsed mode.
+ * \return          RC_OK on success, an error code otherwise.
+ *                   - RC_INVALID_ARG_ERR if any argument is NULL or the name is unknown.
+ */
+int bench_mode_from_str(const char *str, enum BenchMode *mode);
+
+/*!
+ * \brief           Get the name of a benchmark mode.
+ *
+ * \param[in]       mode: The benchmark mode.
+ * \return          The name of the mode.
+ */
+const char *bench_mode_to_str(enum BenchMode mode);
+
+/*!
+ * \brief           Initialize a benchmark handler with the given configuration.
  *
+ * \param[out]      bh: Pointer to the benchmark handler to initialize.
  * \param[in]       cfg: Pointer to the benchmark configuration structure.
  * \return          RC_OK on success, an error code otherwise.
  *                   - RC_INVALID_ARG_ERR if any of the provided arguments is NULL.
  *
  */
-int bench_init(const struct BenchConfig *cfg);
+int bench_init(struct BenchHandler *bh, const struct BenchConfig *cfg);
 
 /*!
  * \brief           Perform the benchmark warmup iterations.
  *
+ * \param[in,out]   bh: Pointer to the benchmark handler.
  * \return          RC_OK on success, an error code otherwise.
  *                   - RC_INVALID_ARG_ERR if the benchmark configuration is invalid (NULL).
  *                   - RC_FILE_IO_ERR if the file could not be opened.
@@ -58,18 +201,19 @@ int bench_init(const struct BenchConfig *cfg);
 
  *
  */
-int bench_warmup(void);
+int bench_warmup(struct BenchHandler *bh);
 
 /*!
  * \brief           Run the benchamerk routine.
  *
+ * \param[in,out]   bh: Pointer to the benchmark handler.
  * \param[in]       results: Pointer to rhe benchmark result structure.
  * \param[out]      arena: Pointer to the arena handler for memory management.
  * \return          RC_OK on success, an error code otherwise.
  *                   - RC_INVALID_ARG_ERR if the benchmark configuration is invalid (NULL).
  *                   - RC_MEM_ALLOC_ERR if memory allocation fails.
  */
-int bench_run(struct BenchResults *results, struct ArenaHandler *arena);
+int bench_run(struct BenchHandler *bh, struct BenchResults *results, struct ArenaHandler *arena);
 
 /*!
  * \brief           Save the benchmark results to a file (JSON format).
@@ -83,4 +227,32 @@ int bench_run(struct BenchResults *results, struct ArenaHandler *arena);
  */
 int bench_save_result(const struct BenchResults *results, const char *filename);
 
+/*!
+ * \brief           Name the results file of a matrix: its file name without path and extension, and ".json".
+ *
+ * \param[in]       matrix: The name of the Matrix Market file.
+ * \param[out]      filename: Buffer of CONFIG_BENCH_FILENAME_MAX_LEN characters receiving the name.
+ */
+void bench_result_filename(const char *matrix, char *filename);
+
+/*!
+ * \brief           Relative L2 difference of a result from the exact one.
+ *
+ * \param[in]       exact: The exact result.
+ * \param[in]       other: The result to compare, as many items as exact.
+ * \return          ||other - exact|| / ||exact||, 0 if exact is zero.
+ */
+double bench_rel_l2(const struct Vec *exact, const struct Vec *other);
+
+/*!
+ * \brief           Release the resources of the benchmark held outside of the arena.
+ *
+ * \details         Detaches from the shared-memory store, if the matrices were
+ *                  loaded through it.
+ *
+ * \param[in,out]   bh: Pointer to the benchmark handler.
+ * \return          RC_OK on success, an error code otherwise.
+ */
+int bench_fini(struct BenchHandler *bh);
+
 #endif /*! BENCH_H */
@@ -0,0 +1,76 @@
+/*!
+ * \file            bench_ata.h
+ * \date            2026-10-18
+ * \author          Mirko Lana [lana.mirko@icloud.com]
+ *
+ * \brief           Fused A^T * A mode of the benchmark (ata).
+ *
+ * \details         Each run computes A^T * (A * x) reading the matrix once
+ *                  (see ata.h); the report times the same product done as two
+ *                  SpMVs and compares both results.
+ *
+ * \warning         Memory management is handled via an arena allocator; ensure
+ *                  that the arena is properly initialized and destroyed.
+ */
+
+#ifndef BENCH_ATA_H
+#define BENCH_ATA_H
+
+#include "arena.h"
+#include "ata.h"
+#include "vec.h"
+
+#include <stdint.h>
+#include <stdio.h>
+
+struct BenchHandler;
+struct BenchResults;
+
+/*!
+ * \brief           Structure containing the fused product of the ata mode.
+ */
+struct BenchAta {
+    struct AtaPlan plan; /*!< Buffers of the fused product. */
+    struct Vec result;   /*!< Result of the fused product, n items. */
+};
+
+/*!
+ * \brief           Structure containing the results of the ata mode.
+ */
+struct BenchAtaResults {
+    uint64_t unfused_mean; /*!< The mean time of A^T * (A * x) done as two SpMVs. */
+    double rel_l2;         /*!< The relative L2 difference between the fused and unfused results. */
+};
+
+/*!
+ * \brief           Set up the fused product and its result vector.
+ *
+ * \param[in,out]   bh: Pointer to the benchmark handler, the input matrix loaded.
+ * \param[out]      arena: Pointer to the arena handler for memory allocation.
+ * \return          RC_OK on success, an error code otherwise.
+ */
+int bench_ata_init(struct BenchHandler *bh, struct ArenaHandler *arena);
+
+/*!
+ * \brief           Measure the fused A^T * (A * x) against two SpMVs.
+ *
+ * \details         Transposes the matrix and times runs of A * x followed by
+ *                  A^T * (A * x), with the thread count and kernel of the
+ *                  benchmark, then compares their result with the fused one.
+ *
+ * \param[in,out]   bh: Pointer to the benchmark handler.
+ * \param[out]      results: Pointer to the benchmark results to fill, mean set.
+ * \param[out]      arena: Pointer to the arena handler for memory allocation.
+ * \return          RC_OK on success, an error code otherwise.
+ */
+int bench_ata_report(struct BenchHandler *bh, struct BenchResults *results, struct ArenaHandler *arena);
+
+/*!
+ * \brief           Write the fields of the ata mode to the results JSON.
+ *
+ * \param[out]      fp: The results file.
+ * \param[in]       results: Pointer to the benchmark results.
+ */
+void bench_ata_write_json(FILE *fp, const struct BenchResults *results);
+
+#endif /*! BENCH_ATA_H */
@@ -0,0 +1,88 @@
+/*!
+ * \file            bench_batch.h
+ * \date            2026-10-18
+ * \author          Mirko Lana [lana.mirko@icloud.com]
+ *
+ * \brief           Batched mode of the benchmark (batched).
+ *
+ * \details         Copies of the input matrices are packed in one batch (see
+ *                  batch.h) and each run computes the SpMV of all of them in a
+ *                  single call; the report times one csr_matrix_mul_vec call
+ *                  per matrix instead.
+ *
+ * \warning         Memory management is handled via an arena allocator; ensure
+ *                  that the arena is properly initialized and destroyed.
+ */
+
+#ifndef BENCH_BATCH_H
+#define BENCH_BATCH_H
+
+#include "arena.h"
+#include "batch.h"
+#include "vec.h"
+
+#include <stdint.h>
+#include <stdio.h>
+
+struct BenchHandler;
+struct BenchConfig;
+struct BenchResults;
+
+/*!
+ * \brief           Structure containing the batch of the batched mode.
+ */
+struct BenchBatch {
+    struct CsrBatch csr; /*!< Copies of the input matrices packed together. */
+    struct Vec x;        /*!< Input vector of the batch, the inputs of the streams. */
+    struct Vec y;        /*!< Result vector of the batch. */
+};
+
+/*!
+ * \brief           Structure containing the results of the batched mode.
+ */
+struct BenchBatchResults {
+    int count;           /*!< The number of matrices of the batch. */
+    int nnz;             /*!< The non-zeros of all the matrices of the batch. */
+    uint64_t calls_mean; /*!< The mean time of one csr_matrix_mul_vec call per matrix. */
+    double rel_l2;       /*!< The relative L2 difference between both. */
+};
+
+/*!
+ * \brief           Pack copies of the input matrices in a batch.
+ *
+ * \details         Matrix b of the batch is a copy of file b % matrices, and
+ *                  its part of the batched input is the input vector of that
+ *                  file (a stream, see bench_throughput_streams_init), so that
+ *                  its part of the result can be checked against a
+ *                  csr_matrix_mul_vec of the file.
+ *
+ * \param[in,out]   bh: Pointer to the benchmark handler, the input matrix loaded.
+ * \param[in]       cfg: Pointer to the benchmark configuration.
+ * \return          RC_OK on success, an error code otherwise.
+ *                   - RC_INVALID_ARG_ERR if the matrices mix value types or the batch is too large.
+ */
+int bench_batch_init(struct BenchHandler *bh, const struct BenchConfig *cfg);
+
+/*!
+ * \brief           Measure the batched SpMV against one csr_matrix_mul_vec call per matrix.
+ *
+ * \details         Times runs of the separate calls, each one paying the checks,
+ *                  the dispatch and the parallel region of a call, then compares
+ *                  the part of the batched result of every matrix with the
+ *                  result of its file.
+ *
+ * \param[in,out]   bh: Pointer to the benchmark handler.
+ * \param[out]      results: Pointer to the benchmark results to fill, mean set.
+ * \return          RC_OK on success, an error code otherwise.
+ */
+int bench_batch_report(struct BenchHandler *bh, struct BenchResults *results);
+
+/*!
+ * \brief           Write the fields of the batched mode to the results JSON.
+ *
+ * \param[out]      fp: The results file.
+ * \param[in]       results: Pointer to the benchmark results.
+ */
+void bench_batch_write_json(FILE *fp, const struct BenchResults *results);
+
+#endif /*! BENCH_BATCH_H */
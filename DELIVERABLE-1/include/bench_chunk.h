@@ -0,0 +1,110 @@
+/*!
+ * \file            bench_chunk.h
+ * \date            2026-10-18
+ * \author          Mirko Lana [lana.mirko@icloud.com]
+ *
+ * \brief           Chunked mode of the benchmark (chunked).
+ *
+ * \details         Each run computes one SpMV delivering y in row chunks (see
+ *                  chunk.h) to a consumer standing for a downstream stage; the
+ *                  report times the SpMV followed by the same consumer on the
+ *                  whole y.
+ */
+
+#ifndef BENCH_CHUNK_H
+#define BENCH_CHUNK_H
+
+#include "chunk.h"
+
+#include <pthread.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+
+struct BenchHandler;
+struct BenchConfig;
+struct BenchResults;
+
+/*!
+ * \brief           Structure containing the state of the consumer of a chunked SpMV.
+ *
+ * \details         Stands for a downstream stage of y: keeps its largest item
+ *                  (top-1) and counts its positive items (thresholding).
+ */
+struct BenchConsumer {
+    pthread_mutex_t lock;    /*!< Lock merging the chunks, possibly delivered concurrently. */
+    double max;              /*!< Largest item of y. */
+    int max_row;             /*!< Row of the largest item (the first one on ties). */
+    long positive;           /*!< Number of positive items of y. */
+    uint64_t start_ns;       /*!< Start of the current SpMV. */
+    uint64_t first_ns;       /*!< Time from the start to the delivery of the first chunk, 0 before it. */
+    uint64_t first_total_ns; /*!< Accumulated first-chunk times. */
+    long spmvs;              /*!< Number of chunked SpMVs. */
+};
+
+/*!
+ * \brief           Structure containing the delivery of the chunks of the chunked mode.
+ */
+struct BenchChunk {
+    struct ChunkPlan plan;         /*!< Chunks of the input matrix and their delivery to the consumer. */
+    struct BenchConsumer consumer; /*!< Consumer of the chunks. */
+};
+
+/*!
+ * \brief           Structure containing the results of the chunked mode.
+ */
+struct BenchChunkResults {
+    int rows;                  /*!< Rows per chunk, 0 for the automatic size. */
+    const char *order;         /*!< Delivery order of the chunks. */
+    int count;                 /*!< Number of chunks. */
+    uint64_t first_mean;       /*!< Mean time from the start of the SpMV to the delivery of the first chunk. */
+    uint64_t unpipelined_mean; /*!< Mean time of the SpMV followed by the consumer on the whole y. */
+    bool match;                /*!< Whether both consumers got the same top-1 and count. */
+};
+
+/*!
+ * \brief           Set up the chunks of the input matrix and their delivery to the consumer.
+ *
+ * \param[in,out]   bh: Pointer to the benchmark handler, the input matrix loaded.
+ * \param[in]       cfg: Pointer to the benchmark configuration.
+ * \return          RC_OK on success, an error code otherwise.
+ */
+int bench_chunk_init(struct BenchHandler *bh, const struct BenchConfig *cfg);
+
+/*!
+ * \brief           Compute one chunked SpMV, its chunks consumed as they complete.
+ *
+ * \param[in,out]   bh: Pointer to the benchmark handler.
+ * \return          RC_OK on success, an error code otherwise.
+ */
+int bench_chunk_spmv(struct BenchHandler *bh);
+
+/*!
+ * \brief           Measure the chunked SpMV against the SpMV followed by the consumer on the whole y.
+ *
+ * \details         The consumer being the same, the difference is the part
+ *                  of its work overlapped with the multiply. Also checks that
+ *                  both consumers end with the same top-1 and count.
+ *
+ * \param[in,out]   bh: Pointer to the benchmark handler.
+ * \param[out]      results: Pointer to the benchmark results to fill, mean set.
+ * \return          RC_OK on success, an error code otherwise.
+ */
+int bench_chunk_report(struct BenchHandler *bh, struct BenchResults *results);
+
+/*!
+ * \brief           Write the fields of the chunked mode to the results JSON.
+ *
+ * \param[out]      fp: The results file.
+ * \param[in]       results: Pointer to the benchmark results.
+ */
+void bench_chunk_write_json(FILE *fp, const struct BenchResults *results);
+
+/*!
+ * \brief           Release the consumer, if bench_chunk_init set it up.
+ *
+ * \param[in,out]   bh: Pointer to the benchmark handler.
+ */
+void bench_chunk_fini(struct BenchHandler *bh);
+
+#endif /*! BENCH_CHUNK_H */
@@ -0,0 +1,62 @@
+/*!
+ * \file            bench_dist.h
+ * \date            2026-10-18
+ * \author          Mirko Lana [lana.mirko@icloud.com]
+ *
+ * \brief           Distributed mode of the benchmark (dist).
+ *
+ * \details         Each run computes one SpMV over the MPI ranks, the rows
+ *                  partitioned and the halo exchanged (see dist.h). The
+ *                  results are gathered over the ranks once the runs are over.
+ *
+ * \warning         Memory management is handled via an arena allocator; ensure
+ *                  that the arena is properly initialized and destroyed.
+ */
+
+#ifndef BENCH_DIST_H
+#define BENCH_DIST_H
+
+#include "arena.h"
+#include "dist.h"
+
+#include <stdint.h>
+#include <stdio.h>
+
+struct BenchHandler;
+struct BenchResults;
+
+/*!
+ * \brief           Structure containing the results of the dist mode.
+ */
+struct BenchDistResults {
+    int ranks;          /*!< The number of MPI ranks. */
+    int max_halo;       /*!< The largest halo of a rank, in vector items. */
+    uint64_t max_mean;  /*!< The mean time of the slowest rank. */
+    uint64_t wait_mean; /*!< The largest mean time a rank waited for its halo after its local block. */
+    double rel_l2;      /*!< The relative L2 difference with the SpMV of the whole matrix, -1 if not checked. */
+};
+
+/*!
+ * \brief           Gather the results of the distributed SpMV over the ranks.
+ *
+ * \details         Collective over the MPI ranks. The slowest rank sets the
+ *                  time. Below CONFIG_DIST_CHECK_MAX_NNZ non-zeros, rank 0
+ *                  gathers the vectors, loads the whole matrix and compares
+ *                  with its csr_matrix_mul_vec.
+ *
+ * \param[in,out]   bh: Pointer to the benchmark handler.
+ * \param[out]      results: Pointer to the benchmark results to fill, mean set.
+ * \param[out]      arena: Pointer to the arena handler for memory allocation.
+ * \return          RC_OK on success, an error code otherwise.
+ */
+int bench_dist_report(struct BenchHandler *bh, struct BenchResults *results, struct ArenaHandler *arena);
+
+/*!
+ * \brief           Write the fields of the dist mode to the results JSON.
+ *
+ * \param[out]      fp: The results file.
+ * \param[in]       results: Pointer to the benchmark results.
+ */
+void bench_dist_write_json(FILE *fp, const struct BenchResults *results);
+
+#endif /*! BENCH_DIST_H */
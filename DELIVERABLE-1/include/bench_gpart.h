@@ -0,0 +1,97 @@
+/*!
+ * \file            bench_gpart.h
+ * \date            2026-10-18
+ * \author          Mirko Lana [lana.mirko@icloud.com]
+ *
+ * \brief           Graph partition mode of the benchmark (gpart).
+ *
+ * \details         The input matrix is partitioned by the multilevel graph
+ *                  partitioner (see gpart.h) and renumbered part by part; each
+ *                  run computes one SpMV of the renumbered matrix. The report
+ *                  compares the partition with the contiguous nnz-balanced
+ *                  split, and the SpMV with that of the original order.
+ *
+ * \warning         Memory management is handled via an arena allocator; ensure
+ *                  that the arena is properly initialized and destroyed.
+ */
+
+#ifndef BENCH_GPART_H
+#define BENCH_GPART_H
+
+#include "arena.h"
+#include "csr.h"
+#include "gpart.h"
+
+#include <stdint.h>
+#include <stdio.h>
+
+struct BenchHandler;
+struct BenchResults;
+
+/*!
+ * \brief           Structure containing the partition of the gpart mode.
+ */
+struct BenchGpart {
+    struct CsrMatrix src; /*!< Input matrix in its original order, the one of the handler being renumbered. */
+    struct Gpart gpart;   /*!< Multilevel partition of the input matrix. */
+    struct Gpart contig;  /*!< Contiguous nnz-balanced split, for comparison. */
+    uint64_t us;          /*!< Time taken by the multilevel partitioner. */
+};
+
+/*!
+ * \brief           Structure containing the results of the gpart mode.
+ */
+struct BenchGpartResults {
+    int parts;            /*!< The number of parts. */
+    uint64_t us;          /*!< The time taken by the multilevel partitioner. */
+    long long cut;        /*!< The non-zeros reading items of other parts. */
+    long long volume;     /*!< The items received by all the parts. */
+    int max_halo;         /*!< The largest halo of a part. */
+    double imbalance;     /*!< The non-zeros of the largest part over the mean. */
+    long long contig_cut; /*!< The cut of the contiguous nnz-balanced split. */
+    long long contig_vol; /*!< The volume of the contiguous nnz-balanced split. */
+    int contig_halo;      /*!< The largest halo of the contiguous nnz-balanced split. */
+    struct ArenaObj halo; /*!< The halo of each part, parts int. */
+    struct ArenaObj pcut; /*!< The cut of each part, parts int. */
+    uint64_t orig_mean;   /*!< The mean time of the SpMV of the matrix in its original order. */
+    double rel_l2;        /*!< The relative L2 difference between both SpMVs. */
+};
+
+/*!
+ * \brief           Partition the input matrix and renumber it part by part.
+ *
+ * \details         The runs compute the SpMV of the renumbered matrix, whose
+ *                  contiguous nnz-balanced split (that of the other modes and
+ *                  of the dist mode) follows the parts; the input matrix is
+ *                  kept to compare with.
+ *
+ * \param[in,out]   bh: Pointer to the benchmark handler, the input matrix loaded.
+ * \param[in]       parts: Number of parts.
+ * \param[out]      arena: Pointer to the arena handler for memory allocation.
+ * \return          RC_OK on success, an error code otherwise.
+ */
+int bench_gpart_init(struct BenchHandler *bh, int parts, struct ArenaHandler *arena);
+
+/*!
+ * \brief           Measure the SpMV of the matrix in its original order against the renumbered one.
+ *
+ * \details         Times runs of csr_matrix_mul_vec on the input matrix, with
+ *                  the input vector put back in the original order, then
+ *                  compares the result with the renumbered one.
+ *
+ * \param[in,out]   bh: Pointer to the benchmark handler.
+ * \param[out]      results: Pointer to the benchmark results to fill, mean set.
+ * \param[out]      arena: Pointer to the arena handler for memory allocation.
+ * \return          RC_OK on success, an error code otherwise.
+ */
+int bench_gpart_report(struct BenchHandler *bh, struct BenchResults *results, struct ArenaHandler *arena);
+
+/*!
+ * \brief           Write the fields of the gpart mode to the results JSON.
+ *
+ * \param[out]      fp: The results file.
+ * \param[in]       results: Pointer to the benchmark results.
+ */
+void bench_gpart_write_json(FILE *fp, const struct BenchResults *results);
+
+#endif /*! BENCH_GPART_H */
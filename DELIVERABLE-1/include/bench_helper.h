@@ -0,0 +1,54 @@
+/*!
+ * \file            bench_helper.h
+ * \date            2026-10-18
+ * \author          Mirko Lana [lana.mirko@icloud.com]
+ *
+ * \brief           Helper-thread prefetching mode of the benchmark (helper).
+ *
+ * \details         Each run computes one SpMV with every compute thread paired
+ *                  with an SMT helper thread loading x ahead (see helper.h);
+ *                  the report times the same SpMV with software prefetching
+ *                  and with plain execution.
+ */
+
+#ifndef BENCH_HELPER_H
+#define BENCH_HELPER_H
+
+#include <stdint.h>
+#include <stdio.h>
+
+struct BenchHandler;
+struct BenchResults;
+
+/*!
+ * \brief           Structure containing the results of the helper mode.
+ */
+struct BenchHelperResults {
+    int pinned;             /*!< The number of compute/helper pairs pinned to one core. */
+    long throttles;         /*!< The number of times a helper waited for its compute thread, warmup included. */
+    uint64_t prefetch_mean; /*!< The mean time of the SpMV with the software prefetching kernel. */
+    uint64_t plain_mean;    /*!< The mean time of the SpMV with the auto-vectorized kernel. */
+};
+
+/*!
+ * \brief           Measure the helper-thread SpMV against software prefetching and plain execution.
+ *
+ * \details         Times runs of csr_matrix_mul_vec with CSR_KERNEL_PREFETCH,
+ *                  then with CSR_KERNEL_AUTO, with the thread count of the
+ *                  benchmark, and restores the selected kernel.
+ *
+ * \param[in,out]   bh: Pointer to the benchmark handler.
+ * \param[out]      results: Pointer to the benchmark results to fill, mean set.
+ * \return          RC_OK on success, an error code otherwise.
+ */
+int bench_helper_report(struct BenchHandler *bh, struct BenchResults *results);
+
+/*!
+ * \brief           Write the fields of the helper mode to the results JSON.
+ *
+ * \param[out]      fp: The results file.
+ * \param[in]       results: Pointer to the benchmark results.
+ */
+void bench_helper_write_json(FILE *fp, const struct BenchResults *results);
+
+#endif /*! BENCH_HELPER_H */
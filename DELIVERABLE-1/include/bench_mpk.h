@@ -0,0 +1,82 @@
+/*!
+ * \file            bench_mpk.h
+ * \date            2026-10-18
+ * \author          Mirko Lana [lana.mirko@icloud.com]
+ *
+ * \brief           Matrix-powers mode of the benchmark (mpk).
+ *
+ * \details         Each run computes [A x, ..., A^s x] with the matrix-powers
+ *                  kernel (see mpk.h); the report times the same powers done
+ *                  as separate SpMVs and compares the last ones.
+ *
+ * \warning         Memory management is handled via an arena allocator; ensure
+ *                  that the arena is properly initialized and destroyed.
+ */
+
+#ifndef BENCH_MPK_H
+#define BENCH_MPK_H
+
+#include "arena.h"
+#include "mpk.h"
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+
+struct BenchHandler;
+struct BenchResults;
+
+/*!
+ * \brief           Structure containing the kernel and the powers of the mpk mode.
+ */
+struct BenchMpk {
+    struct MpkPlan plan;    /*!< Row blocks of the matrix powers. */
+    struct ArenaObj powers; /*!< Powers of the matrix times the input vector, steps struct Vec. */
+};
+
+/*!
+ * \brief           Structure containing the results of the mpk mode.
+ */
+struct BenchMpkResults {
+    int steps;              /*!< The number of powers computed per run. */
+    int blocks;             /*!< The number of row blocks of the wavefront. */
+    int block_nnz;          /*!< The largest number of non-zeros of a block, sized from L2. */
+    int reach;              /*!< The farthest block read by a block. */
+    bool wavefront;         /*!< Whether the powers advanced as a wavefront, not as separate SpMVs. */
+    long stalls;            /*!< The number of times a thread waited for rows of another one, warmup included. */
+    uint64_t separate_mean; /*!< The mean time of the powers done as separate SpMVs. */
+    double rel_l2;          /*!< The relative L2 difference between the last powers of both. */
+};
+
+/*!
+ * \brief           Split the rows in blocks for the powers and allocate them.
+ *
+ * \param[in,out]   bh: Pointer to the benchmark handler, the input matrix loaded.
+ * \param[in]       steps: Number of powers computed per run.
+ * \param[out]      arena: Pointer to the arena handler for memory allocation.
+ * \return          RC_OK on success, an error code otherwise.
+ */
+int bench_mpk_init(struct BenchHandler *bh, int steps, struct ArenaHandler *arena);
+
+/*!
+ * \brief           Measure the matrix-powers kernel against separate SpMVs.
+ *
+ * \details         Times runs of steps csr_matrix_mul_vec calls, each one
+ *                  reading the result of the previous one, then compares the
+ *                  last power with the one of the kernel.
+ *
+ * \param[in,out]   bh: Pointer to the benchmark handler.
+ * \param[out]      results: Pointer to the benchmark results to fill, mean set.
+ * \return          RC_OK on success, an error code otherwise.
+ */
+int bench_mpk_report(struct BenchHandler *bh, struct BenchResults *results);
+
+/*!
+ * \brief           Write the fields of the mpk mode to the results JSON.
+ *
+ * \param[out]      fp: The results file.
+ * \param[in]       results: Pointer to the benchmark results.
+ */
+void bench_mpk_write_json(FILE *fp, const struct BenchResults *results);
+
+#endif /*! BENCH_MPK_H */
@@ -0,0 +1,92 @@
+/*!
+ * \file            bench_poly.h
+ * \date            2026-10-18
+ * \author          Mirko Lana [lana.mirko@icloud.com]
+ *
+ * \brief           Chebyshev polynomial mode of the benchmark (poly).
+ *
+ * \details         Each run applies p(A) x with the fused recurrence of
+ *                  csr_matrix_poly_apply; the report times the same recurrence
+ *                  done as SpMVs and separate vector passes.
+ *
+ * \warning         Memory management is handled via an arena allocator; ensure
+ *                  that the arena is properly initialized and destroyed.
+ */
+
+#ifndef BENCH_POLY_H
+#define BENCH_POLY_H
+
+#include "arena.h"
+#include "csr.h"
+#include "vec.h"
+
+#include <stdint.h>
+#include <stdio.h>
+
+struct BenchHandler;
+struct BenchResults;
+
+/*!
+ * \brief           Structure containing the polynomial of the poly mode.
+ */
+struct BenchPoly {
+    struct CsrPoly poly;    /*!< Chebyshev polynomial of the scaled matrix. */
+    struct ArenaObj coeffs; /*!< Coefficients of the polynomial, degree + 1 doubles. */
+    struct Vec work[2];     /*!< Work vectors of the recurrence. */
+};
+
+/*!
+ * \brief           Structure containing the results of the poly mode.
+ */
+struct BenchPolyResults {
+    int degree;            /*!< The degree of the polynomial. */
+    uint64_t unfused_mean; /*!< The mean time of the polynomial done as SpMVs and vector updates. */
+    double rel_l2;         /*!< The relative L2 difference between the fused and unfused results. */
+};
+
+/*!
+ * \brief           Set up the Chebyshev polynomial of the benchmark.
+ *
+ * \details         The matrix is scaled by the inverse of its largest absolute
+ *                  row sum, which bounds its spectrum (Gershgorin), so that the
+ *                  terms T_k(B) x stay bounded; the coefficients are 1 / (k + 1).
+ *
+ * \param[in,out]   bh: Pointer to the benchmark handler, the input matrix loaded.
+ * \param[in]       degree: Degree of the polynomial.
+ * \param[out]      arena: Pointer to the arena handler for memory allocation.
+ * \return          RC_OK on success, an error code otherwise.
+ *                   - RC_INVALID_ARG_ERR if the matrix is not real and square.
+ */
+int bench_poly_init(struct BenchHandler *bh, int degree, struct ArenaHandler *arena);
+
+/*!
+ * \brief           Apply the polynomial to the input vector, fused.
+ *
+ * \param[in,out]   bh: Pointer to the benchmark handler.
+ * \return          RC_OK on success, an error code otherwise.
+ */
+int bench_poly_spmv(struct BenchHandler *bh);
+
+/*!
+ * \brief           Measure the fused polynomial against its unfused recurrence.
+ *
+ * \details         Times runs of the unfused recurrence, with the thread count
+ *                  of the benchmark, then compares their result with the fused
+ *                  one.
+ *
+ * \param[in,out]   bh: Pointer to the benchmark handler.
+ * \param[out]      results: Pointer to the benchmark results to fill, mean set.
+ * \param[out]      arena: Pointer to the arena handler for memory allocation.
+ * \return          RC_OK on success, an error code otherwise.
+ */
+int bench_poly_report(struct BenchHandler *bh, struct BenchResults *results, struct ArenaHandler *arena);
+
+/*!
+ * \brief           Write the fields of the poly mode to the results JSON.
+ *
+ * \param[out]      fp: The results file.
+ * \param[in]       results: Pointer to the benchmark results.
+ */
+void bench_poly_write_json(FILE *fp, const struct BenchResults *results);
+
+#endif /*! BENCH_POLY_H */
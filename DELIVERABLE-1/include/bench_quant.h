@@ -0,0 +1,87 @@
+/*!
+ * \file            bench_quant.h
+ * \date            2026-10-18
+ * \author          Mirko Lana [lana.mirko@icloud.com]
+ *
+ * \brief           Quantized and compressed values of the benchmark (call mode).
+ *
+ * \details         With -b the SpMV reads the values quantized per row (see
+ *                  quant.h), with -z the values compressed losslessly (see
+ *                  fpc.h). The quantized SpMV is compared with the exact one
+ *                  once the runs are over.
+ *
+ * \warning         Memory management is handled via an arena allocator; ensure
+ *                  that the arena is properly initialized and destroyed.
+ */
+
+#ifndef BENCH_QUANT_H
+#define BENCH_QUANT_H
+
+#include "arena.h"
+#include "fpc.h"
+#include "quant.h"
+
+#include <stdbool.h>
+#include <stdio.h>
+
+struct BenchHandler;
+struct BenchConfig;
+struct BenchResults;
+
+/*!
+ * \brief           Structure containing the quantized or compressed values of a benchmark.
+ */
+struct BenchQuant {
+    int bits;                  /*!< Bits of the quantized values (0 = exact SpMV). */
+    struct QuantMatrix matrix; /*!< Quantized matrix (bits != 0). */
+    bool compressed;           /*!< Flag indicating that the SpMV reads the compressed values. */
+    struct FpcMatrix fpc;      /*!< Matrix with compressed values (compress requested). */
+    double fpc_ratio;          /*!< Compression ratio of the values (0 if not requested). */
+};
+
+/*!
+ * \brief           Structure containing the results of the quantized or compressed values.
+ */
+struct BenchQuantResults {
+    int bits;                 /*!< Bits of the quantized values (0 if exact). */
+    struct QuantError error;  /*!< Error of the quantized SpMV against the exact one. */
+    double bytes_per_nnz;     /*!< Matrix bytes read per non-zero by the SpMV. */
+    double csr_bytes_per_nnz; /*!< Matrix bytes read per non-zero by the exact SpMV. */
+    bool compressed;          /*!< Whether the values were compressed. */
+    double fpc_ratio;         /*!< Compression ratio of the values (0 if not requested). */
+};
+
+/*!
+ * \brief           Quantize or compress the values of the input matrix, as configured.
+ *
+ * \details         The values are only compressed when they shrink by at least
+ *                  CONFIG_FPC_MIN_RATIO, decoding costing ALU cycles.
+ *
+ * \param[in,out]   bh: Pointer to the benchmark handler, the input matrix loaded.
+ * \param[in]       cfg: Pointer to the benchmark configuration.
+ * \return          RC_OK on success, an error code otherwise.
+ */
+int bench_quant_init(struct BenchHandler *bh, const struct BenchConfig *cfg);
+
+/*!
+ * \brief           Measure the quantized SpMV against the exact one.
+ *
+ * \details         Recomputes the quantized product, so the result does not
+ *                  depend on the mode, and the exact one in a new vector.
+ *
+ * \param[in,out]   bh: Pointer to the benchmark handler.
+ * \param[out]      results: Pointer to the benchmark results to fill.
+ * \param[out]      arena: Pointer to the arena handler for memory allocation.
+ * \return          RC_OK on success, an error code otherwise.
+ */
+int bench_quant_report(struct BenchHandler *bh, struct BenchResults *results, struct ArenaHandler *arena);
+
+/*!
+ * \brief           Write the fields of the quantized or compressed values to the results JSON.
+ *
+ * \param[out]      fp: The results file.
+ * \param[in]       results: Pointer to the benchmark results.
+ */
+void bench_quant_write_json(FILE *fp, const struct BenchResults *results);
+
+#endif /*! BENCH_QUANT_H */
@@ -0,0 +1,82 @@
+/*!
+ * \file            bench_spgemm.h
+ * \date            2026-10-18
+ * \author          Mirko Lana [lana.mirko@icloud.com]
+ *
+ * \brief           SpGEMM mode of the benchmark (spgemm).
+ *
+ * \details         Each run computes A * A for a square input matrix, and
+ *                  A * A^T otherwise, with the product planned once at init
+ *                  (see spgemm.h); the report checks the product against
+ *                  two SpMVs.
+ *
+ * \warning         Memory management is handled via an arena allocator; ensure
+ *                  that the arena is properly initialized and destroyed.
+ */
+
+#ifndef BENCH_SPGEMM_H
+#define BENCH_SPGEMM_H
+
+#include "arena.h"
+#include "csr.h"
+#include "spgemm.h"
+
+#include <stddef.h>
+#include <stdio.h>
+
+struct BenchHandler;
+struct BenchResults;
+
+/*!
+ * \brief           Structure containing the operands and the product of the spgemm mode.
+ */
+struct BenchSpgemm {
+    struct CsrMatrix b;       /*!< Transpose of the input matrix, right operand if not square. */
+    struct SpgemmPlan plan;   /*!< Planned product. */
+    struct CsrMatrix product; /*!< Last computed product. */
+};
+
+/*!
+ * \brief           Structure containing the results of the spgemm mode.
+ */
+struct BenchSpgemmResults {
+    long long flops; /*!< The operations of one SpGEMM, 2 per multiply-add. */
+    int nnz;         /*!< The non-zeros of the product. */
+    int ub_nnz;      /*!< The upper bound of the non-zeros of the product. */
+    size_t bytes;    /*!< The bytes allocated for the product and the accumulators. */
+    int hash_rows;   /*!< The rows accumulated in a hash table. */
+    int dense_rows;  /*!< The rows accumulated in a dense array. */
+    double rel_l2;   /*!< The relative L2 difference between C * x and A * (B * x). */
+};
+
+/*!
+ * \brief           Plan the product of the input matrix with itself, or with its transpose if not square.
+ *
+ * \param[in,out]   bh: Pointer to the benchmark handler, the input matrix loaded.
+ * \param[out]      arena: Pointer to the arena handler for memory allocation.
+ * \return          RC_OK on success, an error code otherwise.
+ */
+int bench_spgemm_init(struct BenchHandler *bh, struct ArenaHandler *arena);
+
+/*!
+ * \brief           Collect the figures of the product once the runs are over and check it.
+ *
+ * \details         Compares C * x with A * (B * x), both computed with
+ *                  csr_matrix_mul_vec, for a random x.
+ *
+ * \param[in]       bh: Pointer to the benchmark handler.
+ * \param[out]      results: Pointer to the benchmark results to fill, mean set.
+ * \param[out]      arena: Pointer to the arena handler for memory allocation.
+ * \return          RC_OK on success, an error code otherwise.
+ */
+int bench_spgemm_report(const struct BenchHandler *bh, struct BenchResults *results, struct ArenaHandler *arena);
+
+/*!
+ * \brief           Write the fields of the spgemm mode to the results JSON.
+ *
+ * \param[out]      fp: The results file.
+ * \param[in]       results: Pointer to the benchmark results.
+ */
+void bench_spgemm_write_json(FILE *fp, const struct BenchResults *results);
+
+#endif /*! BENCH_SPGEMM_H */
@@ -0,0 +1,130 @@
+/*!
+ * \file            bench_throughput.h
+ * \date            2026-10-18
+ * \author          Mirko Lana [lana.mirko@icloud.com]
+ *
+ * \brief           Throughput mode of the benchmark (throughput).
+ *
+ * \details         The threads are split in core groups, each one running its
+ *                  own SpMV streams side by side with the others, with a
+ *                  driver thread and a pool of its own. A run computes one
+ *                  SpMV of every stream; the report times the same SpMVs one
+ *                  after the other with the whole team.
+ *
+ *                  The streams (a handler per input file, with its vectors)
+ *                  are also the inputs of the batched mode.
+ *
+ * \warning         Memory management is handled via an arena allocator; ensure
+ *                  that the arena is properly initialized and destroyed.
+ */
+
+#ifndef BENCH_THROUGHPUT_H
+#define BENCH_THROUGHPUT_H
+
+#include "arena.h"
+
+#include <stdint.h>
+#include <stdio.h>
+
+struct BenchHandler;
+struct BenchConfig;
+struct BenchResults;
+
+/*!
+ * \brief           Structure containing the core groups of the throughput mode.
+ */
+struct BenchThroughput {
+    int groups;                 /*!< Number of core groups running the streams side by side. */
+    int group_threads;          /*!< Number of threads of a group. */
+    struct ArenaObj group_cpus; /*!< CPU of each thread of the groups, groups * group_threads int. */
+};
+
+/*!
+ * \brief           Structure containing the results of the throughput mode.
+ */
+struct BenchThroughputResults {
+    int groups;            /*!< The number of core groups. */
+    int group_threads;     /*!< The number of threads of a group. */
+    int streams;           /*!< The number of SpMV streams. */
+    long long flops;       /*!< The operations of one run, 2 per non-zero of every stream. */
+    double spmv_per_s;     /*!< The SpMVs per second of all the streams together. */
+    uint64_t seq_mean;     /*!< The mean time of one SpMV of every stream, one after the other on all the threads. */
+    double seq_spmv_per_s; /*!< The SpMVs per second of the streams one after the other. */
+};
+
+/*!
+ * \brief           Load the matrices of the streams and their vectors.
+ *
+ * \details         Stream s multiplies file s % matrices with vectors of its
+ *                  own; the streams of the same file share its matrix, stream 0
+ *                  that of the handler.
+ *
+ * \param[in,out]   bh: Pointer to the benchmark handler, the input matrix loaded.
+ * \param[in]       cfg: Pointer to the benchmark configuration.
+ * \param[in]       streams: Number of streams.
+ * \return          RC_OK on success, an error code otherwise.
+ */
+int bench_throughput_streams_init(struct BenchHandler *bh, const struct BenchConfig *cfg, int streams);
+
+/*!
+ * \brief           Split the threads in core groups and load the SpMV streams.
+ *
+ * \details         Without a given number of groups, every group gets the
+ *                  thread count the policy picks for the input matrix, so that
+ *                  no thread is spent where the SpMV no longer scales. Stream s
+ *                  runs on group s % groups, each group getting at least one.
+ *
+ * \param[in,out]   bh: Pointer to the benchmark handler, the input matrix loaded.
+ * \param[in]       cfg: Pointer to the benchmark configuration.
+ * \return          RC_OK on success, an error code otherwise.
+ *                   - RC_INVALID_ARG_ERR if there are more groups than threads.
+ */
+int bench_throughput_init(struct BenchHandler *bh, const struct BenchConfig *cfg);
+
+/*!
+ * \brief           Compute one SpMV of every stream, one after the other with all the threads.
+ *
+ * \param[in,out]   bh: Pointer to the benchmark handler.
+ * \return          RC_OK on success, an error code otherwise.
+ */
+int bench_throughput_spmv(struct BenchHandler *bh);
+
+/*!
+ * \brief           Run the streams of every core group side by side.
+ *
+ * \details         Each group has a driver thread, pinned to its first CPU,
+ *                  and a pool of its own for the other ones. The groups warm up
+ *                  and then start their runs together; the sample of a run is
+ *                  that of the slowest group, and the aggregate throughput the
+ *                  SpMVs of all the runs over the time from the common start to
+ *                  the end of the last group.
+ *
+ * \param[in,out]   bh: Pointer to the benchmark handler.
+ * \param[in,out]   results: Pointer to the benchmark results, samples allocated.
+ * \param[out]      arena: Pointer to the arena handler for memory allocation.
+ * \return          RC_OK on success, an error code otherwise.
+ */
+int bench_throughput_run(struct BenchHandler *bh, struct BenchResults *results, struct ArenaHandler *arena);
+
+/*!
+ * \brief           Measure the streams side by side against the same SpMVs one after the other.
+ *
+ * \details         Times runs of one SpMV of every stream with the whole team
+ *                  of the parallel backend, i.e. what a latency-oriented caller
+ *                  would do with the same work.
+ *
+ * \param[in,out]   bh: Pointer to the benchmark handler.
+ * \param[out]      results: Pointer to the benchmark results to fill.
+ * \return          RC_OK on success, an error code otherwise.
+ */
+int bench_throughput_report(struct BenchHandler *bh, struct BenchResults *results);
+
+/*!
+ * \brief           Write the fields of the throughput mode to the results JSON.
+ *
+ * \param[out]      fp: The results file.
+ * \param[in]       results: Pointer to the benchmark results.
+ */
+void bench_throughput_write_json(FILE *fp, const struct BenchResults *results);
+
+#endif /*! BENCH_THROUGHPUT_H */
@@ -0,0 +1,133 @@
+/*!
+ * \file            chunk.h
+ * \date            2026-10-18
+ * \author          Mirko Lana [lana.mirko@icloud.com]
+ *
+ * \brief           SpMV delivering the result in row chunks as they complete.
+ *
+ * \details         Stages consuming y (thresholding, top-k, writing to disk)
+ *                  normally wait for the whole product. chunk_mul_vec splits
+ *                  the rows in chunks, taken in increasing order by the
+ *                  threads as they become free, and hands each chunk of y to
+ *                  a consumer callback as soon as it is computed, while the
+ *                  other threads go on with the following chunks: the
+ *                  consumer works on rows still in the caches of the thread
+ *                  that computed them, overlapped with the rest of the
+ *                  multiply.
+ *
+ *                  With CHUNK_ORDER_ANY the callback runs on the thread that
+ *                  computed the chunk, as soon as it completes, possibly
+ *                  concurrently from several threads. With CHUNK_ORDER_ROWS
+ *                  the chunks are delivered one at a time in row order: a
+ *                  computed chunk is marked done, and the thread that
+ *                  completes the first chunk not delivered yet delivers it and
+ *                  every following chunk already done, while the other
+ *                  threads go on computing. A slow consumer thus holds one
+ *                  thread at a time, and the callback may run on a thread
+ *                  other than the one that computed the chunk.
+ *
+ *                  To process the chunks on a thread of its own, the consumer
+ *                  pushes the chunk index in a queue (see queue.h) from the
+ *                  callback and pops it on the other side.
+ */
+
+#ifndef CHUNK_H
+#define CHUNK_H
+
+#include "arena.h"
+#include "csr.h"
+#include "vec.h"
+
+/*!
+ * \brief           Delivery orders of the chunks.
+ */
+enum ChunkOrder {
+    CHUNK_ORDER_ANY,   /*!< As they complete, possibly concurrently */
+    CHUNK_ORDER_ROWS,  /*!< One at a time, in row order */
+    CHUNK_ORDER_COUNT, /*!< Number of orders */
+};
+
+/*!
+ * \brief           Consumer of a chunk of the result.
+ *
+ * \param[in,out]   arg: User argument of the configuration.
+ * \param[in]       result: The result vector, rows row_begin to row_end - 1 final.
+ * \param[in]       chunk: Index of the chunk.
+ * \param[in]       row_begin: First row of the chunk.
+ * \param[in]       row_end: One past the last row of the chunk.
+ */
+typedef void (*ChunkConsumerFn)(void *arg, const struct Vec *result, int chunk, int row_begin, int row_end);
+
+/*!
+ * \brief           Structure representing how the result of a chunked SpMV is delivered.
+ */
+struct ChunkConfig {
+    int rows;              /*!< Rows per chunk, 0 for automatic nnz-balanced chunks (see chunk_init). */
+    enum ChunkOrder order; /*!< Delivery order of the chunks. */
+    ChunkConsumerFn fn;    /*!< Consumer called once per chunk. */
+    void *arg;             /*!< User argument given to fn. */
+};
+
+/*!
+ * \brief           Structure representing the chunks of a matrix and their delivery.
+ */
+struct ChunkPlan {
+    const struct CsrMatrix *mtx; /*!< Input matrix. */
+    struct ChunkConfig cfg;      /*!< Delivery of the chunks. */
+    int chunks;                  /*!< Number of chunks (0 for a matrix without rows). */
+    struct ArenaObj done;        /*!< Per-chunk computed flags (atomic_bool, row order delivery). */
+};
+
+/*!
+ * \brief           Initialize the chunks of a matrix.
+ *
+ * \details         Automatic chunks are balanced by non-zeros: at least
+ *                  CONFIG_CHUNK_PER_THREAD per thread of the parallel backend,
+ *                  and more if needed so that the non-zeros of a chunk take at
+ *                  most 1/CONFIG_CHUNK_L2_SHARE of the L2 cache. Uses the
+ *                  current thread count of the parallel backend.
+ *
+ * \param[out]      plan: Pointer to the plan to initialize.
+ * \param[in]       mtx: Pointer to the CSR matrix.
+ * \param[in]       cfg: Pointer to the delivery configuration (copied).
+ * \param[out]      arena: Pointer to the arena handler for memory allocation.
+ * \return          RC_OK on success, an error code otherwise:
+ *                   - RC_INVALID_ARG_ERR if any argument is invalid.
+ *                   - RC_MEM_ALLOC_ERR if memory allocation fails.
+ */
+int chunk_init(struct ChunkPlan *plan, const struct CsrMatrix *mtx, const struct ChunkConfig *cfg, struct ArenaHandler *arena);
+
+/*!
+ * \brief           Multiply the matrix of a plan with a vector, delivering the result in chunks.
+ *
+ * \details         Runs with the threads of the parallel backend (the OpenMP
+ *                  team or the default Pthreads pool), serially with a single
+ *                  thread. Returns once every chunk was consumed.
+ *
+ * \param[in,out]   plan: Pointer to the plan of the matrix.
+ * \param[in]       vec: Pointer to the input vector.
+ * \param[out]      result: Pointer to the output vector to store the result.
+ * \return          RC_OK on success, an error code otherwise:
+ *                   - RC_INVALID_ARG_ERR if any argument is invalid.
+ */
+int chunk_mul_vec(struct ChunkPlan *plan, const struct Vec *vec, struct Vec *result);
+
+/*!
+ * \brief           Parse a delivery order name.
+ *
+ * \param[in]       str: The order name ("any", "rows").
+ * \param[out]      order: Pointer to store the parsed order.
+ * \return          RC_OK on success, an error code otherwise.
+ *                   - RC_INVALID_ARG_ERR if any argument is NULL or the name is unknown.
+ */
+int chunk_order_from_str(const char *str, enum ChunkOrder *order);
+
+/*!
+ * \brief           Get the name of a delivery order.
+ *
+ * \param[in]       order: The order.
+ * \return          The name of the order.
+ */
+const char *chunk_order_to_str(enum ChunkOrder order);
+
+#endif /*! CHUNK_H */
@@ -9,17 +9,42 @@
 #ifndef CLI_H
 #define CLI_H
 
+#include "bench.h"
+#include "config.h"
+#include "csr.h"
+
+#include <stdbool.h>
 #include <stdint.h>
 
 /*!
  * \brief          Command-Line Arguments
  */
 struct CliArguments {
-    char *input_file; /*!< Path to the input file */
-    int num_threads;  /*!< Number of threads */
-    int warmup_iters; /*!< Number of warm-up iterations */
-    int runs;         /*!< Number of benchmark runs */
-    uint8_t log_lv;   /*!< Logging level */
+    char *input_file;                             /*!< Path to the input file */
+    char *input_files[CONFIG_SERVE_MAX_MATRICES]; /*!< Paths to the input files, -i given several times (--serve, throughput and batched modes) */
+    int input_count;                              /*!< Number of input files */
+    const char *serve_path;                       /*!< Path of the socket of the SpMV server, NULL to benchmark */
+    const char *batch_list;                       /*!< Path of the list of matrices benchmarked in turn (--batch), NULL for -i */
+    const char *x_file;                           /*!< Path of the input vector (-x), NULL for random values */
+    const char *y_file;                           /*!< Path receiving the result (-y), NULL to drop it */
+    int coalesce;                                 /*!< Maximum number of products of a pass of the server (--serve) */
+    int window_us;                                /*!< Time a product may wait for others of its matrix (--serve) */
+    int num_threads;                              /*!< Number of threads */
+    int warmup_iters;                             /*!< Number of warm-up iterations */
+    int runs;                                     /*!< Number of benchmark runs */
+    enum BenchMode mode;                          /*!< Benchmark execution mode */
+    enum CsrKernel kernel;                        /*!< SpMV kernel */
+    int quant_bits;                               /*!< Bits of the quantized values (0 = exact) */
+    bool compress;                                /*!< Lossless value compression */
+    int mpk_steps;                                /*!< Number of powers (mpk mode) */
+    int poly_degree;                              /*!< Degree of the polynomial (poly mode) */
+    int gpart_parts;                              /*!< Number of parts of the graph partition (gpart mode) */
+    int batch_count;                              /*!< Number of matrices of the batch (batched mode) */
+    int chunk_rows;                               /*!< Rows per chunk, 0 = balanced by non-zeros (chunked mode) */
+    enum ChunkOrder chunk_order;                  /*!< Delivery order of the chunks (chunked mode) */
+    int tp_groups;                                /*!< Number of core groups, 0 = picked from the thread policy (throughput mode) */
+    bool shared;                                  /*!< Load the matrix through the shared-memory store */
+    uint8_t log_lv;                               /*!< Logging level */
 };
 
 /*!
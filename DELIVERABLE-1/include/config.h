@@ -17,10 +17,22 @@
 #define CONFIG_RAND_MAX 99                 /*! Maximum random value */
 #define CONFIG_RAND_MIN 0                  /*! Minimum random value */
 #define CONFIG_BENCH_FILENAME_MAX_LEN 256U /*! Maximum length for benchmark filename */
-#define CONFIG_DEFAULT_NUM_THREADS 16      /*! Default number of threads to use */
+#define CONFIG_DEFAULT_NUM_THREADS 0       /*! Default number of threads to use (0 = picked per matrix) */
 #define CONFIG_DEFAULT_WARMUP_ITERS 5      /*! Default number of warm-up iterations */
 #define CONFIG_DEFAULT_RUNS 10             /*! Default number of runs */
 #define CONFIG_DEFAULT_LOG_LV 0b0111       /*! Default logging level */
+#define CONFIG_DEFAULT_BENCH_MODE "call"   /*! Default benchmark execution mode */
+#define CONFIG_DEFAULT_KERNEL "auto"       /*! Default SpMV kernel */
+#define CONFIG_DEFAULT_QUANT_BITS 0        /*! Default bits of the quantized values (0 = exact SpMV) */
+#define CONFIG_DEFAULT_COMPRESS false      /*! Default lossless value compression (-z) */
+#define CONFIG_DEFAULT_MPK_STEPS 4         /*! Default number of powers computed per run (mpk mode) */
+#define CONFIG_DEFAULT_POLY_DEGREE 8       /*! Default degree of the Chebyshev polynomial (poly mode) */
+#define CONFIG_DEFAULT_GPART_PARTS 8       /*! Default number of parts of the graph partition (gpart mode) */
+#define CONFIG_DEFAULT_TP_GROUPS 0         /*! Default number of core groups (throughput mode, 0 = picked from the thread policy) */
+#define CONFIG_DEFAULT_BATCH_COUNT 4096   /*! Default number of matrices of the batch (batched mode) */
+#define CONFIG_DEFAULT_CHUNK_ROWS 0        /*! Default rows per chunk (chunked mode, 0 = automatic nnz-balanced chunks) */
+#define CONFIG_DEFAULT_CHUNK_ORDER "rows"  /*! Default delivery order of the chunks (chunked mode) */
+#define CONFIG_DEFAULT_SHARED false       /*! Default shared-memory matrix store (-S) */
 
 /*!
  * @}
@@ -32,12 +44,87 @@
  */
 
 // #define CONFIG_ENABLE_SERIAL_EXECUTION     /*! Enable serial execution mode */
-// #define CONFIG_ENABLE_PTHREADS_PARALLELISM /*! Enable Pthreads parallelism (not implemented) */
+// #define CONFIG_ENABLE_PTHREADS_PARALLELISM /*! Enable Pthreads parallelism (persistent pool) */
 #define CONFIG_ENABLE_OMP_PARALLELISM /*! Enable OpenMP parallelism */
+// #define CONFIG_ENABLE_MPI             /*! MPI backend (dist mode), defined by make MPI=1 */
 #define CONFIG_OMP_SCHEDULE guided    /*! OpenMP scheduling strategy */
 
+#define CONFIG_THREADS_AUTO 0                    /*! Thread count value asking the policy to pick it per matrix */
+#define CONFIG_POLICY_SERIAL_NNZ 20000           /*! Below this many non-zeros the SpMV always runs serially */
+#define CONFIG_POLICY_PROBE_MAX_NNZ 50000000     /*! Above this many non-zeros the policy skips probing and uses all threads */
+#define CONFIG_POLICY_PROBE_REGIONS 200          /*! Number of empty parallel regions timed to measure fork/join overhead */
+#define CONFIG_POLICY_PROBE_SPMVS 2              /*! Number of SpMVs timed per probed thread count (best is kept) */
+#define CONFIG_BARRIER_SPINS 4096                /*! Spin iterations before a barrier waiter yields the CPU */
+#define CONFIG_PARTITION_REBALANCE_DAMPING 0.75  /*! Fraction of the measured imbalance corrected at each rebalance */
+#define CONFIG_ADAPTIVE_PROBE_RUNS 3             /*! SpMVs timed per thread before the first rebalance (adaptive mode) */
+#define CONFIG_ADAPTIVE_PERIOD 10                /*! SpMVs between two rebalances after the first one (adaptive mode) */
+#define CONFIG_POOL_SPINS 4096                   /*! Polls of an idle pool worker before it sleeps */
+#define CONFIG_WS_BLOCKS_PER_THREAD 16           /*! Row blocks per thread of the work-stealing scheduler */
+#define CONFIG_SIMD_ROW_GROUP 8                  /*! Rows per scheduling unit of the explicit SIMD kernels */
+#define CONFIG_SIMD_LANES_MAX_NNZ 16             /*! Longest row computed one per lane by the lanes kernel */
+#define CONFIG_FPC_BLOCK_NNZ 256                 /*! Values per independently decodable block of the compressed values (even) */
+#define CONFIG_FPC_MIN_RATIO 1.2                 /*! Below this compression ratio the values are left uncompressed */
+#define CONFIG_CSR_BLOCK_MAX 8                   /*! Maximum number of vectors multiplied at once by csr_matrix_mul_block */
+#define CONFIG_PREFETCH_LINES 4                  /*! Cache lines of column indexes between a software prefetch of a vector item and its use (prefetch kernel) */
+#define CONFIG_HELPER_L2_SHARE 4                 /*! A helper thread may run ahead of its compute thread by 1/n of the L2 lines (helper mode) */
+#define CONFIG_HELPER_STEP 64                    /*! Non-zeros touched by a helper thread between two progress checks (helper mode) */
+#define CONFIG_HELPER_PUBLISH_ROWS 16            /*! Rows computed between two progress updates of a compute thread (helper mode) */
+#define CONFIG_SPGEMM_HASH_MAX_NNZ 512           /*! Longest row bound of the product using a hash accumulator, longer rows use a dense one */
+#define CONFIG_SPGEMM_CHUNK_ROWS 64              /*! Rows per dynamically scheduled chunk of the SpGEMM */
+#define CONFIG_MPK_MAX_STEPS 16                  /*! Maximum number of powers of the matrix-powers kernel */
+#define CONFIG_MPK_MIN_BLOCK_NNZ 1024            /*! Smallest row block of the matrix-powers kernel, blocks being sized so that reach + 2 of them fit in L2 */
+#define CONFIG_MPK_MAX_REACH 4                   /*! Farthest block a block may read for the powers to advance as a wavefront */
+#define CONFIG_POLY_MAX_DEGREE 64                /*! Maximum degree of the Chebyshev polynomial (poly mode) */
+#define CONFIG_DIST_CHECK_MAX_NNZ 50000000       /*! Above this many non-zeros the distributed SpMV is not checked against a whole copy on rank 0 */
+#define CONFIG_GPART_MAX_PARTS 1024              /*! Maximum number of parts of the graph partitioner */
+#define CONFIG_GPART_IMBALANCE 1.03              /*! Largest allowed part weight over the mean weight of a part */
+#define CONFIG_GPART_COARSEN_TO 256              /*! Vertices of the coarsest graph, bisected directly */
+#define CONFIG_GPART_MAX_LEVELS 32               /*! Maximum number of coarsening levels */
+#define CONFIG_GPART_INIT_TRIES 8                /*! Random seeds of the greedy growth of the initial bisection */
+#define CONFIG_GPART_FM_PASSES 8                 /*! Maximum number of Fiduccia-Mattheyses passes per level */
+#define CONFIG_GPART_FM_MAX_STALL 100            /*! Moves without improvement before a Fiduccia-Mattheyses pass stops */
+#define CONFIG_GPART_SEED 0x9e3779b97f4a7c15ULL  /*! Seed of the random generator of the graph partitioner (reproducible partitions) */
+#define CONFIG_SHM_NAME_PREFIX "/spvm-"          /*! Prefix of the names of the shared-memory matrix segments */
+#define CONFIG_SHM_NAME_MAX_LEN 64               /*! Maximum length of the name of a shared-memory segment */
+#define CONFIG_SHM_READY_TIMEOUT_MS 300000       /*! Longest wait for another process to publish a matrix before loading it privately */
+#define CONFIG_SHM_POLL_US 1000                  /*! Interval between two checks of a segment being published */
+#define CONFIG_SERVE_MAX_MATRICES 16             /*! Maximum number of matrices served (-i given several times with --serve) */
+#define CONFIG_SERVE_MAX_CLIENTS 64              /*! Maximum number of clients connected to the server at once */
+#define CONFIG_SERVE_QUEUE_LEN 64                /*! Capacity of the request queue of the server (power of two, >= CONFIG_SERVE_MAX_CLIENTS) */
+#define CONFIG_SERVE_BACKLOG 16                  /*! Pending connections of the server socket */
+#define CONFIG_SERVE_SPINS 100000                /*! Polls of the empty request queue before the SpMV thread of the server sleeps */
+#define CONFIG_SERVE_POLL_MS 100                 /*! Longest time before the connection thread of the server notices a signal */
+#define CONFIG_SERVE_DEFAULT_COALESCE 8          /*! Default maximum number of products of a matrix computed in one SpMM pass (1 to CONFIG_CSR_BLOCK_MAX) */
+#define CONFIG_SERVE_DEFAULT_WINDOW_US 0         /*! Default time a product may wait for others of its matrix (0 = only those already queued) */
+#define CONFIG_SERVE_MAX_WINDOW_US 1000000       /*! Maximum coalescing window of the server */
+#define CONFIG_SWEEP_SLOTS 2                     /*! Matrices held at once by --batch: the one benchmarked and the one loaded next */
+#define CONFIG_SWEEP_PATH_MAX_LEN 1024           /*! Longest path of a matrix of a --batch list, NUL included */
+#define CONFIG_BATCH_MAX_COUNT 1048576           /*! Maximum number of matrices of a batch (batched mode) */
+#define CONFIG_CHUNK_PER_THREAD 4                /*! Minimum automatic chunks per thread of a chunked SpMV, so the threads balance and the first chunk comes early */
+#define CONFIG_CHUNK_L2_SHARE 2                  /*! Fraction of the L2 cache of a core the non-zeros of an automatic chunk may take at most */
+#define CONFIG_VECIO_SLICE_ROWS 2048             /*! Rows of a vector formatted by a thread at a time when written as Matrix Market */
+#define CONFIG_VECIO_SLICES 32                   /*! Slices of a block of rows formatted in parallel, then written in order */
+#define CONFIG_VECIO_ITEM_MAX_LEN 32             /*! Room for a formatted value and its newline ("%.17g\n" needs 25) */
+#define CONFIG_TP_MAX_GROUPS 256                 /*! Maximum number of core groups running SpMV streams side by side (throughput mode) */
+
 /*!
   * @}
   */
 
+/*!
+ * \defgroup        Topology Configuration
+ * @{
+ */
+
+#define CONFIG_TOPO_SYSFS_CPU_PATH "/sys/devices/system/cpu" /*! Root of the sysfs CPU tree */
+#define CONFIG_TOPO_MAX_CPUS 1024                            /*! Maximum number of logical CPUs tracked */
+#define CONFIG_TOPO_FALLBACK_L1D_SIZE (32 * 1024)            /*! L1 data cache size used when sysfs is unavailable */
+#define CONFIG_TOPO_FALLBACK_L2_SIZE (1024 * 1024)           /*! L2 cache size used when sysfs is unavailable */
+#define CONFIG_TOPO_FALLBACK_L3_SIZE (16 * 1024 * 1024)      /*! L3 cache size used when sysfs is unavailable */
+#define CONFIG_TOPO_FALLBACK_LINE_SIZE 64                    /*! Cache line size used when sysfs is unavailable */
+
+/*!
+ * @}
+ */
+
 #endif /* CONFIG_H */
@@ -20,18 +20,117 @@
 #include "vec.h"
 
 #include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+/*!
+ * \brief           SpMV kernel variants.
+ */
+enum CsrKernel {
+    CSR_KERNEL_AUTO,     /*!< Row loop vectorized by the compiler (omp simd) */
+    CSR_KERNEL_GATHER,   /*!< Explicit AVX2/AVX-512 gathers, one row at a time */
+    CSR_KERNEL_LANES,    /*!< Explicit AVX2/AVX-512 gathers, one short row per vector lane */
+    CSR_KERNEL_PREFETCH, /*!< Auto-vectorized row loop with software prefetches of the gathered vector items */
+    CSR_KERNEL_COUNT,    /*!< Number of kernels */
+};
+
+/*!
+ * \brief           Storage types of the CSR values.
+ */
+enum CsrValType {
+    CSR_VAL_REAL,  /*!< double */
+    CSR_VAL_INT32, /*!< int32_t */
+    CSR_VAL_INT16, /*!< int16_t */
+    CSR_VAL_INT8,  /*!< int8_t */
+};
 
 /*!
  * \brief           Structure representing a sparse matrix in CSR format.
+ *
+ * \details         Integer values are stored in the narrowest type holding all
+ *                  of them (see val_type); the SpMV still reads and writes int
+ *                  vectors.
  */
 struct CsrMatrix {
-    int m;        /*< Number of rows in the matrix */
-    int n;        /*< Number of columns in the matrix */
-    int nz;       /*< Number of non-zero items in the matrix */
-    bool is_real; /*< Flag indicating if the matrix holds real (true) or integer (false) values */
+    int m;                    /*< Number of rows in the matrix */
+    int n;                    /*< Number of columns in the matrix */
+    int nz;                   /*< Number of non-zero items in the matrix */
+    bool is_real;             /*< Flag indicating if the matrix holds real (true) or integer (false) values */
+    enum CsrValType val_type; /*< Storage type of the values */
+    int max_abs_val;          /*< Largest absolute value (integer matrices) */
+    int max_row_nnz;          /*< Number of non-zeros of the longest row */
     struct ArenaObj col;
     struct ArenaObj row;
     struct ArenaObj val;
+    int *mapped_col;          /*< Column indices mapped from a shared-memory store (read-only), used instead of col if not NULL */
+    int *mapped_row;          /*< Row pointers mapped from a shared-memory store (read-only), used instead of row if not NULL */
+    void *mapped_val;         /*< Values mapped from a shared-memory store (read-only), used instead of val if not NULL */
+};
+
+/*!
+ * \brief           Get the row pointers of a CSR matrix.
+ *
+ * \details         The arrays of a matrix are in the arena, or outside of it
+ *                  when attached from a shared-memory store (see shm.h): they
+ *                  are always reached through csr_matrix_row_ptr,
+ *                  csr_matrix_col_idx and csr_matrix_values.
+ *
+ * \param[in]       mtx: Pointer to the CSR matrix.
+ * \return          Pointer to the m + 1 row pointers.
+ */
+static inline int *csr_matrix_row_ptr(const struct CsrMatrix *mtx) {
+    return mtx->mapped_row ? mtx->mapped_row : arena_get_ptr(&mtx->row);
+}
+
+/*!
+ * \brief           Get the column indices of a CSR matrix.
+ *
+ * \param[in]       mtx: Pointer to the CSR matrix.
+ * \return          Pointer to the nz column indices.
+ */
+static inline int *csr_matrix_col_idx(const struct CsrMatrix *mtx) {
+    return mtx->mapped_col ? mtx->mapped_col : arena_get_ptr(&mtx->col);
+}
+
+/*!
+ * \brief           Get the values of a CSR matrix.
+ *
+ * \param[in]       mtx: Pointer to the CSR matrix.
+ * \return          Pointer to the nz values, of type val_type.
+ */
+static inline void *csr_matrix_values(const struct CsrMatrix *mtx) {
+    return mtx->mapped_val ? mtx->mapped_val : arena_get_ptr(&mtx->val);
+}
+
+/*!
+ * \brief           Get the size of a value of a CSR matrix.
+ *
+ * \param[in]       mtx: Pointer to the CSR matrix.
+ * \return          The size in bytes of one value, of type val_type.
+ */
+static inline size_t csr_matrix_val_size(const struct CsrMatrix *mtx) {
+    static const size_t val_sizes[] = {
+        [CSR_VAL_REAL] = sizeof(double),
+        [CSR_VAL_INT32] = sizeof(int32_t),
+        [CSR_VAL_INT16] = sizeof(int16_t),
+        [CSR_VAL_INT8] = sizeof(int8_t),
+    };
+    return val_sizes[mtx->val_type];
+}
+
+/*!
+ * \brief           Structure representing a polynomial in the Chebyshev basis of a shifted and scaled matrix.
+ *
+ * \details         p(A) = sum(c_k * T_k(B)) for k = 0 .. degree, with
+ *                  B = scale * A + shift * I. Map the spectrum [lo, hi] of A to
+ *                  [-1, 1] with scale = 2 / (hi - lo) and shift = -(hi + lo) /
+ *                  (hi - lo).
+ */
+struct CsrPoly {
+    int degree;           /*< Degree of the polynomial */
+    const double *coeffs; /*< Coefficients c_0 .. c_degree */
+    double scale;         /*< Scale of A in B */
+    double shift;         /*< Shift of the identity in B */
 };
 
 /*!
@@ -60,6 +159,22 @@ int csr_matrix_from_coo(struct CsrMatrix *dest, const struct CooMatrix *src, str
  */
 int csr_matrix_load_from_file(struct CsrMatrix *mtx, const char *filename, struct ArenaHandler *arena);
 
+/*!
+ * \brief           Transpose a CSR matrix.
+ *
+ * \details         Counting sort of the non-zeros by column: the columns of
+ *                  each row of the transpose come out sorted. Values keep their
+ *                  storage type.
+ *
+ * \param[out]      dest: Pointer to the CSR matrix receiving the transpose.
+ * \param[in]       src: Pointer to the CSR matrix to transpose.
+ * \param[out]      arena: Pointer to the arena handler for memory allocation.
+ * \return          RC_OK on success, an error code otherwise:
+ *                   - RC_INVALID_ARG_ERR if any argument is invalid.
+ *                   - RC_MEM_ALLOC_ERR if memory allocation fails.
+ */
+int csr_matrix_transpose(struct CsrMatrix *dest, const struct CsrMatrix *src, struct ArenaHandler *arena);
+
 /*!
  * \brief           Multiply a CSR matrix with a vector.
  *
@@ -72,4 +187,108 @@ int csr_matrix_load_from_file(struct CsrMatrix *mtx, const char *filename, struc
  */
 int csr_matrix_mul_vec(const struct CsrMatrix *mtx, const struct Vec *vec, struct Vec *result);
 
+/*!
+ * \brief           Multiply a range of rows of a CSR matrix with a vector (serial).
+ *
+ * \details         Building block for callers that manage their own threads
+ *                  (e.g. a persistent parallel region), each thread computing
+ *                  its own rows of the result.
+ *
+ * \warning         Hot path: the matrix and vectors are not validated. Check
+ *                  them once with csr_matrix_mul_vec before looping.
+ *
+ * \param[in]       mtx: Pointer to the CSR matrix.
+ * \param[in]       vec: Pointer to the input vector.
+ * \param[out]      result: Pointer to the output vector to store the result.
+ * \param[in]       row_begin: First row of the range.
+ * \param[in]       row_end: One past the last row of the range.
+ * \return          RC_OK on success, an error code otherwise:
+ *                   - RC_IDX_OUT_OF_BOUNDS_ERR if the range is invalid.
+ */
+int csr_matrix_mul_vec_rows(const struct CsrMatrix *mtx, const struct Vec *vec, struct Vec *result, int row_begin, int row_end);
+
+/*!
+ * \brief           Multiply a CSR matrix with a block of vectors (SpMM).
+ *
+ * \details         The k vectors are interleaved: item j of input vector v is
+ *                  at j * k + v of vec, item i of result v at i * k + v of
+ *                  result. The matrix is streamed once for all of them, each
+ *                  non-zero updating k sums from one contiguous run of vec.
+ *                  Integer sums are accumulated in int64 and saturated to
+ *                  int32. Always runs the auto-vectorized kernel.
+ *
+ * \param[in]       mtx: Pointer to the CSR matrix.
+ * \param[in]       vec: Pointer to the input block (n * k items).
+ * \param[out]      result: Pointer to the result block (m * k items).
+ * \param[in]       k: Number of vectors, 1 to CONFIG_CSR_BLOCK_MAX.
+ * \return          RC_OK on success, an error code otherwise:
+ *                   - RC_INVALID_ARG_ERR if any argument is invalid.
+ */
+int csr_matrix_mul_block(const struct CsrMatrix *mtx, const struct Vec *vec, struct Vec *result, int k);
+
+/*!
+ * \brief           Apply a polynomial of a square real CSR matrix to a vector.
+ *
+ * \details         Runs the three-term recurrence T_(k+1) = 2 B T_k - T_(k-1)
+ *                  with one pass over the rows per degree: each row computes
+ *                  its item of B T_k, the new term and its contribution to the
+ *                  result together, so no vector is swept apart from the SpMV.
+ *                  The terms are written in place of the one before the last.
+ *
+ * \param[in]       mtx: Pointer to the square real CSR matrix.
+ * \param[in]       poly: Pointer to the polynomial.
+ * \param[in]       vec: Pointer to the input vector.
+ * \param[out]      result: Pointer to the result vector (may not be vec).
+ * \param[out]      work: Array of 2 work vectors of mtx->m items.
+ * \return          RC_OK on success, an error code otherwise:
+ *                   - RC_INVALID_ARG_ERR if any argument is invalid.
+ */
+int csr_matrix_poly_apply(const struct CsrMatrix *mtx, const struct CsrPoly *poly, const struct Vec *vec, struct Vec *result, struct Vec *work);
+
+/*!
+ * \brief           Parse a kernel name.
+ *
+ * \param[in]       str: The kernel name (e.g. "auto", "gather", "lanes").
+ * \param[out]      kernel: Pointer to store the parsed kernel.
+ * \return          RC_OK on success, an error code otherwise.
+ *                   - RC_INVALID_ARG_ERR if any argument is NULL or the name is unknown.
+ */
+int csr_kernel_from_str(const char *str, enum CsrKernel *kernel);
+
+/*!
+ * \brief           Get the name of a kernel.
+ *
+ * \param[in]       kernel: The kernel.
+ * \return          The name of the kernel.
+ */
+const char *csr_kernel_to_str(enum CsrKernel kernel);
+
+/*!
+ * \brief           Select the kernel used by all the CSR SpMV functions.
+ *
+ * \param[in]       kernel: The kernel.
+ */
+void csr_set_kernel(enum CsrKernel kernel);
+
+/*!
+ * \brief           Get the kernel selected with csr_set_kernel.
+ *
+ * \return          The selected kernel.
+ */
+enum CsrKernel csr_get_kernel(void);
+
+/*!
+ * \brief           Get the kernel actually used for a matrix.
+ *
+ * \details         The explicit kernels need AVX2 or AVX-512 (see isa_get):
+ *                  otherwise the SpMV falls back to CSR_KERNEL_AUTO. Integer
+ *                  matrices have a single explicit kernel, CSR_KERNEL_GATHER,
+ *                  and no prefetching one. CSR_KERNEL_PREFETCH runs on every
+ *                  instruction set.
+ *
+ * \param[in]       mtx: Pointer to the CSR matrix.
+ * \return          The kernel used for the matrix.
+ */
+enum CsrKernel csr_matrix_get_kernel(const struct CsrMatrix *mtx);
+
 #endif /*! CSR_H */
@@ -0,0 +1,90 @@
+/*!
+ * \file            deque.h
+ * \date            2026-10-18
+ * \author          Mirko Lana [lana.mirko@icloud.com]
+ *
+ * \brief           Lock-free Chase-Lev work-stealing deque.
+ *
+ * \details         The owner thread pushes and pops items at the bottom, any
+ *                  other thread may steal items from the top. The memory
+ *                  orderings follow Le et al., "Correct and Efficient
+ *                  Work-Stealing for Weak Memory Models" (PPoPP 2013).
+ *
+ *                  The capacity is fixed: the deque is meant to be refilled
+ *                  with deque_reset() and deque_push() before each phase, so
+ *                  the buffer never wraps around.
+ *
+ * \warning         Memory management is handled via an arena allocator; ensure
+ *                  that the arena is properly initialized and destroyed.
+ */
+
+#ifndef DEQUE_H
+#define DEQUE_H
+
+#include "arena.h"
+
+#include <stdatomic.h>
+#include <stdbool.h>
+
+#define DEQUE_PAD_SIZE 64 /*!< Padding keeping top, bottom and the neighbouring deques on separate cache lines */
+
+/*!
+ * \brief           Structure representing a work-stealing deque of integers.
+ */
+struct WsDeque {
+    int capacity;              /*< Maximum number of items */
+    struct ArenaObj buf;       /*< Items (atomic_int) */
+    char pad0[DEQUE_PAD_SIZE]; /*< Padding */
+    atomic_long top;           /*< Index of the next item to steal */
+    char pad1[DEQUE_PAD_SIZE]; /*< Padding */
+    atomic_long bottom;        /*< Index of the next free slot */
+    char pad2[DEQUE_PAD_SIZE]; /*< Padding */
+};
+
+/*!
+ * \brief           Initialize a deque.
+ *
+ * \param[out]      dq: Pointer to the deque to initialize.
+ * \param[in]       capacity: Maximum number of items pushed between two resets.
+ * \param[out]      arena: Pointer to the arena handler for memory allocation.
+ * \return          RC_OK on success, an error code otherwise:
+ *                   - RC_INVALID_ARG_ERR if any argument is invalid.
+ *                   - RC_MEM_ALLOC_ERR if memory allocation fails.
+ */
+int deque_init(struct WsDeque *dq, int capacity, struct ArenaHandler *arena);
+
+/*!
+ * \brief           Empty the deque (owner only, no concurrent thieves).
+ *
+ * \param[in,out]   dq: Pointer to the deque.
+ */
+void deque_reset(struct WsDeque *dq);
+
+/*!
+ * \brief           Push an item at the bottom (owner only).
+ *
+ * \param[in,out]   dq: Pointer to the deque.
+ * \param[in]       item: The item to push.
+ * \return          true on success, false if the deque is full.
+ */
+bool deque_push(struct WsDeque *dq, int item);
+
+/*!
+ * \brief           Pop an item from the bottom (owner only).
+ *
+ * \param[in,out]   dq: Pointer to the deque.
+ * \param[out]      item: Pointer to store the popped item.
+ * \return          true on success, false if the deque is empty.
+ */
+bool deque_pop(struct WsDeque *dq, int *item);
+
+/*!
+ * \brief           Steal an item from the top (any thread).
+ *
+ * \param[in,out]   dq: Pointer to the deque.
+ * \param[out]      item: Pointer to store the stolen item.
+ * \return          true on success, false if the deque is empty or the steal lost a race.
+ */
+bool deque_steal(struct WsDeque *dq, int *item);
+
+#endif /*! DEQUE_H */
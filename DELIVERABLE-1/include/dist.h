@@ -0,0 +1,149 @@
+/*!
+ * \file            dist.h
+ * \date            2026-10-18
+ * \author          Mirko Lana [lana.mirko@icloud.com]
+ *
+ * \brief           Distributed-memory SpMV over MPI ranks (row partitioning and halo exchange).
+ *
+ * \details         The rows of the matrix are split among the ranks of
+ *                  MPI_COMM_WORLD in contiguous nnz-balanced parts, and so are
+ *                  the vector items (with the same bounds for square matrices).
+ *                  No rank ever holds the whole matrix: every rank parses a
+ *                  slice of the Matrix Market file and sends each entry to the
+ *                  rank owning its row.
+ *
+ *                  The part of a rank is split in a local block, whose columns
+ *                  are the vector items of the rank, and a remote block, whose
+ *                  columns index the halo: the items owned by other ranks that
+ *                  its rows read, sorted by owner. The communication pattern
+ *                  (which items each rank sends to which) is computed once at
+ *                  load time.
+ *
+ *                  Each SpMV posts the nonblocking receives of the halo and the
+ *                  sends of the items the other ranks need, computes the local
+ *                  block meanwhile (with the threads of the parallel backend:
+ *                  hybrid MPI + OpenMP), waits for the halo and adds the remote
+ *                  block.
+ *
+ *                  Compiled with MPI support only (make MPI=1, which defines
+ *                  CONFIG_ENABLE_MPI); otherwise the functions fail, and a
+ *                  single rank is reported.
+ *
+ * \warning         Memory management is handled via an arena allocator; ensure
+ *                  that the arena is properly initialized and destroyed.
+ */
+
+#ifndef DIST_H
+#define DIST_H
+
+#include "arena.h"
+#include "csr.h"
+#include "vec.h"
+
+#include <stdbool.h>
+
+/*!
+ * \brief           Structure representing the part of a distributed matrix held by a rank.
+ */
+struct DistMatrix {
+    int rank;                    /*< Rank of the calling process */
+    int ranks;                   /*< Number of ranks */
+    int m;                       /*< Number of rows of the whole matrix */
+    int n;                       /*< Number of columns of the whole matrix */
+    long long nz;                /*< Number of non-zeros of the whole matrix */
+    bool is_real;                /*< Flag indicating if the matrix holds real (true) or integer (false) values */
+    int row_begin;               /*< First row of the rank */
+    int row_end;                 /*< One past the last row of the rank */
+    int col_begin;               /*< First vector item of the rank */
+    int col_end;                 /*< One past the last vector item of the rank */
+    struct CsrMatrix local;      /*< Rows of the rank times its vector items */
+    struct CsrMatrix remote;     /*< Rows of the rank times the halo (no rows if the halo is empty) */
+    int halo;                    /*< Number of vector items received from the other ranks */
+    int sends;                   /*< Number of vector items sent to the other ranks */
+    int recv_peers;              /*< Number of ranks the halo comes from */
+    int send_peers;              /*< Number of ranks receiving items of this one */
+    struct ArenaObj row_bounds;  /*< First row of each rank (ranks + 1 items) */
+    struct ArenaObj col_bounds;  /*< First vector item of each rank (ranks + 1 items) */
+    struct ArenaObj recv_rank;   /*< Rank of each receive (recv_peers items) */
+    struct ArenaObj recv_offset; /*< Offset of each receive in the halo (recv_peers + 1 items) */
+    struct ArenaObj send_rank;   /*< Rank of each send (send_peers items) */
+    struct ArenaObj send_offset; /*< Offset of each send in the send buffer (send_peers + 1 items) */
+    struct ArenaObj send_idx;    /*< Local index of each sent item (sends items) */
+    struct ArenaObj send_buf;    /*< Packed sent items (sends items, same kind as the matrix) */
+    struct ArenaObj requests;    /*< Nonblocking requests, receives first (recv_peers + send_peers items) */
+    struct Vec halo_vec;         /*< Received vector items (halo items) */
+    struct Vec remote_result;    /*< Product of the remote block (rows of the rank) */
+    double wait_us;              /*< Time spent waiting for the halo after the local block, summed over the calls since it was last zeroed */
+};
+
+/*!
+ * \brief           Get the rank of the calling process.
+ *
+ * \return          The rank in MPI_COMM_WORLD, 0 without MPI support.
+ */
+int dist_rank(void);
+
+/*!
+ * \brief           Get the number of ranks.
+ *
+ * \return          The size of MPI_COMM_WORLD, 1 without MPI support.
+ */
+int dist_ranks(void);
+
+/*!
+ * \brief           Get the largest value over the ranks.
+ *
+ * \details         Collective over MPI_COMM_WORLD.
+ *
+ * \param[in]       val: Value of the calling rank.
+ * \return          The largest value, val without MPI support.
+ */
+double dist_max(double val);
+
+/*!
+ * \brief           Load the part of a rank of a matrix stored in a Matrix Market file.
+ *
+ * \details         Collective over MPI_COMM_WORLD. Each rank keeps a count per
+ *                  row of the whole matrix while loading (4 bytes per row).
+ *
+ * \param[out]      dm: Pointer to the distributed matrix to initialize.
+ * \param[in]       filename: Path to the Matrix Market file, readable by every rank.
+ * \param[out]      arena: Pointer to the arena handler for memory allocation.
+ * \return          RC_OK on success, an error code otherwise:
+ *                   - RC_INVALID_ARG_ERR if any argument is invalid or MPI support is not compiled.
+ *                   - RC_FILE_IO_ERR if the file could not be opened.
+ *                   - RC_FILE_INVALID_FMT_ERR if a parsing error occurs.
+ *                   - RC_MEM_ALLOC_ERR if memory allocation fails.
+ */
+int dist_matrix_load(struct DistMatrix *dm, const char *filename, struct ArenaHandler *arena);
+
+/*!
+ * \brief           Multiply a distributed matrix with a distributed vector.
+ *
+ * \details         Collective over MPI_COMM_WORLD.
+ *
+ * \param[in,out]   dm: Pointer to the distributed matrix.
+ * \param[in]       vec: Pointer to the vector items of the rank (col_end - col_begin items).
+ * \param[out]      result: Pointer to the result items of the rank (row_end - row_begin items).
+ * \return          RC_OK on success, an error code otherwise:
+ *                   - RC_INVALID_ARG_ERR if any argument is invalid.
+ *                   - RC_FAIL if a communication fails.
+ */
+int dist_matrix_mul_vec(struct DistMatrix *dm, const struct Vec *vec, struct Vec *result);
+
+/*!
+ * \brief           Gather a distributed vector on rank 0.
+ *
+ * \details         Collective over MPI_COMM_WORLD.
+ *
+ * \param[in]       dm: Pointer to the distributed matrix.
+ * \param[in]       part: Pointer to the items of the rank.
+ * \param[in]       is_result: Flag selecting the row bounds (result vector) instead of the column ones (input vector).
+ * \param[out]      full: Pointer to the whole vector, initialized by the caller on rank 0 (unused elsewhere).
+ * \return          RC_OK on success, an error code otherwise:
+ *                   - RC_INVALID_ARG_ERR if any argument is invalid.
+ *                   - RC_FAIL if a communication fails.
+ */
+int dist_vec_gather(const struct DistMatrix *dm, const struct Vec *part, bool is_result, struct Vec *full);
+
+#endif /*! DIST_H */
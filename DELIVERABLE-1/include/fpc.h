@@ -0,0 +1,95 @@
+/*!
+ * \file            fpc.h
+ * \date            2026-10-18
+ * \author          Mirko Lana [lana.mirko@icloud.com]
+ *
+ * \brief           Lossless compression of CSR values decoded inside the SpMV.
+ *
+ * \details         FPC/Gorilla-style compression of the value array: each value
+ *                  is XORed with the previous one, so that equal or close values
+ *                  leave long runs of zero bytes, and only the bytes that are not
+ *                  zero are stored. A 4-bit code per value selects the layout:
+ *                   - 0..8: the low `code` bytes are stored (leading zeros dropped).
+ *                   - 9..15: the `16 - code` high bytes are stored (the low
+ *                     `code - 8` zero bytes dropped, e.g. small integers).
+ *
+ *                  Values are grouped in blocks of CONFIG_FPC_BLOCK_NNZ, each
+ *                  holding its codes followed by its bytes and decodable on its
+ *                  own. The SpMV decodes the values in registers while streaming
+ *                  the non-zeros, trading a few ALU operations per value for
+ *                  fewer bytes read from memory; threads get contiguous
+ *                  nnz-balanced row ranges, so each one seeks into a block once.
+ *
+ * \warning         Memory management is handled via an arena allocator; ensure
+ *                  that the arena is properly initialized and destroyed.
+ */
+
+#ifndef FPC_H
+#define FPC_H
+
+#include "arena.h"
+#include "csr.h"
+#include "vec.h"
+
+#include <stddef.h>
+
+/*!
+ * \brief           Structure representing a CSR matrix with compressed values.
+ */
+struct FpcMatrix {
+    struct CsrMatrix pattern; /*< Shape, row pointers and column indexes (shared with the source) */
+    int blocks;               /*< Number of blocks of values */
+    size_t bytes;             /*< Size of the compressed stream (codes and bytes) */
+    struct ArenaObj data;     /*< Compressed stream (uint8_t) */
+    struct ArenaObj offsets;  /*< Offset of each block in the stream (size_t) */
+};
+
+/*!
+ * \brief           Compress the values of a real CSR matrix.
+ *
+ * \param[out]      fm: Pointer to the compressed matrix to initialize.
+ * \param[in]       mtx: Pointer to the source CSR matrix (real).
+ * \param[out]      arena: Pointer to the arena handler for memory allocation.
+ * \return          RC_OK on success, an error code otherwise:
+ *                   - RC_INVALID_ARG_ERR if any argument is invalid or the matrix is not real.
+ *                   - RC_MEM_ALLOC_ERR if memory allocation fails.
+ */
+int fpc_matrix_init(struct FpcMatrix *fm, const struct CsrMatrix *mtx, struct ArenaHandler *arena);
+
+/*!
+ * \brief           Get the compression ratio of the values.
+ *
+ * \param[in]       fm: Pointer to the compressed matrix.
+ * \return          Size of the uncompressed values over the size of the compressed stream.
+ */
+double fpc_matrix_ratio(const struct FpcMatrix *fm);
+
+/*!
+ * \brief           Multiply a range of rows of a compressed matrix with a vector.
+ *
+ * \details         Serial and unchecked, see csr_matrix_mul_vec_rows. The
+ *                  decoder starts from the block holding the first non-zero of
+ *                  the range: prefer few long ranges to many short ones.
+ *
+ * \param[in]       fm: Pointer to the compressed matrix.
+ * \param[in]       vec: Pointer to the vector.
+ * \param[out]      result: Pointer to the result vector.
+ * \param[in]       row_begin: First row of the range.
+ * \param[in]       row_end: One past the last row of the range.
+ * \return          RC_OK on success, an error code otherwise:
+ *                   - RC_IDX_OUT_OF_BOUNDS_ERR if the range is invalid.
+ */
+int fpc_matrix_mul_vec_rows(const struct FpcMatrix *fm, const struct Vec *vec, struct Vec *result, int row_begin, int row_end);
+
+/*!
+ * \brief           Multiply a compressed matrix with a vector.
+ *
+ * \param[in]       fm: Pointer to the compressed matrix.
+ * \param[in]       vec: Pointer to the vector (real).
+ * \param[out]      result: Pointer to the result vector (real).
+ * \return          RC_OK on success, an error code otherwise:
+ *                   - RC_INVALID_ARG_ERR if any argument is invalid.
+ */
+int fpc_matrix_mul_vec(const struct FpcMatrix *fm, const struct Vec *vec, struct Vec *result);
+
+#endif /*! FPC_H */
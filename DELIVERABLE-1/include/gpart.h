@@ -0,0 +1,109 @@
+/*!
+ * \file            gpart.h
+ * \date            2026-10-18
+ * \author          Mirko Lana [lana.mirko@icloud.com]
+ *
+ * \brief           Multilevel graph partitioning of square CSR matrices.
+ *
+ * \details         A contiguous row split ignores the structure of the matrix:
+ *                  a row reading columns owned by other parts makes them send
+ *                  their vector items (halo exchange of a distributed SpMV,
+ *                  remote NUMA accesses of a threaded one). Here the rows are
+ *                  the vertices of the graph of the symmetrized pattern of the
+ *                  matrix (a vertex weighs its non-zeros, an edge the matrix
+ *                  entries it stands for) and are split in parts of balanced
+ *                  weight cutting as few edges as possible, a proxy of the
+ *                  communication volume.
+ *
+ *                  The parts come from recursive bisection, each bisection
+ *                  being multilevel:
+ *                   - coarsening: vertices are paired with the neighbor of
+ *                     heaviest edge (heavy-edge matching, in random order),
+ *                     halving the graph down to CONFIG_GPART_COARSEN_TO
+ *                     vertices.
+ *                   - initial bisection of the coarsest graph by greedy
+ *                     breadth-first growth from CONFIG_GPART_INIT_TRIES random
+ *                     seeds, the best cut being kept.
+ *                   - uncoarsening: the bisection is projected back level by
+ *                     level and refined with Fiduccia-Mattheyses passes, which
+ *                     move boundary vertices by decreasing gain under the
+ *                     balance constraint and roll back to the best cut seen.
+ *
+ *                  The parts of a partition are not contiguous:
+ *                  gpart_permute renumbers the rows (and columns) part by part,
+ *                  so that the contiguous splits of the other modules follow
+ *                  them.
+ *
+ * \warning         Memory management is handled via an arena allocator; ensure
+ *                  that the arena is properly initialized and destroyed. The
+ *                  graphs of every level stay in the arena.
+ */
+
+#ifndef GPART_H
+#define GPART_H
+
+#include "arena.h"
+#include "csr.h"
+
+/*!
+ * \brief           Structure representing a partition of the rows of a square matrix and its cost.
+ */
+struct Gpart {
+    int parts;                 /*< Number of parts */
+    long long edge_cut;        /*< Non-zeros whose row and column are in different parts */
+    long long volume;          /*< Vector items received by all the parts (sum of the halos) */
+    int max_halo;              /*< Largest halo of a part */
+    double imbalance;          /*< Non-zeros of the largest part over the mean */
+    struct ArenaObj part;      /*< Part of each row (m items) */
+    struct ArenaObj perm;      /*< New index of each row, part by part (m items, see gpart_permute) */
+    struct ArenaObj part_nnz;  /*< Non-zeros of each part (parts items) */
+    struct ArenaObj part_cut;  /*< Non-zeros of each part reading items of other parts (parts items) */
+    struct ArenaObj part_halo; /*< Items of other parts read by each part (parts items) */
+};
+
+/*!
+ * \brief           Partition the rows of a square matrix with the multilevel partitioner.
+ *
+ * \param[out]      gp: Pointer to the partition to initialize.
+ * \param[in]       mtx: Pointer to the square CSR matrix.
+ * \param[in]       parts: Number of parts (1 to CONFIG_GPART_MAX_PARTS).
+ * \param[out]      arena: Pointer to the arena handler for memory allocation.
+ * \return          RC_OK on success, an error code otherwise:
+ *                   - RC_INVALID_ARG_ERR if any argument is invalid or the matrix is not square.
+ *                   - RC_MEM_ALLOC_ERR if memory allocation fails.
+ */
+int gpart_init(struct Gpart *gp, const struct CsrMatrix *mtx, int parts, struct ArenaHandler *arena);
+
+/*!
+ * \brief           Describe the contiguous nnz-balanced split of a square matrix as a partition.
+ *
+ * \details         Gives the cost of the split of partition_init_nnz, to
+ *                  compare with gpart_init.
+ *
+ * \param[out]      gp: Pointer to the partition to initialize.
+ * \param[in]       mtx: Pointer to the square CSR matrix.
+ * \param[in]       parts: Number of parts (1 to CONFIG_GPART_MAX_PARTS).
+ * \param[out]      arena: Pointer to the arena handler for memory allocation.
+ * \return          RC_OK on success, an error code otherwise (see gpart_init).
+ */
+int gpart_init_contiguous(struct Gpart *gp, const struct CsrMatrix *mtx, int parts, struct ArenaHandler *arena);
+
+/*!
+ * \brief           Renumber the rows and columns of a matrix part by part.
+ *
+ * \details         Computes P * A * P^T, where P moves the rows of part 0
+ *                  first, then those of part 1, and so on (in their order):
+ *                  row i becomes row perm[i], and so does column i. Then the
+ *                  vector items are permuted the same way: (P A P^T)(P x) = P (A x).
+ *
+ * \param[out]      dest: Pointer to the permuted CSR matrix.
+ * \param[in]       src: Pointer to the partitioned CSR matrix.
+ * \param[in]       gp: Pointer to the partition of src.
+ * \param[out]      arena: Pointer to the arena handler for memory allocation.
+ * \return          RC_OK on success, an error code otherwise:
+ *                   - RC_INVALID_ARG_ERR if any argument is invalid.
+ *                   - RC_MEM_ALLOC_ERR if memory allocation fails.
+ */
+int gpart_permute(struct CsrMatrix *dest, const struct CsrMatrix *src, const struct Gpart *gp, struct ArenaHandler *arena);
+
+#endif /*! GPART_H */
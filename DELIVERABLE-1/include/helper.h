@@ -0,0 +1,94 @@
+/*!
+ * \file            helper.h
+ * \date            2026-10-18
+ * \author          Mirko Lana [lana.mirko@icloud.com]
+ *
+ * \brief           SMT helper-thread prefetching for the CSR SpMV (experimental).
+ *
+ * \details         A bandwidth-bound SpMV leaves the second hardware thread of
+ *                  each core idle. Here every compute thread gets a helper
+ *                  thread pinned to its SMT sibling: while the compute thread
+ *                  multiplies its nnz-balanced rows, the helper walks the
+ *                  column indexes of the same rows and loads x[col[k]], so the
+ *                  gathers of the compute thread hit in the caches shared by
+ *                  the two threads.
+ *
+ *                  The compute thread publishes the first non-zero it has not
+ *                  computed yet every CONFIG_HELPER_PUBLISH_ROWS rows. The
+ *                  helper waits when it gets as many non-zeros ahead as
+ *                  1/CONFIG_HELPER_L2_SHARE of the lines of the L2 cache, so
+ *                  that its lines are not evicted before use, and jumps
+ *                  forward when it falls behind.
+ *
+ *                  Compute and helper threads run on their own pool of 2 *
+ *                  threads workers, whatever the parallel backend. When the
+ *                  machine has fewer SMT cores than compute threads, the extra
+ *                  pairs are left unpinned.
+ *
+ * \warning         Memory management is handled via an arena allocator; ensure
+ *                  that the arena is properly initialized and destroyed.
+ */
+
+#ifndef HELPER_H
+#define HELPER_H
+
+#include "arena.h"
+#include "csr.h"
+#include "partition.h"
+#include "pool.h"
+#include "vec.h"
+
+#include <stdatomic.h>
+
+/*!
+ * \brief           Structure representing a team of compute and helper threads.
+ */
+struct HelperTeam {
+    int threads;                 /*< Number of compute threads (and of helper threads) */
+    int pinned;                  /*< Number of pairs pinned to the two threads of a core */
+    int max_ahead;               /*< Non-zeros a helper may run ahead of its compute thread */
+    struct Partition part;       /*< Rows of each pair (nnz-balanced) */
+    struct ArenaObj slots;       /*< Per-pair progress shared by the two threads (struct HelperSlot) */
+    struct ThreadPool pool;      /*< Pool running the pairs: compute threads first, then helpers */
+    const struct CsrMatrix *mtx; /*< Input matrix of the current call */
+    const struct Vec *vec;       /*< Input vector of the current call */
+    struct Vec *result;          /*< Result vector of the current call */
+    atomic_long throttles;       /*< Number of times a helper waited for its compute thread */
+};
+
+/*!
+ * \brief           Initialize a helper team for a matrix and start its threads.
+ *
+ * \note            Pins the calling thread, which runs the first compute thread.
+ *
+ * \param[out]      team: Pointer to the team to initialize.
+ * \param[in]       mtx: Pointer to the CSR matrix to compute.
+ * \param[in]       threads: Number of compute threads (1 to CONFIG_TOPO_MAX_CPUS).
+ * \param[out]      arena: Pointer to the arena handler for memory allocation.
+ * \return          RC_OK on success, an error code otherwise:
+ *                   - RC_INVALID_ARG_ERR if any argument is invalid.
+ *                   - RC_MEM_ALLOC_ERR if memory allocation fails.
+ *                   - RC_FAIL if a thread could not be created.
+ */
+int helper_init(struct HelperTeam *team, const struct CsrMatrix *mtx, int threads, struct ArenaHandler *arena);
+
+/*!
+ * \brief           Multiply a CSR matrix with a vector with the helper team.
+ *
+ * \param[in,out]   team: Pointer to the team initialized for mtx.
+ * \param[in]       mtx: Pointer to the CSR matrix.
+ * \param[in]       vec: Pointer to the vector.
+ * \param[out]      result: Pointer to the result vector.
+ * \return          RC_OK on success, an error code otherwise:
+ *                   - RC_INVALID_ARG_ERR if any argument is invalid.
+ */
+int helper_mul_vec(struct HelperTeam *team, const struct CsrMatrix *mtx, const struct Vec *vec, struct Vec *result);
+
+/*!
+ * \brief           Stop and join the threads of a helper team.
+ *
+ * \param[in,out]   team: Pointer to the team.
+ */
+void helper_destroy(struct HelperTeam *team);
+
+#endif /*! HELPER_H */
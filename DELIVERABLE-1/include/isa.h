@@ -0,0 +1,73 @@
+/*!
+ * \file            isa.h
+ * \date            2026-10-18
+ * \author          Mirko Lana [lana.mirko@icloud.com]
+ *
+ * \brief           Runtime CPU feature detection for kernel dispatch.
+ *
+ * \details         The binary is built without `-march`, so hot kernels are
+ *                  compiled once per instruction set with the `target` function
+ *                  attribute and the best variant supported by the running CPU
+ *                  is picked at startup. On non-x86 targets only the baseline
+ *                  variant exists.
+ */
+
+#ifndef ISA_H
+#define ISA_H
+
+#if defined(__x86_64__) && defined(__GNUC__)
+#define ISA_ENABLE_X86_DISPATCH /*!< Build the AVX2 and AVX-512 kernel variants */
+#endif
+
+#define ISA_TARGET_AVX2 "avx2,fma"                                      /*!< Features of the AVX2 variants */
+#define ISA_TARGET_AVX512 "avx512f,avx512vl,avx512bw,avx512dq,avx2,fma" /*!< Features of the AVX-512 variants */
+
+/*!
+ * \brief           Instruction set levels, from the least to the most capable.
+ */
+enum IsaLevel {
+    ISA_LEVEL_BASELINE, /*!< Compiler default (SSE2 on x86-64) */
+    ISA_LEVEL_AVX2,     /*!< AVX2 + FMA */
+    ISA_LEVEL_AVX512,   /*!< AVX-512 F/VL/BW/DQ */
+    ISA_LEVEL_COUNT,    /*!< Number of levels */
+};
+
+/*!
+ * \brief           Detect the instruction sets supported by the CPU and select the best one.
+ *
+ * \return          RC_OK on success.
+ */
+int isa_init(void);
+
+/*!
+ * \brief           Get the selected instruction set level.
+ *
+ * \return          The level kernels must dispatch to.
+ */
+enum IsaLevel isa_get(void);
+
+/*!
+ * \brief           Get the best instruction set level supported by the CPU.
+ *
+ * \return          The best supported level.
+ */
+enum IsaLevel isa_get_max(void);
+
+/*!
+ * \brief           Select a lower instruction set level (e.g. to compare variants).
+ *
+ * \param[in]       level: The level to select.
+ * \return          RC_OK on success, an error code otherwise:
+ *                   - RC_INVALID_ARG_ERR if the level is not supported by the CPU.
+ */
+int isa_set(enum IsaLevel level);
+
+/*!
+ * \brief           Get the name of an instruction set level.
+ *
+ * \param[in]       level: The level.
+ * \return          The name of the level (e.g. "sse2", "avx2", "avx512").
+ */
+const char *isa_to_str(enum IsaLevel level);
+
+#endif /*! ISA_H */
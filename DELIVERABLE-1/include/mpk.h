@@ -0,0 +1,94 @@
+/*!
+ * \file            mpk.h
+ * \date            2026-10-18
+ * \author          Mirko Lana [lana.mirko@icloud.com]
+ *
+ * \brief           Matrix-powers kernel [A x, A^2 x, ..., A^s x] for s-step Krylov methods.
+ *
+ * \details         Computed as s SpMVs, every power streams the whole matrix
+ *                  from memory again. Here the rows are split in blocks sized
+ *                  so that CONFIG_MPK_MAX_REACH + 2 of them fit in the L2
+ *                  cache (see topo.h) and the powers advance
+ *                  as a wavefront: a block of power l is computed as soon as
+ *                  the rows of power l - 1 it reads (from its lowest to its
+ *                  highest column) are done, usually right after them, while
+ *                  its rows are still in the cache.
+ *
+ *                  Each thread runs the wavefront over its nnz-balanced share
+ *                  of blocks, even threads down the rows and odd ones up, and
+ *                  publishes per power how far it got; a block reading rows of
+ *                  another thread waits for them. Nothing is computed twice (no
+ *                  redundant halos), so the results match s calls of
+ *                  csr_matrix_mul_vec.
+ *
+ *                  The gain depends on the locality of the matrix: a block of
+ *                  a power trails the previous power by the reach of the
+ *                  matrix, the farthest block whose rows a block reads. With a
+ *                  narrow band the powers stay a few blocks apart; above
+ *                  CONFIG_MPK_MAX_REACH blocks the rows would be evicted before
+ *                  their reuse, so the powers are computed by separate SpMVs.
+ *                  Reorder such matrices (e.g. Reverse Cuthill-McKee) first.
+ *
+ * \warning         Memory management is handled via an arena allocator; ensure
+ *                  that the arena is properly initialized and destroyed.
+ */
+
+#ifndef MPK_H
+#define MPK_H
+
+#include "arena.h"
+#include "csr.h"
+#include "vec.h"
+
+#include <stdatomic.h>
+#include <stdbool.h>
+
+/*!
+ * \brief           Structure representing the row blocks of the powers of a matrix.
+ */
+struct MpkPlan {
+    const struct CsrMatrix *mtx; /*< Square matrix A */
+    int steps;                   /*< Number of powers s */
+    int threads;                 /*< Number of threads */
+    int block_nnz;               /*< Largest number of non-zeros of a block (single-row blocks aside) */
+    int blocks;                  /*< Number of row blocks */
+    int reach;                   /*< Largest distance, in blocks, between a block and a row it reads */
+    bool wavefront;              /*< Whether the powers advance as a wavefront (reach small enough) */
+    struct ArenaObj first_block; /*< First block of each thread (threads + 1 items) */
+    struct ArenaObj block_row;   /*< First row of each block (blocks + 1 items) */
+    struct ArenaObj block_lo;    /*< Lowest column read by each block (blocks items, n if empty) */
+    struct ArenaObj block_hi;    /*< Highest column read by each block (blocks items, -1 if empty) */
+    struct ArenaObj progress;    /*< Per-thread progress of each power (one cache line each) */
+    atomic_long stalls;          /*< Number of times a thread waited for the rows of another one */
+};
+
+/*!
+ * \brief           Split the rows of a matrix in blocks for its powers.
+ *
+ * \details         Uses the current thread count of the parallel backend.
+ *
+ * \param[out]      plan: Pointer to the plan to initialize.
+ * \param[in]       mtx: Pointer to the square CSR matrix.
+ * \param[in]       steps: Number of powers (1 to CONFIG_MPK_MAX_STEPS).
+ * \param[out]      arena: Pointer to the arena handler for memory allocation.
+ * \return          RC_OK on success, an error code otherwise:
+ *                   - RC_INVALID_ARG_ERR if any argument is invalid or the matrix is not square.
+ *                   - RC_MEM_ALLOC_ERR if memory allocation fails.
+ */
+int mpk_init(struct MpkPlan *plan, const struct CsrMatrix *mtx, int steps, struct ArenaHandler *arena);
+
+/*!
+ * \brief           Compute powers[l] = A^(l + 1) * vec for l = 0 .. steps - 1.
+ *
+ * \details         Falls back to one power after the other when the backend
+ *                  no longer has the thread count of the plan.
+ *
+ * \param[in,out]   plan: Pointer to the plan of A.
+ * \param[in]       vec: Pointer to the vector.
+ * \param[out]      powers: Array of steps result vectors (m items each, same kind as A).
+ * \return          RC_OK on success, an error code otherwise:
+ *                   - RC_INVALID_ARG_ERR if any argument is invalid.
+ */
+int mpk_powers(struct MpkPlan *plan, const struct Vec *vec, struct Vec *powers);
+
+#endif /*! MPK_H */
@@ -0,0 +1,82 @@
+/*!
+ * \file            partition.h
+ * \date            2026-10-18
+ * \author          Mirko Lana [lana.mirko@icloud.com]
+ *
+ * \brief           Static row partitioning of CSR matrices.
+ *
+ * \details         A partition splits the rows of a CSR matrix into contiguous
+ *                  ranges, one per part (thread), so that callers running their
+ *                  own parallel region can compute it without a scheduler.
+ *
+ * \warning         Memory management is handled via an arena allocator; ensure
+ *                  that the arena is properly initialized and destroyed.
+ */
+
+#ifndef PARTITION_H
+#define PARTITION_H
+
+#include "arena.h"
+#include "csr.h"
+
+/*!
+ * \brief           Structure representing a row partition.
+ */
+struct Partition {
+    int parts;              /*< Number of parts */
+    struct ArenaObj bounds; /*< Row boundaries (parts + 1 items): part p owns rows [bounds[p], bounds[p + 1]) */
+};
+
+/*!
+ * \brief           Initialize a partition with balanced number of non-zeros per part.
+ *
+ * \param[out]      part: Pointer to the partition to initialize.
+ * \param[in]       mtx: Pointer to the CSR matrix to partition.
+ * \param[in]       parts: Number of parts (>= 1).
+ * \param[out]      arena: Pointer to the arena handler for memory allocation.
+ * \return          RC_OK on success, an error code otherwise:
+ *                   - RC_INVALID_ARG_ERR if any argument is invalid.
+ *                   - RC_MEM_ALLOC_ERR if memory allocation fails.
+ */
+int partition_init_nnz(struct Partition *part, const struct CsrMatrix *mtx, int parts, struct ArenaHandler *arena);
+
+/*!
+ * \brief           Compute one boundary of a nnz-balanced partition without storing it.
+ *
+ * \details         Lets each thread find its own rows with a binary search on
+ *                  the row pointer array when no partition was precomputed.
+ *                  Matches the boundaries computed by partition_init_nnz.
+ *
+ * \param[in]       mtx: Pointer to the CSR matrix.
+ * \param[in]       p: Index of the boundary (0 <= p <= parts).
+ * \param[in]       parts: Number of parts.
+ * \return          The first row of part p (mtx->m for p == parts).
+ */
+int partition_nnz_bound(const struct CsrMatrix *mtx, int p, int parts);
+
+/*!
+ * \brief           Resize the parts in proportion to their measured throughput.
+ *
+ * \details         The throughput of each part is its number of non-zeros over
+ *                  its measured time. The new share of non-zeros of each part is
+ *                  moved towards its share of the total throughput by a factor of
+ *                  CONFIG_PARTITION_REBALANCE_DAMPING, so that faster threads get
+ *                  more rows and all parts converge to the same time.
+ *
+ * \param[in,out]   part: Pointer to the partition to rebalance.
+ * \param[in]       mtx: Pointer to the partitioned CSR matrix.
+ * \param[in]       part_ns: Measured time of each part (parts items, any unit).
+ * \return          RC_OK on success, an error code otherwise:
+ *                   - RC_INVALID_ARG_ERR if any argument is invalid.
+ */
+int partition_rebalance(struct Partition *part, const struct CsrMatrix *mtx, const double *part_ns);
+
+/*!
+ * \brief           Get the row boundaries of a partition.
+ *
+ * \param[in]       part: Pointer to the partition.
+ * \return          Pointer to the parts + 1 row boundaries.
+ */
+int *partition_get_bounds(const struct Partition *part);
+
+#endif /*! PARTITION_H */
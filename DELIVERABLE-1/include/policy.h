@@ -0,0 +1,50 @@
+/*!
+ * \file            policy.h
+ * \date            2026-10-18
+ * \author          Mirko Lana [lana.mirko@icloud.com]
+ *
+ * \brief           Thread count selection policy.
+ *
+ * \details         Picks the number of threads for a given matrix from its
+ *                  number of non-zeros, the measured per-thread fork/join
+ *                  overhead of the runtime and the thread count at which the
+ *                  memory bandwidth saturates. Matrices below
+ *                  CONFIG_POLICY_SERIAL_NNZ always run serially.
+ */
+
+#ifndef POLICY_H
+#define POLICY_H
+
+#include "csr.h"
+#include "vec.h"
+
+/*!
+ * \brief           Structure containing the outcome of a thread count selection.
+ */
+struct ThreadPolicy {
+    int threads;        /*!< The selected number of threads. */
+    int max_threads;    /*!< The upper bound that was considered. */
+    double serial_ns;   /*!< Measured serial SpMV time (0 if not probed). */
+    double overhead_ns; /*!< Measured fork/join overhead per thread (0 if not probed). */
+    double saturation;  /*!< Estimated thread count at which bandwidth saturates. */
+    const char *reason; /*!< Short description of why the thread count was chosen. */
+};
+
+/*!
+ * \brief           Select the fastest thread count for a CSR SpMV.
+ *
+ * \note            Runs a few SpMVs on the given vectors to probe the serial
+ *                  time and the bandwidth saturation point; the content of
+ *                  result is overwritten.
+ *
+ * \param[out]      policy: Pointer to the structure receiving the decision.
+ * \param[in]       mtx: Pointer to the CSR matrix.
+ * \param[in]       vec: Pointer to the input vector.
+ * \param[out]      result: Pointer to the output vector used by the probes.
+ * \param[in]       max_threads: Upper bound on the number of threads (>= 1).
+ * \return          RC_OK on success, an error code otherwise:
+ *                   - RC_INVALID_ARG_ERR if any argument is invalid.
+ */
+int policy_select_threads(struct ThreadPolicy *policy, const struct CsrMatrix *mtx, const struct Vec *vec, struct Vec *result, int max_threads);
+
+#endif /*! POLICY_H */
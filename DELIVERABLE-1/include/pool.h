@@ -0,0 +1,124 @@
+/*!
+ * \file            pool.h
+ * \date            2026-10-18
+ * \author          Mirko Lana [lana.mirko@icloud.com]
+ *
+ * \brief           Persistent Pthreads thread pool.
+ *
+ * \details         The workers are created once and wait for tasks. A task is
+ *                  a function run by every thread of the pool (the caller
+ *                  included, as thread 0), SPMD style: each invocation gets its
+ *                  thread index and the pool size and decides its own share of
+ *                  the work. Idle workers spin for CONFIG_POOL_SPINS polls and
+ *                  then sleep on a condition variable.
+ *
+ * \warning         Memory management is handled via an arena allocator; ensure
+ *                  that the arena is properly initialized and destroyed.
+ */
+
+#ifndef POOL_H
+#define POOL_H
+
+#include "arena.h"
+
+#include <pthread.h>
+#include <stdatomic.h>
+#include <stdbool.h>
+
+/*!
+ * \brief           Task function run by each thread of the pool.
+ *
+ * \param[in,out]   arg: User argument given to pool_run.
+ * \param[in]       tid: Index of the calling thread (0 is the caller of pool_run).
+ * \param[in]       threads: Number of threads of the pool.
+ */
+typedef void (*PoolTaskFn)(void *arg, int tid, int threads);
+
+/*!
+ * \brief           Structure representing a thread pool.
+ */
+struct ThreadPool {
+    int threads;             /*< Number of threads, the caller of pool_run included */
+    struct ArenaObj workers; /*< Worker thread handles (threads - 1 items) */
+    struct ArenaObj args;    /*< Pool and index of each worker, read once at start (threads - 1 items) */
+    pthread_mutex_t lock;    /*< Lock protecting the sleep/wake-up of idle workers */
+    pthread_cond_t wake;     /*< Condition signalled when a new task is published */
+    atomic_uint generation;  /*< Incremented each time a task is published */
+    atomic_int pending;      /*< Number of workers still running the current task (still starting in pool_init) */
+    atomic_bool stop;        /*< Flag asking the workers to exit */
+    PoolTaskFn fn;           /*< Current task function */
+    void *arg;               /*< Current task argument */
+};
+
+/*!
+ * \brief           Initialize a thread pool and start its workers.
+ *
+ * \param[out]      pool: Pointer to the pool to initialize.
+ * \param[in]       threads: Number of threads, the caller of pool_run included (>= 1).
+ * \param[in]       cpus: CPU each thread is pinned to (threads items, -1 to leave
+ *                  a thread unpinned), or NULL to leave all threads unpinned.
+ * \param[out]      arena: Pointer to the arena handler for memory allocation.
+ * \return          RC_OK on success, an error code otherwise:
+ *                   - RC_INVALID_ARG_ERR if any argument is invalid.
+ *                   - RC_MEM_ALLOC_ERR if memory allocation fails.
+ *                   - RC_FAIL if a worker could not be created.
+ */
+int pool_init(struct ThreadPool *pool, int threads, const int *cpus, struct ArenaHandler *arena);
+
+/*!
+ * \brief           Run a task on every thread of the pool and wait for completion.
+ *
+ * \note            Not re-entrant: a single thread at a time may call pool_run on a pool.
+ *
+ * \param[in,out]   pool: Pointer to the pool.
+ * \param[in]       fn: Task function.
+ * \param[in,out]   arg: Argument passed to the task function.
+ * \return          RC_OK on success, an error code otherwise:
+ *                   - RC_INVALID_ARG_ERR if any argument is invalid.
+ */
+int pool_run(struct ThreadPool *pool, PoolTaskFn fn, void *arg);
+
+/*!
+ * \brief           Stop and join the workers of a pool.
+ *
+ * \param[in,out]   pool: Pointer to the pool.
+ */
+void pool_destroy(struct ThreadPool *pool);
+
+/*!
+ * \brief           Initialize the default pool used by the Pthreads backend.
+ *
+ * \details         Destroys the previous default pool first, if any.
+ *
+ * \param[in]       threads: Number of threads, the caller included (>= 1).
+ * \param[in]       cpus: CPU each thread is pinned to, or NULL (see pool_init).
+ * \param[out]      arena: Pointer to the arena handler for memory allocation.
+ * \return          RC_OK on success, an error code otherwise (see pool_init).
+ */
+int pool_init_default(int threads, const int *cpus, struct ArenaHandler *arena);
+
+/*!
+ * \brief           Stop the default pool, if any.
+ *
+ * \details         To be called before releasing the arena it was allocated from.
+ */
+void pool_fini_default(void);
+
+/*!
+ * \brief           Get the default pool.
+ *
+ * \return          Pointer to the default pool, NULL if it was not initialized.
+ */
+struct ThreadPool *pool_get_default(void);
+
+/*!
+ * \brief           Pin the calling thread to a CPU.
+ *
+ * \note            No-op (returning RC_OK) on systems without thread affinity support.
+ *
+ * \param[in]       cpu: Index of the CPU.
+ * \return          RC_OK on success, RC_FAIL otherwise.
+ */
+int pool_pin_self(int cpu);
+
+#endif /*! POOL_H */
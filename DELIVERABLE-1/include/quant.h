@@ -0,0 +1,116 @@
+/*!
+ * \file            quant.h
+ * \date            2026-10-18
+ * \author          Mirko Lana [lana.mirko@icloud.com]
+ *
+ * \brief           Lossy per-row quantized CSR values for approximate SpMV.
+ *
+ * \details         The values of each row are mapped to int8 or int16 codes q
+ *                  with a per-row scale s and offset o, so that a value is
+ *                  approximated by o + s * q. The SpMV dequantizes on the fly
+ *                  without expanding the codes:
+ *
+ *                      y[i] = o[i] * sum(x[col[k]]) + s[i] * sum(q[k] * x[col[k]])
+ *
+ *                  both sums being computed in the same vectorized loop. With
+ *                  int8 codes the value array of a real matrix shrinks 8 times;
+ *                  the row pointers and column indexes are shared with the
+ *                  source matrix.
+ *
+ *                  Each value is off by at most half a step, (max - min) / (2 *
+ *                  (2^(bits-1) - 1)) of its row; rows holding a single value
+ *                  (e.g. pattern matrices) are exact. Use quant_error to measure
+ *                  the error of a product against csr_matrix_mul_vec.
+ *
+ * \warning         Memory management is handled via an arena allocator; ensure
+ *                  that the arena is properly initialized and destroyed.
+ */
+
+#ifndef QUANT_H
+#define QUANT_H
+
+#include "arena.h"
+#include "csr.h"
+#include "vec.h"
+
+#include <stddef.h>
+
+/*!
+ * \brief           Structure representing a CSR matrix with quantized values.
+ */
+struct QuantMatrix {
+    struct CsrMatrix pattern; /*< Shape, row pointers and column indexes (shared with the source) */
+    int bits;                 /*< Bits per quantized value (8 or 16) */
+    struct ArenaObj codes;    /*< Quantized values (int8_t or int16_t) */
+    struct ArenaObj scale;    /*< Per-row scale (double) */
+    struct ArenaObj offset;   /*< Per-row offset (double) */
+};
+
+/*!
+ * \brief           Structure containing the error of an approximate SpMV.
+ */
+struct QuantError {
+    double max_abs; /*< Largest absolute error of an item */
+    double rel_max; /*< Largest absolute error over the largest absolute exact item */
+    double rel_l2;  /*< L2 norm of the error over the L2 norm of the exact result */
+};
+
+/*!
+ * \brief           Quantize the values of a real CSR matrix.
+ *
+ * \param[out]      qm: Pointer to the quantized matrix to initialize.
+ * \param[in]       mtx: Pointer to the source CSR matrix (real).
+ * \param[in]       bits: Bits per quantized value (8 or 16).
+ * \param[out]      arena: Pointer to the arena handler for memory allocation.
+ * \return          RC_OK on success, an error code otherwise:
+ *                   - RC_INVALID_ARG_ERR if any argument is invalid or the matrix is not real.
+ *                   - RC_MEM_ALLOC_ERR if memory allocation fails.
+ */
+int quant_matrix_init(struct QuantMatrix *qm, const struct CsrMatrix *mtx, int bits, struct ArenaHandler *arena);
+
+/*!
+ * \brief           Multiply a range of rows of a quantized matrix with a vector.
+ *
+ * \details         Serial and unchecked, see csr_matrix_mul_vec_rows.
+ *
+ * \param[in]       qm: Pointer to the quantized matrix.
+ * \param[in]       vec: Pointer to the vector.
+ * \param[out]      result: Pointer to the result vector.
+ * \param[in]       row_begin: First row of the range.
+ * \param[in]       row_end: One past the last row of the range.
+ * \return          RC_OK on success, an error code otherwise:
+ *                   - RC_IDX_OUT_OF_BOUNDS_ERR if the range is invalid.
+ */
+int quant_matrix_mul_vec_rows(const struct QuantMatrix *qm, const struct Vec *vec, struct Vec *result, int row_begin, int row_end);
+
+/*!
+ * \brief           Multiply a quantized matrix with a vector.
+ *
+ * \param[in]       qm: Pointer to the quantized matrix.
+ * \param[in]       vec: Pointer to the vector (real).
+ * \param[out]      result: Pointer to the result vector (real).
+ * \return          RC_OK on success, an error code otherwise:
+ *                   - RC_INVALID_ARG_ERR if any argument is invalid.
+ */
+int quant_matrix_mul_vec(const struct QuantMatrix *qm, const struct Vec *vec, struct Vec *result);
+
+/*!
+ * \brief           Get the number of bytes read by a quantized SpMV for the matrix.
+ *
+ * \param[in]       qm: Pointer to the quantized matrix.
+ * \return          The size of the codes, scales, offsets, row pointers and column indexes.
+ */
+size_t quant_matrix_bytes(const struct QuantMatrix *qm);
+
+/*!
+ * \brief           Measure the error of an approximate SpMV result.
+ *
+ * \param[in]       exact: Pointer to the exact result (real).
+ * \param[in]       approx: Pointer to the approximate result (real).
+ * \param[out]      err: Pointer to the error structure to fill.
+ * \return          RC_OK on success, an error code otherwise:
+ *                   - RC_INVALID_ARG_ERR if any argument is invalid or the vectors differ in size or type.
+ */
+int quant_error(const struct Vec *exact, const struct Vec *approx, struct QuantError *err);
+
+#endif /*! QUANT_H */
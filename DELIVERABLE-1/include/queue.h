@@ -0,0 +1,72 @@
+/*!
+ * \file            queue.h
+ * \date            2026-10-18
+ * \author          Mirko Lana [lana.mirko@icloud.com]
+ *
+ * \brief           Lock-free bounded multi-producer multi-consumer queue.
+ *
+ * \details         Ring of cells carrying a sequence number each (Vyukov's
+ *                  bounded MPMC queue): a producer claims the tail cell once
+ *                  its sequence says it is free, a consumer claims the head
+ *                  cell once its sequence says it is full, each with a single
+ *                  compare-and-swap and no lock. Items are integers (indices
+ *                  of the caller's own slots).
+ *
+ * \warning         Memory management is handled via an arena allocator; ensure
+ *                  that the arena is properly initialized and destroyed.
+ */
+
+#ifndef QUEUE_H
+#define QUEUE_H
+
+#include "arena.h"
+
+#include <stdatomic.h>
+#include <stdbool.h>
+
+#define QUEUE_PAD_SIZE 64 /*!< Padding keeping head and tail on separate cache lines */
+
+/*!
+ * \brief           Structure representing a bounded queue of integers.
+ */
+struct MpmcQueue {
+    int capacity;              /*< Number of cells (power of two) */
+    struct ArenaObj cells;     /*< Cells of the ring (struct MpmcCell, see queue.c) */
+    char pad0[QUEUE_PAD_SIZE]; /*< Padding */
+    atomic_long head;          /*< Position of the next item to pop */
+    char pad1[QUEUE_PAD_SIZE]; /*< Padding */
+    atomic_long tail;          /*< Position of the next item to push */
+    char pad2[QUEUE_PAD_SIZE]; /*< Padding */
+};
+
+/*!
+ * \brief           Initialize a queue.
+ *
+ * \param[out]      q: Pointer to the queue to initialize.
+ * \param[in]       capacity: Maximum number of items in the queue (power of two, >= 2).
+ * \param[out]      arena: Pointer to the arena handler for memory allocation.
+ * \return          RC_OK on success, an error code otherwise:
+ *                   - RC_INVALID_ARG_ERR if any argument is invalid.
+ *                   - RC_MEM_ALLOC_ERR if memory allocation fails.
+ */
+int queue_init(struct MpmcQueue *q, int capacity, struct ArenaHandler *arena);
+
+/*!
+ * \brief           Push an item at the tail (any thread).
+ *
+ * \param[in,out]   q: Pointer to the queue.
+ * \param[in]       item: The item to push.
+ * \return          true on success, false if the queue is full.
+ */
+bool queue_push(struct MpmcQueue *q, int item);
+
+/*!
+ * \brief           Pop an item from the head (any thread).
+ *
+ * \param[in,out]   q: Pointer to the queue.
+ * \param[out]      item: Pointer to store the popped item.
+ * \return          true on success, false if the queue is empty.
+ */
+bool queue_pop(struct MpmcQueue *q, int *item);
+
+#endif /*! QUEUE_H */
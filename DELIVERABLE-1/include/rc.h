@@ -22,7 +22,7 @@
 #define RC_FILE_INVALID_FMT_ERR 0x202 /*!< Invalid file format error. */
 
 /*
- * \brief           Set the error message.
+ * \brief           Set the error message of the calling thread.
  *
  * \param[in]       fmt: Format string.
  * \param[in]       ...: variable arguments.
@@ -31,7 +31,11 @@
 int rc_set_err_msg(const char *fmt, ...);
 
 /*!
- * \brief           Get the error message.
+ * \brief           Get the error message of the calling thread.
+ *
+ * \note            Each thread has its own message: a thread reporting the
+ *                  failure of another one must copy the message of the other
+ *                  thread before it ends.
  *
  * \return          The pointer to the error message.
  */
@@ -0,0 +1,145 @@
+/*!
+ * \file            serve.h
+ * \date            2026-10-18
+ * \author          Mirko Lana [lana.mirko@icloud.com]
+ *
+ * \brief           Long-running SpMV server over a UNIX domain socket.
+ *
+ * \details         spvm --serve <socket> loads and plans its matrices once
+ *                  (thread count, kernel) and then computes y = A * x for
+ *                  the processes connecting to the socket, until asked to
+ *                  stop (SERVE_OP_SHUTDOWN, SIGINT or SIGTERM).
+ *
+ *                  The vectors do not go through the socket: a client creates
+ *                  a shared-memory buffer (shm_open), attaches it to its
+ *                  connection (SERVE_OP_ATTACH) and then asks for products of
+ *                  a matrix (SERVE_OP_SPMV), giving the offsets of x and y in
+ *                  the buffer. The socket only carries fixed-size requests and
+ *                  replies, in the byte order of the machine.
+ *
+ *                  A connection thread reads the requests of all the clients
+ *                  and pushes the products in a lock-free queue. The calling
+ *                  thread pops them and computes them with the whole team of
+ *                  the parallel backend (the persistent pool with Pthreads),
+ *                  staging x and y in blocks allocated at plan time, then
+ *                  replies. It spins on an empty queue for CONFIG_SERVE_SPINS
+ *                  polls before sleeping, so that a call costs little more
+ *                  than the kernel.
+ *
+ *                  Products of the same matrix are coalesced: up to coalesce
+ *                  of them are packed in one block and computed by a single
+ *                  SpMM pass (csr_matrix_mul_block), which streams the matrix
+ *                  once for all. A pass starts when the block is full, or when
+ *                  the queue is drained and its oldest product has waited
+ *                  window_us: with no window, only the products queued at
+ *                  the same time are coalesced, at no added latency.
+ *
+ * \note            A client waits for the reply to a request before sending
+ *                  the next one.
+ *
+ * \note            A client must not shrink its buffer while a product is
+ *                  pending. The server checks the size of the buffer right
+ *                  before copying x and y, and rejects the product with
+ *                  RC_INVALID_ARG_ERR if its vectors no longer fit; a shrink
+ *                  racing the copy itself still raises SIGBUS in the server.
+ *
+ * \warning         Memory management is handled via an arena allocator; ensure
+ *                  that the arena is properly initialized and destroyed.
+ */
+
+#ifndef SERVE_H
+#define SERVE_H
+
+#include "arena.h"
+#include "config.h"
+#include "csr.h"
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#define SERVE_MAGIC 0x53505652U /*!< Magic number of the requests and replies ("SPVR"). */
+
+/*!
+ * \brief           Operations of a request.
+ */
+enum ServeOp {
+    SERVE_OP_INFO,     /*!< Describe a matrix (dimensions, value type) and the number of matrices */
+    SERVE_OP_ATTACH,   /*!< Map the shared-memory buffer named shm_name for the next products */
+    SERVE_OP_SPMV,     /*!< Compute y = A * x, x and y in the attached buffer */
+    SERVE_OP_SHUTDOWN, /*!< Stop the server */
+};
+
+/*!
+ * \brief           Structure representing a request (client to server, 96 bytes).
+ */
+struct ServeRequest {
+    uint32_t magic;                         /*< SERVE_MAGIC */
+    uint32_t op;                            /*< Operation (enum ServeOp) */
+    int32_t matrix;                         /*< Index of the matrix, in the order of the -i options (INFO, SPMV) */
+    int32_t reserved;                       /*< Zero */
+    uint64_t x_off;                         /*< Offset of x in the buffer, n doubles or ints (SPMV) */
+    uint64_t y_off;                         /*< Offset of y in the buffer, m doubles or ints (SPMV) */
+    char shm_name[CONFIG_SHM_NAME_MAX_LEN]; /*< Name of the buffer, NUL-terminated (ATTACH) */
+};
+
+/*!
+ * \brief           Structure representing a reply (server to client, 48 bytes).
+ */
+struct ServeReply {
+    uint32_t magic;     /*< SERVE_MAGIC */
+    int32_t status;     /*< RC_OK, or the error code of the request */
+    int32_t m;          /*< Number of rows of the matrix (INFO, SPMV) */
+    int32_t n;          /*< Number of columns of the matrix (INFO, SPMV) */
+    int32_t is_real;    /*< 1 for double vectors, 0 for int vectors (INFO, SPMV) */
+    int32_t matrices;   /*< Number of matrices served */
+    int32_t batch;      /*< Number of products computed by the same pass (SPMV) */
+    int32_t reserved;   /*< Zero */
+    uint64_t kernel_ns; /*< Time of the pass alone, shared by its products (SPMV) */
+    uint64_t total_ns;  /*< Time from the receipt of the request to the reply (SPMV) */
+};
+
+/*!
+ * \brief           Structure representing the configuration of the server.
+ */
+struct ServeConfig {
+    const char *path;           /*!< Path of the UNIX domain socket. */
+    char *const *filenames;     /*!< Matrix Market files, their index being the matrix of a request. */
+    int matrices;               /*!< Number of files (1 to CONFIG_SERVE_MAX_MATRICES). */
+    int thread_count;           /*!< The number of threads (CONFIG_THREADS_AUTO to pick it per matrix). */
+    enum CsrKernel kernel;      /*!< The SpMV kernel (passes of a single product). */
+    int coalesce;               /*!< Maximum number of products of a pass (1 to CONFIG_CSR_BLOCK_MAX). */
+    int window_us;              /*!< Time a product may wait for others (0 to CONFIG_SERVE_MAX_WINDOW_US). */
+    bool shared;                /*!< Load the matrices through the shared-memory store (see shm.h). */
+    struct ArenaHandler *arena; /*!< The arena handler to use for memory management. */
+};
+
+/*!
+ * \brief           Load and plan the matrices and open the socket.
+ *
+ * \param[in]       cfg: Pointer to the server configuration.
+ * \return          RC_OK on success, an error code otherwise:
+ *                   - RC_INVALID_ARG_ERR if the configuration is invalid or the socket is served by another process.
+ *                   - RC_FILE_IO_ERR if a file could not be opened or the socket could not be created.
+ *                   - RC_FILE_INVALID_FMT_ERR if a parsing error occurs.
+ *                   - RC_MEM_ALLOC_ERR if memory allocation fails.
+ */
+int serve_init(const struct ServeConfig *cfg);
+
+/*!
+ * \brief           Serve the requests until asked to stop.
+ *
+ * \return          RC_OK on success, an error code otherwise:
+ *                   - RC_FAIL if the connection thread could not be started.
+ */
+int serve_run(void);
+
+/*!
+ * \brief           Close the socket and release the resources held outside of the arena.
+ *
+ * \details         Does nothing if the server was not initialized.
+ *
+ * \return          RC_OK on success, an error code otherwise.
+ */
+int serve_fini(void);
+
+#endif /*! SERVE_H */
@@ -0,0 +1,87 @@
+/*!
+ * \file            shm.h
+ * \date            2026-10-18
+ * \author          Mirko Lana [lana.mirko@icloud.com]
+ *
+ * \brief           Matrix store shared by the processes of a node (POSIX shared memory).
+ *
+ * \details         Benchmark sweeps and workers running on one node would each
+ *                  load their own copy of the same matrix. Through the store,
+ *                  the first process loading a matrix publishes its CSR arrays
+ *                  in a named shared-memory segment (shm_open + mmap) and the
+ *                  following ones map them, without parsing the file nor
+ *                  copying anything: N processes hold the matrix once.
+ *
+ *                  The segment is named after the identity of the file (device,
+ *                  inode, size and modification time), so a modified file gets
+ *                  a new segment. Its first page holds a header (layout,
+ *                  matrix metadata, publication state and reference count),
+ *                  the arrays follow, mapped read-only once published. The
+ *                  last process detaching unlinks the segment.
+ *
+ *                  A process finding a segment still being published waits for
+ *                  it up to CONFIG_SHM_READY_TIMEOUT_MS, then loads the matrix
+ *                  on its own. A process killed before detaching leaves its
+ *                  reference: the segment then outlives the processes and
+ *                  serves the next runs, until removed by hand (/dev/shm on
+ *                  Linux).
+ *
+ * \warning         The publisher keeps the copy it parsed in its arena. The
+ *                  arrays of an attached matrix are not in the arena: reach
+ *                  them through csr_matrix_row_ptr, csr_matrix_col_idx and
+ *                  csr_matrix_values, and never write them.
+ */
+
+#ifndef SHM_H
+#define SHM_H
+
+#include "arena.h"
+#include "config.h"
+#include "csr.h"
+
+#include <stdbool.h>
+#include <stddef.h>
+
+/*!
+ * \brief           Structure representing the attachment of a process to a shared matrix.
+ */
+struct ShmStore {
+    char name[CONFIG_SHM_NAME_MAX_LEN]; /*< Name of the segment */
+    void *base;                         /*< Mapped segment, NULL if not attached */
+    size_t size;                        /*< Size of the mapping in bytes */
+    bool published;                     /*< Whether this process published the segment (false if attached) */
+};
+
+/*!
+ * \brief           Load a matrix through the shared-memory store.
+ *
+ * \details         Attaches to the segment of the file when published by
+ *                  another process, else loads the file and publishes it. The
+ *                  arrays of the matrix are those of the segment in both cases.
+ *
+ * \param[out]      store: Pointer to the attachment to initialize.
+ * \param[out]      mtx: Pointer to the CSR matrix.
+ * \param[in]       filename: Path to the Matrix Market file.
+ * \param[out]      arena: Pointer to the arena handler for memory allocation.
+ * \return          RC_OK on success, an error code otherwise:
+ *                   - RC_INVALID_ARG_ERR if any argument is invalid.
+ *                   - RC_FILE_IO_ERR if the file or the segment could not be opened, sized or mapped.
+ *                   - RC_FILE_INVALID_FMT_ERR if a parsing error occurs.
+ *                   - RC_MEM_ALLOC_ERR if memory allocation fails.
+ */
+int shm_store_load(struct ShmStore *store, struct CsrMatrix *mtx, const char *filename, struct ArenaHandler *arena);
+
+/*!
+ * \brief           Detach from a shared matrix.
+ *
+ * \details         Drops the reference of the process and unlinks the segment
+ *                  if it was the last one. The matrices attached through the
+ *                  store must no longer be used. Does nothing if not attached.
+ *
+ * \param[in,out]   store: Pointer to the attachment.
+ * \return          RC_OK on success, an error code otherwise:
+ *                   - RC_INVALID_ARG_ERR if store is NULL.
+ */
+int shm_store_detach(struct ShmStore *store);
+
+#endif /*! SHM_H */
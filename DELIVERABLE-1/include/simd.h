@@ -0,0 +1,109 @@
+/*!
+ * \file            simd.h
+ * \date            2026-10-18
+ * \author          Mirko Lana [lana.mirko@icloud.com]
+ *
+ * \brief           Hand-written AVX2 and AVX-512 CSR SpMV kernels.
+ *
+ * \details         Explicit gather-based kernels, so that the generated code
+ *                  does not depend on the auto-vectorizer of the compiler:
+ *                   - gather: one row at a time, four independent accumulators
+ *                     hiding the FMA latency and a masked tail.
+ *                   - lanes: one row per vector lane (4 with AVX2, 8 with
+ *                     AVX-512) for groups of short rows, falling back to the
+ *                     gather kernel for groups holding a row longer than
+ *                     CONFIG_SIMD_LANES_MAX_NNZ.
+ *
+ *                  Integer matrices use one row at a time kernels for int8,
+ *                  int16 and int32 values. Products are summed in int32 when the
+ *                  caller proves that no row sum can overflow (SIMD_INT_ACC32),
+ *                  with vpmaddwd when values and vector also fit in int16
+ *                  (SIMD_INT_MADD) and vpmulld otherwise; else they are summed in
+ *                  int64 (vpmuldq) and the result saturates to int32.
+ *
+ *                  Quantized matrices (see quant.h) have gather kernels for
+ *                  int8 and int16 codes, widening them to double on the fly and
+ *                  summing x and q * x in separate accumulators.
+ *
+ *                  The kernels are only built on x86-64 (ISA_ENABLE_X86_DISPATCH)
+ *                  and must only be called when isa_get() reports the matching
+ *                  instruction set.
+ */
+
+#ifndef SIMD_H
+#define SIMD_H
+
+#include "isa.h"
+
+#include <stdint.h>
+
+#define SIMD_INT_ACC32 0x1 /*!< Row sums fit in int32: accumulate in int32 */
+#define SIMD_INT_MADD 0x2  /*!< Values and vector fit in int16: multiply pairs with vpmaddwd */
+
+/*!
+ * \brief           Multiply a range of rows of a real CSR matrix with a vector.
+ *
+ * \param[in]       row: CSR row pointer array.
+ * \param[in]       col: CSR column index array.
+ * \param[in]       val: CSR value array.
+ * \param[in]       x: Input vector values.
+ * \param[out]      y: Result vector values.
+ * \param[in]       row_begin: First row of the range.
+ * \param[in]       row_end: One past the last row of the range.
+ */
+typedef void (*SimdRowsFn)(const int *row, const int *col, const double *val, const double *x, double *y, int row_begin, int row_end);
+
+/*!
+ * \brief           Multiply a range of rows of an integer CSR matrix with a vector.
+ *
+ * \param[in]       row: CSR row pointer array.
+ * \param[in]       col: CSR column index array.
+ * \param[in]       val: CSR value array (int8_t, int16_t or int32_t, per kernel).
+ * \param[in]       x: Input vector values.
+ * \param[out]      y: Result vector values (saturated to int32).
+ * \param[in]       row_begin: First row of the range.
+ * \param[in]       row_end: One past the last row of the range.
+ * \param[in]       flags: SIMD_INT_* flags.
+ */
+typedef void (*SimdIntRowsFn)(const int *row, const int *col, const void *val, const int *x, int *y, int row_begin, int row_end, int flags);
+
+/*!
+ * \brief           Multiply a range of rows of a quantized CSR matrix with a vector.
+ *
+ * \param[in]       row: CSR row pointer array.
+ * \param[in]       col: CSR column index array.
+ * \param[in]       codes: Quantized values (int8_t or int16_t, per kernel).
+ * \param[in]       scale: Per-row scale.
+ * \param[in]       offset: Per-row offset.
+ * \param[in]       x: Input vector values.
+ * \param[out]      y: Result vector values.
+ * \param[in]       row_begin: First row of the range.
+ * \param[in]       row_end: One past the last row of the range.
+ */
+typedef void (*SimdQuantRowsFn)(const int *row, const int *col, const void *codes, const double *scale, const double *offset, const double *x, double *y, int row_begin, int row_end);
+
+#ifdef ISA_ENABLE_X86_DISPATCH
+void simd_csr_gather_avx2(const int *row, const int *col, const double *val, const double *x, double *y, int row_begin, int row_end);
+void simd_csr_gather_avx512(const int *row, const int *col, const double *val, const double *x, double *y, int row_begin, int row_end);
+void simd_csr_lanes_avx2(const int *row, const int *col, const double *val, const double *x, double *y, int row_begin, int row_end);
+void simd_csr_lanes_avx512(const int *row, const int *col, const double *val, const double *x, double *y, int row_begin, int row_end);
+void simd_csr_int8_avx2(const int *row, const int *col, const void *val, const int *x, int *y, int row_begin, int row_end, int flags);
+void simd_csr_int16_avx2(const int *row, const int *col, const void *val, const int *x, int *y, int row_begin, int row_end, int flags);
+void simd_csr_int32_avx2(const int *row, const int *col, const void *val, const int *x, int *y, int row_begin, int row_end, int flags);
+void simd_quant8_avx2(const int *row, const int *col, const void *codes, const double *scale, const double *offset, const double *x, double *y, int row_begin, int row_end);
+void simd_quant16_avx2(const int *row, const int *col, const void *codes, const double *scale, const double *offset, const double *x, double *y, int row_begin, int row_end);
+void simd_quant8_avx512(const int *row, const int *col, const void *codes, const double *scale, const double *offset, const double *x, double *y, int row_begin, int row_end);
+void simd_quant16_avx512(const int *row, const int *col, const void *codes, const double *scale, const double *offset, const double *x, double *y, int row_begin, int row_end);
+#endif /*! ISA_ENABLE_X86_DISPATCH */
+
+/*!
+ * \brief           Saturate a 64-bit sum to int32.
+ *
+ * \param[in]       sum: The sum.
+ * \return          The sum clamped to [INT32_MIN, INT32_MAX].
+ */
+static inline int simd_saturate_int32(long long sum) {
+    return sum > INT32_MAX ? INT32_MAX : (sum < INT32_MIN ? INT32_MIN : (int)sum);
+}
+
+#endif /*! SIMD_H */
@@ -0,0 +1,106 @@
+/*!
+ * \file            spgemm.h
+ * \date            2026-10-18
+ * \author          Mirko Lana [lana.mirko@icloud.com]
+ *
+ * \brief           Sparse matrix-sparse matrix multiply (SpGEMM) of CSR matrices.
+ *
+ * \details         Row-by-row (Gustavson) product C = A * B in two phases:
+ *                   - symbolic: the non-zeros of each row of C are bounded by
+ *                     the sum of the lengths of the rows of B it gathers
+ *                     (capped at the columns of B). The bounds size the arrays
+ *                     of C, so that each row has its own slot and threads
+ *                     never synchronize.
+ *                   - numeric: each row is accumulated in a per-thread
+ *                     accumulator, a small open-addressing hash table when its
+ *                     bound is at most CONFIG_SPGEMM_HASH_MAX_NNZ and a dense
+ *                     array of B->n items otherwise, and written to its slot;
+ *                     then the slots are compacted. Like the rows loaded from
+ *                     a file, the columns of a row are not sorted: they come
+ *                     in the order they were first touched.
+ *
+ *                  The symbolic phase only depends on the patterns: a plan can
+ *                  recompute the product after the values of A and B changed
+ *                  (e.g. the Galerkin product R * A * P of a multigrid setup).
+ *
+ *                  Real operands give a real product. Integer operands give an
+ *                  int32 product, summed in int64 and saturated.
+ *
+ * \warning         Memory management is handled via an arena allocator; ensure
+ *                  that the arena is properly initialized and destroyed.
+ */
+
+#ifndef SPGEMM_H
+#define SPGEMM_H
+
+#include "arena.h"
+#include "csr.h"
+
+#include <stddef.h>
+
+/*!
+ * \brief           Structure representing a planned SpGEMM.
+ */
+struct SpgemmPlan {
+    const struct CsrMatrix *a; /*< Left operand */
+    const struct CsrMatrix *b; /*< Right operand */
+    int threads;               /*< Number of threads (one scratch area each) */
+    long long flops;           /*< Operations of the product, 2 per multiply-add */
+    int ub_nnz;                /*< Upper bound of the non-zeros of the product */
+    int max_row_ub;            /*< Largest upper bound of a row */
+    int hash_cap;              /*< Slots of the hash table of each thread (0 without hash rows) */
+    int hash_rows;             /*< Number of rows using the hash accumulator */
+    int dense_rows;            /*< Number of rows using the dense accumulator */
+    size_t bytes;              /*< Bytes allocated by the plan (product arrays and scratch) */
+    struct ArenaObj ub;        /*< Offset of the slot of each row in the product arrays (m + 1 items) */
+    struct ArenaObj counts;    /*< Non-zeros of each row of the product (m items) */
+    struct ArenaObj row;       /*< Row pointers of the product */
+    struct ArenaObj col;       /*< Column indexes of the product (ub_nnz items) */
+    struct ArenaObj val;       /*< Values of the product (ub_nnz items, double or int) */
+    struct ArenaObj keys;      /*< Per-thread hash table keys (int) */
+    struct ArenaObj acc;       /*< Per-thread hash table sums (double or long long) */
+    struct ArenaObj touched;   /*< Per-thread columns (dense) or slots (hash) of the current row (int) */
+    struct ArenaObj mark;      /*< Per-thread last row touching each column, dense accumulator (int) */
+    struct ArenaObj dense;     /*< Per-thread dense accumulator sums (double or long long) */
+};
+
+/*!
+ * \brief           Plan the product of two CSR matrices (symbolic phase).
+ *
+ * \details         Uses the current thread count of the parallel backend.
+ *
+ * \param[out]      plan: Pointer to the plan to initialize.
+ * \param[in]       a: Pointer to the left operand.
+ * \param[in]       b: Pointer to the right operand (a->n rows, same value kind as a).
+ * \param[out]      arena: Pointer to the arena handler for memory allocation.
+ * \return          RC_OK on success, an error code otherwise:
+ *                   - RC_INVALID_ARG_ERR if any argument is invalid or the operands do not match.
+ *                   - RC_MEM_ALLOC_ERR if memory allocation fails or the product has too many non-zeros.
+ */
+int spgemm_plan_init(struct SpgemmPlan *plan, const struct CsrMatrix *a, const struct CsrMatrix *b, struct ArenaHandler *arena);
+
+/*!
+ * \brief           Compute the product of a plan (numeric phase).
+ *
+ * \details         The product shares the arrays of the plan: the next call on
+ *                  the same plan overwrites it.
+ *
+ * \param[in,out]   plan: Pointer to the plan.
+ * \param[out]      c: Pointer to the CSR matrix receiving the product.
+ * \return          RC_OK on success, an error code otherwise:
+ *                   - RC_INVALID_ARG_ERR if any argument is invalid.
+ */
+int spgemm_compute(struct SpgemmPlan *plan, struct CsrMatrix *c);
+
+/*!
+ * \brief           Multiply two CSR matrices.
+ *
+ * \param[out]      c: Pointer to the CSR matrix receiving the product.
+ * \param[in]       a: Pointer to the left operand.
+ * \param[in]       b: Pointer to the right operand.
+ * \param[out]      arena: Pointer to the arena handler for memory allocation.
+ * \return          RC_OK on success, an error code otherwise (see spgemm_plan_init).
+ */
+int spgemm_multiply(struct CsrMatrix *c, const struct CsrMatrix *a, const struct CsrMatrix *b, struct ArenaHandler *arena);
+
+#endif /*! SPGEMM_H */
@@ -0,0 +1,79 @@
+/*!
+ * \file            sweep.h
+ * \date            2026-10-18
+ * \author          Mirko Lana [lana.mirko@icloud.com]
+ *
+ * \brief           Benchmark of a list of matrices in one process (--batch).
+ *
+ * \details         spvm --batch <list> benchmarks the Matrix Market files of
+ *                  a list one after the other, with the options of a single
+ *                  benchmark, and saves the results of each one in its own
+ *                  JSON file (see bench_result_filename).
+ *
+ *                  Parsing a file and converting it to CSR takes longer than
+ *                  benchmarking it, so a loader thread reads the next matrix
+ *                  while the current one is benchmarked: matrix k + 1 is
+ *                  parsed in the background and, unless it takes longer than
+ *                  the benchmark of matrix k, ready when it is needed. Each
+ *                  matrix lives with its benchmark in an arena of its own,
+ *                  released once its results are saved, and CONFIG_SWEEP_SLOTS
+ *                  of them are held at once.
+ *
+ *                  The loader is pinned to the last online CPU and the
+ *                  benchmark threads to the CPUs of the other cores, so that
+ *                  the parsing does not compete with the SpMV. On a single
+ *                  core both share it.
+ *
+ *                  The list holds one path per line; empty lines and lines
+ *                  starting with '#' are skipped. A matrix failing to load or
+ *                  to run is reported and skipped.
+ *
+ * \warning         Memory management is handled via an arena allocator; ensure
+ *                  that the arena is properly initialized and destroyed.
+ */
+
+#ifndef SWEEP_H
+#define SWEEP_H
+
+#include "arena.h"
+#include "bench.h"
+
+/*!
+ * \brief           Structure representing the configuration of a sweep.
+ */
+struct SweepConfig {
+    const char *list;           /*!< Path of the list of Matrix Market files. */
+    struct BenchConfig bench;   /*!< Configuration of every benchmark, its filename, matrix, cpus and arena being set per matrix. */
+    struct ArenaHandler *arena; /*!< The arena handler holding the list. */
+};
+
+/*!
+ * \brief           Read the list and plan the CPUs of the loader and of the benchmarks.
+ *
+ * \param[in]       cfg: Pointer to the sweep configuration.
+ * \return          RC_OK on success, an error code otherwise:
+ *                   - RC_INVALID_ARG_ERR if the configuration is invalid (mode not benchmarking a single matrix, shared store).
+ *                   - RC_FILE_IO_ERR if the list could not be opened.
+ *                   - RC_FILE_INVALID_FMT_ERR if the list is empty or a path is too long.
+ *                   - RC_MEM_ALLOC_ERR if memory allocation fails.
+ */
+int sweep_init(const struct SweepConfig *cfg);
+
+/*!
+ * \brief           Benchmark every matrix of the list, loading the next one in the background.
+ *
+ * \return          RC_OK if every matrix was benchmarked, an error code otherwise:
+ *                   - RC_FAIL if the loader thread could not be started or a matrix was skipped.
+ */
+int sweep_run(void);
+
+/*!
+ * \brief           Release the resources held outside of the arena.
+ *
+ * \details         Does nothing if the sweep was not initialized.
+ *
+ * \return          RC_OK on success, an error code otherwise.
+ */
+int sweep_fini(void);
+
+#endif /*! SWEEP_H */
@@ -0,0 +1,92 @@
+/*!
+ * \file            topo.h
+ * \date            2026-10-18
+ * \author          Mirko Lana [lana.mirko@icloud.com]
+ *
+ * \brief           CPU cache and topology discovery module.
+ *
+ * \details         This module reads the cache hierarchy and the core/SMT layout
+ *                  of the machine from `/sys/devices/system/cpu` so that kernels
+ *                  and planners can size blocks, chunks and thread counts at
+ *                  runtime. When sysfs is not available (e.g. on macOS) the
+ *                  fallback values from `config.h` are used.
+ */
+
+#ifndef TOPO_H
+#define TOPO_H
+
+#include "config.h"
+
+#include <stdbool.h>
+#include <stdio.h>
+
+#define TOPO_MAX_CACHE_LEVELS 4 /*!< Maximum number of cache levels tracked */
+
+/*!
+ * \brief           Structure describing a data (or unified) cache level.
+ */
+struct TopoCache {
+    int level;       /*!< Cache level (1, 2, 3, ...) */
+    int size;        /*!< Size of one cache instance in bytes */
+    int line_size;   /*!< Cache line size in bytes */
+    int ways;        /*!< Associativity (0 if unknown) */
+    int shared_cpus; /*!< Number of logical CPUs sharing one instance of this cache */
+};
+
+/*!
+ * \brief           Structure describing the machine topology.
+ */
+struct Topology {
+    bool from_sysfs;                               /*!< Flag indicating if the values were read from sysfs (false means fallback values) */
+    int num_cpus;                                  /*!< Number of online logical CPUs */
+    int num_cores;                                 /*!< Number of physical cores */
+    int num_sockets;                               /*!< Number of sockets (packages) */
+    int smt_width;                                 /*!< Number of hardware threads per core */
+    int num_caches;                                /*!< Number of valid entries in cache */
+    struct TopoCache cache[TOPO_MAX_CACHE_LEVELS]; /*!< Data/unified caches seen by CPU 0, sorted by level */
+    int cpu_core[CONFIG_TOPO_MAX_CPUS];            /*!< Machine-wide core index of each logical CPU (-1 if offline) */
+    int cpu_socket[CONFIG_TOPO_MAX_CPUS];          /*!< Socket index of each logical CPU (-1 if offline) */
+    int cpu_sibling[CONFIG_TOPO_MAX_CPUS];         /*!< First SMT sibling of each logical CPU (-1 if none) */
+};
+
+/*!
+ * \brief           Discover the machine topology.
+ *
+ * \note            Must be called once before topo_get(). Falls back to the
+ *                  `CONFIG_TOPO_FALLBACK_*` values when sysfs cannot be read.
+ *
+ * \return          RC_OK on success, an error code otherwise.
+ */
+int topo_init(void);
+
+/*!
+ * \brief           Get the discovered topology.
+ *
+ * \return          Pointer to the topology structure.
+ */
+const struct Topology *topo_get(void);
+
+/*!
+ * \brief           Get the size of the data cache at the given level.
+ *
+ * \param[in]       level: Cache level (1, 2, 3).
+ * \return          The cache size in bytes, or the fallback value if unknown.
+ */
+int topo_get_cache_size(int level);
+
+/*!
+ * \brief           Get the cache line size.
+ *
+ * \return          The cache line size in bytes, or the fallback value if unknown.
+ */
+int topo_get_line_size(void);
+
+/*!
+ * \brief           Write the topology as a JSON object.
+ *
+ * \param[out]      fp: Output stream.
+ * \param[in]       indent: Indentation prefix used for each nested line.
+ */
+void topo_write_json(FILE *fp, const char *indent);
+
+#endif /*! TOPO_H */
@@ -9,6 +9,9 @@
 #ifndef UTILS_H
 #define UTILS_H
 
+#include <stdint.h>
+#include <time.h>
+
 /*!
  * \brief           Generate a random integer between min and max (inclusive).
  *
@@ -52,4 +55,15 @@
  */
 #define GET_MIN(x, y) ((x) > (y) ? (y) : (x))
 
+/*!
+ * \brief           Get current time in nanoseconds.
+ *
+ * \return          Current time in nanoseconds (monotonic clock).
+ */
+static inline uint64_t utils_get_ns(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000U + (uint64_t)ts.tv_nsec;
+}
+
 #endif /*! UTILS_H */
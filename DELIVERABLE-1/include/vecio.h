@@ -0,0 +1,70 @@
+/*!
+ * \file            vecio.h
+ * \date            2026-10-18
+ * \author          Mirko Lana [lana.mirko@icloud.com]
+ *
+ * \brief           Reading and writing vectors from and to files.
+ *
+ * \details         Two formats are supported:
+ *                   - Matrix Market array files ("%%MatrixMarket matrix array
+ *                     real|integer general"), n x 1 or 1 x n, one value per
+ *                     line, as written by most tools;
+ *                   - raw binary files, the n values in the native byte order
+ *                     with no header: doubles for real vectors, 32-bit
+ *                     integers for integer ones.
+ *
+ *                  Files are mapped in memory (mmap) and parsed or copied from
+ *                  the mapping, without stdio buffering. Writing a Matrix
+ *                  Market file formats the values in parallel, in blocks of
+ *                  CONFIG_VECIO_SLICES slices of CONFIG_VECIO_SLICE_ROWS
+ *                  rows taken by the threads of the parallel backend, and
+ *                  writes each block in order. The binary format is exact
+ *                  and the fastest to read and write; the Matrix Market one
+ *                  writes real values with 17 significant digits, which read
+ *                  back to the same doubles.
+ *
+ * \warning         Memory management is handled via an arena allocator; ensure
+ *                  that the arena is properly initialized and destroyed.
+ */
+
+#ifndef VECIO_H
+#define VECIO_H
+
+#include "arena.h"
+#include "vec.h"
+
+/*!
+ * \brief           Fill a vector with the values of a file.
+ *
+ * \details         The format is detected from the content: a file starting
+ *                  with the Matrix Market banner is parsed as an array,
+ *                  anything else is read as raw binary. A real vector accepts
+ *                  real and integer Matrix Market files, an integer one only
+ *                  integer files.
+ *
+ * \param[in,out]   vec: Pointer to the initialized vector, its size and type giving the expected ones.
+ * \param[in]       filename: Path of the file.
+ * \return          RC_OK on success, an error code otherwise:
+ *                   - RC_INVALID_ARG_ERR if any argument is NULL.
+ *                   - RC_FILE_IO_ERR if the file could not be opened or mapped.
+ *                   - RC_FILE_INVALID_FMT_ERR if its type, size or values do not match the vector.
+ */
+int vecio_load(struct Vec *vec, const char *filename);
+
+/*!
+ * \brief           Write a vector to a file.
+ *
+ * \details         Paths ending in ".mtx" are written as a Matrix Market
+ *                  array, n x 1, any other one as raw binary.
+ *
+ * \param[in]       vec: Pointer to the vector.
+ * \param[in]       filename: Path of the file, created or truncated.
+ * \param[in,out]   arena: Pointer to the arena handler holding the formatting buffer.
+ * \return          RC_OK on success, an error code otherwise:
+ *                   - RC_INVALID_ARG_ERR if any argument is NULL.
+ *                   - RC_FILE_IO_ERR if the file could not be opened or written.
+ *                   - RC_MEM_ALLOC_ERR if memory allocation fails.
+ */
+int vecio_save(const struct Vec *vec, const char *filename, struct ArenaHandler *arena);
+
+#endif /*! VECIO_H */
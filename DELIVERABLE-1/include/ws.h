@@ -0,0 +1,75 @@
+/*!
+ * \file            ws.h
+ * \date            2026-10-18
+ * \author          Mirko Lana [lana.mirko@icloud.com]
+ *
+ * \brief           Work-stealing row-block scheduler for the CSR SpMV.
+ *
+ * \details         The rows are split into CONFIG_WS_BLOCKS_PER_THREAD
+ *                  nnz-balanced blocks per thread. Each thread owns a
+ *                  contiguous range of blocks, kept in its own Chase-Lev deque,
+ *                  and computes them from the lowest one; once its deque is
+ *                  empty it steals the highest remaining block of a random
+ *                  victim. Rows whose cost is not predictable from their
+ *                  non-zeros (e.g. gathers hitting or missing the cache) are
+ *                  thus balanced at run time, while the blocks a thread does
+ *                  not lose stay the same across calls.
+ *
+ *                  The scheduler runs on an OpenMP parallel region or, with
+ *                  CONFIG_ENABLE_PTHREADS_PARALLELISM, on the default pool.
+ *
+ * \warning         Memory management is handled via an arena allocator; ensure
+ *                  that the arena is properly initialized and destroyed.
+ */
+
+#ifndef WS_H
+#define WS_H
+
+#include "arena.h"
+#include "barrier.h"
+#include "csr.h"
+#include "partition.h"
+#include "vec.h"
+
+#include <stdatomic.h>
+
+/*!
+ * \brief           Structure representing a work-stealing scheduler.
+ */
+struct WsScheduler {
+    int threads;                /*< Number of threads */
+    struct Partition blocks;    /*< Row blocks (nnz-balanced) */
+    struct ArenaObj deques;     /*< Per-thread deques of block indexes (struct WsDeque) */
+    struct ArenaObj senses;     /*< Per-thread barrier sense */
+    struct SpinBarrier barrier; /*< Barrier separating the deque refill from the stealing */
+    atomic_int done;            /*< Number of blocks computed in the current call */
+    atomic_long steals;         /*< Number of blocks stolen since initialization */
+};
+
+/*!
+ * \brief           Initialize a work-stealing scheduler for a matrix.
+ *
+ * \param[out]      ws: Pointer to the scheduler to initialize.
+ * \param[in]       mtx: Pointer to the CSR matrix to schedule.
+ * \param[in]       threads: Number of threads (>= 1).
+ * \param[out]      arena: Pointer to the arena handler for memory allocation.
+ * \return          RC_OK on success, an error code otherwise:
+ *                   - RC_INVALID_ARG_ERR if any argument is invalid.
+ *                   - RC_MEM_ALLOC_ERR if memory allocation fails.
+ */
+int ws_init(struct WsScheduler *ws, const struct CsrMatrix *mtx, int threads, struct ArenaHandler *arena);
+
+/*!
+ * \brief           Multiply a CSR matrix with a vector using the work-stealing scheduler.
+ *
+ * \param[in,out]   ws: Pointer to the scheduler initialized for mtx.
+ * \param[in]       mtx: Pointer to the CSR matrix.
+ * \param[in]       vec: Pointer to the vector.
+ * \param[out]      result: Pointer to the result vector.
+ * \return          RC_OK on success, an error code otherwise:
+ *                   - RC_INVALID_ARG_ERR if any argument is invalid.
+ *                   - RC_FAIL if the Pthreads default pool is missing or has a different size.
+ */
+int ws_mul_vec(struct WsScheduler *ws, const struct CsrMatrix *mtx, const struct Vec *vec, struct Vec *result);
+
+#endif /*! WS_H */
@@ -0,0 +1,204 @@
+/*!
+ * \file            ata.c
+ * \date            2026-10-18
+ * \author          Mirko Lana [lana.mirko@icloud.com]
+ *
+ * \brief           Fused A^T * (A * x) product of a CSR matrix (normal equations).
+ */
+
+#include "config.h"
+#include "ata.h"
+#include "rc.h"
+#include "arena.h"
+#include "csr.h"
+#include "partition.h"
+#include "pool.h"
+#include "vec.h"
+#include "slog.h"
+#include "utils.h"
+
+#include <string.h>
+
+#ifdef CONFIG_ENABLE_OMP_PARALLELISM
+#include <omp.h>
+#endif /*! CONFIG_ENABLE_OMP_PARALLELISM */
+
+/*!
+ * \brief           Structure containing the arguments of a Pthreads fused product.
+ */
+struct AtaPoolTask {
+    struct AtaPlan *plan; /*< Plan */
+    const double *x;      /*< Input vector */
+    double *y;            /*< Result vector */
+};
+
+/*!
+ * \brief           Get the number of threads of the parallel backend.
+ *
+ * \return          The number of threads.
+ */
+static int prv_ata_threads(void) {
+#ifdef CONFIG_ENABLE_PTHREADS_PARALLELISM
+    struct ThreadPool *pool = pool_get_default();
+    return pool ? pool->threads : 1;
+#elif defined(CONFIG_ENABLE_OMP_PARALLELISM)
+    return omp_get_max_threads();
+#else
+    return 1;
+#endif /*! CONFIG_ENABLE_PTHREADS_PARALLELISM */
+}
+
+/*!
+ * \brief           Scatter the rows of one thread: out += (a_i * x) * a_i.
+ *
+ * \param[in]       plan: Pointer to the plan.
+ * \param[in]       tid: Index of the calling thread.
+ * \param[in]       threads: Number of threads sharing the rows.
+ * \param[in]       x: Input vector.
+ * \param[in,out]   y: Result vector (the first thread scatters into it).
+ */
+static void prv_ata_scatter(const struct AtaPlan *plan, int tid, int threads, const double *x, double *y) {
+    const struct CsrMatrix *mtx = plan->mtx;
+    const int *row = csr_matrix_row_ptr(mtx);
+    const int *col = csr_matrix_col_idx(mtx);
+    const double *val = csr_matrix_values(mtx);
+    double *out = tid == 0 ? y : (double *)arena_get_ptr(&plan->buffers) + (size_t)(tid - 1) * plan->stride;
+    const int row_begin = partition_nnz_bound(mtx, tid, threads);
+    const int row_end = partition_nnz_bound(mtx, tid + 1, threads);
+
+    if (tid == 0)
+        memset(y, 0, sizeof(double) * (size_t)mtx->n);
+
+    for (int i = row_begin; i < row_end; ++i) {
+        double t = 0.0;
+#pragma omp simd reduction(+ : t)
+        for (int k = row[i]; k < row[i + 1]; ++k)
+            t += val[k] * x[col[k]];
+
+        /*! The row was just read: the scatter finds it in the L1 cache */
+        if (t != 0.0)
+            for (int k = row[i]; k < row[i + 1]; ++k)
+                out[col[k]] += t * val[k];
+    }
+}
+
+/*!
+ * \brief           Sum a slice of the buffers into the result and clear them.
+ *
+ * \param[in,out]   plan: Pointer to the plan.
+ * \param[in]       tid: Index of the calling thread.
+ * \param[in]       threads: Number of threads that scattered.
+ * \param[in,out]   y: Result vector.
+ */
+static void prv_ata_reduce(struct AtaPlan *plan, int tid, int threads, double *y) {
+    double *buffers = arena_get_ptr(&plan->buffers);
+    const int n = plan->mtx->n;
+    const int begin = (int)((long long)n * tid / threads);
+    const int end = (int)((long long)n * (tid + 1) / threads);
+
+    for (int t = 1; t < threads; ++t) {
+        double *buf = buffers + (size_t)(t - 1) * plan->stride;
+#pragma omp simd
+        for (int j = begin; j < end; ++j) {
+            y[j] += buf[j];
+            buf[j] = 0.0;
+        }
+    }
+}
+
+/*!
+ * \brief           Pool task scattering the rows of one thread.
+ *
+ * \param[in,out]   arg: Pointer to the AtaPoolTask.
+ * \param[in]       tid: Index of the calling thread.
+ * \param[in]       threads: Number of threads of the pool.
+ */
+static void __attribute__((unused)) prv_ata_scatter_task(void *arg, int tid, int threads) {
+    struct AtaPoolTask *task = arg;
+    prv_ata_scatter(task->plan, tid, threads, task->x, task->y);
+}
+
+/*!
+ * \brief           Pool task reducing a slice of the buffers.
+ *
+ * \param[in,out]   arg: Pointer to the AtaPoolTask.
+ * \param[in]       tid: Index of the calling thread.
+ * \param[in]       threads: Number of threads of the pool.
+ */
+static void __attribute__((unused)) prv_ata_reduce_task(void *arg, int tid, int threads) {
+    struct AtaPoolTask *task = arg;
+    prv_ata_reduce(task->plan, tid, threads, task->y);
+}
+
+int ata_init(struct AtaPlan *plan, const struct CsrMatrix *mtx, struct ArenaHandler *arena) {
+    SLOG_DEBUG("Entering ata_init");
+    if (!plan || !mtx || !arena) {
+        rc_set_err_msg("Invalid NULL argument(s) provided to ata_init");
+        return RC_INVALID_ARG_ERR;
+    }
+
+    if (!mtx->is_real) {
+        rc_set_err_msg("Only real matrices support the fused A^T * A product");
+        return RC_INVALID_ARG_ERR;
+    }
+
+    /*! One cache line apart, so the threads never write to the same line */
+    const int line = CONFIG_TOPO_FALLBACK_LINE_SIZE / (int)sizeof(double);
+    *plan = (struct AtaPlan){
+        .mtx = mtx,
+        .threads = prv_ata_threads(),
+        .stride = (mtx->n + line - 1) / line * line,
+    };
+
+    if (plan->threads > 1) {
+        enum ArenaReturnCode res = arena_calloc(arena, sizeof(double), (size_t)(plan->threads - 1) * plan->stride, &plan->buffers);
+        if (res != ARENA_RC_OK) {
+            rc_set_err_msg("Memory array allocation failed in ata_init");
+            return RC_MEM_ALLOC_ERR;
+        }
+    }
+
+    SLOG_DEBUG("A^T * A of a %dx%d matrix: %d threads, %d buffers of %d items", mtx->m, mtx->n, plan->threads, plan->threads - 1, plan->stride);
+    return RC_OK;
+}
+
+int ata_mul_vec(struct AtaPlan *plan, const struct Vec *vec, struct Vec *result) {
+    if (!plan || !vec || !result) {
+        rc_set_err_msg("Invalid NULL argument(s) provided to ata_mul_vec");
+        return RC_INVALID_ARG_ERR;
+    }
+
+    if (vec->n != plan->mtx->n || vec_size(result) != plan->mtx->n || !vec->is_real || !result->is_real) {
+        rc_set_err_msg("Incompatible matrix and vector dimensions or types in ata_mul_vec");
+        return RC_INVALID_ARG_ERR;
+    }
+
+    const double *x = arena_get_ptr(&vec->val);
+    double *y = arena_get_ptr(&result->val);
+
+#ifdef CONFIG_ENABLE_PTHREADS_PARALLELISM
+    struct ThreadPool *pool = pool_get_default();
+    if (pool && pool->threads == plan->threads && plan->threads > 1) {
+        struct AtaPoolTask task = { .plan = plan, .x = x, .y = y };
+        int res = pool_run(pool, prv_ata_scatter_task, &task);
+        if (res == RC_OK)
+            res = pool_run(pool, prv_ata_reduce_task, &task);
+        return res;
+    }
+#elif defined(CONFIG_ENABLE_OMP_PARALLELISM)
+    if (plan->threads > 1) {
+#pragma omp parallel num_threads(plan->threads)
+        {
+            const int tid = omp_get_thread_num();
+            const int threads = omp_get_num_threads();
+            prv_ata_scatter(plan, tid, threads, x, y);
+#pragma omp barrier
+            prv_ata_reduce(plan, tid, threads, y);
+        }
+        return RC_OK;
+    }
+#endif /*! CONFIG_ENABLE_PTHREADS_PARALLELISM */
+
+    prv_ata_scatter(plan, 0, 1, x, y);
+    return RC_OK;
+}
@@ -0,0 +1,46 @@
+/*!
+ * \file            barrier.c
+ * \date            2026-10-18
+ * \author          Mirko Lana [lana.mirko@icloud.com]
+ *
+ * \brief           Lightweight sense-reversing spin barrier.
+ */
+
+#include "config.h"
+#include "barrier.h"
+#include "rc.h"
+
+#include <sched.h>
+
+int barrier_init(struct SpinBarrier *barrier, int threads) {
+    if (!barrier || threads < 1) {
+        rc_set_err_msg("Invalid argument(s) provided to barrier_init");
+        return RC_INVALID_ARG_ERR;
+    }
+
+    atomic_init(&barrier->count, threads);
+    atomic_init(&barrier->sense, 0);
+    barrier->threads = threads;
+
+    return RC_OK;
+}
+
+void barrier_wait(struct SpinBarrier *barrier, int *local_sense) {
+    *local_sense = !*local_sense;
+
+    if (atomic_fetch_sub_explicit(&barrier->count, 1, memory_order_acq_rel) == 1) {
+        /*! Last thread to arrive: reset the counter and release the others */
+        atomic_store_explicit(&barrier->count, barrier->threads, memory_order_relaxed);
+        atomic_store_explicit(&barrier->sense, *local_sense, memory_order_release);
+        return;
+    }
+
+    for (int spins = 0; atomic_load_explicit(&barrier->sense, memory_order_acquire) != *local_sense; ++spins) {
+        if (spins < CONFIG_BARRIER_SPINS) {
+            barrier_cpu_relax();
+        } else {
+            sched_yield(); /*! Oversubscribed: let the late threads run */
+            spins = 0;
+        }
+    }
+}
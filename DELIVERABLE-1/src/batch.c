@@ -0,0 +1,293 @@
+/*!
+ * \file            batch.c
+ * \date            2026-10-18
+ * \author          Mirko Lana [lana.mirko@icloud.com]
+ *
+ * \brief           Batches of many small CSR matrices multiplied in one call.
+ */
+
+#include "config.h"
+#include "batch.h"
+#include "rc.h"
+#include "arena.h"
+#include "csr.h"
+#include "vec.h"
+#include "isa.h"
+#include "simd.h"
+#include "pool.h"
+#include "utils.h"
+#include "slog.h"
+
+#include <stdint.h>
+#include <string.h>
+
+#ifdef CONFIG_ENABLE_OMP_PARALLELISM
+#include <omp.h>
+#endif /*! CONFIG_ENABLE_OMP_PARALLELISM */
+
+/*!
+ * \brief           Structure containing the arguments of a Pthreads batched SpMV.
+ */
+struct BatchPoolTask {
+    const struct CsrBatch *batch; /*< Input batch */
+    const struct Vec *vec;        /*< Input vector */
+    struct Vec *result;           /*< Result vector */
+};
+
+/*!
+ * \brief           Multiply a range of matrices of a batch with their part of a vector.
+ *
+ * \details         Body shared by all the instruction set variants, see
+ *                  prv_csr_matrix_mul_vec_rows_body in csr.c.
+ *
+ * \param[in]       batch: Pointer to the batch.
+ * \param[in]       vec: Pointer to the input vector.
+ * \param[out]      result: Pointer to the result vector.
+ * \param[in]       begin: First matrix of the range.
+ * \param[in]       end: One past the last matrix of the range.
+ */
+static inline __attribute__((always_inline)) void prv_batch_rows_body(const struct CsrBatch *batch, const struct Vec *vec, struct Vec *result, int begin, int end) {
+    const int *row_off = arena_get_ptr(&batch->row_off);
+    const int *col_off = arena_get_ptr(&batch->col_off);
+    const int *row = arena_get_ptr(&batch->row);
+    const int *col = arena_get_ptr(&batch->col);
+
+    if (batch->is_real) {
+        const double *val = arena_get_ptr(&batch->val);
+        const double *x = arena_get_ptr(&vec->val);
+        double *y = arena_get_ptr(&result->val);
+        for (int b = begin; b < end; ++b) {
+            const double *xb = x + col_off[b];
+            for (int i = row_off[b]; i < row_off[b + 1]; ++i) {
+                double sum = 0.0;
+#pragma omp simd reduction(+ : sum)
+                for (int k = row[i]; k < row[i + 1]; ++k)
+                    sum += val[k] * xb[col[k]];
+                y[i] = sum;
+            }
+        }
+    } else {
+        const int32_t *val = arena_get_ptr(&batch->val);
+        const int *x = arena_get_ptr(&vec->val);
+        int *y = arena_get_ptr(&result->val);
+        for (int b = begin; b < end; ++b) {
+            const int *xb = x + col_off[b];
+            for (int i = row_off[b]; i < row_off[b + 1]; ++i) {
+                long long sum = 0;
+#pragma omp simd reduction(+ : sum)
+                for (int k = row[i]; k < row[i + 1]; ++k)
+                    sum += (long long)val[k] * xb[col[k]];
+                y[i] = simd_saturate_int32(sum);
+            }
+        }
+    }
+}
+
+/*!
+ * \brief           Define the kernel variants of an instruction set level.
+ *
+ * \param[in]       isa: Suffix of the variants.
+ * \param[in]       attr: Target attribute of the variants (empty for the baseline).
+ */
+#define PRV_BATCH_DEFINE_KERNELS(isa, attr)                                                                                             \
+    attr static void prv_batch_rows_##isa(const struct CsrBatch *batch, const struct Vec *vec, struct Vec *result, int begin, int end) { \
+        prv_batch_rows_body(batch, vec, result, begin, end);                                                                            \
+    }
+
+PRV_BATCH_DEFINE_KERNELS(baseline, )
+#ifdef ISA_ENABLE_X86_DISPATCH
+PRV_BATCH_DEFINE_KERNELS(avx2, __attribute__((target(ISA_TARGET_AVX2))))
+PRV_BATCH_DEFINE_KERNELS(avx512, __attribute__((target(ISA_TARGET_AVX512))))
+#endif /*! ISA_ENABLE_X86_DISPATCH */
+
+/*!
+ * \brief           Type of the kernel multiplying a range of matrices of a batch.
+ */
+typedef void (*BatchRowsFn)(const struct CsrBatch *, const struct Vec *, struct Vec *, int, int);
+
+/*!
+ * \brief           Kernel variants indexed by instruction set level (see isa_get).
+ */
+static const BatchRowsFn g_batch_kernels[ISA_LEVEL_COUNT] = {
+    [ISA_LEVEL_BASELINE] = prv_batch_rows_baseline,
+#ifdef ISA_ENABLE_X86_DISPATCH
+    [ISA_LEVEL_AVX2] = prv_batch_rows_avx2,
+    [ISA_LEVEL_AVX512] = prv_batch_rows_avx512,
+#else
+    [ISA_LEVEL_AVX2] = prv_batch_rows_baseline,
+    [ISA_LEVEL_AVX512] = prv_batch_rows_baseline,
+#endif /*! ISA_ENABLE_X86_DISPATCH */
+};
+
+/*!
+ * \brief           Find the first matrix of the share of a thread.
+ *
+ * \details         Whole matrices, balanced by non-zeros: the first matrix
+ *                  starting at or after p / parts of them.
+ *
+ * \param[in]       batch: Pointer to the batch.
+ * \param[in]       p: Index of the share.
+ * \param[in]       parts: Number of shares.
+ * \return          The index of the matrix (count for p >= parts).
+ */
+static int __attribute__((unused)) prv_batch_bound(const struct CsrBatch *batch, int p, int parts) {
+    if (p <= 0)
+        return 0;
+    if (p >= parts)
+        return batch->count;
+
+    const int *row_off = arena_get_ptr(&batch->row_off);
+    const int *row = arena_get_ptr(&batch->row);
+    long target = (long)batch->nz * p / parts;
+    int lo = 0;
+    int hi = batch->count;
+    while (lo < hi) {
+        int mid = lo + (hi - lo) / 2;
+        if (row[row_off[mid]] < target)
+            lo = mid + 1;
+        else
+            hi = mid;
+    }
+    return lo;
+}
+
+#ifdef CONFIG_ENABLE_PTHREADS_PARALLELISM
+/*!
+ * \brief           Pool task computing the nnz-balanced share of matrices of one thread.
+ *
+ * \param[in,out]   arg: Pointer to the BatchPoolTask.
+ * \param[in]       tid: Index of the calling thread.
+ * \param[in]       threads: Number of threads of the pool.
+ */
+static void prv_batch_pool_task(void *arg, int tid, int threads) {
+    struct BatchPoolTask *task = arg;
+    int begin = prv_batch_bound(task->batch, tid, threads);
+    int end = prv_batch_bound(task->batch, tid + 1, threads);
+
+    g_batch_kernels[isa_get()](task->batch, task->vec, task->result, begin, end);
+}
+#endif /*! CONFIG_ENABLE_PTHREADS_PARALLELISM */
+
+int batch_init(struct CsrBatch *batch, int count, int m, int n, int nz, bool is_real, struct ArenaHandler *arena) {
+    SLOG_DEBUG("Entering batch_init");
+    if (!batch || !arena || count < 1 || m < 0 || n < 0 || nz < 0) {
+        rc_set_err_msg("Invalid argument(s) provided to batch_init");
+        return RC_INVALID_ARG_ERR;
+    }
+
+    *batch = (struct CsrBatch){
+        .count = 0,
+        .m = 0,
+        .n = 0,
+        .nz = 0,
+        .max_count = count,
+        .max_m = m,
+        .max_n = n,
+        .max_nz = nz,
+        .is_real = is_real,
+    };
+
+    enum ArenaReturnCode res = arena_calloc(arena, sizeof(int), (size_t)count + 1, &batch->row_off);
+    if (res == ARENA_RC_OK)
+        res = arena_calloc(arena, sizeof(int), (size_t)count + 1, &batch->col_off);
+    if (res == ARENA_RC_OK)
+        res = arena_calloc(arena, sizeof(int), (size_t)m + 1, &batch->row);
+    if (res == ARENA_RC_OK)
+        res = arena_calloc(arena, sizeof(int), GET_MAX(nz, 1), &batch->col);
+    if (res == ARENA_RC_OK)
+        res = arena_calloc(arena, is_real ? sizeof(double) : sizeof(int32_t), GET_MAX(nz, 1), &batch->val);
+    if (res != ARENA_RC_OK) {
+        rc_set_err_msg("Memory array allocation failed in batch_init");
+        return RC_MEM_ALLOC_ERR;
+    }
+
+    return RC_OK;
+}
+
+int batch_add(struct CsrBatch *batch, const struct CsrMatrix *mtx) {
+    if (!batch || !mtx || mtx->is_real != batch->is_real) {
+        rc_set_err_msg("Invalid argument(s) provided to batch_add");
+        return RC_INVALID_ARG_ERR;
+    }
+
+    if (batch->count == batch->max_count || mtx->m > batch->max_m - batch->m || mtx->n > batch->max_n - batch->n || mtx->nz > batch->max_nz - batch->nz) {
+        rc_set_err_msg("Matrix %d exceeds the space reserved for the batch", batch->count);
+        return RC_IDX_OUT_OF_BOUNDS_ERR;
+    }
+
+    const int *src_row = csr_matrix_row_ptr(mtx);
+    const void *src_val = csr_matrix_values(mtx);
+    int *row_off = arena_get_ptr(&batch->row_off);
+    int *col_off = arena_get_ptr(&batch->col_off);
+    int *row = arena_get_ptr(&batch->row);
+    int *col = (int *)arena_get_ptr(&batch->col) + batch->nz;
+
+    for (int i = 1; i <= mtx->m; ++i)
+        row[batch->m + i] = batch->nz + src_row[i];
+    memcpy(col, csr_matrix_col_idx(mtx), sizeof(int) * (size_t)mtx->nz);
+
+    if (batch->is_real) {
+        memcpy((double *)arena_get_ptr(&batch->val) + batch->nz, src_val, sizeof(double) * (size_t)mtx->nz);
+    } else {
+        int32_t *val = (int32_t *)arena_get_ptr(&batch->val) + batch->nz;
+        for (int k = 0; k < mtx->nz; ++k) {
+            switch (mtx->val_type) {
+                case CSR_VAL_INT8:
+                    val[k] = ((const int8_t *)src_val)[k];
+                    break;
+                case CSR_VAL_INT16:
+                    val[k] = ((const int16_t *)src_val)[k];
+                    break;
+                default:
+                    val[k] = ((const int32_t *)src_val)[k];
+                    break;
+            }
+        }
+    }
+
+    batch->count++;
+    batch->m += mtx->m;
+    batch->n += mtx->n;
+    batch->nz += mtx->nz;
+    row_off[batch->count] = batch->m;
+    col_off[batch->count] = batch->n;
+
+    return RC_OK;
+}
+
+int batch_mul_vec(const struct CsrBatch *batch, const struct Vec *vec, struct Vec *result) {
+    if (!batch || !vec || !result) {
+        rc_set_err_msg("Invalid NULL argument(s) provided to batch_mul_vec");
+        return RC_INVALID_ARG_ERR;
+    }
+
+    if (vec_size(vec) != batch->n || vec->is_real != batch->is_real || vec_size(result) != batch->m || result->is_real != batch->is_real) {
+        rc_set_err_msg("Incompatible batch and vector dimensions or types in batch_mul_vec");
+        return RC_INVALID_ARG_ERR;
+    }
+
+    const BatchRowsFn rows = g_batch_kernels[isa_get()];
+
+#ifdef CONFIG_ENABLE_OMP_PARALLELISM
+    if (omp_get_max_threads() > 1 && batch->count > 1) {
+#pragma omp parallel
+        {
+            const int tid = omp_get_thread_num();
+            const int threads = omp_get_num_threads();
+            rows(batch, vec, result, prv_batch_bound(batch, tid, threads), prv_batch_bound(batch, tid + 1, threads));
+        }
+        return RC_OK;
+    }
+#endif /*! CONFIG_ENABLE_OMP_PARALLELISM */
+
+#ifdef CONFIG_ENABLE_PTHREADS_PARALLELISM
+    struct ThreadPool *pool = pool_get_default();
+    if (pool && pool->threads > 1 && batch->count > 1) {
+        struct BatchPoolTask task = { .batch = batch, .vec = vec, .result = result };
+        return pool_run(pool, prv_batch_pool_task, &task);
+    }
+#endif /*! CONFIG_ENABLE_PTHREADS_PARALLELISM */
+
+    rows(batch, vec, result, 0, batch->count);
+    return RC_OK;
+}
@@ -9,9 +9,38 @@
 #include "rc.h"
 #include "arena.h"
 #include "bench.h"
+#include "config.h"
 #include "csr.h"
 #include "vec.h"
+#include "policy.h"
+#include "partition.h"
+#include "barrier.h"
+#include "pool.h"
+#include "ws.h"
+#include "helper.h"
+#include "spgemm.h"
+#include "ata.h"
+#include "mpk.h"
+#include "dist.h"
+#include "quant.h"
+#include "shm.h"
+#include "fpc.h"
+#include "batch.h"
+#include "bench_spgemm.h"
+#include "bench_ata.h"
+#include "bench_mpk.h"
+#include "bench_poly.h"
+#include "bench_dist.h"
+#include "bench_gpart.h"
+#include "bench_quant.h"
+#include "bench_throughput.h"
+#include "bench_batch.h"
+#include "bench_chunk.h"
+#include "bench_helper.h"
+#include "vecio.h"
 #include "slog.h"
+#include "topo.h"
+#include "isa.h"
 #include "utils.h"
 
 #include <stdint.h>
@@ -20,19 +49,11 @@
 #include <time.h>
 #include <math.h>
 
-/*!
- * \struct          Benchmark handler structure.
- */
-struct BenchHandler {
-    struct CsrMatrix mtx; /*!< Input matrix. */
-    struct Vec vec;       /*!< Input vector. */
-    struct Vec result;    /*!< Result matrix. */
-    int thread_count;     /*!< Number of threads */
-    int warmup_iters;     /*!< Number of warmup iterations. */
-    int runs;             /*!< Number of benchmark runs. */
-};
+#ifdef CONFIG_ENABLE_OMP_PARALLELISM
+#include <omp.h>
+#endif /*! CONFIG_ENABLE_OMP_PARALLELISM */
 
-static struct BenchHandler g_bench_handler; /*!< Global benchmark handler. */
+#define PRV_BENCH_PAD 8 /*!< Stride (in doubles) keeping per-thread counters on separate cache lines. */
 
 /*!
  * \brief           Get current time in microseconds.
@@ -65,68 +86,541 @@ static inline uint64_t prv_bench_compute_stddev(const uint64_t *samples, int run
     return (uint64_t)sqrt((double)sum / (double)runs);
 }
 
-int bench_init(const struct BenchConfig *cfg) {
+/*!
+ * \brief           Set the number of threads used by the SpMV.
+ *
+ * \param[in,out]   bh: Pointer to the benchmark handler.
+ * \param[in]       requested: Requested number of threads, CONFIG_THREADS_AUTO
+ *                  to let the policy pick the fastest one for the loaded matrix.
+ * \param[in]       cpus: Largest number of threads the policy may pick.
+ * \param[out]      arena: Pointer to the arena handler (Pthreads pool allocation).
+ * \return          RC_OK on success, an error code otherwise.
+ */
+static int prv_bench_set_thread_count(struct BenchHandler *bh, int requested, int cpus, struct ArenaHandler *arena) {
+    SLOG_DEBUG("Entering prv_bench_set_thread_count");
+    bh->thread_count = requested;
+    bh->policy = "fixed";
+
+    if (requested == CONFIG_THREADS_AUTO) {
+        struct ThreadPolicy policy;
+        int res = policy_select_threads(&policy, &bh->mtx, &bh->vec, &bh->result, cpus);
+        if (res != RC_OK)
+            return res;
+
+        bh->thread_count = policy.threads;
+        bh->policy = policy.reason;
+    }
+
+#ifdef CONFIG_ENABLE_OMP_PARALLELISM
+    omp_set_num_threads(bh->thread_count);
+#endif /*! CONFIG_ENABLE_OMP_PARALLELISM */
+
+#ifdef CONFIG_ENABLE_PTHREADS_PARALLELISM
+    int res = pool_init_default(bh->thread_count, NULL, arena);
+    if (res != RC_OK)
+        return res;
+#else
+    UNUSED(arena);
+#endif /*! CONFIG_ENABLE_PTHREADS_PARALLELISM */
+    SLOG_INFO("Set threads count to: %d (%s)", bh->thread_count, bh->policy);
+
+    return RC_OK;
+}
+
+/*!
+ * \brief           Compute the product timed by one run of the current mode.
+ *
+ * \param[in,out]   bh: Pointer to the benchmark handler.
+ * \return          RC_OK on success, an error code otherwise.
+ */
+static inline int prv_bench_spmv(struct BenchHandler *bh) {
+    if (bh->quant.bits != 0)
+        return quant_matrix_mul_vec(&bh->quant.matrix, &bh->vec, &bh->result);
+    if (bh->quant.compressed)
+        return fpc_matrix_mul_vec(&bh->quant.fpc, &bh->vec, &bh->result);
+
+    switch (bh->mode) {
+        case BENCH_MODE_WS:
+            return ws_mul_vec(&bh->ws, &bh->mtx, &bh->vec, &bh->result);
+        case BENCH_MODE_HELPER:
+            return helper_mul_vec(&bh->helper, &bh->mtx, &bh->vec, &bh->result);
+        case BENCH_MODE_SPGEMM:
+            return spgemm_compute(&bh->spgemm.plan, &bh->spgemm.product);
+        case BENCH_MODE_ATA:
+            return ata_mul_vec(&bh->ata.plan, &bh->vec, &bh->ata.result);
+        case BENCH_MODE_MPK:
+            return mpk_powers(&bh->mpk.plan, &bh->vec, arena_get_ptr(&bh->mpk.powers));
+        case BENCH_MODE_POLY:
+            return bench_poly_spmv(bh);
+        case BENCH_MODE_DIST:
+            return dist_matrix_mul_vec(&bh->dist, &bh->vec, &bh->result);
+        case BENCH_MODE_THROUGHPUT:
+            return bench_throughput_spmv(bh);
+        case BENCH_MODE_BATCHED:
+            return batch_mul_vec(&bh->batch.csr, &bh->batch.x, &bh->batch.y);
+        case BENCH_MODE_CHUNKED:
+            return bench_chunk_spmv(bh);
+        default:
+            return csr_matrix_mul_vec(&bh->mtx, &bh->vec, &bh->result);
+    }
+}
+
+/*!
+ * \brief           Run the benchmark with one SpMV call per run.
+ *
+ * \param[in,out]   bh: Pointer to the benchmark handler.
+ * \param[out]      samples: Array receiving the time of each run.
+ * \return          RC_OK on success, an error code otherwise.
+ */
+static int prv_bench_run_call(struct BenchHandler *bh, uint64_t *samples) {
+    for (int i = 0; i < bh->runs; ++i) {
+        uint64_t start = prv_bench_get_us();
+
+        int res = prv_bench_spmv(bh);
+        if (res != RC_OK)
+            return res;
+
+        uint64_t end = prv_bench_get_us();
+
+        SLOG_DEBUG("Run %d completed in %lu us", i + 1, (end - start));
+        samples[i] = end - start;
+    }
+
+    return RC_OK;
+}
+
+/*!
+ * \brief           Run the benchmark inside a single parallel region.
+ *
+ * \details         Threads enter the region once and loop over the runs, each
+ *                  computing its rows of the static partition and meeting at a
+ *                  spin barrier. The master timestamps right after every
+ *                  barrier, so a sample is the time between two barriers.
+ *
+ *                  In adaptive mode every thread also times its part. After the
+ *                  first CONFIG_ADAPTIVE_PROBE_RUNS runs, and then every
+ *                  CONFIG_ADAPTIVE_PERIOD runs, the master resizes the parts in
+ *                  proportion to their measured throughput between two barriers;
+ *                  the rebalance itself is not part of the samples.
+ *
+ * \param[in,out]   bh: Pointer to the benchmark handler.
+ * \param[out]      samples: Array receiving the time of each run.
+ * \param[in]       adaptive: Flag enabling the feedback-directed rebalancing.
+ * \return          RC_OK on success, an error code otherwise.
+ */
+static int prv_bench_run_persistent(struct BenchHandler *bh, uint64_t *samples, bool adaptive) {
+#ifdef CONFIG_ENABLE_OMP_PARALLELISM
+    const struct CsrMatrix *mtx = &bh->mtx;
+    const int *bounds = partition_get_bounds(&bh->part);
+    const int parts = bh->part.parts;
+    const int runs = bh->runs;
+    double *part_ns = adaptive ? arena_get_ptr(&bh->part_ns) : NULL;
+    double *part_times = adaptive ? arena_get_ptr(&bh->part_times) : NULL;
+    struct SpinBarrier barrier;
+    uint64_t prev = 0U;
+    int res = RC_OK;
+
+    bh->rebalances = 0;
+
+#pragma omp parallel num_threads(parts)
+    {
+        const int tid = omp_get_thread_num();
+        const int threads = omp_get_num_threads();
+        int sense = 0;
+
+#pragma omp single
+        barrier_init(&barrier, threads);
+
+        barrier_wait(&barrier, &sense);
+        if (tid == 0)
+            prev = prv_bench_get_us();
+
+        for (int i = 0; i < runs; ++i) {
+            /*! The team may be smaller than requested: cycle over the parts */
+            for (int p = tid; p < parts; p += threads) {
+                uint64_t start = adaptive ? utils_get_ns() : 0U;
+                csr_matrix_mul_vec_rows(mtx, &bh->vec, &bh->result, bounds[p], bounds[p + 1]);
+                if (adaptive)
+                    part_ns[p * PRV_BENCH_PAD] += (double)(utils_get_ns() - start);
+            }
+
+            barrier_wait(&barrier, &sense);
+            if (tid == 0) {
+                uint64_t now = prv_bench_get_us();
+                samples[i] = now - prev;
+                prev = now;
+            }
+
+            bool rebalance = adaptive && (i + 1 == CONFIG_ADAPTIVE_PROBE_RUNS ||
+                                          (i + 1 > CONFIG_ADAPTIVE_PROBE_RUNS && (i + 1 - CONFIG_ADAPTIVE_PROBE_RUNS) % CONFIG_ADAPTIVE_PERIOD == 0));
+            if (rebalance) {
+                if (tid == 0) {
+                    for (int p = 0; p < parts; ++p) {
+                        part_times[p] = part_ns[p * PRV_BENCH_PAD];
+                        part_ns[p * PRV_BENCH_PAD] = 0.0;
+                    }
+                    if (res == RC_OK)
+                        res = partition_rebalance(&bh->part, mtx, part_times);
+                    bh->rebalances++;
+                }
+
+                barrier_wait(&barrier, &sense);
+                if (tid == 0)
+                    prev = prv_bench_get_us();
+            }
+        }
+    }
+
+    if (adaptive) {
+        const int *row = csr_matrix_row_ptr(mtx);
+        for (int p = 0; p < parts; ++p)
+            SLOG_DEBUG("Part %d: rows [%d, %d), %d non-zeros", p, bounds[p], bounds[p + 1], row[bounds[p + 1]] - row[bounds[p]]);
+    }
+
+    return res;
+#else
+    UNUSED(adaptive);
+    SLOG_WARN("Persistent and adaptive modes require OpenMP, falling back to one call per run");
+    return prv_bench_run_call(bh, samples);
+#endif /*! CONFIG_ENABLE_OMP_PARALLELISM */
+}
+
+double bench_rel_l2(const struct Vec *exact, const struct Vec *other) {
+    double norm_e = 0.0;
+    double norm_y = 0.0;
+
+    for (int i = 0; i < exact->n; ++i) {
+        double y, y_hat;
+        if (exact->is_real) {
+            y = ((const double *)arena_get_ptr(&exact->val))[i];
+            y_hat = ((const double *)arena_get_ptr(&other->val))[i];
+        } else {
+            y = ((const int *)arena_get_ptr(&exact->val))[i];
+            y_hat = ((const int *)arena_get_ptr(&other->val))[i];
+        }
+        norm_e += (y_hat - y) * (y_hat - y);
+        norm_y += y * y;
+    }
+
+    return norm_y > 0.0 ? sqrt(norm_e / norm_y) : 0.0;
+}
+
+/*!
+ * \brief           Describe how the input matrix was loaded.
+ *
+ * \param[in]       bh: Pointer to the benchmark handler.
+ * \return          "off" without the shared-memory store, else "published",
+ *                  "attached" or "private" (the store could not be used).
+ */
+static const char *prv_bench_shm_to_str(const struct BenchHandler *bh) {
+    if (!bh->shared)
+        return "off";
+    if (!bh->shm.base)
+        return "private";
+    return bh->shm.published ? "published" : "attached";
+}
+
+/*!
+ * \brief           Check whether a mode multiplies the matrix, in its original order, with bh->vec.
+ *
+ * \param[in]       mode: The execution mode.
+ * \return          true if the input vector may be read from a file, false otherwise.
+ */
+static bool prv_bench_mode_reads_x(enum BenchMode mode) {
+    switch (mode) {
+        case BENCH_MODE_CALL:
+        case BENCH_MODE_PERSISTENT:
+        case BENCH_MODE_ADAPTIVE:
+        case BENCH_MODE_WS:
+        case BENCH_MODE_HELPER:
+        case BENCH_MODE_ATA:
+        case BENCH_MODE_MPK:
+        case BENCH_MODE_POLY:
+        case BENCH_MODE_CHUNKED:
+            return true;
+        default:
+            return false;
+    }
+}
+
+/*!
+ * \brief           Check whether a mode leaves y = A x, in the original row order, in bh->result.
+ *
+ * \param[in]       mode: The execution mode.
+ * \return          true if the result may be written to a file, false otherwise.
+ */
+static bool prv_bench_mode_writes_y(enum BenchMode mode) {
+    switch (mode) {
+        case BENCH_MODE_CALL:
+        case BENCH_MODE_PERSISTENT:
+        case BENCH_MODE_ADAPTIVE:
+        case BENCH_MODE_WS:
+        case BENCH_MODE_HELPER:
+        case BENCH_MODE_CHUNKED:
+            return true;
+        default:
+            return false;
+    }
+}
+
+int bench_mode_from_str(const char *str, enum BenchMode *mode) {
+    if (!str || !mode) {
+        rc_set_err_msg("Invalid NULL argument(s) provided to bench_mode_from_str");
+        return RC_INVALID_ARG_ERR;
+    }
+
+    for (int i = 0; i < BENCH_MODE_COUNT; ++i) {
+        if (strcmp(str, bench_mode_to_str((enum BenchMode)i)) == 0) {
+            *mode = (enum BenchMode)i;
+            return RC_OK;
+        }
+    }
+
+    rc_set_err_msg("Unknown benchmark mode '%s'", str);
+    return RC_INVALID_ARG_ERR;
+}
+
+const char *bench_mode_to_str(enum BenchMode mode) {
+    switch (mode) {
+        case BENCH_MODE_CALL:
+            return "call";
+        case BENCH_MODE_PERSISTENT:
+            return "persistent";
+        case BENCH_MODE_ADAPTIVE:
+            return "adaptive";
+        case BENCH_MODE_WS:
+            return "ws";
+        case BENCH_MODE_HELPER:
+            return "helper";
+        case BENCH_MODE_SPGEMM:
+            return "spgemm";
+        case BENCH_MODE_ATA:
+            return "ata";
+        case BENCH_MODE_MPK:
+            return "mpk";
+        case BENCH_MODE_POLY:
+            return "poly";
+        case BENCH_MODE_DIST:
+            return "dist";
+        case BENCH_MODE_GPART:
+            return "gpart";
+        case BENCH_MODE_THROUGHPUT:
+            return "throughput";
+        case BENCH_MODE_BATCHED:
+            return "batched";
+        case BENCH_MODE_CHUNKED:
+            return "chunked";
+        default:
+            return "unknown";
+    }
+}
+
+int bench_init(struct BenchHandler *bh, const struct BenchConfig *cfg) {
     SLOG_DEBUG("Entering bench_init");
 
-    if (!cfg) {
+    if (!bh || !cfg) {
         rc_set_err_msg("Invalid NULL argument(s) provided to bench_init");
         return RC_INVALID_ARG_ERR;
     }
 
     SLOG_DEBUG("Setting warmup iterations to: %d", cfg->warmup_iters);
-    g_bench_handler.warmup_iters = cfg->warmup_iters;
+    bh->warmup_iters = cfg->warmup_iters;
 
     SLOG_DEBUG("Setting benchmark runs to: %d", cfg->runs);
-    g_bench_handler.runs = cfg->runs;
+    bh->runs = cfg->runs;
+
+    SLOG_DEBUG("Setting benchmark mode to: %s", bench_mode_to_str(cfg->mode));
+    bh->mode = cfg->mode;
+
+    SLOG_DEBUG("Setting SpMV kernel to: %s", csr_kernel_to_str(cfg->kernel));
+    csr_set_kernel(cfg->kernel);
+
+    if ((cfg->quant_bits != 0 || cfg->compress) && cfg->mode != BENCH_MODE_CALL) {
+        rc_set_err_msg("Quantized and compressed values are only supported in call mode");
+        return RC_INVALID_ARG_ERR;
+    }
+    if (cfg->shared && cfg->mode == BENCH_MODE_DIST) {
+        rc_set_err_msg("The shared-memory store is not supported in dist mode");
+        return RC_INVALID_ARG_ERR;
+    }
+    if (cfg->x_file && !prv_bench_mode_reads_x(cfg->mode)) {
+        rc_set_err_msg("The input vector cannot be read from a file in %s mode", bench_mode_to_str(cfg->mode));
+        return RC_INVALID_ARG_ERR;
+    }
+    if (cfg->y_file && !prv_bench_mode_writes_y(cfg->mode)) {
+        rc_set_err_msg("The result cannot be written to a file in %s mode", bench_mode_to_str(cfg->mode));
+        return RC_INVALID_ARG_ERR;
+    }
+    if (cfg->quant_bits != 0 && cfg->compress) {
+        rc_set_err_msg("Quantized values cannot be compressed");
+        return RC_INVALID_ARG_ERR;
+    }
 
     SLOG_DEBUG("Loading input matrix from file: %s", cfg->filename);
-    int res = csr_matrix_load_from_file(&g_bench_handler.mtx, cfg->filename, cfg->arena);
+    bh->filename = cfg->filename;
+    bh->shared = cfg->shared;
+    int res;
+    if (bh->mode == BENCH_MODE_DIST) {
+        res = dist_matrix_load(&bh->dist, cfg->filename, cfg->arena);
+        bh->mtx = bh->dist.local; /*! The vectors and the thread count follow the part of the rank */
+    } else if (cfg->matrix) {
+        bh->mtx = *cfg->matrix;
+        res = RC_OK;
+    } else if (cfg->shared) {
+        res = shm_store_load(&bh->shm, &bh->mtx, cfg->filename, cfg->arena);
+    } else {
+        res = csr_matrix_load_from_file(&bh->mtx, cfg->filename, cfg->arena);
+    }
     if (res != RC_OK)
         return res;
-    SLOG_DEBUG("Martix loaded: rows=%d, cols=%d, non-zero=%d", g_bench_handler.mtx.m, g_bench_handler.mtx.n, g_bench_handler.mtx.nz);
+    SLOG_DEBUG("Martix loaded: rows=%d, cols=%d, non-zero=%d", bh->mtx.m, bh->mtx.n, bh->mtx.nz);
 
-    SLOG_DEBUG("Initializing input vector of size: %d", g_bench_handler.mtx.n);
-    res = vec_init(&g_bench_handler.vec, g_bench_handler.mtx.n, g_bench_handler.mtx.is_real, cfg->arena);
+    res = bench_quant_init(bh, cfg);
     if (res != RC_OK)
         return res;
-    SLOG_DEBUG("Input vector initialized");
 
-    SLOG_DEBUG("Filling input vector with random values");
-    res = vec_rand_fill(&g_bench_handler.vec);
+    SLOG_DEBUG("Initializing input vector of size: %d", bh->mtx.n);
+    res = vec_init(&bh->vec, bh->mtx.n, bh->mtx.is_real, cfg->arena);
     if (res != RC_OK)
         return res;
-    if (g_bench_handler.vec.is_real) {
+    SLOG_DEBUG("Input vector initialized");
+
+    bh->x_file = cfg->x_file;
+    bh->y_file = cfg->y_file;
+    if (cfg->x_file) {
+        SLOG_DEBUG("Reading input vector from file: %s", cfg->x_file);
+        uint64_t start = prv_bench_get_us();
+        res = vecio_load(&bh->vec, cfg->x_file);
+        if (res != RC_OK)
+            return res;
+        SLOG_INFO("Input vector read from '%s' in %.3f ms", cfg->x_file, (double)(prv_bench_get_us() - start) / 1e3);
+    } else {
+        SLOG_DEBUG("Filling input vector with random values");
+        res = vec_rand_fill(&bh->vec);
+        if (res != RC_OK)
+            return res;
+    }
+    if (bh->vec.is_real) {
         double v1, v2;
-        vec_get_real_item(&g_bench_handler.vec, 0, &v1);
-        vec_get_real_item(&g_bench_handler.vec, g_bench_handler.vec.n - 1, &v2);
-        SLOG_DEBUG("Input vector filled. 2 random-picked values [%f, %f]", v1, v2);
+        vec_get_real_item(&bh->vec, 0, &v1);
+        vec_get_real_item(&bh->vec, bh->vec.n - 1, &v2);
+        SLOG_DEBUG("Input vector filled. First and last values [%f, %f]", v1, v2);
     } else {
         int v1, v2;
-        vec_get_integer_item(&g_bench_handler.vec, 0, &v1);
-        vec_get_integer_item(&g_bench_handler.vec, g_bench_handler.vec.n - 1, &v2);
-        SLOG_DEBUG("Input vector filled. 2 random-picked values [%d, %d]", v1, v2);
+        vec_get_integer_item(&bh->vec, 0, &v1);
+        vec_get_integer_item(&bh->vec, bh->vec.n - 1, &v2);
+        SLOG_DEBUG("Input vector filled. First and last values [%d, %d]", v1, v2);
     }
 
-    SLOG_DEBUG("Initializing result vector of size: %d", g_bench_handler.mtx.m);
-    res = vec_init(&g_bench_handler.result, g_bench_handler.mtx.m, g_bench_handler.mtx.is_real, cfg->arena);
+    SLOG_DEBUG("Initializing result vector of size: %d", bh->mtx.m);
+    res = vec_init(&bh->result, bh->mtx.m, bh->mtx.is_real, cfg->arena);
     if (res != RC_OK)
         return res;
     SLOG_DEBUG("Result vector initialized");
 
+    /*! The policy judges a single matrix: the throughput and batched modes use the whole machine by default */
+    const int cpus = cfg->cpus > 0 ? cfg->cpus : topo_get()->num_cpus;
+    int requested = cfg->thread_count;
+    if ((bh->mode == BENCH_MODE_THROUGHPUT || bh->mode == BENCH_MODE_BATCHED) && requested == CONFIG_THREADS_AUTO)
+        requested = cpus;
+    res = prv_bench_set_thread_count(bh, requested, cpus, cfg->arena);
+    if (res != RC_OK)
+        return res;
+
+    if (bh->mode == BENCH_MODE_THROUGHPUT) {
+        res = bench_throughput_init(bh, cfg);
+        if (res != RC_OK)
+            return res;
+    }
+
+    if (bh->mode == BENCH_MODE_BATCHED) {
+        res = bench_batch_init(bh, cfg);
+        if (res != RC_OK)
+            return res;
+    }
+
+    if (bh->mode == BENCH_MODE_CHUNKED) {
+        res = bench_chunk_init(bh, cfg);
+        if (res != RC_OK)
+            return res;
+    }
+
+    if (bh->mode == BENCH_MODE_PERSISTENT || bh->mode == BENCH_MODE_ADAPTIVE) {
+        SLOG_DEBUG("Partitioning rows in %d nnz-balanced parts", bh->thread_count);
+        res = partition_init_nnz(&bh->part, &bh->mtx, bh->thread_count, cfg->arena);
+        if (res != RC_OK)
+            return res;
+    }
+
+    if (bh->mode == BENCH_MODE_ADAPTIVE) {
+        SLOG_DEBUG("Allocating per-part timers");
+        enum ArenaReturnCode arena_res = arena_calloc(cfg->arena, sizeof(double), (size_t)bh->thread_count * PRV_BENCH_PAD, &bh->part_ns);
+        if (arena_res == ARENA_RC_OK)
+            arena_res = arena_calloc(cfg->arena, sizeof(double), bh->thread_count, &bh->part_times);
+        if (arena_res != ARENA_RC_OK) {
+            rc_set_err_msg("Memory array allocation failed in bench_init");
+            return RC_MEM_ALLOC_ERR;
+        }
+    }
+
+    if (bh->mode == BENCH_MODE_WS) {
+        SLOG_DEBUG("Initializing the work-stealing scheduler for %d threads", bh->thread_count);
+        res = ws_init(&bh->ws, &bh->mtx, bh->thread_count, cfg->arena);
+        if (res != RC_OK)
+            return res;
+    }
+
+    if (bh->mode == BENCH_MODE_HELPER) {
+        SLOG_DEBUG("Starting %d compute threads, each with an SMT helper thread", bh->thread_count);
+        res = helper_init(&bh->helper, &bh->mtx, bh->thread_count, cfg->arena);
+        if (res != RC_OK)
+            return res;
+    }
+
+    if (bh->mode == BENCH_MODE_ATA) {
+        res = bench_ata_init(bh, cfg->arena);
+        if (res != RC_OK)
+            return res;
+    }
+
+    if (bh->mode == BENCH_MODE_MPK) {
+        res = bench_mpk_init(bh, cfg->mpk_steps, cfg->arena);
+        if (res != RC_OK)
+            return res;
+    }
+
+    if (bh->mode == BENCH_MODE_POLY) {
+        res = bench_poly_init(bh, cfg->poly_degree, cfg->arena);
+        if (res != RC_OK)
+            return res;
+    }
+
+    if (bh->mode == BENCH_MODE_GPART) {
+        res = bench_gpart_init(bh, cfg->gpart_parts, cfg->arena);
+        if (res != RC_OK)
+            return res;
+    }
+
+    if (bh->mode == BENCH_MODE_SPGEMM) {
+        res = bench_spgemm_init(bh, cfg->arena);
+        if (res != RC_OK)
+            return res;
+    }
+
     return RC_OK;
 }
 
-int bench_warmup(void) {
+int bench_warmup(struct BenchHandler *bh) {
     SLOG_DEBUG("Entering bench_warmup");
 
-    SLOG_INFO("Starting warmup with %d iterations", g_bench_handler.warmup_iters);
-    for (int i = 0; i < g_bench_handler.warmup_iters; ++i)
-        csr_matrix_mul_vec(&g_bench_handler.mtx, &g_bench_handler.vec, &g_bench_handler.result);
+    SLOG_INFO("Starting warmup with %d iterations", bh->warmup_iters);
+    for (int i = 0; i < bh->warmup_iters; ++i)
+        prv_bench_spmv(bh);
 
     return RC_OK;
 }
 
-int bench_run(struct BenchResults *results, struct ArenaHandler *arena) {
+int bench_run(struct BenchHandler *bh, struct BenchResults *results, struct ArenaHandler *arena) {
     SLOG_DEBUG("Entering bench_run");
     if (!results) {
         rc_set_err_msg("Invalid NULL argument(s) provided to bench_run");
@@ -135,8 +629,23 @@ int bench_run(struct BenchResults *results, struct ArenaHandler *arena) {
 
     SLOG_DEBUG("Initializing empty benchmark results structure");
     *results = (struct BenchResults){
-        .warmup_iters = g_bench_handler.warmup_iters,
-        .runs = g_bench_handler.runs,
+        .warmup_iters = bh->warmup_iters,
+        .runs = bh->runs,
+        .mode = bh->mode,
+        .rebalances = 0,
+        .steals = 0,
+        .dist = { .ranks = 1, .rel_l2 = -1.0 },
+        .load_ms = -1.0,
+        .load_wait_ms = 0.0,
+        .x_file = bh->x_file,
+        .y_file = bh->y_file,
+        .y_save_ms = 0.0,
+        .shm = prv_bench_shm_to_str(bh),
+        .thread_count = bh->thread_count,
+        .thread_policy = bh->policy,
+        .isa = isa_to_str(isa_get()),
+        .kernel = csr_matrix_get_kernel(&bh->mtx),
+        .quant = { .bits = bh->quant.bits, .compressed = bh->quant.compressed, .fpc_ratio = bh->quant.fpc_ratio },
         .samples = { 0 },
         .mean = 0U,
         .stddev = 0U,
@@ -145,35 +654,124 @@ int bench_run(struct BenchResults *results, struct ArenaHandler *arena) {
     };
 
     SLOG_DEBUG("Allocating memory for benchmark samples array");
-    enum ArenaReturnCode arena_res = arena_calloc(arena, sizeof(uint64_t), g_bench_handler.runs, &results->samples);
+    enum ArenaReturnCode arena_res = arena_calloc(arena, sizeof(uint64_t), bh->runs, &results->samples);
     if (arena_res != ARENA_RC_OK) {
         rc_set_err_msg("Memory array allocation failed in bench_run");
         return RC_MEM_ALLOC_ERR;
     }
     SLOG_DEBUG("Memory allocated for benchmark samples array");
 
-    SLOG_INFO("Starting benchmark with %d runs", g_bench_handler.runs);
+    SLOG_INFO("Starting benchmark with %d runs (%s mode)", bh->runs, bench_mode_to_str(bh->mode));
     uint64_t *samples = arena_get_ptr(&results->samples);
-    for (int i = 0; i < g_bench_handler.runs; ++i) {
+    if (bh->mode == BENCH_MODE_DIST)
+        bh->dist.wait_us = 0.0; /*! Like the samples, without the warmup calls and their MPI connection setup */
+    int res;
+    switch (bh->mode) {
+        case BENCH_MODE_PERSISTENT:
+            res = prv_bench_run_persistent(bh, samples, false);
+            break;
+        case BENCH_MODE_ADAPTIVE:
+            res = prv_bench_run_persistent(bh, samples, true);
+            break;
+        case BENCH_MODE_THROUGHPUT:
+            res = bench_throughput_run(bh, results, arena);
+            samples = arena_get_ptr(&results->samples); /*! The pools of the groups allocate from the arena */
+            break;
+        default:
+            res = prv_bench_run_call(bh, samples);
+            break;
+    }
+    if (res != RC_OK)
+        return res;
+
+    /*! Update benchmark results. */
+    results->rebalances = bh->rebalances;
+    if (bh->mode == BENCH_MODE_WS)
+        results->steals = atomic_load(&bh->ws.steals);
+    for (int i = 0; i < bh->runs; ++i) {
+        results->mean += samples[i];
+        results->min = GET_MIN(results->min, samples[i]);
+        results->max = GET_MAX(results->max, samples[i]);
+    }
+
+    results->mean /= (uint64_t)bh->runs;
+    results->stddev = prv_bench_compute_stddev(samples, bh->runs, results->mean);
+
+    /*! Before the reports, which may reuse the result vector for their own products */
+    if (bh->y_file) {
         uint64_t start = prv_bench_get_us();
+        res = vecio_save(&bh->result, bh->y_file, arena);
+        if (res != RC_OK)
+            return res;
+        results->y_save_ms = (double)(prv_bench_get_us() - start) / 1e3;
+        SLOG_INFO("Result written to '%s' in %.3f ms", bh->y_file, results->y_save_ms);
+    }
 
-        int res = csr_matrix_mul_vec(&g_bench_handler.mtx, &g_bench_handler.vec, &g_bench_handler.result);
+    if (bh->quant.bits != 0) {
+        res = bench_quant_report(bh, results, arena);
         if (res != RC_OK)
             return res;
+    }
 
-        uint64_t end = prv_bench_get_us();
+    if (bh->mode == BENCH_MODE_HELPER) {
+        res = bench_helper_report(bh, results);
+        if (res != RC_OK)
+            return res;
+    }
 
-        SLOG_DEBUG("Run %d completed in %lu us", i + 1, (end - start));
+    if (bh->mode == BENCH_MODE_ATA) {
+        res = bench_ata_report(bh, results, arena);
+        if (res != RC_OK)
+            return res;
+    }
 
-        /*! Update benchmark results. */
-        samples[i] = end - start;
-        results->mean += samples[i];
-        results->min = GET_MIN(results->min, samples[i]);
-        results->max = GET_MAX(results->max, samples[i]);
+    if (bh->mode == BENCH_MODE_MPK) {
+        res = bench_mpk_report(bh, results);
+        if (res != RC_OK)
+            return res;
+    }
+
+    if (bh->mode == BENCH_MODE_DIST) {
+        res = bench_dist_report(bh, results, arena);
+        if (res != RC_OK)
+            return res;
     }
 
-    results->mean /= (uint64_t)g_bench_handler.runs;
-    results->stddev = prv_bench_compute_stddev(samples, g_bench_handler.runs, results->mean);
+    if (bh->mode == BENCH_MODE_POLY) {
+        res = bench_poly_report(bh, results, arena);
+        if (res != RC_OK)
+            return res;
+    }
+
+    if (bh->mode == BENCH_MODE_GPART) {
+        res = bench_gpart_report(bh, results, arena);
+        if (res != RC_OK)
+            return res;
+    }
+
+    if (bh->mode == BENCH_MODE_THROUGHPUT) {
+        res = bench_throughput_report(bh, results);
+        if (res != RC_OK)
+            return res;
+    }
+
+    if (bh->mode == BENCH_MODE_BATCHED) {
+        res = bench_batch_report(bh, results);
+        if (res != RC_OK)
+            return res;
+    }
+
+    if (bh->mode == BENCH_MODE_CHUNKED) {
+        res = bench_chunk_report(bh, results);
+        if (res != RC_OK)
+            return res;
+    }
+
+    if (bh->mode == BENCH_MODE_SPGEMM) {
+        res = bench_spgemm_report(bh, results, arena);
+        if (res != RC_OK)
+            return res;
+    }
 
     SLOG_INFO("Benchmark completed: mean=%lu us, stddev=%lu us, min=%lu us, max=%lu us",
               results->mean,
@@ -199,15 +797,83 @@ int bench_save_result(const struct BenchResults *results, const char *filename)
     }
     SLOG_INFO("File opened correctly");
 
-    fprintf(fp, "{\n\t\"warmup-iters\": %d,\n\t\"runs\": %d,\n\t\"samples\": [", results->warmup_iters, results->runs);
+    fprintf(fp, "{\n\t\"mode\": \"%s\",\n", bench_mode_to_str(results->mode));
+    if (results->mode == BENCH_MODE_ADAPTIVE)
+        fprintf(fp, "\t\"rebalances\": %d,\n", results->rebalances);
+    if (results->mode == BENCH_MODE_WS)
+        fprintf(fp, "\t\"steals\": %ld,\n", results->steals);
+    if (results->mode == BENCH_MODE_HELPER)
+        bench_helper_write_json(fp, results);
+    if (results->mode == BENCH_MODE_SPGEMM)
+        bench_spgemm_write_json(fp, results);
+    if (results->mode == BENCH_MODE_ATA)
+        bench_ata_write_json(fp, results);
+    if (results->mode == BENCH_MODE_MPK)
+        bench_mpk_write_json(fp, results);
+    if (results->mode == BENCH_MODE_POLY)
+        bench_poly_write_json(fp, results);
+    if (results->mode == BENCH_MODE_DIST)
+        bench_dist_write_json(fp, results);
+    if (results->mode == BENCH_MODE_GPART)
+        bench_gpart_write_json(fp, results);
+    if (results->mode == BENCH_MODE_THROUGHPUT)
+        bench_throughput_write_json(fp, results);
+    if (results->mode == BENCH_MODE_BATCHED)
+        bench_batch_write_json(fp, results);
+    if (results->mode == BENCH_MODE_CHUNKED)
+        bench_chunk_write_json(fp, results);
+    if (results->x_file)
+        fprintf(fp, "\t\"x-file\": \"%s\",\n", results->x_file);
+    if (results->y_file)
+        fprintf(fp, "\t\"y-file\": \"%s\",\n\t\"y-save-ms\": %.3f,\n", results->y_file, results->y_save_ms);
+    if (results->load_ms >= 0.0)
+        fprintf(fp, "\t\"load-ms\": %.3f,\n\t\"load-wait-ms\": %.3f,\n", results->load_ms, results->load_wait_ms);
+    fprintf(fp, "\t\"shm\": \"%s\",\n", results->shm);
+    fprintf(fp, "\t\"threads\": %d,\n\t\"thread-policy\": \"%s\",\n", results->thread_count, results->thread_policy);
+    fprintf(fp, "\t\"isa\": \"%s\",\n\t\"kernel\": \"%s\",\n", results->isa, csr_kernel_to_str(results->kernel));
+    bench_quant_write_json(fp, results);
+    fprintf(fp, "\t\"warmup-iters\": %d,\n\t\"runs\": %d,\n\t\"samples\": [", results->warmup_iters, results->runs);
 
     int i = 0;
     uint64_t *samples = arena_get_ptr(&results->samples);
     for (; i < results->runs - 1; ++i)
         fprintf(fp, "%lu, ", samples[i]);
 
-    fprintf(fp, "%lu],\n\t\"mean\": %lu,\n\t\"stddev\": %lu,\n\t\"min\": %lu,\n\t\"max\": %lu,\n}", samples[i], results->mean, results->stddev, results->min, results->max);
+    fprintf(fp, "%lu],\n\t\"mean\": %lu,\n\t\"stddev\": %lu,\n\t\"min\": %lu,\n\t\"max\": %lu,\n", samples[i], results->mean, results->stddev, results->min, results->max);
+
+    fprintf(fp, "\t\"topology\": ");
+    topo_write_json(fp, "\t");
+    fprintf(fp, "\n}");
     fclose(fp);
 
     return RC_OK;
 }
+
+void bench_result_filename(const char *matrix, char *filename) {
+    /*! Get the filename only (removing path/to/file and extension) */
+    const char *last_slash = strrchr(matrix, '/');
+    filename[0] = '\0';
+    strncat(filename, last_slash ? last_slash + 1 : matrix, CONFIG_BENCH_FILENAME_MAX_LEN - 1);
+    char *dot = strrchr(filename, '.');
+    if (dot)
+        *dot = '\0';
+    strncat(filename, ".json", CONFIG_BENCH_FILENAME_MAX_LEN - strlen(filename) - 1);
+}
+
+int bench_fini(struct BenchHandler *bh) {
+    SLOG_DEBUG("Entering bench_fini");
+    int res = RC_OK;
+
+    struct BenchHandler *streams = bh->streams > 0 ? arena_get_ptr(&bh->stream_bh) : NULL;
+    for (int s = 1; s < bh->streams; ++s) {
+        int stream_res = shm_store_detach(&streams[s].shm);
+        if (res == RC_OK)
+            res = stream_res;
+    }
+
+    if (bh->mode == BENCH_MODE_CHUNKED)
+        bench_chunk_fini(bh);
+
+    int own_res = shm_store_detach(&bh->shm);
+    return res == RC_OK ? own_res : res;
+}
@@ -0,0 +1,73 @@
+/*!
+ * \file            bench_ata.c
+ * \date            2026-10-18
+ * \author          Mirko Lana [lana.mirko@icloud.com]
+ *
+ * \brief           Fused A^T * A mode of the benchmark (ata).
+ */
+
+#include "rc.h"
+#include "arena.h"
+#include "bench.h"
+#include "bench_ata.h"
+#include "csr.h"
+#include "vec.h"
+#include "ata.h"
+#include "quant.h"
+#include "slog.h"
+#include "utils.h"
+
+#include <stdint.h>
+#include <stdio.h>
+
+int bench_ata_init(struct BenchHandler *bh, struct ArenaHandler *arena) {
+    SLOG_DEBUG("Initializing the fused A^T * A product and its result vector of size: %d", bh->mtx.n);
+    int res = ata_init(&bh->ata.plan, &bh->mtx, arena);
+    if (res == RC_OK)
+        res = vec_init(&bh->ata.result, bh->mtx.n, true, arena);
+    return res;
+}
+
+int bench_ata_report(struct BenchHandler *bh, struct BenchResults *results, struct ArenaHandler *arena) {
+    const struct CsrMatrix *mtx = &bh->mtx;
+    struct BenchAtaResults *ata = &results->ata;
+    struct CsrMatrix transposed;
+    struct Vec unfused;
+    struct QuantError diff;
+
+    int res = csr_matrix_transpose(&transposed, mtx, arena);
+    if (res == RC_OK)
+        res = vec_init(&unfused, mtx->n, true, arena);
+    if (res != RC_OK)
+        return res;
+
+    uint64_t total = 0U;
+    for (int i = 0; i < bh->runs && res == RC_OK; ++i) {
+        uint64_t start = utils_get_ns();
+        res = csr_matrix_mul_vec(mtx, &bh->vec, &bh->result);
+        if (res == RC_OK)
+            res = csr_matrix_mul_vec(&transposed, &bh->result, &unfused);
+        total += utils_get_ns() - start;
+    }
+    if (res == RC_OK)
+        res = ata_mul_vec(&bh->ata.plan, &bh->vec, &bh->ata.result);
+    if (res == RC_OK)
+        res = quant_error(&unfused, &bh->ata.result, &diff);
+    if (res != RC_OK)
+        return res;
+
+    ata->unfused_mean = total / (uint64_t)bh->runs / 1000U;
+    ata->rel_l2 = diff.rel_l2;
+
+    SLOG_INFO("A^T * A * x: fused mean=%lu us, two SpMVs mean=%lu us (%.2fx), relative L2 difference=%g",
+              results->mean,
+              ata->unfused_mean,
+              (double)ata->unfused_mean / (double)GET_MAX(results->mean, 1U),
+              ata->rel_l2);
+
+    return RC_OK;
+}
+
+void bench_ata_write_json(FILE *fp, const struct BenchResults *results) {
+    fprintf(fp, "\t\"ata-unfused-mean\": %lu,\n\t\"ata-rel-l2-diff\": %g,\n", results->ata.unfused_mean, results->ata.rel_l2);
+}
@@ -0,0 +1,145 @@
+/*!
+ * \file            bench_batch.c
+ * \date            2026-10-18
+ * \author          Mirko Lana [lana.mirko@icloud.com]
+ *
+ * \brief           Batched mode of the benchmark (batched).
+ */
+
+#include "rc.h"
+#include "arena.h"
+#include "bench.h"
+#include "bench_batch.h"
+#include "bench_throughput.h"
+#include "csr.h"
+#include "vec.h"
+#include "batch.h"
+#include "slog.h"
+#include "utils.h"
+
+#include <math.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+
+int bench_batch_init(struct BenchHandler *bh, const struct BenchConfig *cfg) {
+    struct BenchBatch *batch = &bh->batch;
+    const int files = cfg->filenames && cfg->matrices > 0 ? cfg->matrices : 1;
+    const int count = cfg->batch_count;
+
+    int res = bench_throughput_streams_init(bh, cfg, files);
+    if (res != RC_OK)
+        return res;
+
+    const struct BenchHandler *streams = arena_get_ptr(&bh->stream_bh);
+    const bool is_real = streams[0].mtx.is_real;
+    long long m = 0;
+    long long n = 0;
+    long long nz = 0;
+    for (int b = 0; b < count; ++b) {
+        const struct CsrMatrix *mtx = &streams[b % files].mtx;
+        if (mtx->is_real != is_real) {
+            rc_set_err_msg("The matrices of a batch must all be real or all integer");
+            return RC_INVALID_ARG_ERR;
+        }
+        m += mtx->m;
+        n += mtx->n;
+        nz += mtx->nz;
+    }
+    if (m > INT32_MAX || n > INT32_MAX || nz > INT32_MAX) {
+        rc_set_err_msg("A batch of %d matrices exceeds %d rows, columns or non-zeros", count, INT32_MAX);
+        return RC_INVALID_ARG_ERR;
+    }
+
+    res = batch_init(&batch->csr, count, (int)m, (int)n, (int)nz, is_real, cfg->arena);
+    if (res == RC_OK)
+        res = vec_init(&batch->x, (int)n, is_real, cfg->arena);
+    if (res == RC_OK)
+        res = vec_init(&batch->y, (int)m, is_real, cfg->arena);
+    if (res != RC_OK)
+        return res;
+
+    const size_t item = is_real ? sizeof(double) : sizeof(int);
+    streams = arena_get_ptr(&bh->stream_bh); /*! The arena may have moved */
+    for (int b = 0; b < count && res == RC_OK; ++b) {
+        const struct BenchHandler *stream = &streams[b % files];
+        memcpy((char *)arena_get_ptr(&batch->x.val) + (size_t)batch->csr.n * item, arena_get_ptr(&stream->vec.val), (size_t)stream->mtx.n * item);
+        res = batch_add(&batch->csr, &stream->mtx);
+    }
+    if (res != RC_OK)
+        return res;
+
+    SLOG_INFO("Batch of %d matrices from %d files: %d rows, %d non-zeros (%.1f per matrix)",
+              batch->csr.count,
+              files,
+              batch->csr.m,
+              batch->csr.nz,
+              (double)batch->csr.nz / batch->csr.count);
+
+    return RC_OK;
+}
+
+int bench_batch_report(struct BenchHandler *bh, struct BenchResults *results) {
+    struct BenchHandler *streams = arena_get_ptr(&bh->stream_bh);
+    struct BenchBatchResults *batch = &results->batch;
+    const int count = bh->batch.csr.count;
+
+    batch->count = count;
+    batch->nnz = bh->batch.csr.nz;
+
+    int res = RC_OK;
+    uint64_t total = 0U;
+    for (int i = 0; i < bh->runs && res == RC_OK; ++i) {
+        uint64_t start = utils_get_ns();
+        for (int b = 0; b < count && res == RC_OK; ++b) {
+            struct BenchHandler *stream = &streams[b % bh->streams];
+            res = csr_matrix_mul_vec(&stream->mtx, &stream->vec, &stream->result);
+        }
+        total += utils_get_ns() - start;
+    }
+    if (res != RC_OK)
+        return res;
+
+    const int *row_off = arena_get_ptr(&bh->batch.csr.row_off);
+    double norm_e = 0.0;
+    double norm_y = 0.0;
+    for (int b = 0; b < count; ++b) {
+        const struct Vec *exact = &streams[b % bh->streams].result;
+        for (int i = 0; i < exact->n; ++i) {
+            double y, y_hat;
+            if (exact->is_real) {
+                y = ((const double *)arena_get_ptr(&exact->val))[i];
+                y_hat = ((const double *)arena_get_ptr(&bh->batch.y.val))[row_off[b] + i];
+            } else {
+                y = ((const int *)arena_get_ptr(&exact->val))[i];
+                y_hat = ((const int *)arena_get_ptr(&bh->batch.y.val))[row_off[b] + i];
+            }
+            norm_e += (y_hat - y) * (y_hat - y);
+            norm_y += y * y;
+        }
+    }
+
+    batch->calls_mean = total / (uint64_t)bh->runs / 1000U;
+    batch->rel_l2 = norm_y > 0.0 ? sqrt(norm_e / norm_y) : 0.0;
+
+    SLOG_INFO("Batched SpMV of %d matrices: mean=%lu us (%.1f ns per matrix), one call per matrix mean=%lu us (%.1f ns per matrix, %.2fx), relative L2 difference=%g",
+              count,
+              results->mean,
+              (double)results->mean * 1e3 / count,
+              batch->calls_mean,
+              (double)total / bh->runs / count,
+              (double)batch->calls_mean / (double)GET_MAX(results->mean, 1U),
+              batch->rel_l2);
+
+    return RC_OK;
+}
+
+void bench_batch_write_json(FILE *fp, const struct BenchResults *results) {
+    const struct BenchBatchResults *batch = &results->batch;
+
+    fprintf(fp, "\t\"batch-count\": %d,\n\t\"batch-nnz\": %d,\n", batch->count, batch->nnz);
+    fprintf(fp, "\t\"batch-ns-per-matrix\": %.1f,\n", (double)results->mean * 1e3 / GET_MAX(batch->count, 1));
+    fprintf(fp, "\t\"batch-calls-mean\": %lu,\n\t\"batch-calls-ns-per-matrix\": %.1f,\n", batch->calls_mean, (double)batch->calls_mean * 1e3 / GET_MAX(batch->count, 1));
+    fprintf(fp, "\t\"batch-rel-l2-diff\": %g,\n", batch->rel_l2);
+}
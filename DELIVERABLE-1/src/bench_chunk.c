@@ -0,0 +1,164 @@
+/*!
+ * \file            bench_chunk.c
+ * \date            2026-10-18
+ * \author          Mirko Lana [lana.mirko@icloud.com]
+ *
+ * \brief           Chunked mode of the benchmark (chunked).
+ */
+
+#include "rc.h"
+#include "arena.h"
+#include "bench.h"
+#include "bench_chunk.h"
+#include "csr.h"
+#include "vec.h"
+#include "chunk.h"
+#include "slog.h"
+#include "utils.h"
+
+#include <math.h>
+#include <pthread.h>
+#include <stdint.h>
+#include <stdio.h>
+
+/*!
+ * \brief           Consume a chunk of y: merge its largest and positive items (see struct BenchConsumer).
+ *
+ * \param[in,out]   arg: Pointer to the struct BenchConsumer.
+ * \param[in]       result: The result vector.
+ * \param[in]       chunk: Index of the chunk.
+ * \param[in]       row_begin: First row of the chunk.
+ * \param[in]       row_end: One past the last row of the chunk.
+ */
+static void prv_bench_consume(void *arg, const struct Vec *result, int chunk, int row_begin, int row_end) {
+    UNUSED(chunk);
+    struct BenchConsumer *consumer = arg;
+    double max = -INFINITY;
+    int max_row = -1;
+    long positive = 0;
+
+    if (result->is_real) {
+        const double *y = arena_get_ptr(&result->val);
+        for (int i = row_begin; i < row_end; ++i) {
+            if (y[i] > max) {
+                max = y[i];
+                max_row = i;
+            }
+            positive += y[i] > 0.0;
+        }
+    } else {
+        const int *y = arena_get_ptr(&result->val);
+        for (int i = row_begin; i < row_end; ++i) {
+            if (y[i] > max) {
+                max = y[i];
+                max_row = i;
+            }
+            positive += y[i] > 0;
+        }
+    }
+
+    pthread_mutex_lock(&consumer->lock);
+    if (consumer->first_ns == 0U)
+        consumer->first_ns = GET_MAX(utils_get_ns() - consumer->start_ns, 1U);
+    if (max > consumer->max || (max == consumer->max && max_row < consumer->max_row)) {
+        consumer->max = max;
+        consumer->max_row = max_row;
+    }
+    consumer->positive += positive;
+    pthread_mutex_unlock(&consumer->lock);
+}
+
+/*!
+ * \brief           Clear the consumer before a SpMV.
+ *
+ * \param[in,out]   consumer: Pointer to the consumer.
+ */
+static void prv_bench_consumer_reset(struct BenchConsumer *consumer) {
+    consumer->max = -INFINITY;
+    consumer->max_row = -1;
+    consumer->positive = 0;
+    consumer->first_ns = 0U;
+    consumer->start_ns = utils_get_ns();
+}
+
+int bench_chunk_init(struct BenchHandler *bh, const struct BenchConfig *cfg) {
+    struct BenchChunk *chunk = &bh->chunk;
+    const struct ChunkConfig chunk_cfg = {
+        .rows = cfg->chunk_rows,
+        .order = cfg->chunk_order,
+        .fn = prv_bench_consume,
+        .arg = &chunk->consumer,
+    };
+
+    int res = chunk_init(&chunk->plan, &bh->mtx, &chunk_cfg, cfg->arena);
+    if (res != RC_OK)
+        return res;
+    chunk->consumer = (struct BenchConsumer){ 0 };
+    pthread_mutex_init(&chunk->consumer.lock, NULL);
+
+    SLOG_INFO("Chunked SpMV: %d chunks of %s, delivered in %s order",
+              chunk->plan.chunks,
+              cfg->chunk_rows > 0 ? "fixed rows" : "balanced non-zeros",
+              chunk_order_to_str(cfg->chunk_order));
+    return RC_OK;
+}
+
+int bench_chunk_spmv(struct BenchHandler *bh) {
+    struct BenchConsumer *consumer = &bh->chunk.consumer;
+
+    prv_bench_consumer_reset(consumer);
+    int res = chunk_mul_vec(&bh->chunk.plan, &bh->vec, &bh->result);
+    consumer->first_total_ns += consumer->first_ns;
+    consumer->spmvs++;
+    return res;
+}
+
+int bench_chunk_report(struct BenchHandler *bh, struct BenchResults *results) {
+    struct BenchConsumer *consumer = &bh->chunk.consumer;
+    const struct BenchConsumer chunked = *consumer;
+    struct BenchChunkResults *chunk = &results->chunk;
+
+    chunk->rows = bh->chunk.plan.cfg.rows;
+    chunk->order = chunk_order_to_str(bh->chunk.plan.cfg.order);
+    chunk->count = bh->chunk.plan.chunks;
+    chunk->first_mean = consumer->first_total_ns / (uint64_t)GET_MAX(consumer->spmvs, 1L) / 1000U;
+
+    uint64_t total = 0U;
+    for (int i = 0; i < bh->runs; ++i) {
+        uint64_t start = utils_get_ns();
+        int res = csr_matrix_mul_vec(&bh->mtx, &bh->vec, &bh->result);
+        if (res != RC_OK)
+            return res;
+        prv_bench_consumer_reset(consumer);
+        prv_bench_consume(consumer, &bh->result, 0, 0, bh->mtx.m);
+        total += utils_get_ns() - start;
+    }
+    chunk->unpipelined_mean = total / (uint64_t)GET_MAX(bh->runs, 1) / 1000U;
+    chunk->match = bh->runs == 0 || (chunked.max_row == consumer->max_row && chunked.positive == consumer->positive);
+
+    SLOG_INFO("Chunked SpMV: %d chunks (%s order), first one consumed after %lu us, mean=%lu us; SpMV then consumer mean=%lu us; consumers %s",
+              chunk->count,
+              chunk->order,
+              chunk->first_mean,
+              results->mean,
+              chunk->unpipelined_mean,
+              chunk->match ? "match" : "DIFFER");
+
+    return RC_OK;
+}
+
+void bench_chunk_write_json(FILE *fp, const struct BenchResults *results) {
+    const struct BenchChunkResults *chunk = &results->chunk;
+
+    fprintf(fp, "\t\"chunk-rows\": %d,\n\t\"chunk-order\": \"%s\",\n\t\"chunk-count\": %d,\n", chunk->rows, chunk->order, chunk->count);
+    fprintf(fp, "\t\"chunk-first-mean\": %lu,\n\t\"chunk-unpipelined-mean\": %lu,\n", chunk->first_mean, chunk->unpipelined_mean);
+    fprintf(fp, "\t\"chunk-consumers-match\": %s,\n", chunk->match ? "true" : "false");
+}
+
+void bench_chunk_fini(struct BenchHandler *bh) {
+    if (!bh->chunk.plan.cfg.fn)
+        return;
+
+    pthread_mutex_destroy(&bh->chunk.consumer.lock);
+    bh->chunk.plan.cfg.fn = NULL;
+}
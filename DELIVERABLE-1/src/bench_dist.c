@@ -0,0 +1,76 @@
+/*!
+ * \file            bench_dist.c
+ * \date            2026-10-18
+ * \author          Mirko Lana [lana.mirko@icloud.com]
+ *
+ * \brief           Distributed mode of the benchmark (dist).
+ */
+
+#include "rc.h"
+#include "arena.h"
+#include "bench.h"
+#include "bench_dist.h"
+#include "config.h"
+#include "csr.h"
+#include "vec.h"
+#include "dist.h"
+#include "slog.h"
+#include "utils.h"
+
+#include <stdint.h>
+#include <stdio.h>
+
+int bench_dist_report(struct BenchHandler *bh, struct BenchResults *results, struct ArenaHandler *arena) {
+    struct DistMatrix *dm = &bh->dist;
+    struct BenchDistResults *dist = &results->dist;
+    dist->ranks = dm->ranks;
+    dist->max_halo = (int)dist_max((double)dm->halo);
+    dist->max_mean = (uint64_t)dist_max((double)results->mean);
+    dist->wait_mean = (uint64_t)dist_max(dm->wait_us / GET_MAX(bh->runs, 1));
+    dist->rel_l2 = -1.0;
+
+    if (dm->nz <= CONFIG_DIST_CHECK_MAX_NNZ) {
+        struct Vec x, y, exact;
+        struct CsrMatrix whole;
+        int res = RC_OK;
+        if (dm->rank == 0) {
+            res = vec_init(&x, dm->n, dm->is_real, arena);
+            if (res == RC_OK)
+                res = vec_init(&y, dm->m, dm->is_real, arena);
+            if (res == RC_OK)
+                res = vec_init(&exact, dm->m, dm->is_real, arena);
+            if (res != RC_OK)
+                return res;
+        }
+
+        res = dist_vec_gather(dm, &bh->vec, false, &x);
+        if (res == RC_OK)
+            res = dist_vec_gather(dm, &bh->result, true, &y);
+        if (res == RC_OK && dm->rank == 0)
+            res = csr_matrix_load_from_file(&whole, bh->filename, arena);
+        if (res == RC_OK && dm->rank == 0)
+            res = csr_matrix_mul_vec(&whole, &x, &exact);
+        if (res != RC_OK)
+            return res;
+
+        if (dm->rank == 0)
+            dist->rel_l2 = bench_rel_l2(&exact, &y);
+    }
+
+    SLOG_INFO("Distributed SpMV on %d ranks: slowest rank mean=%lu us, halo wait mean=%lu us, largest halo of %d items, relative L2 difference=%g",
+              dist->ranks,
+              dist->max_mean,
+              dist->wait_mean,
+              dist->max_halo,
+              dist->rel_l2);
+
+    return RC_OK;
+}
+
+void bench_dist_write_json(FILE *fp, const struct BenchResults *results) {
+    const struct BenchDistResults *dist = &results->dist;
+
+    fprintf(fp, "\t\"dist-ranks\": %d,\n\t\"dist-max-halo\": %d,\n", dist->ranks, dist->max_halo);
+    fprintf(fp, "\t\"dist-max-mean\": %lu,\n\t\"dist-wait-mean\": %lu,\n", dist->max_mean, dist->wait_mean);
+    fprintf(fp, "\t\"dist-rel-l2-diff\": %g,\n", dist->rel_l2);
+}
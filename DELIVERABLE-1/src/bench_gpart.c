@@ -0,0 +1,130 @@
+/*!
+ * \file            bench_gpart.c
+ * \date            2026-10-18
+ * \author          Mirko Lana [lana.mirko@icloud.com]
+ *
+ * \brief           Graph partition mode of the benchmark (gpart).
+ */
+
+#include "rc.h"
+#include "arena.h"
+#include "bench.h"
+#include "bench_gpart.h"
+#include "csr.h"
+#include "vec.h"
+#include "gpart.h"
+#include "slog.h"
+#include "utils.h"
+
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+
+int bench_gpart_init(struct BenchHandler *bh, int parts, struct ArenaHandler *arena) {
+    struct BenchGpart *gp = &bh->gpart;
+    gp->src = bh->mtx;
+
+    uint64_t start = utils_get_ns();
+    int res = gpart_init(&gp->gpart, &gp->src, parts, arena);
+    gp->us = (utils_get_ns() - start) / 1000U;
+    if (res == RC_OK)
+        res = gpart_init_contiguous(&gp->contig, &gp->src, parts, arena);
+    if (res == RC_OK)
+        res = gpart_permute(&bh->mtx, &gp->src, &gp->gpart, arena);
+    if (res != RC_OK)
+        return res;
+
+    SLOG_INFO("Graph partition in %d parts done in %lu us: edge cut %lld, volume %lld, largest halo %d, imbalance %.3f (contiguous split: edge cut %lld, volume %lld, largest halo %d)",
+              parts,
+              gp->us,
+              gp->gpart.edge_cut,
+              gp->gpart.volume,
+              gp->gpart.max_halo,
+              gp->gpart.imbalance,
+              gp->contig.edge_cut,
+              gp->contig.volume,
+              gp->contig.max_halo);
+
+    return RC_OK;
+}
+
+int bench_gpart_report(struct BenchHandler *bh, struct BenchResults *results, struct ArenaHandler *arena) {
+    const struct CsrMatrix *mtx = &bh->gpart.src;
+    const struct Gpart *gp = &bh->gpart.gpart;
+    struct BenchGpartResults *gpart = &results->gpart;
+    struct Vec x, y, y_perm;
+
+    gpart->parts = gp->parts;
+    gpart->us = bh->gpart.us;
+    gpart->cut = gp->edge_cut;
+    gpart->volume = gp->volume;
+    gpart->max_halo = gp->max_halo;
+    gpart->imbalance = gp->imbalance;
+    gpart->contig_cut = bh->gpart.contig.edge_cut;
+    gpart->contig_vol = bh->gpart.contig.volume;
+    gpart->contig_halo = bh->gpart.contig.max_halo;
+    gpart->halo = gp->part_halo;
+    gpart->pcut = gp->part_cut;
+
+    int res = vec_init(&x, mtx->n, mtx->is_real, arena);
+    if (res == RC_OK)
+        res = vec_init(&y, mtx->m, mtx->is_real, arena);
+    if (res == RC_OK)
+        res = vec_init(&y_perm, mtx->m, mtx->is_real, arena);
+    if (res != RC_OK)
+        return res;
+
+    /*! Item i of the original order is item perm[i] of the renumbered one */
+    const int *perm = arena_get_ptr(&gp->perm);
+    const size_t size = mtx->is_real ? sizeof(double) : sizeof(int);
+    const char *vec = arena_get_ptr(&bh->vec.val);
+    const char *result = arena_get_ptr(&bh->result.val);
+    char *x_val = arena_get_ptr(&x.val);
+    char *y_perm_val = arena_get_ptr(&y_perm.val);
+    for (int i = 0; i < mtx->n; ++i) {
+        memcpy(x_val + (size_t)i * size, vec + (size_t)perm[i] * size, size);
+        memcpy(y_perm_val + (size_t)i * size, result + (size_t)perm[i] * size, size);
+    }
+
+    uint64_t total = 0U;
+    for (int i = 0; i < bh->runs && res == RC_OK; ++i) {
+        uint64_t start = utils_get_ns();
+        res = csr_matrix_mul_vec(mtx, &x, &y);
+        total += utils_get_ns() - start;
+    }
+    if (res != RC_OK)
+        return res;
+
+    gpart->orig_mean = total / (uint64_t)bh->runs / 1000U;
+    gpart->rel_l2 = bench_rel_l2(&y, &y_perm);
+
+    SLOG_INFO("Graph partition (%d parts): renumbered mean=%lu us, original mean=%lu us (%.2fx), relative L2 difference=%g",
+              gpart->parts,
+              results->mean,
+              gpart->orig_mean,
+              (double)gpart->orig_mean / (double)GET_MAX(results->mean, 1U),
+              gpart->rel_l2);
+
+    return RC_OK;
+}
+
+void bench_gpart_write_json(FILE *fp, const struct BenchResults *results) {
+    const struct BenchGpartResults *gpart = &results->gpart;
+
+    fprintf(fp, "\t\"gpart-parts\": %d,\n\t\"gpart-time\": %lu,\n", gpart->parts, gpart->us);
+    fprintf(fp, "\t\"gpart-edge-cut\": %lld,\n\t\"gpart-volume\": %lld,\n", gpart->cut, gpart->volume);
+    fprintf(fp, "\t\"gpart-max-halo\": %d,\n\t\"gpart-imbalance\": %.4f,\n", gpart->max_halo, gpart->imbalance);
+    fprintf(fp, "\t\"gpart-contiguous-edge-cut\": %lld,\n\t\"gpart-contiguous-volume\": %lld,\n", gpart->contig_cut, gpart->contig_vol);
+    fprintf(fp, "\t\"gpart-contiguous-max-halo\": %d,\n", gpart->contig_halo);
+
+    const int *halo = arena_get_ptr(&gpart->halo);
+    const int *cut = arena_get_ptr(&gpart->pcut);
+    fprintf(fp, "\t\"gpart-part-halo\": [");
+    for (int p = 0; p < gpart->parts; ++p)
+        fprintf(fp, "%s%d", p > 0 ? ", " : "", halo[p]);
+    fprintf(fp, "],\n\t\"gpart-part-edge-cut\": [");
+    for (int p = 0; p < gpart->parts; ++p)
+        fprintf(fp, "%s%d", p > 0 ? ", " : "", cut[p]);
+    fprintf(fp, "],\n");
+    fprintf(fp, "\t\"gpart-original-mean\": %lu,\n\t\"gpart-rel-l2-diff\": %g,\n", gpart->orig_mean, gpart->rel_l2);
+}
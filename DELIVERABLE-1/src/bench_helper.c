@@ -0,0 +1,77 @@
+/*!
+ * \file            bench_helper.c
+ * \date            2026-10-18
+ * \author          Mirko Lana [lana.mirko@icloud.com]
+ *
+ * \brief           Helper-thread prefetching mode of the benchmark (helper).
+ */
+
+#include "rc.h"
+#include "bench.h"
+#include "bench_helper.h"
+#include "csr.h"
+#include "helper.h"
+#include "slog.h"
+#include "utils.h"
+
+#include <stdatomic.h>
+#include <stdint.h>
+#include <stdio.h>
+
+/*!
+ * \brief           Time runs of the SpMV of the benchmark with one kernel.
+ *
+ * \param[in,out]   bh: Pointer to the benchmark handler.
+ * \param[in]       kernel: The kernel to run.
+ * \param[out]      mean: Pointer to store the mean time of the runs, in microseconds.
+ * \return          RC_OK on success, an error code otherwise.
+ */
+static int prv_bench_helper_time(struct BenchHandler *bh, enum CsrKernel kernel, uint64_t *mean) {
+    csr_set_kernel(kernel);
+    if (csr_matrix_get_kernel(&bh->mtx) != kernel)
+        SLOG_WARN("The %s kernel is not available for this matrix, timing the %s one", csr_kernel_to_str(kernel), csr_kernel_to_str(csr_matrix_get_kernel(&bh->mtx)));
+
+    int res = RC_OK;
+    uint64_t total = 0U;
+    for (int i = 0; i < bh->runs && res == RC_OK; ++i) {
+        uint64_t start = utils_get_ns();
+        res = csr_matrix_mul_vec(&bh->mtx, &bh->vec, &bh->result);
+        total += utils_get_ns() - start;
+    }
+
+    *mean = total / (uint64_t)bh->runs / 1000U;
+    return res;
+}
+
+int bench_helper_report(struct BenchHandler *bh, struct BenchResults *results) {
+    struct BenchHelperResults *helper = &results->helper;
+    const enum CsrKernel selected = csr_get_kernel();
+
+    helper->pinned = bh->helper.pinned;
+    helper->throttles = atomic_load(&bh->helper.throttles);
+
+    int res = prv_bench_helper_time(bh, CSR_KERNEL_PREFETCH, &helper->prefetch_mean);
+    if (res == RC_OK)
+        res = prv_bench_helper_time(bh, CSR_KERNEL_AUTO, &helper->plain_mean);
+    csr_set_kernel(selected);
+    if (res != RC_OK)
+        return res;
+
+    SLOG_INFO("Helper threads: mean=%lu us, software prefetching mean=%lu us (%.2fx), plain mean=%lu us (%.2fx)",
+              results->mean,
+              helper->prefetch_mean,
+              (double)helper->prefetch_mean / (double)GET_MAX(results->mean, 1U),
+              helper->plain_mean,
+              (double)helper->plain_mean / (double)GET_MAX(results->mean, 1U));
+
+    return RC_OK;
+}
+
+void bench_helper_write_json(FILE *fp, const struct BenchResults *results) {
+    const struct BenchHelperResults *helper = &results->helper;
+    const double mean = (double)GET_MAX(results->mean, 1U);
+
+    fprintf(fp, "\t\"helper-pinned\": %d,\n\t\"helper-throttles\": %ld,\n", helper->pinned, helper->throttles);
+    fprintf(fp, "\t\"helper-prefetch-mean\": %lu,\n\t\"helper-plain-mean\": %lu,\n", helper->prefetch_mean, helper->plain_mean);
+    fprintf(fp, "\t\"helper-prefetch-speedup\": %.3f,\n\t\"helper-plain-speedup\": %.3f,\n", (double)helper->prefetch_mean / mean, (double)helper->plain_mean / mean);
+}
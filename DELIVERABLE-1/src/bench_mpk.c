@@ -0,0 +1,107 @@
+/*!
+ * \file            bench_mpk.c
+ * \date            2026-10-18
+ * \author          Mirko Lana [lana.mirko@icloud.com]
+ *
+ * \brief           Matrix-powers mode of the benchmark (mpk).
+ */
+
+#include "rc.h"
+#include "arena.h"
+#include "bench.h"
+#include "bench_mpk.h"
+#include "csr.h"
+#include "vec.h"
+#include "mpk.h"
+#include "slog.h"
+#include "utils.h"
+
+#include <stdatomic.h>
+#include <stdint.h>
+#include <stdio.h>
+
+int bench_mpk_init(struct BenchHandler *bh, int steps, struct ArenaHandler *arena) {
+    SLOG_DEBUG("Splitting rows in blocks for %d powers", steps);
+    int res = mpk_init(&bh->mpk.plan, &bh->mtx, steps, arena);
+    if (res != RC_OK)
+        return res;
+
+    enum ArenaReturnCode arena_res = arena_calloc(arena, sizeof(struct Vec), steps, &bh->mpk.powers);
+    if (arena_res != ARENA_RC_OK) {
+        rc_set_err_msg("Memory array allocation failed in bench_init");
+        return RC_MEM_ALLOC_ERR;
+    }
+
+    /*! Built aside: vec_init allocates from the arena, which may move the array */
+    for (int l = 0; l < steps; ++l) {
+        struct Vec power;
+        res = vec_init(&power, bh->mtx.m, bh->mtx.is_real, arena);
+        if (res != RC_OK)
+            return res;
+        ((struct Vec *)arena_get_ptr(&bh->mpk.powers))[l] = power;
+    }
+    SLOG_INFO("Matrix powers: %d steps over %d row blocks of up to %d non-zeros, reach of %d blocks (%s)",
+              steps,
+              bh->mpk.plan.blocks,
+              bh->mpk.plan.block_nnz,
+              bh->mpk.plan.reach,
+              bh->mpk.plan.wavefront ? "wavefront" : "separate SpMVs");
+
+    return RC_OK;
+}
+
+int bench_mpk_report(struct BenchHandler *bh, struct BenchResults *results) {
+    const struct CsrMatrix *mtx = &bh->mtx;
+    struct BenchMpkResults *mpk = &results->mpk;
+    struct Vec *powers = arena_get_ptr(&bh->mpk.powers);
+    const int steps = bh->mpk.plan.steps;
+
+    mpk->steps = steps;
+    mpk->blocks = bh->mpk.plan.blocks;
+    mpk->block_nnz = bh->mpk.plan.block_nnz;
+    mpk->reach = bh->mpk.plan.reach;
+    mpk->wavefront = bh->mpk.plan.wavefront;
+    mpk->stalls = atomic_load(&bh->mpk.plan.stalls);
+
+    int res = mpk_powers(&bh->mpk.plan, &bh->vec, powers);
+    if (res != RC_OK)
+        return res;
+
+    /*! Only the last power of the kernel is kept: the SpMVs alternate between the result vector and the one before it */
+    struct Vec *last = &bh->result;
+    struct Vec *ping = steps > 1 ? &powers[steps - 2] : last;
+    uint64_t total = 0U;
+    for (int i = 0; i < bh->runs && res == RC_OK; ++i) {
+        uint64_t start = utils_get_ns();
+        const struct Vec *in = &bh->vec;
+        for (int l = 0; l < steps && res == RC_OK; ++l) {
+            struct Vec *out = (steps - 1 - l) % 2 == 0 ? last : ping;
+            res = csr_matrix_mul_vec(mtx, in, out);
+            in = out;
+        }
+        total += utils_get_ns() - start;
+    }
+    if (res != RC_OK)
+        return res;
+
+    mpk->separate_mean = total / (uint64_t)bh->runs / 1000U;
+    mpk->rel_l2 = bench_rel_l2(last, &powers[steps - 1]);
+
+    SLOG_INFO("Matrix powers (%d steps): kernel mean=%lu us, separate SpMVs mean=%lu us (%.2fx), %ld stalls, relative L2 difference=%g",
+              steps,
+              results->mean,
+              mpk->separate_mean,
+              (double)mpk->separate_mean / (double)GET_MAX(results->mean, 1U),
+              mpk->stalls,
+              mpk->rel_l2);
+
+    return RC_OK;
+}
+
+void bench_mpk_write_json(FILE *fp, const struct BenchResults *results) {
+    const struct BenchMpkResults *mpk = &results->mpk;
+
+    fprintf(fp, "\t\"mpk-steps\": %d,\n\t\"mpk-blocks\": %d,\n\t\"mpk-block-nnz\": %d,\n\t\"mpk-reach\": %d,\n", mpk->steps, mpk->blocks, mpk->block_nnz, mpk->reach);
+    fprintf(fp, "\t\"mpk-wavefront\": %s,\n\t\"mpk-stalls\": %ld,\n", mpk->wavefront ? "true" : "false", mpk->stalls);
+    fprintf(fp, "\t\"mpk-separate-mean\": %lu,\n\t\"mpk-rel-l2-diff\": %g,\n", mpk->separate_mean, mpk->rel_l2);
+}
@@ -0,0 +1,171 @@
+/*!
+ * \file            bench_poly.c
+ * \date            2026-10-18
+ * \author          Mirko Lana [lana.mirko@icloud.com]
+ *
+ * \brief           Chebyshev polynomial mode of the benchmark (poly).
+ */
+
+#include "rc.h"
+#include "arena.h"
+#include "bench.h"
+#include "bench_poly.h"
+#include "csr.h"
+#include "vec.h"
+#include "quant.h"
+#include "slog.h"
+#include "utils.h"
+
+#include <math.h>
+#include <stdint.h>
+#include <stdio.h>
+
+/*!
+ * \brief           Apply the polynomial of the benchmark as SpMVs and separate vector passes.
+ *
+ * \details         Per degree, one csr_matrix_mul_vec, one pass computing the
+ *                  next term from its result and one adding it to the result.
+ *
+ * \param[in,out]   bh: Pointer to the benchmark handler.
+ * \param[in,out]   terms: Array of 3 vectors of m items receiving the terms.
+ * \param[out]      spmv: Pointer to the vector receiving the SpMVs (m items).
+ * \param[out]      result: Pointer to the result vector (m items).
+ * \return          RC_OK on success, an error code otherwise.
+ */
+static int prv_bench_poly_unfused(struct BenchHandler *bh, struct Vec *terms, struct Vec *spmv, struct Vec *result) {
+    const struct CsrPoly *poly = &bh->poly.poly;
+    const int m = bh->mtx.m;
+    const double *x = arena_get_ptr(&bh->vec.val);
+    const double *t = arena_get_ptr(&spmv->val);
+    double *y = arena_get_ptr(&result->val);
+
+    for (int i = 0; i < m; ++i)
+        y[i] = poly->coeffs[0] * x[i];
+
+    /*! T_j is stored in terms[(j - 1) % 3], T_0 is the input vector */
+    const struct Vec *prev = &bh->vec;
+    const struct Vec *cur = &bh->vec;
+    for (int k = 0; k < poly->degree; ++k) {
+        int res = csr_matrix_mul_vec(&bh->mtx, cur, spmv);
+        if (res != RC_OK)
+            return res;
+
+        const double *p = arena_get_ptr(&prev->val);
+        const double *c = arena_get_ptr(&cur->val);
+        double *next = arena_get_ptr(&terms[k % 3].val);
+        const double alpha = k == 0 ? 1.0 : 2.0;
+        const double beta = k == 0 ? 0.0 : 1.0;
+        for (int i = 0; i < m; ++i)
+            next[i] = alpha * (poly->scale * t[i] + poly->shift * c[i]) - beta * p[i];
+        for (int i = 0; i < m; ++i)
+            y[i] += poly->coeffs[k + 1] * next[i];
+
+        prev = cur;
+        cur = &terms[k % 3];
+    }
+
+    return RC_OK;
+}
+
+int bench_poly_init(struct BenchHandler *bh, int degree, struct ArenaHandler *arena) {
+    const struct CsrMatrix *mtx = &bh->mtx;
+    if (!mtx->is_real || mtx->m != mtx->n) {
+        rc_set_err_msg("Only real square matrices support the polynomial mode");
+        return RC_INVALID_ARG_ERR;
+    }
+
+    enum ArenaReturnCode arena_res = arena_calloc(arena, sizeof(double), (size_t)degree + 1, &bh->poly.coeffs);
+    if (arena_res != ARENA_RC_OK) {
+        rc_set_err_msg("Memory array allocation failed in bench_init");
+        return RC_MEM_ALLOC_ERR;
+    }
+
+    double *coeffs = arena_get_ptr(&bh->poly.coeffs);
+    for (int k = 0; k <= degree; ++k)
+        coeffs[k] = 1.0 / (k + 1);
+
+    const int *row = csr_matrix_row_ptr(mtx);
+    const double *val = csr_matrix_values(mtx);
+    double bound = 0.0;
+    for (int i = 0; i < mtx->m; ++i) {
+        double sum = 0.0;
+        for (int k = row[i]; k < row[i + 1]; ++k)
+            sum += fabs(val[k]);
+        bound = GET_MAX(bound, sum);
+    }
+
+    bh->poly.poly = (struct CsrPoly){
+        .degree = degree,
+        .coeffs = coeffs,
+        .scale = bound > 0.0 ? 1.0 / bound : 1.0,
+        .shift = 0.0,
+    };
+
+    int res = RC_OK;
+    for (int j = 0; j < 2 && res == RC_OK; ++j)
+        res = vec_init(&bh->poly.work[j], mtx->m, true, arena);
+    if (res != RC_OK)
+        return res;
+
+    SLOG_INFO("Chebyshev polynomial of degree %d, matrix scaled by 1/%g", degree, bound);
+    return RC_OK;
+}
+
+int bench_poly_spmv(struct BenchHandler *bh) {
+    bh->poly.poly.coeffs = arena_get_ptr(&bh->poly.coeffs); /*! The arena may have moved since bench_init */
+    return csr_matrix_poly_apply(&bh->mtx, &bh->poly.poly, &bh->vec, &bh->result, bh->poly.work);
+}
+
+int bench_poly_report(struct BenchHandler *bh, struct BenchResults *results, struct ArenaHandler *arena) {
+    struct BenchPolyResults *poly = &results->poly;
+    const int m = bh->mtx.m;
+    struct Vec terms[3];
+    struct Vec spmv;
+    struct Vec unfused;
+    struct QuantError diff;
+
+    poly->degree = bh->poly.poly.degree;
+
+    int res = RC_OK;
+    for (int j = 0; j < 3 && res == RC_OK; ++j)
+        res = vec_init(&terms[j], m, true, arena);
+    if (res == RC_OK)
+        res = vec_init(&spmv, m, true, arena);
+    if (res == RC_OK)
+        res = vec_init(&unfused, m, true, arena);
+    if (res != RC_OK)
+        return res;
+
+    bh->poly.poly.coeffs = arena_get_ptr(&bh->poly.coeffs);
+    uint64_t total = 0U;
+    for (int i = 0; i < bh->runs && res == RC_OK; ++i) {
+        uint64_t start = utils_get_ns();
+        res = prv_bench_poly_unfused(bh, terms, &spmv, &unfused);
+        total += utils_get_ns() - start;
+    }
+    if (res == RC_OK)
+        res = bench_poly_spmv(bh);
+    if (res == RC_OK)
+        res = quant_error(&unfused, &bh->result, &diff);
+    if (res != RC_OK)
+        return res;
+
+    poly->unfused_mean = total / (uint64_t)bh->runs / 1000U;
+    poly->rel_l2 = diff.rel_l2;
+
+    SLOG_INFO("Chebyshev polynomial (degree %d): fused mean=%lu us, unfused mean=%lu us (%.2fx), relative L2 difference=%g",
+              poly->degree,
+              results->mean,
+              poly->unfused_mean,
+              (double)poly->unfused_mean / (double)GET_MAX(results->mean, 1U),
+              poly->rel_l2);
+
+    return RC_OK;
+}
+
+void bench_poly_write_json(FILE *fp, const struct BenchResults *results) {
+    const struct BenchPolyResults *poly = &results->poly;
+
+    fprintf(fp, "\t\"poly-degree\": %d,\n", poly->degree);
+    fprintf(fp, "\t\"poly-unfused-mean\": %lu,\n\t\"poly-rel-l2-diff\": %g,\n", poly->unfused_mean, poly->rel_l2);
+}
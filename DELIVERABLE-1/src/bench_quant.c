@@ -0,0 +1,87 @@
+/*!
+ * \file            bench_quant.c
+ * \date            2026-10-18
+ * \author          Mirko Lana [lana.mirko@icloud.com]
+ *
+ * \brief           Quantized and compressed values of the benchmark (call mode).
+ */
+
+#include "rc.h"
+#include "arena.h"
+#include "bench.h"
+#include "bench_quant.h"
+#include "config.h"
+#include "csr.h"
+#include "vec.h"
+#include "quant.h"
+#include "fpc.h"
+#include "slog.h"
+#include "utils.h"
+
+#include <stdio.h>
+
+int bench_quant_init(struct BenchHandler *bh, const struct BenchConfig *cfg) {
+    bh->quant = (struct BenchQuant){ .bits = cfg->quant_bits };
+
+    if (bh->quant.bits != 0) {
+        SLOG_DEBUG("Quantizing matrix values to %d bits", bh->quant.bits);
+        int res = quant_matrix_init(&bh->quant.matrix, &bh->mtx, bh->quant.bits, cfg->arena);
+        if (res != RC_OK)
+            return res;
+    }
+
+    if (cfg->compress) {
+        SLOG_DEBUG("Compressing matrix values");
+        int res = fpc_matrix_init(&bh->quant.fpc, &bh->mtx, cfg->arena);
+        if (res != RC_OK)
+            return res;
+
+        /*! Decoding costs ALU cycles: only worth it when enough bytes are saved */
+        bh->quant.fpc_ratio = fpc_matrix_ratio(&bh->quant.fpc);
+        bh->quant.compressed = bh->quant.fpc_ratio >= CONFIG_FPC_MIN_RATIO;
+        SLOG_INFO("Values compression ratio: %.2f (%s)", bh->quant.fpc_ratio, bh->quant.compressed ? "compressed" : "left uncompressed");
+    }
+
+    return RC_OK;
+}
+
+int bench_quant_report(struct BenchHandler *bh, struct BenchResults *results, struct ArenaHandler *arena) {
+    const struct CsrMatrix *mtx = &bh->mtx;
+    struct BenchQuantResults *quant = &results->quant;
+    struct Vec exact;
+
+    int res = vec_init(&exact, mtx->m, mtx->is_real, arena);
+    if (res == RC_OK)
+        res = quant_matrix_mul_vec(&bh->quant.matrix, &bh->vec, &bh->result);
+    if (res == RC_OK)
+        res = csr_matrix_mul_vec(mtx, &bh->vec, &exact);
+    if (res == RC_OK)
+        res = quant_error(&exact, &bh->result, &quant->error);
+    if (res != RC_OK)
+        return res;
+
+    size_t csr_bytes = (size_t)mtx->nz * (sizeof(double) + sizeof(int)) + ((size_t)mtx->m + 1) * sizeof(int);
+    quant->bytes_per_nnz = (double)quant_matrix_bytes(&bh->quant.matrix) / GET_MAX(mtx->nz, 1);
+    quant->csr_bytes_per_nnz = (double)csr_bytes / GET_MAX(mtx->nz, 1);
+
+    SLOG_INFO("Quantized SpMV (%d bits): relative L2 error=%g, max error=%g, %.2f bytes/nnz (exact: %.2f)",
+              quant->bits,
+              quant->error.rel_l2,
+              quant->error.max_abs,
+              quant->bytes_per_nnz,
+              quant->csr_bytes_per_nnz);
+
+    return RC_OK;
+}
+
+void bench_quant_write_json(FILE *fp, const struct BenchResults *results) {
+    const struct BenchQuantResults *quant = &results->quant;
+
+    if (quant->fpc_ratio > 0.0)
+        fprintf(fp, "\t\"compressed\": %s,\n\t\"fpc-ratio\": %.3f,\n", quant->compressed ? "true" : "false", quant->fpc_ratio);
+    if (quant->bits != 0) {
+        fprintf(fp, "\t\"quant-bits\": %d,\n\t\"quant-rel-l2-err\": %g,\n", quant->bits, quant->error.rel_l2);
+        fprintf(fp, "\t\"quant-rel-max-err\": %g,\n\t\"quant-max-abs-err\": %g,\n", quant->error.rel_max, quant->error.max_abs);
+        fprintf(fp, "\t\"bytes-per-nnz\": %.3f,\n\t\"csr-bytes-per-nnz\": %.3f,\n", quant->bytes_per_nnz, quant->csr_bytes_per_nnz);
+    }
+}
@@ -0,0 +1,97 @@
+/*!
+ * \file            bench_spgemm.c
+ * \date            2026-10-18
+ * \author          Mirko Lana [lana.mirko@icloud.com]
+ *
+ * \brief           SpGEMM mode of the benchmark (spgemm).
+ */
+
+#include "rc.h"
+#include "arena.h"
+#include "bench.h"
+#include "bench_spgemm.h"
+#include "csr.h"
+#include "spgemm.h"
+#include "vec.h"
+#include "slog.h"
+#include "utils.h"
+
+#include <stdint.h>
+#include <stdio.h>
+
+int bench_spgemm_init(struct BenchHandler *bh, struct ArenaHandler *arena) {
+    const struct CsrMatrix *b = &bh->mtx;
+    if (bh->mtx.m != bh->mtx.n) {
+        SLOG_DEBUG("Transposing the non-square input matrix");
+        int res = csr_matrix_transpose(&bh->spgemm.b, &bh->mtx, arena);
+        if (res != RC_OK)
+            return res;
+        b = &bh->spgemm.b;
+    }
+
+    uint64_t start = utils_get_ns();
+    int res = spgemm_plan_init(&bh->spgemm.plan, &bh->mtx, b, arena);
+    if (res != RC_OK)
+        return res;
+    SLOG_INFO("SpGEMM %s planned in %lu us: at most %d non-zeros, %d hash rows, %d dense rows",
+              b == &bh->mtx ? "A * A" : "A * A^T",
+              (utils_get_ns() - start) / 1000U,
+              bh->spgemm.plan.ub_nnz,
+              bh->spgemm.plan.hash_rows,
+              bh->spgemm.plan.dense_rows);
+
+    return RC_OK;
+}
+
+int bench_spgemm_report(const struct BenchHandler *bh, struct BenchResults *results, struct ArenaHandler *arena) {
+    struct BenchSpgemmResults *spgemm = &results->spgemm;
+    const struct CsrMatrix *a = &bh->mtx;
+    const struct CsrMatrix *b = a->m == a->n ? a : &bh->spgemm.b;
+    const struct CsrMatrix *c = &bh->spgemm.product;
+    struct Vec x, bx, abx, cx;
+
+    spgemm->flops = bh->spgemm.plan.flops;
+    spgemm->nnz = c->nz;
+    spgemm->ub_nnz = bh->spgemm.plan.ub_nnz;
+    spgemm->bytes = bh->spgemm.plan.bytes;
+    spgemm->hash_rows = bh->spgemm.plan.hash_rows;
+    spgemm->dense_rows = bh->spgemm.plan.dense_rows;
+
+    int res = vec_init(&x, b->n, a->is_real, arena);
+    if (res == RC_OK)
+        res = vec_init(&bx, b->m, a->is_real, arena);
+    if (res == RC_OK)
+        res = vec_init(&abx, a->m, a->is_real, arena);
+    if (res == RC_OK)
+        res = vec_init(&cx, c->m, a->is_real, arena);
+    if (res == RC_OK)
+        res = vec_rand_fill(&x);
+    if (res == RC_OK)
+        res = csr_matrix_mul_vec(b, &x, &bx);
+    if (res == RC_OK)
+        res = csr_matrix_mul_vec(a, &bx, &abx);
+    if (res == RC_OK)
+        res = csr_matrix_mul_vec(c, &x, &cx);
+    if (res != RC_OK)
+        return res;
+
+    spgemm->rel_l2 = bench_rel_l2(&abx, &cx);
+
+    SLOG_INFO("SpGEMM: %d non-zeros, %.3f GFLOP/s (mean), %zu bytes allocated, relative L2 difference=%g",
+              spgemm->nnz,
+              (double)spgemm->flops / (double)GET_MAX(results->mean, 1U) / 1e3,
+              spgemm->bytes,
+              spgemm->rel_l2);
+
+    return RC_OK;
+}
+
+void bench_spgemm_write_json(FILE *fp, const struct BenchResults *results) {
+    const struct BenchSpgemmResults *spgemm = &results->spgemm;
+    double gflops = (double)spgemm->flops / (double)GET_MAX(results->mean, 1U) / 1e3;
+
+    fprintf(fp, "\t\"spgemm-flops\": %lld,\n\t\"spgemm-gflops\": %.3f,\n", spgemm->flops, gflops);
+    fprintf(fp, "\t\"spgemm-nnz\": %d,\n\t\"spgemm-ub-nnz\": %d,\n\t\"spgemm-bytes\": %zu,\n", spgemm->nnz, spgemm->ub_nnz, spgemm->bytes);
+    fprintf(fp, "\t\"spgemm-hash-rows\": %d,\n\t\"spgemm-dense-rows\": %d,\n", spgemm->hash_rows, spgemm->dense_rows);
+    fprintf(fp, "\t\"spgemm-rel-l2-diff\": %g,\n", spgemm->rel_l2);
+}
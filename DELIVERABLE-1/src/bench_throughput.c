@@ -0,0 +1,384 @@
+/*!
+ * \file            bench_throughput.c
+ * \date            2026-10-18
+ * \author          Mirko Lana [lana.mirko@icloud.com]
+ *
+ * \brief           Throughput mode of the benchmark (throughput).
+ */
+
+#include "rc.h"
+#include "arena.h"
+#include "bench.h"
+#include "bench_throughput.h"
+#include "config.h"
+#include "csr.h"
+#include "vec.h"
+#include "policy.h"
+#include "partition.h"
+#include "barrier.h"
+#include "pool.h"
+#include "shm.h"
+#include "slog.h"
+#include "topo.h"
+#include "utils.h"
+
+#include <pthread.h>
+#include <sched.h>
+#include <stdatomic.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+
+/*!
+ * \brief           Structure containing the state shared by the drivers of the core groups.
+ */
+struct BenchGroupSync {
+    pthread_mutex_t lock;       /*!< Lock serializing the arena allocations of the pools. */
+    struct SpinBarrier start;   /*!< Barrier met once the pools exist and once the groups are warm. */
+    atomic_int launched;        /*!< Number of drivers started, -1 until all the creations were tried. */
+    struct ArenaObj rounds;     /*!< Time of each run of each group in ns, groups * runs uint64_t. */
+    struct ArenaHandler *arena; /*!< Arena handler of the pools. */
+};
+
+/*!
+ * \brief           Structure representing the driver of a core group.
+ */
+struct BenchGroup {
+    struct BenchHandler *bh;     /*!< Benchmark handler owning the streams. */
+    struct BenchGroupSync *sync; /*!< State shared by the drivers. */
+    int index;                   /*!< Index of the group. */
+    struct ThreadPool pool;      /*!< Threads of the group, the driver first. */
+    uint64_t begin;              /*!< Time the runs of the group started, in ns. */
+    uint64_t end;                /*!< Time the runs of the group ended, in ns. */
+    int res;                     /*!< RC_OK, or the error code of the group. */
+    char err[RC_ERR_MSG_LEN];    /*!< Error message of the group, the driver having its own. */
+};
+
+/*!
+ * \brief           Order the CPUs of the groups.
+ *
+ * \details         Socket by socket, first one hardware thread of every core,
+ *                  then their SMT siblings, so that consecutive groups share a
+ *                  socket and a group only doubles up on a core when there are
+ *                  fewer cores than threads. Threads beyond the online CPUs stay
+ *                  unpinned.
+ *
+ * \param[in]       threads: Number of threads of all the groups.
+ * \param[out]      cpus: CPU of each thread (threads items, -1 if unpinned).
+ */
+static void prv_bench_plan_cpus(int threads, int *cpus) {
+    const struct Topology *topo = topo_get();
+    int sockets = 0;
+    int n = 0;
+
+    for (int cpu = 0; cpu < CONFIG_TOPO_MAX_CPUS; ++cpu)
+        sockets = GET_MAX(sockets, topo->cpu_socket[cpu] + 1);
+
+    for (int pass = 0; pass < 2; ++pass) {
+        for (int socket = 0; socket < sockets; ++socket) {
+            for (int cpu = 0; cpu < CONFIG_TOPO_MAX_CPUS && n < threads; ++cpu) {
+                int sibling = topo->cpu_sibling[cpu];
+                bool first = sibling < 0 || sibling > cpu;
+                if (topo->cpu_core[cpu] < 0 || topo->cpu_socket[cpu] != socket || first != (pass == 0))
+                    continue;
+                cpus[n++] = cpu;
+            }
+        }
+    }
+
+    for (; n < threads; ++n)
+        cpus[n] = -1;
+}
+
+/*!
+ * \brief           Pool task computing the rows of a thread of a stream SpMV.
+ *
+ * \param[in,out]   arg: Pointer to the handler of the stream.
+ * \param[in]       tid: Index of the calling thread.
+ * \param[in]       threads: Number of threads of the group.
+ */
+static void prv_bench_stream_task(void *arg, int tid, int threads) {
+    struct BenchHandler *stream = arg;
+    int begin = partition_nnz_bound(&stream->mtx, tid, threads);
+    int end = partition_nnz_bound(&stream->mtx, tid + 1, threads);
+    csr_matrix_mul_vec_rows(&stream->mtx, &stream->vec, &stream->result, begin, end);
+}
+
+/*!
+ * \brief           Compute one SpMV of every stream of a group.
+ *
+ * \param[in,out]   group: Pointer to the group.
+ * \param[in,out]   streams: Handlers of all the streams.
+ * \return          RC_OK on success, an error code otherwise.
+ */
+static int prv_bench_group_round(struct BenchGroup *group, struct BenchHandler *streams) {
+    const struct BenchHandler *bh = group->bh;
+
+    for (int s = group->index; s < bh->streams; s += bh->tp.groups) {
+        if (group->pool.threads == 1) {
+            prv_bench_stream_task(&streams[s], 0, 1); /*! No wake-up to pay for */
+            continue;
+        }
+
+        int res = pool_run(&group->pool, prv_bench_stream_task, &streams[s]);
+        if (res != RC_OK)
+            return res;
+    }
+
+    return RC_OK;
+}
+
+/*!
+ * \brief           Thread driving a core group: create its pool, warm up, then time its runs.
+ *
+ * \param[in,out]   arg: Pointer to the BenchGroup.
+ * \return          NULL.
+ */
+static void *prv_bench_group_main(void *arg) {
+    struct BenchGroup *group = arg;
+    struct BenchGroupSync *sync = group->sync;
+    const struct BenchHandler *bh = group->bh;
+    const int group_threads = bh->tp.group_threads;
+    int sense = 0;
+    int launched;
+
+    while ((launched = atomic_load_explicit(&sync->launched, memory_order_acquire)) < 0)
+        sched_yield();
+    if (launched < bh->tp.groups) {
+        group->res = RC_FAIL; /*! Another driver could not start: nobody to meet at the barrier */
+        snprintf(group->err, sizeof(group->err), "Another core group could not start");
+        return NULL;
+    }
+
+    /*! On the stack: pool_init allocates from the arena before pinning */
+    int cpus[CONFIG_TOPO_MAX_CPUS];
+    pthread_mutex_lock(&sync->lock);
+    memcpy(cpus, (const int *)arena_get_ptr(&bh->tp.group_cpus) + (size_t)group->index * group_threads, sizeof(int) * group_threads);
+    group->res = pool_init(&group->pool, group_threads, cpus, sync->arena);
+    pthread_mutex_unlock(&sync->lock);
+    const bool ready = group->res == RC_OK;
+
+    /*! All the pools exist: the arena no longer moves */
+    barrier_wait(&sync->start, &sense);
+    struct BenchHandler *streams = arena_get_ptr(&bh->stream_bh);
+    uint64_t *rounds = (uint64_t *)arena_get_ptr(&sync->rounds) + (size_t)group->index * bh->runs;
+
+    for (int i = 0; i < bh->warmup_iters && group->res == RC_OK; ++i)
+        group->res = prv_bench_group_round(group, streams);
+
+    barrier_wait(&sync->start, &sense);
+    group->begin = utils_get_ns();
+    group->end = group->begin;
+    for (int i = 0; i < bh->runs && group->res == RC_OK; ++i) {
+        group->res = prv_bench_group_round(group, streams);
+        uint64_t now = utils_get_ns();
+        rounds[i] = now - group->end;
+        group->end = now;
+    }
+
+    if (group->res != RC_OK)
+        snprintf(group->err, sizeof(group->err), "%s", rc_get_err_msg());
+    if (ready)
+        pool_destroy(&group->pool);
+    return NULL;
+}
+
+int bench_throughput_streams_init(struct BenchHandler *bh, const struct BenchConfig *cfg, int streams) {
+    const int files = cfg->filenames && cfg->matrices > 0 ? cfg->matrices : 1;
+
+    enum ArenaReturnCode arena_res = arena_calloc(cfg->arena, sizeof(struct BenchHandler), streams, &bh->stream_bh);
+    if (arena_res != ARENA_RC_OK) {
+        rc_set_err_msg("Memory array allocation failed in bench_init");
+        return RC_MEM_ALLOC_ERR;
+    }
+
+    /*! Built aside: loading and vec_init allocate from the arena, which may move the array */
+    for (int s = 0; s < streams; ++s) {
+        struct BenchHandler stream = { .mode = BENCH_MODE_CALL };
+        int res = RC_OK;
+        if (s == 0) {
+            stream.mtx = bh->mtx;
+        } else if (s < files) {
+            SLOG_DEBUG("Loading the matrix of stream %d from file: %s", s, cfg->filenames[s]);
+            stream.filename = cfg->filenames[s];
+            stream.shared = cfg->shared;
+            if (cfg->shared)
+                res = shm_store_load(&stream.shm, &stream.mtx, cfg->filenames[s], cfg->arena);
+            else
+                res = csr_matrix_load_from_file(&stream.mtx, cfg->filenames[s], cfg->arena);
+        } else {
+            stream.mtx = ((struct BenchHandler *)arena_get_ptr(&bh->stream_bh))[s - files].mtx;
+        }
+        if (res == RC_OK)
+            res = vec_init(&stream.vec, stream.mtx.n, stream.mtx.is_real, cfg->arena);
+        if (res == RC_OK)
+            res = vec_rand_fill(&stream.vec);
+        if (res == RC_OK)
+            res = vec_init(&stream.result, stream.mtx.m, stream.mtx.is_real, cfg->arena);
+        ((struct BenchHandler *)arena_get_ptr(&bh->stream_bh))[s] = stream; /*! Stored first, so that bench_fini detaches it */
+        bh->streams = s + 1;
+        if (res != RC_OK)
+            return res;
+    }
+
+    return RC_OK;
+}
+
+int bench_throughput_init(struct BenchHandler *bh, const struct BenchConfig *cfg) {
+    struct BenchThroughput *tp = &bh->tp;
+    const int files = cfg->filenames && cfg->matrices > 0 ? cfg->matrices : 1;
+    const char *reason = "fixed";
+
+    tp->groups = cfg->groups;
+    if (tp->groups == 0) {
+        struct ThreadPolicy policy;
+        int res = policy_select_threads(&policy, &bh->mtx, &bh->vec, &bh->result, bh->thread_count);
+        if (res != RC_OK)
+            return res;
+
+        tp->groups = GET_MIN(GET_MAX(bh->thread_count / policy.threads, 1), CONFIG_TP_MAX_GROUPS);
+        reason = policy.reason;
+    }
+    if (tp->groups > bh->thread_count) {
+        rc_set_err_msg("%d core groups need at least as many threads (%d given)", tp->groups, bh->thread_count);
+        return RC_INVALID_ARG_ERR;
+    }
+
+    tp->group_threads = bh->thread_count / tp->groups;
+    if (bh->thread_count % tp->groups != 0)
+        SLOG_WARN("%d threads left idle by %d groups of %d threads", bh->thread_count % tp->groups, tp->groups, tp->group_threads);
+
+    enum ArenaReturnCode arena_res = arena_calloc(cfg->arena, sizeof(int), (size_t)tp->groups * tp->group_threads, &tp->group_cpus);
+    if (arena_res != ARENA_RC_OK) {
+        rc_set_err_msg("Memory array allocation failed in bench_init");
+        return RC_MEM_ALLOC_ERR;
+    }
+    prv_bench_plan_cpus(tp->groups * tp->group_threads, arena_get_ptr(&tp->group_cpus));
+
+    int res = bench_throughput_streams_init(bh, cfg, GET_MAX(tp->groups, files));
+    if (res != RC_OK)
+        return res;
+
+    SLOG_INFO("Throughput: %d streams of %d matrices on %d groups of %d threads (%s)", bh->streams, files, tp->groups, tp->group_threads, reason);
+    return RC_OK;
+}
+
+int bench_throughput_spmv(struct BenchHandler *bh) {
+    struct BenchHandler *streams = arena_get_ptr(&bh->stream_bh);
+
+    for (int s = 0; s < bh->streams; ++s) {
+        int res = csr_matrix_mul_vec(&streams[s].mtx, &streams[s].vec, &streams[s].result);
+        if (res != RC_OK)
+            return res;
+    }
+
+    return RC_OK;
+}
+
+int bench_throughput_run(struct BenchHandler *bh, struct BenchResults *results, struct ArenaHandler *arena) {
+    const int group_count = bh->tp.groups;
+    struct BenchGroup groups[CONFIG_TP_MAX_GROUPS];
+    pthread_t drivers[CONFIG_TP_MAX_GROUPS];
+    struct BenchGroupSync sync = { .arena = arena };
+
+    enum ArenaReturnCode arena_res = arena_calloc(arena, sizeof(uint64_t), (size_t)group_count * bh->runs, &sync.rounds);
+    if (arena_res != ARENA_RC_OK) {
+        rc_set_err_msg("Memory array allocation failed in bench_run");
+        return RC_MEM_ALLOC_ERR;
+    }
+
+    pthread_mutex_init(&sync.lock, NULL);
+    barrier_init(&sync.start, group_count);
+    atomic_init(&sync.launched, -1);
+
+    int launched = 0;
+    for (; launched < group_count; ++launched) {
+        groups[launched] = (struct BenchGroup){ .bh = bh, .sync = &sync, .index = launched, .res = RC_OK };
+        if (pthread_create(&drivers[launched], NULL, prv_bench_group_main, &groups[launched]) != 0)
+            break;
+    }
+    atomic_store_explicit(&sync.launched, launched, memory_order_release);
+
+    int res = RC_OK;
+    int failed = -1;
+    uint64_t begin = UINT64_MAX;
+    uint64_t end = 0U;
+    for (int g = 0; g < launched; ++g) {
+        pthread_join(drivers[g], NULL);
+        if (res == RC_OK && groups[g].res != RC_OK) {
+            res = groups[g].res;
+            failed = g;
+        }
+        begin = GET_MIN(begin, groups[g].begin);
+        end = GET_MAX(end, groups[g].end);
+    }
+    pthread_mutex_destroy(&sync.lock);
+
+    if (launched < group_count) {
+        rc_set_err_msg("Could not create the driver of core group %d", launched);
+        return RC_FAIL;
+    }
+    if (res != RC_OK) {
+        rc_set_err_msg("Core group %d failed - %s", failed, groups[failed].err);
+        return res;
+    }
+
+    const uint64_t *rounds = arena_get_ptr(&sync.rounds);
+    uint64_t *samples = arena_get_ptr(&results->samples);
+    for (int i = 0; i < bh->runs; ++i) {
+        uint64_t slowest = 0U;
+        for (int g = 0; g < group_count; ++g)
+            slowest = GET_MAX(slowest, rounds[(size_t)g * bh->runs + i]);
+        samples[i] = slowest / 1000U;
+    }
+
+    results->tp.spmv_per_s = (double)bh->streams * bh->runs / ((double)GET_MAX(end - begin, 1U) * 1e-9);
+    return RC_OK;
+}
+
+int bench_throughput_report(struct BenchHandler *bh, struct BenchResults *results) {
+    const struct BenchHandler *streams = arena_get_ptr(&bh->stream_bh);
+    struct BenchThroughputResults *tp = &results->tp;
+
+    tp->groups = bh->tp.groups;
+    tp->group_threads = bh->tp.group_threads;
+    tp->streams = bh->streams;
+    for (int s = 0; s < bh->streams; ++s)
+        tp->flops += 2LL * streams[s].mtx.nz;
+
+    int res = RC_OK;
+    uint64_t total = 0U;
+    for (int i = 0; i < bh->runs && res == RC_OK; ++i) {
+        uint64_t start = utils_get_ns();
+        res = bench_throughput_spmv(bh);
+        total += utils_get_ns() - start;
+    }
+    if (res != RC_OK)
+        return res;
+
+    tp->seq_mean = total / (uint64_t)bh->runs / 1000U;
+    tp->seq_spmv_per_s = (double)bh->streams * bh->runs / ((double)GET_MAX(total, 1U) * 1e-9);
+
+    SLOG_INFO("Throughput: %d streams on %d groups of %d threads, %.0f SpMVs/s (%.3f GFLOP/s); one after the other on %d threads, %.0f SpMVs/s (%.2fx)",
+              tp->streams,
+              tp->groups,
+              tp->group_threads,
+              tp->spmv_per_s,
+              (double)tp->flops * tp->spmv_per_s / tp->streams / 1e9,
+              bh->thread_count,
+              tp->seq_spmv_per_s,
+              tp->spmv_per_s / GET_MAX(tp->seq_spmv_per_s, 1e-9));
+
+    return RC_OK;
+}
+
+void bench_throughput_write_json(FILE *fp, const struct BenchResults *results) {
+    const struct BenchThroughputResults *tp = &results->tp;
+    double gflops = (double)tp->flops * tp->spmv_per_s / GET_MAX(tp->streams, 1) / 1e9;
+
+    fprintf(fp, "\t\"throughput-groups\": %d,\n\t\"throughput-group-threads\": %d,\n", tp->groups, tp->group_threads);
+    fprintf(fp, "\t\"throughput-streams\": %d,\n\t\"throughput-flops\": %lld,\n", tp->streams, tp->flops);
+    fprintf(fp, "\t\"throughput-spmv-per-s\": %.1f,\n\t\"throughput-gflops\": %.3f,\n", tp->spmv_per_s, gflops);
+    fprintf(fp, "\t\"throughput-sequential-mean\": %lu,\n\t\"throughput-sequential-spmv-per-s\": %.1f,\n", tp->seq_mean, tp->seq_spmv_per_s);
+}
@@ -0,0 +1,253 @@
+/*!
+ * \file            chunk.c
+ * \date            2026-10-18
+ * \author          Mirko Lana [lana.mirko@icloud.com]
+ *
+ * \brief           SpMV delivering the result in row chunks as they complete.
+ */
+
+#include "config.h"
+#include "chunk.h"
+#include "rc.h"
+#include "csr.h"
+#include "vec.h"
+#include "arena.h"
+#include "partition.h"
+#include "pool.h"
+#include "topo.h"
+#include "utils.h"
+
+#include <stdatomic.h>
+#include <stdbool.h>
+#include <string.h>
+
+#ifdef CONFIG_ENABLE_OMP_PARALLELISM
+#include <omp.h>
+#endif /*! CONFIG_ENABLE_OMP_PARALLELISM */
+
+/*!
+ * \brief           Structure containing the state of a chunked SpMV, shared by its threads.
+ */
+struct ChunkTask {
+    struct ChunkPlan *plan; /*< Chunks and their delivery */
+    const struct Vec *vec;  /*< Input vector */
+    struct Vec *result;     /*< Result vector */
+    atomic_int next;        /*< Next chunk to compute */
+    atomic_bool delivering; /*< Flag held by the thread delivering the chunks (row order) */
+    int frontier;           /*< First chunk not delivered yet (row order, owned by the delivering thread) */
+};
+
+/*!
+ * \brief           Compute the rows of a chunk.
+ *
+ * \param[in]       plan: Pointer to the plan.
+ * \param[in]       c: Index of the chunk.
+ * \param[out]      begin: First row of the chunk.
+ * \param[out]      end: One past the last row of the chunk.
+ */
+static void prv_chunk_bounds(const struct ChunkPlan *plan, int c, int *begin, int *end) {
+    const int rows = plan->cfg.rows;
+    if (rows > 0) {
+        *begin = (int)GET_MIN((long)c * rows, (long)plan->mtx->m);
+        *end = (int)GET_MIN((long)(c + 1) * rows, (long)plan->mtx->m);
+    } else {
+        *begin = partition_nnz_bound(plan->mtx, c, plan->chunks);
+        *end = partition_nnz_bound(plan->mtx, c + 1, plan->chunks);
+    }
+}
+
+/*!
+ * \brief           Mark a chunk computed and deliver the chunks reaching the frontier (row order).
+ *
+ * \details         The thread that takes the delivering flag delivers every
+ *                  consecutive computed chunk from the frontier on; the other
+ *                  threads return to computing at once. After dropping the
+ *                  flag the deliverer checks the frontier again: a chunk
+ *                  marked while it held the flag is then delivered by it.
+ *
+ * \param[in,out]   task: Pointer to the task.
+ * \param[in]       c: Index of the computed chunk.
+ */
+static void prv_chunk_deliver_rows(struct ChunkTask *task, int c) {
+    struct ChunkPlan *plan = task->plan;
+    atomic_bool *done = arena_get_ptr(&plan->done);
+
+    atomic_store(&done[c], true);
+    while (!atomic_exchange(&task->delivering, true)) {
+        int f = task->frontier;
+        for (; f < plan->chunks && atomic_load(&done[f]); ++f) {
+            int begin, end;
+            prv_chunk_bounds(plan, f, &begin, &end);
+            plan->cfg.fn(plan->cfg.arg, task->result, f, begin, end);
+        }
+        task->frontier = f;
+        atomic_store(&task->delivering, false);
+
+        if (f == plan->chunks || !atomic_load(&done[f]))
+            return;
+    }
+}
+
+/*!
+ * \brief           Compute and deliver chunks until none is left (run by every thread).
+ *
+ * \param[in,out]   task: Pointer to the task.
+ */
+static void prv_chunk_work(struct ChunkTask *task) {
+    const struct ChunkPlan *plan = task->plan;
+
+    for (;;) {
+        const int c = atomic_fetch_add_explicit(&task->next, 1, memory_order_relaxed);
+        if (c >= plan->chunks)
+            return;
+
+        int begin, end;
+        prv_chunk_bounds(plan, c, &begin, &end);
+        csr_matrix_mul_vec_rows(plan->mtx, task->vec, task->result, begin, end);
+
+        if (plan->cfg.order == CHUNK_ORDER_ANY)
+            plan->cfg.fn(plan->cfg.arg, task->result, c, begin, end);
+        else
+            prv_chunk_deliver_rows(task, c);
+    }
+}
+
+/*!
+ * \brief           Get the number of threads of the parallel backend.
+ *
+ * \return          The number of threads.
+ */
+static int prv_chunk_threads(void) {
+#ifdef CONFIG_ENABLE_PTHREADS_PARALLELISM
+    struct ThreadPool *pool = pool_get_default();
+    return pool ? pool->threads : 1;
+#elif defined(CONFIG_ENABLE_OMP_PARALLELISM)
+    return omp_get_max_threads();
+#else
+    return 1;
+#endif /*! CONFIG_ENABLE_PTHREADS_PARALLELISM */
+}
+
+/*!
+ * \brief           Get the number of chunks of a matrix.
+ *
+ * \param[in]       mtx: Pointer to the CSR matrix.
+ * \param[in]       rows: Rows per chunk, 0 for the automatic size (see chunk_init).
+ * \return          The number of chunks (0 for a matrix without rows).
+ */
+static int prv_chunk_count(const struct CsrMatrix *mtx, int rows) {
+    if (mtx->m == 0)
+        return 0;
+    if (rows > 0)
+        return (int)(((long)mtx->m + rows - 1) / rows);
+
+    const long max_nnz = GET_MAX((long)topo_get_cache_size(2) / CONFIG_CHUNK_L2_SHARE / (long)(csr_matrix_val_size(mtx) + sizeof(int)), 1L);
+    long chunks = GET_MAX(((long)mtx->nz + max_nnz - 1) / max_nnz, (long)CONFIG_CHUNK_PER_THREAD * prv_chunk_threads());
+    return (int)GET_MAX(GET_MIN(chunks, (long)mtx->m), 1L);
+}
+
+#ifdef CONFIG_ENABLE_PTHREADS_PARALLELISM
+/*!
+ * \brief           Pool task running the chunk loop of one thread.
+ *
+ * \param[in,out]   arg: Pointer to the ChunkTask.
+ * \param[in]       tid: Index of the calling thread.
+ * \param[in]       threads: Number of threads of the pool.
+ */
+static void prv_chunk_pool_task(void *arg, int tid, int threads) {
+    UNUSED(tid);
+    UNUSED(threads);
+    prv_chunk_work(arg);
+}
+#endif /*! CONFIG_ENABLE_PTHREADS_PARALLELISM */
+
+int chunk_init(struct ChunkPlan *plan, const struct CsrMatrix *mtx, const struct ChunkConfig *cfg, struct ArenaHandler *arena) {
+    if (!plan || !mtx || !cfg || !arena || !cfg->fn || cfg->rows < 0 || cfg->order < 0 || cfg->order >= CHUNK_ORDER_COUNT) {
+        rc_set_err_msg("Invalid argument(s) provided to chunk_init");
+        return RC_INVALID_ARG_ERR;
+    }
+
+    plan->chunks = prv_chunk_count(mtx, cfg->rows);
+    enum ArenaReturnCode res = arena_calloc(arena, sizeof(atomic_bool), (size_t)GET_MAX(plan->chunks, 1), &plan->done);
+    if (res != ARENA_RC_OK) {
+        rc_set_err_msg("Memory array allocation failed in chunk_init");
+        return RC_MEM_ALLOC_ERR;
+    }
+
+    /*! Last: only a complete plan has a consumer */
+    plan->mtx = mtx;
+    plan->cfg = *cfg;
+    return RC_OK;
+}
+
+int chunk_mul_vec(struct ChunkPlan *plan, const struct Vec *vec, struct Vec *result) {
+    if (!plan || !vec || !result) {
+        rc_set_err_msg("Invalid NULL argument(s) provided to chunk_mul_vec");
+        return RC_INVALID_ARG_ERR;
+    }
+
+    const struct CsrMatrix *mtx = plan->mtx;
+    if (vec_size(vec) != mtx->n || vec->is_real != mtx->is_real || vec_size(result) != mtx->m || result->is_real != mtx->is_real) {
+        rc_set_err_msg("Incompatible matrix and vector dimensions or types in chunk_mul_vec");
+        return RC_INVALID_ARG_ERR;
+    }
+
+    struct ChunkTask task = {
+        .plan = plan,
+        .vec = vec,
+        .result = result,
+        .frontier = 0,
+    };
+    atomic_init(&task.next, 0);
+    atomic_init(&task.delivering, false);
+
+    /*! Before the threads start: they only set the flags */
+    atomic_bool *done = arena_get_ptr(&plan->done);
+    for (int c = 0; c < plan->chunks; ++c)
+        atomic_store_explicit(&done[c], false, memory_order_relaxed);
+
+#ifdef CONFIG_ENABLE_OMP_PARALLELISM
+    if (omp_get_max_threads() > 1 && plan->chunks > 1) {
+#pragma omp parallel
+        prv_chunk_work(&task);
+        return RC_OK;
+    }
+#endif /*! CONFIG_ENABLE_OMP_PARALLELISM */
+
+#ifdef CONFIG_ENABLE_PTHREADS_PARALLELISM
+    struct ThreadPool *pool = pool_get_default();
+    if (pool && pool->threads > 1 && plan->chunks > 1)
+        return pool_run(pool, prv_chunk_pool_task, &task);
+#endif /*! CONFIG_ENABLE_PTHREADS_PARALLELISM */
+
+    prv_chunk_work(&task);
+    return RC_OK;
+}
+
+int chunk_order_from_str(const char *str, enum ChunkOrder *order) {
+    if (!str || !order) {
+        rc_set_err_msg("Invalid NULL argument(s) provided to chunk_order_from_str");
+        return RC_INVALID_ARG_ERR;
+    }
+
+    for (int i = 0; i < CHUNK_ORDER_COUNT; ++i) {
+        if (strcmp(str, chunk_order_to_str((enum ChunkOrder)i)) == 0) {
+            *order = (enum ChunkOrder)i;
+            return RC_OK;
+        }
+    }
+
+    rc_set_err_msg("Unknown chunk order '%s'", str);
+    return RC_INVALID_ARG_ERR;
+}
+
+const char *chunk_order_to_str(enum ChunkOrder order) {
+    switch (order) {
+        case CHUNK_ORDER_ANY:
+            return "any";
+        case CHUNK_ORDER_ROWS:
+            return "rows";
+        default:
+            return "unknown";
+    }
+}
@@ -8,6 +8,10 @@
 
 #include "config.h"
 #include "cli.h"
+#include "bench.h"
+#include "chunk.h"
+#include "csr.h"
+#include "rc.h"
 #include "slog.h"
 
 #include <stdio.h>
@@ -15,6 +19,13 @@
 #include <stdbool.h>
 #include <getopt.h>
 
+#define PRV_CLI_OPT_SERVE 0x100       /*!< Value of the --serve option (long only) */
+#define PRV_CLI_OPT_COALESCE 0x101    /*!< Value of the --coalesce option (long only) */
+#define PRV_CLI_OPT_WINDOW 0x102      /*!< Value of the --window option (long only) */
+#define PRV_CLI_OPT_BATCH 0x103       /*!< Value of the --batch option (long only) */
+#define PRV_CLI_OPT_CHUNK_ROWS 0x104  /*!< Value of the --chunk-rows option (long only) */
+#define PRV_CLI_OPT_CHUNK_ORDER 0x105 /*!< Value of the --chunk-order option (long only) */
+
 static struct CliArguments g_cli_args; /*!< Global CLI arguments structure */
 
 /*!
@@ -24,12 +35,35 @@ static struct CliArguments g_cli_args; /*!< Global CLI arguments structure */
  * \param           pgm_name: Name of the program.
  */
 static void prv_cli_print_usage(FILE *os, const char *pgm_name) {
-    fprintf(os, "Usage: %s -i <matrix_file> [-t num_threads] [-w warmup] [-r runs] [-v | -q]\n", pgm_name);
+    fprintf(os, "Usage: %s -i <matrix_file> [-t num_threads] [-w warmup] [-r runs] [-m mode] [-k kernel] [-b bits] [-z] [-s steps] [-d degree] [-p parts] [-g groups] [-c count] [-x x_file] [-y y_file] [-S] [-v | -q]\n", pgm_name);
+    fprintf(os, "       %s -m throughput -i <matrix_file> [-i <matrix_file> ...] [-t num_threads] [-g groups] [-w warmup] [-r runs] [-k kernel] [-S] [-v | -q]\n", pgm_name);
+    fprintf(os, "       %s -m batched -i <matrix_file> [-i <matrix_file> ...] [-c count] [-t num_threads] [-w warmup] [-r runs] [-S] [-v | -q]\n", pgm_name);
+    fprintf(os, "       %s -m chunked -i <matrix_file> [--chunk-rows rows] [--chunk-order order] [-t num_threads] [-w warmup] [-r runs] [-k kernel] [-x x_file] [-y y_file] [-S] [-v | -q]\n", pgm_name);
+    fprintf(os, "       %s --batch <list_file> [-t num_threads] [-w warmup] [-r runs] [-m mode] [-k kernel] [-b bits] [-z] [-s steps] [-d degree] [-p parts] [-v | -q]\n", pgm_name);
+    fprintf(os, "       %s --serve <socket> -i <matrix_file> [-i <matrix_file> ...] [-t num_threads] [-k kernel] [--coalesce k] [--window us] [-S] [-v | -q]\n", pgm_name);
     fprintf(os, "Options:\n");
-    fprintf(os, "  -i <matrix_file>     Input file containing the sparse matrix in Matrix Market format (required)\n");
-    fprintf(os, "  -t <num_threads>     Number of threads to use (Default: %d)\n", CONFIG_DEFAULT_NUM_THREADS);
+    fprintf(os, "  -i <matrix_file>     Input file containing the sparse matrix in Matrix Market format (required, up to %d with --serve or in throughput and batched modes)\n", CONFIG_SERVE_MAX_MATRICES);
+    fprintf(os, "  -t <num_threads>     Number of threads to use, %d picks the fastest per matrix (Default: %d)\n", CONFIG_THREADS_AUTO, CONFIG_DEFAULT_NUM_THREADS);
     fprintf(os, "  -w <warmup>          Number of warm-up runs before benchmarking (Default: %d)\n", CONFIG_DEFAULT_WARMUP_ITERS);
     fprintf(os, "  -r <runs>            Number of benchmark runs (Default: %d)\n", CONFIG_DEFAULT_RUNS);
+    fprintf(os, "  -m <mode>            Execution mode: call, persistent, adaptive, ws, helper, spgemm, ata, mpk, poly, dist, gpart, throughput, batched, chunked (Default: %s)\n", CONFIG_DEFAULT_BENCH_MODE);
+    fprintf(os, "  -k <kernel>          SpMV kernel: auto, gather, lanes, prefetch (Default: %s)\n", CONFIG_DEFAULT_KERNEL);
+    fprintf(os, "  -b <bits>            Quantize real values per row to 8 or 16 bits (approximate SpMV), 0 disables (Default: %d)\n", CONFIG_DEFAULT_QUANT_BITS);
+    fprintf(os, "  -z                   Compress real values losslessly, if they shrink by at least %.1fx\n", CONFIG_FPC_MIN_RATIO);
+    fprintf(os, "  -s <steps>           Number of powers of the matrix computed per run in mpk mode, 1 to %d (Default: %d)\n", CONFIG_MPK_MAX_STEPS, CONFIG_DEFAULT_MPK_STEPS);
+    fprintf(os, "  -d <degree>          Degree of the Chebyshev polynomial of the matrix applied per run in poly mode, 0 to %d (Default: %d)\n", CONFIG_POLY_MAX_DEGREE, CONFIG_DEFAULT_POLY_DEGREE);
+    fprintf(os, "  -p <parts>           Number of parts of the graph partition in gpart mode, 1 to %d (Default: %d)\n", CONFIG_GPART_MAX_PARTS, CONFIG_DEFAULT_GPART_PARTS);
+    fprintf(os, "  -g <groups>          Number of core groups running independent SpMV streams in throughput mode, 1 to %d, 0 picks it from the thread policy (Default: %d)\n", CONFIG_TP_MAX_GROUPS, CONFIG_DEFAULT_TP_GROUPS);
+    fprintf(os, "  -c <count>           Number of matrices of the batch in batched mode, copies of the input matrices in turn, 1 to %d (Default: %d)\n", CONFIG_BATCH_MAX_COUNT, CONFIG_DEFAULT_BATCH_COUNT);
+    fprintf(os, "  -x <x_file>          Read the input vector from a Matrix Market array or raw binary file instead of random values\n");
+    fprintf(os, "  -y <y_file>          Write the result of the last run, as a Matrix Market array if the path ends in .mtx, else as raw binary\n");
+    fprintf(os, "  -S                   Share the matrix with the other processes of the node loading it (POSIX shared memory)\n");
+    fprintf(os, "  --batch <list_file>  Benchmark the matrices of a list (one path per line) in turn, loading the next one in the background\n");
+    fprintf(os, "  --chunk-rows <rows>  Rows per chunk in chunked mode, 0 balances the non-zeros of at least %d chunks per thread (Default: %d)\n", CONFIG_CHUNK_PER_THREAD, CONFIG_DEFAULT_CHUNK_ROWS);
+    fprintf(os, "  --chunk-order <o>    Delivery order of the chunks in chunked mode: any, rows (Default: %s)\n", CONFIG_DEFAULT_CHUNK_ORDER);
+    fprintf(os, "  --serve <socket>     Serve SpMVs of the input matrices on a UNIX domain socket until stopped (see include/serve.h)\n");
+    fprintf(os, "  --coalesce <k>       Compute up to k products of a matrix in one SpMM pass with --serve, 1 to %d (Default: %d)\n", CONFIG_CSR_BLOCK_MAX, CONFIG_SERVE_DEFAULT_COALESCE);
+    fprintf(os, "  --window <us>        Time a product may wait for others of its matrix with --serve, 0 to %d (Default: %d)\n", CONFIG_SERVE_MAX_WINDOW_US, CONFIG_SERVE_DEFAULT_WINDOW_US);
     fprintf(os, "  -v                   Enable DEBUG logging level\n");
     fprintf(os, "  -q                   Enable only ERROR logging level\n");
     fprintf(os, "  -h                   Show this help message\n");
@@ -38,24 +72,108 @@ static void prv_cli_print_usage(FILE *os, const char *pgm_name) {
 const struct CliArguments *cli_parse_args(int argc, char *argv[]) {
     SLOG_DEBUG("Entering cli_parse_args");
     g_cli_args.input_file = NULL;
+    g_cli_args.input_count = 0;
+    g_cli_args.serve_path = NULL;
+    g_cli_args.batch_list = NULL;
+    g_cli_args.x_file = NULL;
+    g_cli_args.y_file = NULL;
+    g_cli_args.coalesce = CONFIG_SERVE_DEFAULT_COALESCE;
+    g_cli_args.window_us = CONFIG_SERVE_DEFAULT_WINDOW_US;
     g_cli_args.num_threads = CONFIG_DEFAULT_NUM_THREADS;
     g_cli_args.warmup_iters = CONFIG_DEFAULT_WARMUP_ITERS;
     g_cli_args.runs = CONFIG_DEFAULT_RUNS;
     g_cli_args.log_lv = CONFIG_DEFAULT_LOG_LV;
+    bench_mode_from_str(CONFIG_DEFAULT_BENCH_MODE, &g_cli_args.mode);
+    csr_kernel_from_str(CONFIG_DEFAULT_KERNEL, &g_cli_args.kernel);
+    g_cli_args.quant_bits = CONFIG_DEFAULT_QUANT_BITS;
+    g_cli_args.compress = CONFIG_DEFAULT_COMPRESS;
+    g_cli_args.mpk_steps = CONFIG_DEFAULT_MPK_STEPS;
+    g_cli_args.poly_degree = CONFIG_DEFAULT_POLY_DEGREE;
+    g_cli_args.gpart_parts = CONFIG_DEFAULT_GPART_PARTS;
+    g_cli_args.tp_groups = CONFIG_DEFAULT_TP_GROUPS;
+    g_cli_args.batch_count = CONFIG_DEFAULT_BATCH_COUNT;
+    g_cli_args.chunk_rows = CONFIG_DEFAULT_CHUNK_ROWS;
+    chunk_order_from_str(CONFIG_DEFAULT_CHUNK_ORDER, &g_cli_args.chunk_order);
+    g_cli_args.shared = CONFIG_DEFAULT_SHARED;
 
     if (argc < 2) {
         prv_cli_print_usage(stderr, argv[0]);
         exit(EXIT_FAILURE);
     }
 
+    static const struct option long_opts[] = {
+        { "serve", required_argument, NULL, PRV_CLI_OPT_SERVE },
+        { "coalesce", required_argument, NULL, PRV_CLI_OPT_COALESCE },
+        { "window", required_argument, NULL, PRV_CLI_OPT_WINDOW },
+        { "batch", required_argument, NULL, PRV_CLI_OPT_BATCH },
+        { "chunk-rows", required_argument, NULL, PRV_CLI_OPT_CHUNK_ROWS },
+        { "chunk-order", required_argument, NULL, PRV_CLI_OPT_CHUNK_ORDER },
+        { "help", no_argument, NULL, 'h' },
+        { NULL, 0, NULL, 0 },
+    };
+
     int opt;
     bool has_v = false;
     bool has_q = false;
+    bool has_m = false;
+    bool has_batching = false;
+    bool has_g = false;
+    bool has_c = false;
+    bool has_chunk = false;
 
-    while ((opt = getopt(argc, argv, "i:o:t:w:r:vqh")) != EOF) {
+    while ((opt = getopt_long(argc, argv, "i:o:t:w:r:m:k:b:zs:d:p:g:c:x:y:Svqh", long_opts, NULL)) != EOF) {
         switch (opt) {
             case 'i':
-                g_cli_args.input_file = optarg;
+                if (g_cli_args.input_count == CONFIG_SERVE_MAX_MATRICES) {
+                    fprintf(stderr, "Error: At most %d input matrices can be given\n", CONFIG_SERVE_MAX_MATRICES);
+                    exit(EXIT_FAILURE);
+                }
+                g_cli_args.input_files[g_cli_args.input_count++] = optarg;
+                g_cli_args.input_file = g_cli_args.input_files[0];
+                break;
+
+            case PRV_CLI_OPT_SERVE:
+                g_cli_args.serve_path = optarg;
+                break;
+
+            case PRV_CLI_OPT_BATCH:
+                g_cli_args.batch_list = optarg;
+                break;
+
+            case PRV_CLI_OPT_CHUNK_ROWS:
+                g_cli_args.chunk_rows = atoi(optarg);
+                if (g_cli_args.chunk_rows < 0) {
+                    fprintf(stderr, "Error: The number of rows per chunk cannot be negative\n");
+                    exit(EXIT_FAILURE);
+                }
+                has_chunk = true;
+                break;
+
+            case PRV_CLI_OPT_CHUNK_ORDER:
+                if (chunk_order_from_str(optarg, &g_cli_args.chunk_order) != RC_OK) {
+                    fprintf(stderr, "Error: %s\n", rc_get_err_msg());
+                    prv_cli_print_usage(stderr, argv[0]);
+                    exit(EXIT_FAILURE);
+                }
+                has_chunk = true;
+                break;
+
+            case PRV_CLI_OPT_COALESCE:
+                g_cli_args.coalesce = atoi(optarg);
+                if (g_cli_args.coalesce < 1 || g_cli_args.coalesce > CONFIG_CSR_BLOCK_MAX) {
+                    fprintf(stderr, "Error: The number of products per pass must be between 1 and %d\n", CONFIG_CSR_BLOCK_MAX);
+                    exit(EXIT_FAILURE);
+                }
+                has_batching = true;
+                break;
+
+            case PRV_CLI_OPT_WINDOW:
+                g_cli_args.window_us = atoi(optarg);
+                if (g_cli_args.window_us < 0 || g_cli_args.window_us > CONFIG_SERVE_MAX_WINDOW_US) {
+                    fprintf(stderr, "Error: The coalescing window must be between 0 and %d us\n", CONFIG_SERVE_MAX_WINDOW_US);
+                    exit(EXIT_FAILURE);
+                }
+                has_batching = true;
                 break;
 
             case 't':
@@ -82,6 +200,89 @@ const struct CliArguments *cli_parse_args(int argc, char *argv[]) {
                 }
                 break;
 
+            case 'm':
+                if (bench_mode_from_str(optarg, &g_cli_args.mode) != RC_OK) {
+                    fprintf(stderr, "Error: %s\n", rc_get_err_msg());
+                    prv_cli_print_usage(stderr, argv[0]);
+                    exit(EXIT_FAILURE);
+                }
+                has_m = true;
+                break;
+
+            case 'k':
+                if (csr_kernel_from_str(optarg, &g_cli_args.kernel) != RC_OK) {
+                    fprintf(stderr, "Error: %s\n", rc_get_err_msg());
+                    prv_cli_print_usage(stderr, argv[0]);
+                    exit(EXIT_FAILURE);
+                }
+                break;
+
+            case 'b':
+                g_cli_args.quant_bits = atoi(optarg);
+                if (g_cli_args.quant_bits != 0 && g_cli_args.quant_bits != 8 && g_cli_args.quant_bits != 16) {
+                    fprintf(stderr, "Error: Quantized values must have 0, 8 or 16 bits\n");
+                    exit(EXIT_FAILURE);
+                }
+                break;
+
+            case 'z':
+                g_cli_args.compress = true;
+                break;
+
+            case 's':
+                g_cli_args.mpk_steps = atoi(optarg);
+                if (g_cli_args.mpk_steps < 1 || g_cli_args.mpk_steps > CONFIG_MPK_MAX_STEPS) {
+                    fprintf(stderr, "Error: The number of powers must be between 1 and %d\n", CONFIG_MPK_MAX_STEPS);
+                    exit(EXIT_FAILURE);
+                }
+                break;
+
+            case 'd':
+                g_cli_args.poly_degree = atoi(optarg);
+                if (g_cli_args.poly_degree < 0 || g_cli_args.poly_degree > CONFIG_POLY_MAX_DEGREE) {
+                    fprintf(stderr, "Error: The degree of the polynomial must be between 0 and %d\n", CONFIG_POLY_MAX_DEGREE);
+                    exit(EXIT_FAILURE);
+                }
+                break;
+
+            case 'p':
+                g_cli_args.gpart_parts = atoi(optarg);
+                if (g_cli_args.gpart_parts < 1 || g_cli_args.gpart_parts > CONFIG_GPART_MAX_PARTS) {
+                    fprintf(stderr, "Error: The number of parts must be between 1 and %d\n", CONFIG_GPART_MAX_PARTS);
+                    exit(EXIT_FAILURE);
+                }
+                break;
+
+            case 'g':
+                g_cli_args.tp_groups = atoi(optarg);
+                if (g_cli_args.tp_groups < 0 || g_cli_args.tp_groups > CONFIG_TP_MAX_GROUPS) {
+                    fprintf(stderr, "Error: The number of core groups must be between 0 and %d\n", CONFIG_TP_MAX_GROUPS);
+                    exit(EXIT_FAILURE);
+                }
+                has_g = true;
+                break;
+
+            case 'c':
+                g_cli_args.batch_count = atoi(optarg);
+                if (g_cli_args.batch_count < 1 || g_cli_args.batch_count > CONFIG_BATCH_MAX_COUNT) {
+                    fprintf(stderr, "Error: The number of matrices of the batch must be between 1 and %d\n", CONFIG_BATCH_MAX_COUNT);
+                    exit(EXIT_FAILURE);
+                }
+                has_c = true;
+                break;
+
+            case 'x':
+                g_cli_args.x_file = optarg;
+                break;
+
+            case 'y':
+                g_cli_args.y_file = optarg;
+                break;
+
+            case 'S':
+                g_cli_args.shared = true;
+                break;
+
             case 'v':
                 if (has_q) {
                     fprintf(stderr, "Error: Options -v (verbose) and -q (quiet) cannot be used together.\n");
@@ -112,11 +313,53 @@ const struct CliArguments *cli_parse_args(int argc, char *argv[]) {
         }
     }
 
-    if (!g_cli_args.input_file) {
+    if (g_cli_args.batch_list && (g_cli_args.input_file || g_cli_args.serve_path)) {
+        fprintf(stderr, "Error: Option --batch cannot be used with -i or --serve.\n");
+        exit(EXIT_FAILURE);
+    }
+
+    if ((g_cli_args.x_file || g_cli_args.y_file) && (g_cli_args.batch_list || g_cli_args.serve_path)) {
+        fprintf(stderr, "Error: Options -x and -y cannot be used with --batch or --serve.\n");
+        exit(EXIT_FAILURE);
+    }
+
+    if (!g_cli_args.input_file && !g_cli_args.batch_list) {
         fprintf(stderr, "Error: Input matrix file (-i) is required.\n");
         prv_cli_print_usage(stderr, argv[0]);
         exit(EXIT_FAILURE);
     }
 
+    bool throughput = !g_cli_args.serve_path && g_cli_args.mode == BENCH_MODE_THROUGHPUT;
+    bool batched = !g_cli_args.serve_path && g_cli_args.mode == BENCH_MODE_BATCHED;
+    if (g_cli_args.input_count > 1 && !g_cli_args.serve_path && !throughput && !batched) {
+        fprintf(stderr, "Error: Several input matrices (-i) can only be given with --serve or in throughput and batched modes.\n");
+        exit(EXIT_FAILURE);
+    }
+
+    if (has_c && !batched) {
+        fprintf(stderr, "Error: Option -c only applies to batched mode.\n");
+        exit(EXIT_FAILURE);
+    }
+
+    if (has_chunk && (g_cli_args.serve_path || g_cli_args.mode != BENCH_MODE_CHUNKED)) {
+        fprintf(stderr, "Error: Options --chunk-rows and --chunk-order only apply to chunked mode.\n");
+        exit(EXIT_FAILURE);
+    }
+
+    if (has_g && !throughput) {
+        fprintf(stderr, "Error: Option -g only applies to throughput mode.\n");
+        exit(EXIT_FAILURE);
+    }
+
+    if (has_batching && !g_cli_args.serve_path) {
+        fprintf(stderr, "Error: Options --coalesce and --window only apply to --serve.\n");
+        exit(EXIT_FAILURE);
+    }
+
+    if (g_cli_args.serve_path && (has_m || g_cli_args.quant_bits != 0 || g_cli_args.compress)) {
+        fprintf(stderr, "Error: Options -m, -b and -z do not apply to --serve.\n");
+        exit(EXIT_FAILURE);
+    }
+
     return &g_cli_args;
 }
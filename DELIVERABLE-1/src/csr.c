@@ -19,15 +19,62 @@
 #include "coo.h"
 #include "vec.h"
 #include "utils.h"
+#include "isa.h"
+#include "simd.h"
+#include "partition.h"
+#include "pool.h"
+#include "topo.h"
 #include "slog.h"
 
 #include <string.h>
 #include <stdbool.h>
+#include <stdint.h>
+
+#ifdef CONFIG_ENABLE_OMP_PARALLELISM
+#include <omp.h>
+#endif /*! CONFIG_ENABLE_OMP_PARALLELISM */
 
 /*! Unused function warning suppression */
-static int prv_csr_matrix_mul_vec_serial(const struct CsrMatrix *mtx, const struct Vec *vec, struct Vec *result) __attribute__((unused));
-static int prv_csr_matrix_mul_vec_omp(const struct CsrMatrix *mtx, const struct Vec *vec, struct Vec *result) __attribute__((unused));
-static int prv_csr_matrix_mul_vec_pthreads(const struct CsrMatrix *mtx, const struct Vec *vec, struct Vec *result) __attribute__((unused));
+static int prv_csr_matrix_mul_vec_serial(const struct CsrMatrix *mtx, const struct Vec *vec, struct Vec *result, int flags) __attribute__((unused));
+static int prv_csr_matrix_mul_vec_omp(const struct CsrMatrix *mtx, const struct Vec *vec, struct Vec *result, int flags) __attribute__((unused));
+static int prv_csr_matrix_mul_vec_pthreads(const struct CsrMatrix *mtx, const struct Vec *vec, struct Vec *result, int flags) __attribute__((unused));
+static void prv_csr_matrix_mul_vec_pool_task(void *arg, int tid, int threads) __attribute__((unused));
+static void prv_csr_poly_pool_task(void *arg, int tid, int threads) __attribute__((unused));
+static void prv_csr_block_pool_task(void *arg, int tid, int threads) __attribute__((unused));
+
+/*!
+ * \brief           Structure containing the arguments of a Pthreads SpMV.
+ */
+struct CsrPoolTask {
+    const struct CsrMatrix *mtx; /*< Input matrix */
+    const struct Vec *vec;       /*< Input vector */
+    struct Vec *result;          /*< Result vector */
+    int flags;                   /*< SIMD_INT_* flags */
+};
+
+/*!
+ * \brief           Structure containing the arguments of a Pthreads SpMM.
+ */
+struct CsrBlockTask {
+    const struct CsrMatrix *mtx; /*< Input matrix */
+    const void *x;               /*< Interleaved input vectors */
+    void *y;                     /*< Interleaved result vectors */
+    int k;                       /*< Number of vectors */
+};
+
+/*!
+ * \brief           Structure containing the arguments of one degree of a polynomial.
+ */
+struct CsrPolyStep {
+    const struct CsrMatrix *mtx; /*< Input matrix */
+    const struct CsrPoly *poly;  /*< Polynomial */
+    int k;                       /*< Degree of the current term (T_(k+1) is computed) */
+    const double *x;             /*< Input vector (T_0) */
+    const double *prev;          /*< Term T_(k-1) */
+    const double *cur;           /*< Term T_k */
+    double *next;                /*< Term T_(k+1), may be prev */
+    double *y;                   /*< Result */
+};
 
 /*!
  * \brief           Check if a CSR matrix is compatible with a vector for multiplication.
@@ -45,75 +92,124 @@ static inline bool prv_csr_matrix_is_compatible_with_vec(const struct CsrMatrix
 }
 
 /*!
- * \brief           Multiply a CSR matrix with a vector (serial implementation).
+ * \brief           Multiply a range of rows of an integer matrix with the vector.
  *
- * \param[in]       mtx: Pointer to the COO matrix.
+ * \param[in]       T: Storage type of the values.
+ * \param[in]       ACC: Accumulator type.
+ */
+#define PRV_CSR_INT_ROWS(T, ACC)                                 \
+    do {                                                         \
+        const T *v = val;                                        \
+        for (int i = row_begin; i < row_end; ++i) {              \
+            ACC sum = 0;                                         \
+            _Pragma("omp simd reduction(+ : sum)")               \
+            for (int k = row[i]; k < row[i + 1]; ++k)            \
+                sum += (ACC)v[k] * x[col[k]];                    \
+            y[i] = simd_saturate_int32(sum);                     \
+        }                                                        \
+    } while (0)
+
+/*!
+ * \brief           Multiply a range of rows of an integer CSR matrix with a vector.
+ *
+ * \details         Inlined in the kernel bodies, with the dispatch on the
+ *                  storage type and the accumulator hoisted out of the row loop:
+ *                  each combination gets its own vectorized loop.
+ *
+ * \param[in]       row: CSR row pointer array.
+ * \param[in]       col: CSR column index array.
+ * \param[in]       val: CSR value array.
+ * \param[in]       type: Storage type of the values.
+ * \param[in]       x: Input vector values.
+ * \param[out]      y: Result vector values (saturated to int32).
+ * \param[in]       row_begin: First row of the range.
+ * \param[in]       row_end: One past the last row of the range.
+ * \param[in]       acc32: Flag indicating that no row sum can overflow int32.
+ */
+static inline __attribute__((always_inline)) void prv_csr_int_rows(const int *row, const int *col, const void *val, enum CsrValType type, const int *x, int *y, int row_begin, int row_end, bool acc32) {
+    switch (type) {
+        case CSR_VAL_INT8:
+            if (acc32)
+                PRV_CSR_INT_ROWS(int8_t, int);
+            else
+                PRV_CSR_INT_ROWS(int8_t, long long);
+            break;
+        case CSR_VAL_INT16:
+            if (acc32)
+                PRV_CSR_INT_ROWS(int16_t, int);
+            else
+                PRV_CSR_INT_ROWS(int16_t, long long);
+            break;
+        default:
+            if (acc32)
+                PRV_CSR_INT_ROWS(int32_t, int);
+            else
+                PRV_CSR_INT_ROWS(int32_t, long long);
+            break;
+    }
+}
+
+/*!
+ * \brief           Multiply a range of rows of a CSR matrix with a vector.
+ *
+ * \details         Body shared by all the instruction set variants: inlined in
+ *                  each of them, so it is vectorized for the target of the caller.
+ *
+ * \param[in]       mtx: Pointer to the CSR matrix.
  * \param[in]       vec: Pointer to the vector.
  * \param[out]      result: Pointer to the result vector.
- * \return          RC_OK on success, an error code otherwise.
+ * \param[in]       row_begin: First row of the range.
+ * \param[in]       row_end: One past the last row of the range.
+ * \param[in]       flags: SIMD_INT_* flags (integer matrices).
  */
-static int prv_csr_matrix_mul_vec_serial(const struct CsrMatrix *mtx, const struct Vec *vec, struct Vec *result) {
-    // SLOG_DEBUG("Entering prv_csr_matrix_mul_vec_serial"); /*! disable logging for performance */
-    int *row = arena_get_ptr(&mtx->row);
-    int *col = arena_get_ptr(&mtx->col);
-
-    // SLOG_DEBUG("Matrix dimensions: %d x %d, Non-zeros: %d", mtx->m, mtx->n, mtx->nz);
-    // SLOG_DEBUG("Vector size: %d", vec_size(vec));
-    // SLOG_DEBUG("Result vector size: %d", vec_size(result));
+static inline __attribute__((always_inline)) void prv_csr_matrix_mul_vec_rows_body(const struct CsrMatrix *mtx, const struct Vec *vec, struct Vec *result, int row_begin, int row_end, int flags) {
+    int *row = csr_matrix_row_ptr(mtx);
+    int *col = csr_matrix_col_idx(mtx);
 
     if (mtx->is_real) {
-        double *mtx_val = arena_get_ptr(&mtx->val);
+        double *mtx_val = csr_matrix_values(mtx);
         double *vec_val = arena_get_ptr(&vec->val);
         double *res_val = arena_get_ptr(&result->val);
-        for (int i = 0; i <= mtx->m - 1; ++i) {
+        for (int i = row_begin; i < row_end; ++i) {
             double sum = 0.0;
 
-            for (int k = row[i]; k < row[i + 1]; ++k) {
+#pragma omp simd reduction(+ : sum)
+            for (int k = row[i]; k < row[i + 1]; ++k)
                 sum += mtx_val[k] * vec_val[col[k]];
-                // SLOG_DEBUG("mtx_val[%d] = %f, vec_val[%d] = %f, partial sum = %f", k, mtx_val[k], col[k], vec_val[col[k]], sum);
-            }
 
             res_val[i] = sum;
-            // SLOG_DEBUG("res_val[%d] = %f", i, res_val[i]);
         }
     } else {
-        int *mtx_val = arena_get_ptr(&mtx->val);
+        const void *mtx_val = csr_matrix_values(mtx);
         int *vec_val = arena_get_ptr(&vec->val);
         int *res_val = arena_get_ptr(&result->val);
-        for (int i = 0; i <= mtx->m - 1; ++i) {
-            int sum = 0;
-
-            for (int k = row[i]; k < row[i + 1]; ++k) {
-                sum += mtx_val[k] * vec_val[col[k]];
-                // SLOG_DEBUG("mtx_val[%d] = %d, vec_val[%d] = %d, partial sum = %d", k, mtx_val[k], col[k], vec_val[col[k]], sum);
-            }
-
-            res_val[i] = sum;
-            // SLOG_DEBUG("res_val[%d] = %d", i, res_val[i]);
-        }
+        prv_csr_int_rows(row, col, mtx_val, mtx->val_type, vec_val, res_val, row_begin, row_end, flags & SIMD_INT_ACC32);
     }
-    return RC_OK;
 }
 
 /*!
- * \brief           Multiply a CSR matrix with a vector (OpenMP implementation).
+ * \brief           Share the rows of a CSR matrix among the threads of the enclosing parallel region.
  *
- * \param[in]       mtx: Pointer to the COO matrix.
+ * \details         Body shared by all the instruction set variants, see
+ *                  prv_csr_matrix_mul_vec_rows_body. The parallel region itself
+ *                  is opened by the variant, so that its outlined function gets
+ *                  the target of the variant.
+ *
+ * \param[in]       mtx: Pointer to the CSR matrix.
  * \param[in]       vec: Pointer to the vector.
  * \param[out]      result: Pointer to the result vector.
- * \return          RC_OK on success, an error code otherwise.
+ * \param[in]       flags: SIMD_INT_* flags (integer matrices).
  */
-static int prv_csr_matrix_mul_vec_omp(const struct CsrMatrix *mtx, const struct Vec *vec, struct Vec *result) {
-    // SLOG_DEBUG("Entering prv_csr_matrix_mul_vec_omp"); /*! disable logging for performance */
-    int *row = arena_get_ptr(&mtx->row);
-    int *col = arena_get_ptr(&mtx->col);
+static inline __attribute__((always_inline)) void prv_csr_matrix_mul_vec_omp_body(const struct CsrMatrix *mtx, const struct Vec *vec, struct Vec *result, int flags) {
+    int *row = csr_matrix_row_ptr(mtx);
+    int *col = csr_matrix_col_idx(mtx);
 
     if (mtx->is_real) {
-        double *mtx_val = arena_get_ptr(&mtx->val);
+        double *mtx_val = csr_matrix_values(mtx);
         double *vec_val = arena_get_ptr(&vec->val);
         double *res_val = arena_get_ptr(&result->val);
 
-#pragma omp parallel for schedule(CONFIG_OMP_SCHEDULE)
+#pragma omp for schedule(CONFIG_OMP_SCHEDULE)
         for (int i = 0; i <= mtx->m - 1; ++i) {
             double sum = 0.0;
 
@@ -124,38 +220,542 @@ static int prv_csr_matrix_mul_vec_omp(const struct CsrMatrix *mtx, const struct
             res_val[i] = sum;
         }
     } else {
-        int *mtx_val = arena_get_ptr(&mtx->val);
+        const void *mtx_val = csr_matrix_values(mtx);
         int *vec_val = arena_get_ptr(&vec->val);
         int *res_val = arena_get_ptr(&result->val);
 
-#pragma omp parallel for schedule(CONFIG_OMP_SCHEDULE)
-        for (int i = 0; i <= mtx->m - 1; ++i) {
-            int sum = 0;
+        /*! Groups of rows, so the type dispatch stays out of the row loop */
+#pragma omp for schedule(CONFIG_OMP_SCHEDULE)
+        for (int i = 0; i < mtx->m; i += CONFIG_SIMD_ROW_GROUP)
+            prv_csr_int_rows(row, col, mtx_val, mtx->val_type, vec_val, res_val, i, GET_MIN(i + CONFIG_SIMD_ROW_GROUP, mtx->m), flags & SIMD_INT_ACC32);
+    }
+}
+
+/*!
+ * \brief           Multiply a range of rows of a real CSR matrix with a vector, prefetching the vector.
+ *
+ * \details         Before computing a row, prefetches the vector items gathered
+ *                  CONFIG_PREFETCH_LINES cache lines of column indexes ahead of
+ *                  it, so that their cache misses overlap the computation of
+ *                  the rows in between.
+ *                  The prefetch loop is kept apart so the row loop still
+ *                  vectorizes.
+ *
+ * \param[in]       row: CSR row pointer array.
+ * \param[in]       col: CSR column index array.
+ * \param[in]       val: CSR value array.
+ * \param[in]       x: Input vector values.
+ * \param[out]      y: Result vector values.
+ * \param[in]       row_begin: First row of the range.
+ * \param[in]       row_end: One past the last row of the range.
+ */
+static inline __attribute__((always_inline)) void prv_csr_prefetch_rows_body(const int *row, const int *col, const double *val, const double *x, double *y, int row_begin, int row_end) {
+    const int last = row[row_end];
+    const int distance = CONFIG_PREFETCH_LINES * topo_get_line_size() / (int)sizeof(int);
+
+    for (int i = row_begin; i < row_end; ++i) {
+        int pf_end = GET_MIN(row[i + 1] + distance, last);
+        for (int k = GET_MIN(row[i] + distance, last); k < pf_end; ++k)
+            __builtin_prefetch(&x[col[k]], 0, 3);
+
+        double sum = 0.0;
 
 #pragma omp simd reduction(+ : sum)
-            for (int k = row[i]; k < row[i + 1]; ++k)
-                sum += mtx_val[k] * vec_val[col[k]];
+        for (int k = row[i]; k < row[i + 1]; ++k)
+            sum += val[k] * x[col[k]];
 
-            res_val[i] = sum;
+        y[i] = sum;
+    }
+}
+
+/*!
+ * \brief           Multiply a range of rows of an integer matrix with a block of vectors.
+ *
+ * \param[in]       T: Storage type of the values.
+ */
+#define PRV_CSR_INT_BLOCK_ROWS(T)                                   \
+    do {                                                            \
+        const T *v = val;                                           \
+        for (int i = row_begin; i < row_end; ++i) {                 \
+            long long sum[CONFIG_CSR_BLOCK_MAX] = { 0 };            \
+            for (int p = row[i]; p < row[i + 1]; ++p) {             \
+                const long long a = v[p];                           \
+                const int *xp = &x[(size_t)col[p] * k];             \
+                _Pragma("omp simd")                                 \
+                for (int j = 0; j < k; ++j)                         \
+                    sum[j] += a * xp[j];                            \
+            }                                                       \
+            for (int j = 0; j < k; ++j)                             \
+                y[(size_t)i * k + j] = simd_saturate_int32(sum[j]); \
+        }                                                           \
+    } while (0)
+
+/*!
+ * \brief           Multiply a range of rows of a CSR matrix with a block of k interleaved vectors.
+ *
+ * \details         Body shared by all the instruction set variants, see
+ *                  prv_csr_matrix_mul_vec_rows_body. Each non-zero is read
+ *                  once and updates the k sums of its row from one contiguous
+ *                  run of x. Inlined with a constant k by prv_csr_block_rows_const,
+ *                  so that the loop over the vectors is unrolled.
+ *
+ * \param[in]       mtx: Pointer to the CSR matrix.
+ * \param[in]       vx: Interleaved input vectors (n * k items).
+ * \param[out]      vy: Interleaved result vectors (m * k items).
+ * \param[in]       k: Number of vectors (1 to CONFIG_CSR_BLOCK_MAX).
+ * \param[in]       row_begin: First row of the range.
+ * \param[in]       row_end: One past the last row of the range.
+ */
+static inline __attribute__((always_inline)) void prv_csr_block_rows_body(const struct CsrMatrix *mtx, const void *vx, void *vy, int k, int row_begin, int row_end) {
+    const int *row = csr_matrix_row_ptr(mtx);
+    const int *col = csr_matrix_col_idx(mtx);
+    const void *val = csr_matrix_values(mtx);
+
+    if (mtx->is_real) {
+        const double *v = val;
+        const double *x = vx;
+        double *y = vy;
+        for (int i = row_begin; i < row_end; ++i) {
+            double sum[CONFIG_CSR_BLOCK_MAX] = { 0 };
+            for (int p = row[i]; p < row[i + 1]; ++p) {
+                const double a = v[p];
+                const double *xp = &x[(size_t)col[p] * k];
+#pragma omp simd
+                for (int j = 0; j < k; ++j)
+                    sum[j] += a * xp[j];
+            }
+            for (int j = 0; j < k; ++j)
+                y[(size_t)i * k + j] = sum[j];
         }
+        return;
+    }
+
+    const int *x = vx;
+    int *y = vy;
+    switch (mtx->val_type) {
+        case CSR_VAL_INT8:
+            PRV_CSR_INT_BLOCK_ROWS(int8_t);
+            break;
+        case CSR_VAL_INT16:
+            PRV_CSR_INT_BLOCK_ROWS(int16_t);
+            break;
+        default:
+            PRV_CSR_INT_BLOCK_ROWS(int32_t);
+            break;
+    }
+}
+
+/*!
+ * \brief           Multiply a range of rows of a CSR matrix with a block of vectors, for a constant k where common.
+ *
+ * \param[in]       mtx: Pointer to the CSR matrix.
+ * \param[in]       x: Interleaved input vectors.
+ * \param[out]      y: Interleaved result vectors.
+ * \param[in]       k: Number of vectors.
+ * \param[in]       row_begin: First row of the range.
+ * \param[in]       row_end: One past the last row of the range.
+ */
+static inline __attribute__((always_inline)) void prv_csr_block_rows_const(const struct CsrMatrix *mtx, const void *x, void *y, int k, int row_begin, int row_end) {
+    switch (k) {
+        case 2:
+            prv_csr_block_rows_body(mtx, x, y, 2, row_begin, row_end);
+            break;
+        case 4:
+            prv_csr_block_rows_body(mtx, x, y, 4, row_begin, row_end);
+            break;
+        case 8:
+            prv_csr_block_rows_body(mtx, x, y, 8, row_begin, row_end);
+            break;
+        default:
+            prv_csr_block_rows_body(mtx, x, y, k, row_begin, row_end);
+            break;
+    }
+}
+
+/*!
+ * \brief           Define the kernel variants of an instruction set level.
+ *
+ * \param[in]       isa: Suffix of the variants.
+ * \param[in]       attr: Target attribute of the variants (empty for the baseline).
+ */
+#define PRV_CSR_DEFINE_KERNELS(isa, attr)                                                                                                                          \
+    attr static void prv_csr_matrix_mul_vec_rows_##isa(const struct CsrMatrix *mtx, const struct Vec *vec, struct Vec *result, int row_begin, int row_end, int flags) { \
+        prv_csr_matrix_mul_vec_rows_body(mtx, vec, result, row_begin, row_end, flags);                                                                             \
+    }                                                                                                                                                              \
+    attr static void prv_csr_matrix_mul_vec_omp_##isa(const struct CsrMatrix *mtx, const struct Vec *vec, struct Vec *result, int flags) {                         \
+        _Pragma("omp parallel") prv_csr_matrix_mul_vec_omp_body(mtx, vec, result, flags);                                                                          \
+    }                                                                                                                                                              \
+    attr static void prv_csr_prefetch_rows_##isa(const int *row, const int *col, const double *val, const double *x, double *y, int row_begin, int row_end) {       \
+        prv_csr_prefetch_rows_body(row, col, val, x, y, row_begin, row_end);                                                                                       \
+    }                                                                                                                                                              \
+    attr static void prv_csr_block_rows_##isa(const struct CsrMatrix *mtx, const void *x, void *y, int k, int row_begin, int row_end) {                             \
+        prv_csr_block_rows_const(mtx, x, y, k, row_begin, row_end);                                                                                                \
+    }
+
+PRV_CSR_DEFINE_KERNELS(baseline, )
+#ifdef ISA_ENABLE_X86_DISPATCH
+PRV_CSR_DEFINE_KERNELS(avx2, __attribute__((target(ISA_TARGET_AVX2))))
+PRV_CSR_DEFINE_KERNELS(avx512, __attribute__((target(ISA_TARGET_AVX512))))
+#endif /*! ISA_ENABLE_X86_DISPATCH */
+
+/*!
+ * \brief           Structure containing the kernel variants of an instruction set level.
+ */
+struct CsrKernels {
+    void (*rows)(const struct CsrMatrix *, const struct Vec *, struct Vec *, int, int, int); /*< Range of rows */
+    void (*omp)(const struct CsrMatrix *, const struct Vec *, struct Vec *, int);            /*< OpenMP parallel region */
+    void (*block)(const struct CsrMatrix *, const void *, void *, int, int, int);            /*< Range of rows of a block of vectors */
+};
+
+/*!
+ * \brief           Kernel variants indexed by instruction set level (see isa_get).
+ */
+static const struct CsrKernels g_csr_kernels[ISA_LEVEL_COUNT] = {
+    [ISA_LEVEL_BASELINE] = { prv_csr_matrix_mul_vec_rows_baseline, prv_csr_matrix_mul_vec_omp_baseline, prv_csr_block_rows_baseline },
+#ifdef ISA_ENABLE_X86_DISPATCH
+    [ISA_LEVEL_AVX2] = { prv_csr_matrix_mul_vec_rows_avx2, prv_csr_matrix_mul_vec_omp_avx2, prv_csr_block_rows_avx2 },
+    [ISA_LEVEL_AVX512] = { prv_csr_matrix_mul_vec_rows_avx512, prv_csr_matrix_mul_vec_omp_avx512, prv_csr_block_rows_avx512 },
+#else
+    [ISA_LEVEL_AVX2] = { prv_csr_matrix_mul_vec_rows_baseline, prv_csr_matrix_mul_vec_omp_baseline, prv_csr_block_rows_baseline },
+    [ISA_LEVEL_AVX512] = { prv_csr_matrix_mul_vec_rows_baseline, prv_csr_matrix_mul_vec_omp_baseline, prv_csr_block_rows_baseline },
+#endif /*! ISA_ENABLE_X86_DISPATCH */
+};
+
+/*!
+ * \brief           Kernels of real matrices replacing the auto-vectorized one, indexed by kernel and instruction set level (NULL if missing).
+ */
+static const SimdRowsFn g_csr_simd_kernels[CSR_KERNEL_COUNT][ISA_LEVEL_COUNT] = {
+#ifdef ISA_ENABLE_X86_DISPATCH
+    [CSR_KERNEL_GATHER] = { [ISA_LEVEL_AVX2] = simd_csr_gather_avx2, [ISA_LEVEL_AVX512] = simd_csr_gather_avx512 },
+    [CSR_KERNEL_LANES] = { [ISA_LEVEL_AVX2] = simd_csr_lanes_avx2, [ISA_LEVEL_AVX512] = simd_csr_lanes_avx512 },
+    [CSR_KERNEL_PREFETCH] = { prv_csr_prefetch_rows_baseline, prv_csr_prefetch_rows_avx2, prv_csr_prefetch_rows_avx512 },
+#else
+    [CSR_KERNEL_PREFETCH] = { prv_csr_prefetch_rows_baseline, prv_csr_prefetch_rows_baseline, prv_csr_prefetch_rows_baseline },
+#endif /*! ISA_ENABLE_X86_DISPATCH */
+};
+
+/*!
+ * \brief           Explicit kernels of integer matrices indexed by instruction set level and value type (NULL if missing).
+ */
+static const SimdIntRowsFn g_csr_simd_int_kernels[ISA_LEVEL_COUNT][CSR_VAL_INT8 + 1] = {
+#ifdef ISA_ENABLE_X86_DISPATCH
+    [ISA_LEVEL_AVX2] = { [CSR_VAL_INT32] = simd_csr_int32_avx2, [CSR_VAL_INT16] = simd_csr_int16_avx2, [CSR_VAL_INT8] = simd_csr_int8_avx2 },
+    [ISA_LEVEL_AVX512] = { [CSR_VAL_INT32] = simd_csr_int32_avx2, [CSR_VAL_INT16] = simd_csr_int16_avx2, [CSR_VAL_INT8] = simd_csr_int8_avx2 },
+#endif /*! ISA_ENABLE_X86_DISPATCH */
+};
+
+static enum CsrKernel g_csr_kernel = CSR_KERNEL_AUTO; /*!< Selected kernel */
+
+/*!
+ * \brief           Get the explicit kernel selected for a real matrix.
+ *
+ * \param[in]       mtx: Pointer to the CSR matrix.
+ * \return          The kernel, NULL to use the auto-vectorized one.
+ */
+static inline SimdRowsFn prv_csr_get_simd_kernel(const struct CsrMatrix *mtx) {
+    return mtx->is_real ? g_csr_simd_kernels[g_csr_kernel][isa_get()] : NULL;
+}
+
+/*!
+ * \brief           Get the explicit kernel selected for an integer matrix.
+ *
+ * \details         The integer kernels compute one row at a time: "lanes" uses
+ *                  the same kernel as "gather".
+ *
+ * \param[in]       mtx: Pointer to the CSR matrix.
+ * \return          The kernel, NULL to use the auto-vectorized one.
+ */
+static inline SimdIntRowsFn prv_csr_get_simd_int_kernel(const struct CsrMatrix *mtx) {
+    bool explicit = g_csr_kernel == CSR_KERNEL_GATHER || g_csr_kernel == CSR_KERNEL_LANES;
+    return (!mtx->is_real && explicit) ? g_csr_simd_int_kernels[isa_get()][mtx->val_type] : NULL;
+}
+
+/*!
+ * \brief           Pick the accumulation of an integer SpMV.
+ *
+ * \details         No row sum can overflow int32 when max_row_nnz * max|val| *
+ *                  max|x| fits in it. Scanning x costs n reads, little next to
+ *                  the gathers of the non-zeros.
+ *
+ * \param[in]       mtx: Pointer to the CSR matrix.
+ * \param[in]       vec: Pointer to the vector.
+ * \return          The SIMD_INT_* flags (0 for real matrices).
+ */
+static int prv_csr_int_flags(const struct CsrMatrix *mtx, const struct Vec *vec) {
+    if (mtx->is_real)
+        return 0;
+
+    const int *x = arena_get_ptr(&vec->val);
+    long long x_max = 0;
+
+#pragma omp simd reduction(max : x_max)
+    for (int j = 0; j < vec->n; ++j) {
+        long long a = x[j] < 0 ? -(long long)x[j] : x[j];
+        x_max = a > x_max ? a : x_max;
+    }
+
+    int flags = 0;
+    if (x_max == 0 || (long long)mtx->max_row_nnz * mtx->max_abs_val <= (INT32_MAX - 1LL) / x_max)
+        flags |= SIMD_INT_ACC32;
+    if ((flags & SIMD_INT_ACC32) && mtx->val_type != CSR_VAL_INT32 && x_max <= INT16_MAX)
+        flags |= SIMD_INT_MADD;
+
+    return flags;
+}
+
+/*!
+ * \brief           Multiply a range of rows of a CSR matrix with a vector.
+ *
+ * \param[in]       mtx: Pointer to the CSR matrix.
+ * \param[in]       vec: Pointer to the vector.
+ * \param[out]      result: Pointer to the result vector.
+ * \param[in]       row_begin: First row of the range.
+ * \param[in]       row_end: One past the last row of the range.
+ * \param[in]       flags: SIMD_INT_* flags (integer matrices).
+ */
+static inline void prv_csr_matrix_mul_vec_rows(const struct CsrMatrix *mtx, const struct Vec *vec, struct Vec *result, int row_begin, int row_end, int flags) {
+    SimdRowsFn simd = prv_csr_get_simd_kernel(mtx);
+    SimdIntRowsFn simd_int = prv_csr_get_simd_int_kernel(mtx);
+
+    if (simd)
+        simd(csr_matrix_row_ptr(mtx), csr_matrix_col_idx(mtx), csr_matrix_values(mtx), arena_get_ptr(&vec->val), arena_get_ptr(&result->val), row_begin, row_end);
+    else if (simd_int)
+        simd_int(csr_matrix_row_ptr(mtx), csr_matrix_col_idx(mtx), csr_matrix_values(mtx), arena_get_ptr(&vec->val), arena_get_ptr(&result->val), row_begin, row_end, flags);
+    else
+        g_csr_kernels[isa_get()].rows(mtx, vec, result, row_begin, row_end, flags);
+}
+
+/*!
+ * \brief           Multiply a CSR matrix with a vector (serial implementation).
+ *
+ * \param[in]       mtx: Pointer to the COO matrix.
+ * \param[in]       vec: Pointer to the vector.
+ * \param[out]      result: Pointer to the result vector.
+ * \param[in]       flags: SIMD_INT_* flags (integer matrices).
+ * \return          RC_OK on success, an error code otherwise.
+ */
+static int prv_csr_matrix_mul_vec_serial(const struct CsrMatrix *mtx, const struct Vec *vec, struct Vec *result, int flags) {
+    // SLOG_DEBUG("Entering prv_csr_matrix_mul_vec_serial"); /*! disable logging for performance */
+    prv_csr_matrix_mul_vec_rows(mtx, vec, result, 0, mtx->m, flags);
+    return RC_OK;
+}
+
+/*!
+ * \brief           Multiply a CSR matrix with a vector (OpenMP implementation).
+ *
+ * \param[in]       mtx: Pointer to the COO matrix.
+ * \param[in]       vec: Pointer to the vector.
+ * \param[out]      result: Pointer to the result vector.
+ * \param[in]       flags: SIMD_INT_* flags (integer matrices).
+ * \return          RC_OK on success, an error code otherwise.
+ */
+static int prv_csr_matrix_mul_vec_omp(const struct CsrMatrix *mtx, const struct Vec *vec, struct Vec *result, int flags) {
+    // SLOG_DEBUG("Entering prv_csr_matrix_mul_vec_omp"); /*! disable logging for performance */
+    SimdRowsFn simd = prv_csr_get_simd_kernel(mtx);
+    SimdIntRowsFn simd_int = prv_csr_get_simd_int_kernel(mtx);
+    if (!simd && !simd_int) {
+        g_csr_kernels[isa_get()].omp(mtx, vec, result, flags);
+        return RC_OK;
+    }
+
+    const int *row = csr_matrix_row_ptr(mtx);
+    const int *col = csr_matrix_col_idx(mtx);
+    const void *mtx_val = csr_matrix_values(mtx);
+    const void *vec_val = arena_get_ptr(&vec->val);
+    void *res_val = arena_get_ptr(&result->val);
+
+#pragma omp parallel for schedule(CONFIG_OMP_SCHEDULE)
+    for (int i = 0; i < mtx->m; i += CONFIG_SIMD_ROW_GROUP) {
+        int end = GET_MIN(i + CONFIG_SIMD_ROW_GROUP, mtx->m);
+        if (simd)
+            simd(row, col, mtx_val, vec_val, res_val, i, end);
+        else
+            simd_int(row, col, mtx_val, vec_val, res_val, i, end, flags);
     }
+
     return RC_OK;
 }
 
+/*!
+ * \brief           Pool task computing the nnz-balanced share of rows of one thread.
+ *
+ * \param[in,out]   arg: Pointer to the CsrPoolTask.
+ * \param[in]       tid: Index of the calling thread.
+ * \param[in]       threads: Number of threads of the pool.
+ */
+static void prv_csr_matrix_mul_vec_pool_task(void *arg, int tid, int threads) {
+    struct CsrPoolTask *task = arg;
+    int row_begin = partition_nnz_bound(task->mtx, tid, threads);
+    int row_end = partition_nnz_bound(task->mtx, tid + 1, threads);
+
+    prv_csr_matrix_mul_vec_rows(task->mtx, task->vec, task->result, row_begin, row_end, task->flags);
+}
+
 /*!
  * \brief           Multiply a CSR matrix with a vector (Pthreads implementation).
  *
+ * \details         Runs on the default pool (see pool_init_default), serially if
+ *                  there is none or it has a single thread.
+ *
  * \param[in]       mtx: Pointer to the COO matrix.
  * \param[in]       vec: Pointer to the vector.
  * \param[out]      result: Pointer to the result vector.
+ * \param[in]       flags: SIMD_INT_* flags (integer matrices).
  * \return          RC_OK on success, an error code otherwise.
  */
-static int prv_csr_matrix_mul_vec_pthreads(const struct CsrMatrix *mtx, const struct Vec *vec, struct Vec *result) {
-    SLOG_DEBUG("Entering prv_csr_matrix_mul_vec_pthreads");
-    SLOG_WARN("Pthreads parallelism is not yet implemented for CSR matrix-vector multiplication.");
-    UNUSED(mtx);
-    UNUSED(vec);
-    UNUSED(result);
+static int prv_csr_matrix_mul_vec_pthreads(const struct CsrMatrix *mtx, const struct Vec *vec, struct Vec *result, int flags) {
+    // SLOG_DEBUG("Entering prv_csr_matrix_mul_vec_pthreads"); /*! disable logging for performance */
+    struct ThreadPool *pool = pool_get_default();
+    if (!pool || pool->threads == 1)
+        return prv_csr_matrix_mul_vec_serial(mtx, vec, result, flags);
+
+    struct CsrPoolTask task = { .mtx = mtx, .vec = vec, .result = result, .flags = flags };
+    return pool_run(pool, prv_csr_matrix_mul_vec_pool_task, &task);
+}
+
+/*!
+ * \brief           Compute one degree of a polynomial on a range of rows.
+ *
+ * \details         The first degree computes T_1 = B x and y = c_0 x + c_1 T_1,
+ *                  the next ones T_(k+1) = 2 B T_k - T_(k-1) and y += c_(k+1)
+ *                  T_(k+1). next may alias prev: each item is read before it is
+ *                  overwritten, and no other row reads it in this degree.
+ *
+ * \param[in]       step: Pointer to the degree.
+ * \param[in]       row_begin: First row of the range.
+ * \param[in]       row_end: One past the last row of the range.
+ */
+static void prv_csr_poly_rows(const struct CsrPolyStep *step, int row_begin, int row_end) {
+    const int *row = csr_matrix_row_ptr(step->mtx);
+    const int *col = csr_matrix_col_idx(step->mtx);
+    const double *val = csr_matrix_values(step->mtx);
+    const double scale = step->poly->scale;
+    const double shift = step->poly->shift;
+    const double c = step->poly->coeffs[step->k + 1];
+    const double *cur = step->cur;
+
+    for (int i = row_begin; i < row_end; ++i) {
+        double t = 0.0;
+#pragma omp simd reduction(+ : t)
+        for (int k = row[i]; k < row[i + 1]; ++k)
+            t += val[k] * cur[col[k]];
+
+        const double b = scale * t + shift * cur[i];
+        if (step->k == 0) {
+            step->next[i] = b;
+            step->y[i] = step->poly->coeffs[0] * step->x[i] + c * b;
+        } else {
+            const double term = 2.0 * b - step->prev[i];
+            step->next[i] = term;
+            step->y[i] += c * term;
+        }
+    }
+}
+
+/*!
+ * \brief           Move a polynomial to its next degree.
+ *
+ * \details         T_(k+2) overwrites T_k, but T_2, which cannot overwrite the
+ *                  input vector, goes to the second work vector.
+ *
+ * \param[in,out]   step: Pointer to the degree.
+ * \param[in]       spare: Second work vector.
+ */
+static inline void prv_csr_poly_next(struct CsrPolyStep *step, double *spare) {
+    step->prev = step->cur;
+    step->cur = step->next;
+    step->next = step->k == 0 ? spare : (double *)step->prev;
+    step->k++;
+}
+
+/*!
+ * \brief           Pool task computing one degree of a polynomial on the nnz-balanced rows of one thread.
+ *
+ * \param[in,out]   arg: Pointer to the CsrPolyStep.
+ * \param[in]       tid: Index of the calling thread.
+ * \param[in]       threads: Number of threads of the pool.
+ */
+static void prv_csr_poly_pool_task(void *arg, int tid, int threads) {
+    const struct CsrPolyStep *step = arg;
+    prv_csr_poly_rows(step, partition_nnz_bound(step->mtx, tid, threads), partition_nnz_bound(step->mtx, tid + 1, threads));
+}
+
+/*!
+ * \brief           Pool task multiplying the nnz-balanced rows of one thread with a block of vectors.
+ *
+ * \param[in,out]   arg: Pointer to the CsrBlockTask.
+ * \param[in]       tid: Index of the calling thread.
+ * \param[in]       threads: Number of threads of the pool.
+ */
+static void prv_csr_block_pool_task(void *arg, int tid, int threads) {
+    const struct CsrBlockTask *task = arg;
+    int row_begin = partition_nnz_bound(task->mtx, tid, threads);
+    int row_end = partition_nnz_bound(task->mtx, tid + 1, threads);
+
+    g_csr_kernels[isa_get()].block(task->mtx, task->x, task->y, task->k, row_begin, row_end);
+}
+
+/*!
+ * \brief           Record the row statistics of a CSR matrix and narrow its integer values.
+ *
+ * \details         Integer values are moved to the narrowest of int8, int16 and
+ *                  int32 holding all of them, so the SpMV moves fewer bytes.
+ *
+ * \param[in,out]   mtx: Pointer to the CSR matrix.
+ * \param[out]      arena: Pointer to the arena handler for memory allocation.
+ * \return          RC_OK on success, an error code otherwise:
+ *                   - RC_MEM_ALLOC_ERR if memory allocation fails.
+ */
+static int prv_csr_matrix_narrow_values(struct CsrMatrix *mtx, struct ArenaHandler *arena) {
+    const int *row = csr_matrix_row_ptr(mtx);
+    mtx->max_row_nnz = 0;
+    for (int i = 0; i < mtx->m; ++i)
+        mtx->max_row_nnz = GET_MAX(mtx->max_row_nnz, row[i + 1] - row[i]);
+
+    mtx->val_type = CSR_VAL_REAL;
+    mtx->max_abs_val = 0;
+    if (mtx->is_real)
+        return RC_OK;
+
+    const int *val = csr_matrix_values(mtx);
+    int lo = 0;
+    int hi = 0;
+    for (int k = 0; k < mtx->nz; ++k) {
+        lo = GET_MIN(lo, val[k]);
+        hi = GET_MAX(hi, val[k]);
+    }
+
+    /*! |INT32_MIN| does not fit: saturate, the overflow checks are strict */
+    mtx->max_abs_val = lo == INT32_MIN ? INT32_MAX : GET_MAX(-lo, hi);
+    mtx->val_type = CSR_VAL_INT32;
+    if (lo >= INT8_MIN && hi <= INT8_MAX)
+        mtx->val_type = CSR_VAL_INT8;
+    else if (lo >= INT16_MIN && hi <= INT16_MAX)
+        mtx->val_type = CSR_VAL_INT16;
+
+    SLOG_DEBUG("Integer values in [%d, %d] stored as int%d", lo, hi, mtx->val_type == CSR_VAL_INT8 ? 8 : (mtx->val_type == CSR_VAL_INT16 ? 16 : 32));
+    if (mtx->val_type == CSR_VAL_INT32)
+        return RC_OK;
+
+    struct ArenaObj narrow;
+    enum ArenaReturnCode res = arena_calloc(arena, mtx->val_type == CSR_VAL_INT8 ? sizeof(int8_t) : sizeof(int16_t), mtx->nz, &narrow);
+    if (res != ARENA_RC_OK) {
+        rc_set_err_msg("Memory array allocation failed in csr_matrix_from_coo");
+        return RC_MEM_ALLOC_ERR;
+    }
+
+    val = csr_matrix_values(mtx);
+    if (mtx->val_type == CSR_VAL_INT8) {
+        int8_t *out = arena_get_ptr(&narrow);
+        for (int k = 0; k < mtx->nz; ++k)
+            out[k] = (int8_t)val[k];
+    } else {
+        int16_t *out = arena_get_ptr(&narrow);
+        for (int k = 0; k < mtx->nz; ++k)
+            out[k] = (int16_t)val[k];
+    }
+    mtx->val = narrow;
+
     return RC_OK;
 }
 
@@ -170,6 +770,9 @@ int csr_matrix_from_coo(struct CsrMatrix *dest, const struct CooMatrix *src, str
     dest->is_real = src->is_real;
     dest->col = src->col;
     dest->val = src->val;
+    dest->mapped_col = NULL;
+    dest->mapped_row = NULL;
+    dest->mapped_val = NULL;
 
     SLOG_DEBUG("Allocating memory for CSR row pointer array of size: %d", dest->m + 1);
     enum ArenaReturnCode res = arena_calloc(arena, sizeof(int), dest->m + 1, &dest->row);
@@ -180,16 +783,52 @@ int csr_matrix_from_coo(struct CsrMatrix *dest, const struct CooMatrix *src, str
     SLOG_DEBUG("Memory allocated for CSR row pointer array");
 
     int *coo_row = arena_get_ptr(&src->row);
-    int *csr_row = arena_get_ptr(&dest->row);
+    int *csr_row = csr_matrix_row_ptr(dest);
+    bool is_sorted = true;
     int i = 0;
 
-    for (; i < src->nz; ++i)
+    for (; i < src->nz; ++i) {
         csr_row[coo_row[i] + 1]++;
+        if (i > 0 && coo_row[i] < coo_row[i - 1])
+            is_sorted = false;
+    }
 
     for (i = 0; i < dest->m; ++i)
         csr_row[i + 1] += csr_row[i];
 
-    return RC_OK;
+    if (is_sorted)
+        return prv_csr_matrix_narrow_values(dest, arena); /*! Entries already grouped by row: share the COO arrays */
+
+    /*! Entries are not grouped by row (e.g. column-major files): scatter them */
+    SLOG_DEBUG("COO entries not sorted by row, scattering them into new CSR arrays");
+    size_t val_size = dest->is_real ? sizeof(double) : sizeof(int);
+    struct ArenaObj next;
+    res = arena_calloc(arena, sizeof(int), dest->m, &next);
+    if (res == ARENA_RC_OK)
+        res = arena_calloc(arena, sizeof(int), dest->nz, &dest->col);
+    if (res == ARENA_RC_OK)
+        res = arena_calloc(arena, val_size, dest->nz, &dest->val);
+    if (res != ARENA_RC_OK) {
+        rc_set_err_msg("Memory array allocation failed in csr_matrix_from_coo");
+        return RC_MEM_ALLOC_ERR;
+    }
+
+    coo_row = arena_get_ptr(&src->row);
+    csr_row = csr_matrix_row_ptr(dest);
+    int *coo_col = arena_get_ptr(&src->col);
+    int *csr_col = csr_matrix_col_idx(dest);
+    char *coo_val = arena_get_ptr(&src->val);
+    char *csr_val = csr_matrix_values(dest);
+    int *pos = arena_get_ptr(&next);
+
+    memcpy(pos, csr_row, (size_t)dest->m * sizeof(int));
+    for (i = 0; i < src->nz; ++i) {
+        int k = pos[coo_row[i]]++;
+        csr_col[k] = coo_col[i];
+        memcpy(csr_val + (size_t)k * val_size, coo_val + (size_t)i * val_size, val_size);
+    }
+
+    return prv_csr_matrix_narrow_values(dest, arena);
 }
 
 int csr_matrix_load_from_file(struct CsrMatrix *mtx, const char *filename, struct ArenaHandler *arena) {
@@ -203,6 +842,63 @@ int csr_matrix_load_from_file(struct CsrMatrix *mtx, const char *filename, struc
     return csr_matrix_from_coo(mtx, &coo, arena);
 }
 
+int csr_matrix_transpose(struct CsrMatrix *dest, const struct CsrMatrix *src, struct ArenaHandler *arena) {
+    SLOG_DEBUG("Entering csr_matrix_transpose");
+    if (!dest || !src || !arena || dest == src) {
+        rc_set_err_msg("Invalid argument(s) provided to csr_matrix_transpose");
+        return RC_INVALID_ARG_ERR;
+    }
+
+    const size_t val_size = csr_matrix_val_size(src);
+
+    *dest = (struct CsrMatrix){
+        .m = src->n,
+        .n = src->m,
+        .nz = src->nz,
+        .is_real = src->is_real,
+        .val_type = src->val_type,
+        .max_abs_val = src->max_abs_val,
+        .max_row_nnz = 0,
+    };
+
+    enum ArenaReturnCode res = arena_calloc(arena, sizeof(int), (size_t)dest->m + 1, &dest->row);
+    if (res == ARENA_RC_OK)
+        res = arena_calloc(arena, sizeof(int), GET_MAX(dest->nz, 1), &dest->col);
+    if (res == ARENA_RC_OK)
+        res = arena_calloc(arena, val_size, GET_MAX(dest->nz, 1), &dest->val);
+    if (res != ARENA_RC_OK) {
+        rc_set_err_msg("Memory array allocation failed in csr_matrix_transpose");
+        return RC_MEM_ALLOC_ERR;
+    }
+
+    const int *row = csr_matrix_row_ptr(src);
+    const int *col = csr_matrix_col_idx(src);
+    const char *val = csr_matrix_values(src);
+    int *t_row = csr_matrix_row_ptr(dest);
+    int *t_col = csr_matrix_col_idx(dest);
+    char *t_val = csr_matrix_values(dest);
+
+    for (int k = 0; k < src->nz; ++k)
+        t_row[col[k] + 1]++;
+    for (int j = 0; j < dest->m; ++j) {
+        dest->max_row_nnz = GET_MAX(dest->max_row_nnz, t_row[j + 1]);
+        t_row[j + 1] += t_row[j];
+    }
+
+    /*! t_row[j] is used as the insertion point of row j, then shifted back */
+    for (int i = 0; i < src->m; ++i) {
+        for (int k = row[i]; k < row[i + 1]; ++k) {
+            int pos = t_row[col[k]]++;
+            t_col[pos] = i;
+            memcpy(t_val + (size_t)pos * val_size, val + (size_t)k * val_size, val_size);
+        }
+    }
+    memmove(t_row + 1, t_row, sizeof(int) * (size_t)dest->m);
+    t_row[0] = 0;
+
+    return RC_OK;
+}
+
 int csr_matrix_mul_vec(const struct CsrMatrix *mtx, const struct Vec *vec, struct Vec *result) {
     // SLOG_DEBUG("Entering csr_matrix_mul_vec"); /*! disable logging for performance */
     if (!mtx || !vec || !result) {
@@ -220,17 +916,177 @@ int csr_matrix_mul_vec(const struct CsrMatrix *mtx, const struct Vec *vec, struc
         return RC_INVALID_ARG_ERR;
     }
 
+    int flags = prv_csr_int_flags(mtx, vec);
+
 #ifdef CONFIG_ENABLE_SERIAL_EXECUTION
-    return prv_csr_matrix_mul_vec_serial(mtx, vec, result);
+    return prv_csr_matrix_mul_vec_serial(mtx, vec, result, flags);
 #endif /*! CONFIG_ENABLE_SERIAL_EXECUTION */
 
 #ifdef CONFIG_ENABLE_OMP_PARALLELISM
-    return prv_csr_matrix_mul_vec_omp(mtx, vec, result);
+    if (omp_get_max_threads() == 1)
+        return prv_csr_matrix_mul_vec_serial(mtx, vec, result, flags); /*! Serial fast path: skip the fork/join */
+    return prv_csr_matrix_mul_vec_omp(mtx, vec, result, flags);
 #endif /*! CONFIG_ENABLE_OMP_PARALLELISM */
 
 #ifdef CONFIG_ENABLE_PTHREADS_PARALLELISM
-    return prv_csr_matrix_mul_vec_pthreads(mtx, vec, result);
+    return prv_csr_matrix_mul_vec_pthreads(mtx, vec, result, flags);
 #endif /*! CONFIG_ENABLE_PTHREADS_PARALLELISM */
 
     return RC_FAIL; /*! Configuration error: no parallelism mode enabled */
 }
+
+int csr_matrix_mul_vec_rows(const struct CsrMatrix *mtx, const struct Vec *vec, struct Vec *result, int row_begin, int row_end) {
+    if (row_begin < 0 || row_end > mtx->m || row_begin > row_end)
+        return RC_IDX_OUT_OF_BOUNDS_ERR;
+
+    prv_csr_matrix_mul_vec_rows(mtx, vec, result, row_begin, row_end, 0); /*! Vector not scanned: int64 sums */
+    return RC_OK;
+}
+
+int csr_matrix_mul_block(const struct CsrMatrix *mtx, const struct Vec *vec, struct Vec *result, int k) {
+    if (!mtx || !vec || !result || k < 1 || k > CONFIG_CSR_BLOCK_MAX) {
+        rc_set_err_msg("Invalid argument(s) provided to csr_matrix_mul_block");
+        return RC_INVALID_ARG_ERR;
+    }
+
+    if (vec_size(vec) != mtx->n * k || vec->is_real != mtx->is_real || vec_size(result) != mtx->m * k || result->is_real != mtx->is_real) {
+        rc_set_err_msg("Incompatible matrix and vector block dimensions or types in csr_matrix_mul_block");
+        return RC_INVALID_ARG_ERR;
+    }
+
+    struct CsrBlockTask task = { .mtx = mtx, .x = arena_get_ptr(&vec->val), .y = arena_get_ptr(&result->val), .k = k };
+    const struct CsrKernels *kernels = &g_csr_kernels[isa_get()];
+
+#ifdef CONFIG_ENABLE_OMP_PARALLELISM
+    if (omp_get_max_threads() > 1) {
+#pragma omp parallel
+        {
+            const int tid = omp_get_thread_num();
+            const int threads = omp_get_num_threads();
+            kernels->block(mtx, task.x, task.y, k, partition_nnz_bound(mtx, tid, threads), partition_nnz_bound(mtx, tid + 1, threads));
+        }
+        return RC_OK;
+    }
+#endif /*! CONFIG_ENABLE_OMP_PARALLELISM */
+
+#ifdef CONFIG_ENABLE_PTHREADS_PARALLELISM
+    struct ThreadPool *pool = pool_get_default();
+    if (pool && pool->threads > 1)
+        return pool_run(pool, prv_csr_block_pool_task, &task);
+#endif /*! CONFIG_ENABLE_PTHREADS_PARALLELISM */
+
+    kernels->block(mtx, task.x, task.y, k, 0, mtx->m);
+    return RC_OK;
+}
+
+int csr_matrix_poly_apply(const struct CsrMatrix *mtx, const struct CsrPoly *poly, const struct Vec *vec, struct Vec *result, struct Vec *work) {
+    if (!mtx || !poly || !vec || !result || !work || poly->degree < 0 || !poly->coeffs || result == vec) {
+        rc_set_err_msg("Invalid argument(s) provided to csr_matrix_poly_apply");
+        return RC_INVALID_ARG_ERR;
+    }
+
+    if (mtx->m != mtx->n || !mtx->is_real || !prv_csr_matrix_is_compatible_with_vec(mtx, vec) || vec_size(result) != mtx->m || !result->is_real ||
+        vec_size(&work[0]) != mtx->m || !work[0].is_real || vec_size(&work[1]) != mtx->m || !work[1].is_real) {
+        rc_set_err_msg("Incompatible matrix and vector dimensions or types in csr_matrix_poly_apply");
+        return RC_INVALID_ARG_ERR;
+    }
+
+    const double *x = arena_get_ptr(&vec->val);
+    double *y = arena_get_ptr(&result->val);
+    double *spare = arena_get_ptr(&work[1].val);
+
+    if (poly->degree == 0) {
+        for (int i = 0; i < mtx->m; ++i)
+            y[i] = poly->coeffs[0] * x[i];
+        return RC_OK;
+    }
+
+    struct CsrPolyStep step = {
+        .mtx = mtx,
+        .poly = poly,
+        .k = 0,
+        .x = x,
+        .prev = x,
+        .cur = x,
+        .next = arena_get_ptr(&work[0].val),
+        .y = y,
+    };
+
+#ifdef CONFIG_ENABLE_OMP_PARALLELISM
+    /*! One region for all the degrees: the threads only meet at a barrier between two */
+#pragma omp parallel firstprivate(step)
+    {
+        const int tid = omp_get_thread_num();
+        const int threads = omp_get_num_threads();
+        const int row_begin = partition_nnz_bound(mtx, tid, threads);
+        const int row_end = partition_nnz_bound(mtx, tid + 1, threads);
+
+        while (step.k < poly->degree) {
+            prv_csr_poly_rows(&step, row_begin, row_end);
+            prv_csr_poly_next(&step, spare);
+#pragma omp barrier
+        }
+    }
+    return RC_OK;
+#endif /*! CONFIG_ENABLE_OMP_PARALLELISM */
+
+#ifdef CONFIG_ENABLE_PTHREADS_PARALLELISM
+    struct ThreadPool *pool = pool_get_default();
+    if (pool && pool->threads > 1) {
+        for (int res; step.k < poly->degree; prv_csr_poly_next(&step, spare))
+            if ((res = pool_run(pool, prv_csr_poly_pool_task, &step)) != RC_OK)
+                return res;
+        return RC_OK;
+    }
+#endif /*! CONFIG_ENABLE_PTHREADS_PARALLELISM */
+
+    for (; step.k < poly->degree; prv_csr_poly_next(&step, spare))
+        prv_csr_poly_rows(&step, 0, mtx->m);
+    return RC_OK;
+}
+
+int csr_kernel_from_str(const char *str, enum CsrKernel *kernel) {
+    if (!str || !kernel) {
+        rc_set_err_msg("Invalid NULL argument(s) provided to csr_kernel_from_str");
+        return RC_INVALID_ARG_ERR;
+    }
+
+    for (int i = 0; i < CSR_KERNEL_COUNT; ++i) {
+        if (strcmp(str, csr_kernel_to_str((enum CsrKernel)i)) == 0) {
+            *kernel = (enum CsrKernel)i;
+            return RC_OK;
+        }
+    }
+
+    rc_set_err_msg("Unknown kernel '%s'", str);
+    return RC_INVALID_ARG_ERR;
+}
+
+const char *csr_kernel_to_str(enum CsrKernel kernel) {
+    switch (kernel) {
+        case CSR_KERNEL_AUTO:
+            return "auto";
+        case CSR_KERNEL_GATHER:
+            return "gather";
+        case CSR_KERNEL_LANES:
+            return "lanes";
+        case CSR_KERNEL_PREFETCH:
+            return "prefetch";
+        default:
+            return "unknown";
+    }
+}
+
+void csr_set_kernel(enum CsrKernel kernel) {
+    g_csr_kernel = kernel;
+}
+
+enum CsrKernel csr_get_kernel(void) {
+    return g_csr_kernel;
+}
+
+enum CsrKernel csr_matrix_get_kernel(const struct CsrMatrix *mtx) {
+    if (prv_csr_get_simd_kernel(mtx))
+        return g_csr_kernel;
+    return prv_csr_get_simd_int_kernel(mtx) ? CSR_KERNEL_GATHER : CSR_KERNEL_AUTO;
+}
@@ -0,0 +1,86 @@
+/*!
+ * \file            deque.c
+ * \date            2026-10-18
+ * \author          Mirko Lana [lana.mirko@icloud.com]
+ *
+ * \brief           Lock-free Chase-Lev work-stealing deque.
+ */
+
+#include "deque.h"
+#include "rc.h"
+#include "arena.h"
+
+int deque_init(struct WsDeque *dq, int capacity, struct ArenaHandler *arena) {
+    if (!dq || !arena || capacity < 1) {
+        rc_set_err_msg("Invalid argument(s) provided to deque_init");
+        return RC_INVALID_ARG_ERR;
+    }
+
+    dq->capacity = capacity;
+    enum ArenaReturnCode res = arena_calloc(arena, sizeof(atomic_int), capacity, &dq->buf);
+    if (res != ARENA_RC_OK) {
+        rc_set_err_msg("Memory array allocation failed in deque_init");
+        return RC_MEM_ALLOC_ERR;
+    }
+
+    atomic_init(&dq->top, 0);
+    atomic_init(&dq->bottom, 0);
+
+    return RC_OK;
+}
+
+void deque_reset(struct WsDeque *dq) {
+    atomic_store_explicit(&dq->top, 0, memory_order_relaxed);
+    atomic_store_explicit(&dq->bottom, 0, memory_order_relaxed);
+}
+
+bool deque_push(struct WsDeque *dq, int item) {
+    long b = atomic_load_explicit(&dq->bottom, memory_order_relaxed);
+    if (b >= dq->capacity)
+        return false;
+
+    atomic_int *buf = arena_get_ptr(&dq->buf);
+    atomic_store_explicit(&buf[b], item, memory_order_relaxed);
+    atomic_thread_fence(memory_order_release);
+    atomic_store_explicit(&dq->bottom, b + 1, memory_order_relaxed);
+
+    return true;
+}
+
+bool deque_pop(struct WsDeque *dq, int *item) {
+    long b = atomic_load_explicit(&dq->bottom, memory_order_relaxed) - 1;
+    atomic_store_explicit(&dq->bottom, b, memory_order_relaxed);
+    atomic_thread_fence(memory_order_seq_cst);
+    long t = atomic_load_explicit(&dq->top, memory_order_relaxed);
+
+    if (t > b) {
+        /*! Empty */
+        atomic_store_explicit(&dq->bottom, b + 1, memory_order_relaxed);
+        return false;
+    }
+
+    atomic_int *buf = arena_get_ptr(&dq->buf);
+    *item = atomic_load_explicit(&buf[b], memory_order_relaxed);
+    if (t < b)
+        return true;
+
+    /*! Last item: race against the thieves */
+    bool won = atomic_compare_exchange_strong_explicit(&dq->top, &t, t + 1, memory_order_seq_cst, memory_order_relaxed);
+    atomic_store_explicit(&dq->bottom, b + 1, memory_order_relaxed);
+
+    return won;
+}
+
+bool deque_steal(struct WsDeque *dq, int *item) {
+    long t = atomic_load_explicit(&dq->top, memory_order_acquire);
+    atomic_thread_fence(memory_order_seq_cst);
+    long b = atomic_load_explicit(&dq->bottom, memory_order_acquire);
+
+    if (t >= b)
+        return false;
+
+    atomic_int *buf = arena_get_ptr(&dq->buf);
+    *item = atomic_load_explicit(&buf[t], memory_order_relaxed);
+
+    return atomic_compare_exchange_strong_explicit(&dq->top, &t, t + 1, memory_order_seq_cst, memory_order_relaxed);
+}
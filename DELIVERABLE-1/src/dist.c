@@ -0,0 +1,731 @@
+/*!
+ * \file            dist.c
+ * \date            2026-10-18
+ * \author          Mirko Lana [lana.mirko@icloud.com]
+ *
+ * \brief           Distributed-memory SpMV over MPI ranks (row partitioning and halo exchange).
+ */
+
+#include "config.h"
+#include "dist.h"
+#include "rc.h"
+#include "arena.h"
+#include "coo.h"
+#include "csr.h"
+#include "mmio.h"
+#include "vec.h"
+#include "slog.h"
+#include "utils.h"
+
+#ifdef CONFIG_ENABLE_MPI
+
+#include <errno.h>
+#include <limits.h>
+#include <mpi.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define PRV_DIST_TAG 91 /*!< Tag of the halo messages. */
+
+/*!
+ * \brief           Structure containing the entries of a matrix held by a rank.
+ */
+struct DistEntries {
+    int nz;              /*< Number of entries */
+    struct ArenaObj row; /*< Global row of each entry */
+    struct ArenaObj col; /*< Global column of each entry */
+    struct ArenaObj val; /*< Value of each entry (double or int) */
+};
+
+/*!
+ * \brief           Make every rank fail when one of them did.
+ *
+ * \details         Called before the collectives following a step that may
+ *                  fail on some ranks only, which would leave the others
+ *                  waiting forever.
+ *
+ * \param[in]       res: Result of the step on the calling rank.
+ * \return          res if it is an error, RC_FAIL if another rank failed, RC_OK otherwise.
+ */
+static int prv_dist_agree(int res) {
+    int failed = res != RC_OK;
+    if (MPI_Allreduce(MPI_IN_PLACE, &failed, 1, MPI_INT, MPI_MAX, MPI_COMM_WORLD) != MPI_SUCCESS) {
+        rc_set_err_msg("MPI_Allreduce failed in dist_matrix_load");
+        return RC_FAIL;
+    }
+    if (res != RC_OK)
+        return res;
+    if (failed) {
+        rc_set_err_msg("Another rank failed to load its part of the matrix");
+        return RC_FAIL;
+    }
+    return RC_OK;
+}
+
+/*!
+ * \brief           Allocate arrays of the arena, stopping at the first failure.
+ *
+ * \param[out]      arena: Pointer to the arena handler for memory allocation.
+ * \param[in]       size: Size of an item.
+ * \param[in]       count: Number of items (at least one is allocated).
+ * \param[out]      obj: Pointer to the array.
+ * \param[in,out]   res: Result of the previous allocations, RC_MEM_ALLOC_ERR after a failure.
+ */
+static void prv_dist_calloc(struct ArenaHandler *arena, size_t size, size_t count, struct ArenaObj *obj, int *res) {
+    if (*res != RC_OK)
+        return;
+    if (arena_calloc(arena, size, GET_MAX(count, 1U), obj) != ARENA_RC_OK) {
+        rc_set_err_msg("Memory array allocation failed in dist_matrix_load");
+        *res = RC_MEM_ALLOC_ERR;
+    }
+}
+
+/*!
+ * \brief           Find the rank owning an index.
+ *
+ * \param[in]       bounds: First index of each rank (ranks + 1 items).
+ * \param[in]       ranks: Number of ranks.
+ * \param[in]       idx: Row or column index.
+ * \return          The last rank whose first index is not after idx.
+ */
+static int prv_dist_owner(const int *bounds, int ranks, int idx) {
+    int lo = 0;
+    int hi = ranks - 1;
+    while (lo < hi) {
+        int mid = (lo + hi + 1) / 2;
+        if (bounds[mid] <= idx)
+            lo = mid;
+        else
+            hi = mid - 1;
+    }
+    return lo;
+}
+
+/*!
+ * \brief           Compare two ints (qsort and bsearch).
+ */
+static int prv_dist_cmp_int(const void *a, const void *b) {
+    int x = *(const int *)a;
+    int y = *(const int *)b;
+    return (x > y) - (x < y);
+}
+
+/*!
+ * \brief           Read the entries of the slice of the file of the calling rank.
+ *
+ * \details         The data lines are split in ranks slices of about the same
+ *                  number of bytes; a line belongs to the slice holding its
+ *                  first byte. The slice is read twice: once to count its
+ *                  lines, once to parse them.
+ *
+ * \param[in,out]   dm: Pointer to the distributed matrix (sizes and kind are set).
+ * \param[in]       filename: Path to the Matrix Market file.
+ * \param[out]      entries: Pointer to the entries read.
+ * \param[out]      arena: Pointer to the arena handler for memory allocation.
+ * \return          RC_OK on success, an error code otherwise.
+ */
+static int prv_dist_read_slice(struct DistMatrix *dm, const char *filename, struct DistEntries *entries, struct ArenaHandler *arena) {
+    MM_typecode matcode;
+    FILE *fp = fopen(filename, "r");
+    if (!fp) {
+        rc_set_err_msg("Invalid file name provided to fopen - %s", strerror(errno));
+        return RC_FILE_IO_ERR;
+    }
+
+    int m, n, nz;
+    if (mm_read_banner(fp, &matcode) != RC_OK || !mm_is_matrix(matcode) || !mm_is_sparse(matcode) ||
+        !(mm_is_real(matcode) || mm_is_integer(matcode)) || mm_read_mtx_crd_size(fp, &m, &n, &nz) != RC_OK) {
+        fclose(fp);
+        rc_set_err_msg("Market Matrix file [%s] not supported or invalid", filename);
+        return RC_FILE_INVALID_FMT_ERR;
+    }
+    dm->m = m;
+    dm->n = n;
+    dm->nz = nz;
+    dm->is_real = mm_is_real(matcode);
+
+    long data = ftell(fp);
+    fseek(fp, 0, SEEK_END);
+    long size = ftell(fp) - data;
+    long begin = data + (long)((long long)size * dm->rank / dm->ranks);
+    long end = data + (long)((long long)size * (dm->rank + 1) / dm->ranks);
+
+    /*! Skip the line started by the previous slice, unless the slice starts a line */
+    char line[256];
+    if (dm->rank > 0) {
+        fseek(fp, begin - 1, SEEK_SET);
+        if (fgetc(fp) != '\n' && !fgets(line, sizeof(line), fp))
+            begin = end;
+        else
+            begin = ftell(fp);
+    }
+
+    int count = 0;
+    fseek(fp, begin, SEEK_SET);
+    while (ftell(fp) < end && fgets(line, sizeof(line), fp))
+        count += line[strspn(line, " \t\r\n")] != '\0';
+
+    int res = RC_OK;
+    entries->nz = count;
+    prv_dist_calloc(arena, sizeof(int), (size_t)count, &entries->row, &res);
+    prv_dist_calloc(arena, sizeof(int), (size_t)count, &entries->col, &res);
+    prv_dist_calloc(arena, dm->is_real ? sizeof(double) : sizeof(int), (size_t)count, &entries->val, &res);
+    if (res != RC_OK) {
+        fclose(fp);
+        return res;
+    }
+
+    int *row = arena_get_ptr(&entries->row);
+    int *col = arena_get_ptr(&entries->col);
+    void *val = arena_get_ptr(&entries->val);
+    int k = 0;
+    fseek(fp, begin, SEEK_SET);
+    while (k < count && ftell(fp) < end && fgets(line, sizeof(line), fp)) {
+        if (line[strspn(line, " \t\r\n")] == '\0')
+            continue;
+
+        int parsed = dm->is_real ? sscanf(line, "%d %d %lg", &row[k], &col[k], &((double *)val)[k]) : sscanf(line, "%d %d %d", &row[k], &col[k], &((int *)val)[k]);
+        row[k]--;
+        col[k]--;
+        if (parsed != 3 || row[k] < 0 || row[k] >= m || col[k] < 0 || col[k] >= n) {
+            fclose(fp);
+            rc_set_err_msg("Invalid Matrix Market entry: %s", line);
+            return RC_FILE_INVALID_FMT_ERR;
+        }
+        k++;
+    }
+
+    fclose(fp);
+    return RC_OK;
+}
+
+/*!
+ * \brief           Split the rows and the vector items of a matrix among the ranks.
+ *
+ * \details         Rows go in nnz-balanced parts, from the counts per row
+ *                  summed over the ranks. Vector items follow the row bounds
+ *                  for square matrices, an even split otherwise.
+ *
+ * \param[in,out]   dm: Pointer to the distributed matrix.
+ * \param[in]       entries: Pointer to the entries read by the rank.
+ * \param[out]      arena: Pointer to the arena handler for memory allocation.
+ * \return          RC_OK on success, an error code otherwise.
+ */
+static int prv_dist_partition(struct DistMatrix *dm, const struct DistEntries *entries, struct ArenaHandler *arena) {
+    struct ArenaObj counts_obj;
+    int res = RC_OK;
+    prv_dist_calloc(arena, sizeof(int), (size_t)dm->m, &counts_obj, &res);
+    prv_dist_calloc(arena, sizeof(int), (size_t)dm->ranks + 1, &dm->row_bounds, &res);
+    prv_dist_calloc(arena, sizeof(int), (size_t)dm->ranks + 1, &dm->col_bounds, &res);
+    res = prv_dist_agree(res);
+    if (res != RC_OK)
+        return res;
+
+    int *counts = arena_get_ptr(&counts_obj);
+    const int *row = arena_get_ptr(&entries->row);
+    for (int k = 0; k < entries->nz; ++k)
+        counts[row[k]]++;
+    if (MPI_Allreduce(MPI_IN_PLACE, counts, dm->m, MPI_INT, MPI_SUM, MPI_COMM_WORLD) != MPI_SUCCESS) {
+        rc_set_err_msg("MPI_Allreduce failed in dist_matrix_load");
+        return RC_FAIL;
+    }
+
+    /*! Same walk on every rank: rank r starts at the first row reaching r / ranks of the non-zeros */
+    int *row_bounds = arena_get_ptr(&dm->row_bounds);
+    int *col_bounds = arena_get_ptr(&dm->col_bounds);
+    long long prefix = 0;
+    int i = 0;
+    for (int r = 1; r < dm->ranks; ++r) {
+        long long target = dm->nz * r / dm->ranks;
+        while (i < dm->m && prefix < target)
+            prefix += counts[i++];
+        row_bounds[r] = i;
+    }
+    row_bounds[dm->ranks] = dm->m;
+
+    for (int r = 0; r <= dm->ranks; ++r)
+        col_bounds[r] = dm->m == dm->n ? row_bounds[r] : (int)((long long)dm->n * r / dm->ranks);
+
+    dm->row_begin = row_bounds[dm->rank];
+    dm->row_end = row_bounds[dm->rank + 1];
+    dm->col_begin = col_bounds[dm->rank];
+    dm->col_end = col_bounds[dm->rank + 1];
+    return RC_OK;
+}
+
+/*!
+ * \brief           Send each entry to the rank owning its row.
+ *
+ * \param[in]       dm: Pointer to the distributed matrix (partitioned).
+ * \param[in]       sent: Pointer to the entries read by the rank.
+ * \param[out]      owned: Pointer to the entries of the rows of the rank.
+ * \param[out]      arena: Pointer to the arena handler for memory allocation.
+ * \return          RC_OK on success, an error code otherwise.
+ */
+static int prv_dist_exchange(const struct DistMatrix *dm, const struct DistEntries *sent, struct DistEntries *owned, struct ArenaHandler *arena) {
+    const size_t val_size = dm->is_real ? sizeof(double) : sizeof(int);
+    struct ArenaObj counts_obj, packed_row, packed_col, packed_val;
+    int res = RC_OK;
+    prv_dist_calloc(arena, sizeof(int), 4 * (size_t)dm->ranks, &counts_obj, &res);
+    prv_dist_calloc(arena, sizeof(int), (size_t)sent->nz, &packed_row, &res);
+    prv_dist_calloc(arena, sizeof(int), (size_t)sent->nz, &packed_col, &res);
+    prv_dist_calloc(arena, val_size, (size_t)sent->nz, &packed_val, &res);
+    res = prv_dist_agree(res);
+    if (res != RC_OK)
+        return res;
+
+    int *send_counts = arena_get_ptr(&counts_obj);
+    int *send_displs = send_counts + dm->ranks;
+    int *recv_counts = send_displs + dm->ranks;
+    int *recv_displs = recv_counts + dm->ranks;
+    const int *row_bounds = arena_get_ptr(&dm->row_bounds);
+    const int *row = arena_get_ptr(&sent->row);
+
+    for (int k = 0; k < sent->nz; ++k)
+        send_counts[prv_dist_owner(row_bounds, dm->ranks, row[k])]++;
+    if (MPI_Alltoall(send_counts, 1, MPI_INT, recv_counts, 1, MPI_INT, MPI_COMM_WORLD) != MPI_SUCCESS) {
+        rc_set_err_msg("MPI_Alltoall failed in dist_matrix_load");
+        return RC_FAIL;
+    }
+
+    long long total = 0;
+    for (int r = 0; r < dm->ranks; ++r) {
+        send_displs[r] = r == 0 ? 0 : send_displs[r - 1] + send_counts[r - 1];
+        recv_displs[r] = (int)total;
+        total += recv_counts[r];
+    }
+    if (total > INT_MAX) {
+        rc_set_err_msg("Too many non-zeros for one rank (%lld), use more ranks", total);
+        res = RC_MEM_ALLOC_ERR;
+    }
+
+    owned->nz = (int)GET_MIN(total, (long long)INT_MAX);
+    prv_dist_calloc(arena, sizeof(int), (size_t)owned->nz, &owned->row, &res);
+    prv_dist_calloc(arena, sizeof(int), (size_t)owned->nz, &owned->col, &res);
+    prv_dist_calloc(arena, val_size, (size_t)owned->nz, &owned->val, &res);
+    res = prv_dist_agree(res);
+    if (res != RC_OK)
+        return res;
+
+    /*! Pack the entries by destination rank (the displacements are used as insertion points, then restored) */
+    row = arena_get_ptr(&sent->row);
+    const int *col = arena_get_ptr(&sent->col);
+    const char *val = arena_get_ptr(&sent->val);
+    int *p_row = arena_get_ptr(&packed_row);
+    int *p_col = arena_get_ptr(&packed_col);
+    char *p_val = arena_get_ptr(&packed_val);
+    send_counts = arena_get_ptr(&counts_obj);
+    send_displs = send_counts + dm->ranks;
+    recv_counts = send_displs + dm->ranks;
+    recv_displs = recv_counts + dm->ranks;
+    row_bounds = arena_get_ptr(&dm->row_bounds);
+
+    for (int k = 0; k < sent->nz; ++k) {
+        int pos = send_displs[prv_dist_owner(row_bounds, dm->ranks, row[k])]++;
+        p_row[pos] = row[k];
+        p_col[pos] = col[k];
+        memcpy(p_val + (size_t)pos * val_size, val + (size_t)k * val_size, val_size);
+    }
+    for (int r = 0; r < dm->ranks; ++r)
+        send_displs[r] -= send_counts[r];
+
+    MPI_Datatype type = dm->is_real ? MPI_DOUBLE : MPI_INT;
+    if (MPI_Alltoallv(p_row, send_counts, send_displs, MPI_INT, arena_get_ptr(&owned->row), recv_counts, recv_displs, MPI_INT, MPI_COMM_WORLD) != MPI_SUCCESS ||
+        MPI_Alltoallv(p_col, send_counts, send_displs, MPI_INT, arena_get_ptr(&owned->col), recv_counts, recv_displs, MPI_INT, MPI_COMM_WORLD) != MPI_SUCCESS ||
+        MPI_Alltoallv(p_val, send_counts, send_displs, type, arena_get_ptr(&owned->val), recv_counts, recv_displs, type, MPI_COMM_WORLD) != MPI_SUCCESS) {
+        rc_set_err_msg("MPI_Alltoallv failed in dist_matrix_load");
+        return RC_FAIL;
+    }
+
+    return RC_OK;
+}
+
+/*!
+ * \brief           Build the local and remote blocks of the rows of the rank.
+ *
+ * \details         The remote columns are renumbered by their position in the
+ *                  sorted list of the halo items. The entries of both blocks
+ *                  are grouped by row, so that their CSR share the COO arrays.
+ *
+ * \param[in,out]   dm: Pointer to the distributed matrix.
+ * \param[in]       owned: Pointer to the entries of the rows of the rank.
+ * \param[out]      halo_cols: Pointer to the sorted global columns of the halo.
+ * \param[out]      arena: Pointer to the arena handler for memory allocation.
+ * \return          RC_OK on success, an error code otherwise.
+ */
+static int prv_dist_build_blocks(struct DistMatrix *dm, const struct DistEntries *owned, struct ArenaObj *halo_cols, struct ArenaHandler *arena) {
+    const size_t val_size = dm->is_real ? sizeof(double) : sizeof(int);
+    const int rows = dm->row_end - dm->row_begin;
+    const int *col = arena_get_ptr(&owned->col);
+
+    int local_nz = 0;
+    for (int k = 0; k < owned->nz; ++k)
+        local_nz += col[k] >= dm->col_begin && col[k] < dm->col_end;
+    const int remote_nz = owned->nz - local_nz;
+
+    struct CooMatrix local = { .m = rows, .n = dm->col_end - dm->col_begin, .nz = local_nz, .is_real = dm->is_real };
+    struct CooMatrix remote = { .m = rows, .n = 0, .nz = remote_nz, .is_real = dm->is_real };
+    struct ArenaObj next_obj;
+    int res = RC_OK;
+    prv_dist_calloc(arena, sizeof(int), (size_t)remote_nz, halo_cols, &res);
+    prv_dist_calloc(arena, sizeof(int), 2 * ((size_t)rows + 1), &next_obj, &res);
+    prv_dist_calloc(arena, sizeof(int), (size_t)local_nz, &local.row, &res);
+    prv_dist_calloc(arena, sizeof(int), (size_t)local_nz, &local.col, &res);
+    prv_dist_calloc(arena, val_size, (size_t)local_nz, &local.val, &res);
+    prv_dist_calloc(arena, sizeof(int), (size_t)remote_nz, &remote.row, &res);
+    prv_dist_calloc(arena, sizeof(int), (size_t)remote_nz, &remote.col, &res);
+    prv_dist_calloc(arena, val_size, (size_t)remote_nz, &remote.val, &res);
+    if (res != RC_OK)
+        return res;
+
+    /*! Halo: the distinct remote columns, sorted (hence grouped by owner) */
+    const int *row = arena_get_ptr(&owned->row);
+    const char *val = arena_get_ptr(&owned->val);
+    int *halo = arena_get_ptr(halo_cols);
+    col = arena_get_ptr(&owned->col);
+    int h = 0;
+    for (int k = 0; k < owned->nz; ++k)
+        if (col[k] < dm->col_begin || col[k] >= dm->col_end)
+            halo[h++] = col[k];
+    qsort(halo, (size_t)h, sizeof(int), prv_dist_cmp_int);
+    dm->halo = 0;
+    for (int k = 0; k < h; ++k)
+        if (k == 0 || halo[k] != halo[k - 1])
+            halo[dm->halo++] = halo[k];
+    remote.n = dm->halo;
+
+    /*! Counting sort of the entries of both blocks by local row */
+    int *local_next = arena_get_ptr(&next_obj);
+    int *remote_next = local_next + rows + 1;
+    for (int k = 0; k < owned->nz; ++k) {
+        bool is_local = col[k] >= dm->col_begin && col[k] < dm->col_end;
+        (is_local ? local_next : remote_next)[row[k] - dm->row_begin + 1]++;
+    }
+    for (int i = 0; i < rows; ++i) {
+        local_next[i + 1] += local_next[i];
+        remote_next[i + 1] += remote_next[i];
+    }
+
+    int *l_row = arena_get_ptr(&local.row);
+    int *l_col = arena_get_ptr(&local.col);
+    char *l_val = arena_get_ptr(&local.val);
+    int *r_row = arena_get_ptr(&remote.row);
+    int *r_col = arena_get_ptr(&remote.col);
+    char *r_val = arena_get_ptr(&remote.val);
+    for (int k = 0; k < owned->nz; ++k) {
+        const int i = row[k] - dm->row_begin;
+        int pos;
+        if (col[k] >= dm->col_begin && col[k] < dm->col_end) {
+            pos = local_next[i]++;
+            l_row[pos] = i;
+            l_col[pos] = col[k] - dm->col_begin;
+            memcpy(l_val + (size_t)pos * val_size, val + (size_t)k * val_size, val_size);
+        } else {
+            pos = remote_next[i]++;
+            r_row[pos] = i;
+            r_col[pos] = (int)((const int *)bsearch(&col[k], halo, (size_t)dm->halo, sizeof(int), prv_dist_cmp_int) - halo);
+            memcpy(r_val + (size_t)pos * val_size, val + (size_t)k * val_size, val_size);
+        }
+    }
+
+    res = csr_matrix_from_coo(&dm->local, &local, arena);
+    if (res == RC_OK && dm->halo > 0)
+        res = csr_matrix_from_coo(&dm->remote, &remote, arena);
+    return res;
+}
+
+/*!
+ * \brief           Compute the communication pattern of the halo.
+ *
+ * \details         Each rank tells the owners of its halo items which ones it
+ *                  reads; in return it learns which of its items to send, and
+ *                  to whom.
+ *
+ * \param[in,out]   dm: Pointer to the distributed matrix.
+ * \param[in]       halo_cols: Pointer to the sorted global columns of the halo.
+ * \param[out]      arena: Pointer to the arena handler for memory allocation.
+ * \return          RC_OK on success, an error code otherwise.
+ */
+static int prv_dist_plan_halo(struct DistMatrix *dm, const struct ArenaObj *halo_cols, struct ArenaHandler *arena) {
+    struct ArenaObj counts_obj;
+    int res = RC_OK;
+    prv_dist_calloc(arena, sizeof(int), 4 * (size_t)dm->ranks, &counts_obj, &res);
+    res = prv_dist_agree(res);
+    if (res != RC_OK)
+        return res;
+
+    int *want_counts = arena_get_ptr(&counts_obj);
+    int *want_displs = want_counts + dm->ranks;
+    int *give_counts = want_displs + dm->ranks;
+    int *give_displs = give_counts + dm->ranks;
+    const int *col_bounds = arena_get_ptr(&dm->col_bounds);
+    const int *halo = arena_get_ptr(halo_cols);
+
+    for (int k = 0; k < dm->halo; ++k)
+        want_counts[prv_dist_owner(col_bounds, dm->ranks, halo[k])]++;
+    if (MPI_Alltoall(want_counts, 1, MPI_INT, give_counts, 1, MPI_INT, MPI_COMM_WORLD) != MPI_SUCCESS) {
+        rc_set_err_msg("MPI_Alltoall failed in dist_matrix_load");
+        return RC_FAIL;
+    }
+
+    dm->sends = 0;
+    dm->recv_peers = 0;
+    dm->send_peers = 0;
+    for (int r = 0; r < dm->ranks; ++r) {
+        want_displs[r] = r == 0 ? 0 : want_displs[r - 1] + want_counts[r - 1];
+        give_displs[r] = dm->sends;
+        dm->sends += give_counts[r];
+        dm->recv_peers += want_counts[r] > 0;
+        dm->send_peers += give_counts[r] > 0;
+    }
+
+    prv_dist_calloc(arena, sizeof(int), (size_t)dm->recv_peers, &dm->recv_rank, &res);
+    prv_dist_calloc(arena, sizeof(int), (size_t)dm->recv_peers + 1, &dm->recv_offset, &res);
+    prv_dist_calloc(arena, sizeof(int), (size_t)dm->send_peers, &dm->send_rank, &res);
+    prv_dist_calloc(arena, sizeof(int), (size_t)dm->send_peers + 1, &dm->send_offset, &res);
+    prv_dist_calloc(arena, sizeof(int), (size_t)dm->sends, &dm->send_idx, &res);
+    prv_dist_calloc(arena, dm->is_real ? sizeof(double) : sizeof(int), (size_t)dm->sends, &dm->send_buf, &res);
+    prv_dist_calloc(arena, sizeof(MPI_Request), (size_t)dm->recv_peers + (size_t)dm->send_peers, &dm->requests, &res);
+    res = prv_dist_agree(res);
+    if (res != RC_OK)
+        return res;
+
+    want_counts = arena_get_ptr(&counts_obj);
+    want_displs = want_counts + dm->ranks;
+    give_counts = want_displs + dm->ranks;
+    give_displs = give_counts + dm->ranks;
+    int *send_idx = arena_get_ptr(&dm->send_idx);
+    if (MPI_Alltoallv(arena_get_ptr(halo_cols), want_counts, want_displs, MPI_INT, send_idx, give_counts, give_displs, MPI_INT, MPI_COMM_WORLD) != MPI_SUCCESS) {
+        rc_set_err_msg("MPI_Alltoallv failed in dist_matrix_load");
+        return RC_FAIL;
+    }
+    for (int k = 0; k < dm->sends; ++k)
+        send_idx[k] -= dm->col_begin;
+
+    int *recv_rank = arena_get_ptr(&dm->recv_rank);
+    int *recv_offset = arena_get_ptr(&dm->recv_offset);
+    int *send_rank = arena_get_ptr(&dm->send_rank);
+    int *send_offset = arena_get_ptr(&dm->send_offset);
+    int p = 0;
+    int q = 0;
+    for (int r = 0; r < dm->ranks; ++r) {
+        if (want_counts[r] > 0) {
+            recv_rank[p] = r;
+            recv_offset[p++] = want_displs[r];
+        }
+        if (give_counts[r] > 0) {
+            send_rank[q] = r;
+            send_offset[q++] = give_displs[r];
+        }
+    }
+    recv_offset[p] = dm->halo;
+    send_offset[q] = dm->sends;
+
+    return RC_OK;
+}
+
+int dist_rank(void) {
+    int rank = 0;
+    MPI_Comm_rank(MPI_COMM_WORLD, &rank);
+    return rank;
+}
+
+int dist_ranks(void) {
+    int ranks = 1;
+    MPI_Comm_size(MPI_COMM_WORLD, &ranks);
+    return ranks;
+}
+
+double dist_max(double val) {
+    double max = val;
+    MPI_Allreduce(&val, &max, 1, MPI_DOUBLE, MPI_MAX, MPI_COMM_WORLD);
+    return max;
+}
+
+int dist_matrix_load(struct DistMatrix *dm, const char *filename, struct ArenaHandler *arena) {
+    SLOG_DEBUG("Entering dist_matrix_load");
+    if (!dm || !filename || !arena) {
+        rc_set_err_msg("Invalid NULL argument(s) provided to dist_matrix_load");
+        return RC_INVALID_ARG_ERR;
+    }
+
+    *dm = (struct DistMatrix){ .rank = dist_rank(), .ranks = dist_ranks() };
+
+    struct DistEntries sent, owned;
+    struct ArenaObj halo_cols;
+    int res = prv_dist_agree(prv_dist_read_slice(dm, filename, &sent, arena));
+    if (res == RC_OK)
+        res = prv_dist_partition(dm, &sent, arena);
+    if (res == RC_OK)
+        res = prv_dist_exchange(dm, &sent, &owned, arena);
+    if (res == RC_OK)
+        res = prv_dist_agree(prv_dist_build_blocks(dm, &owned, &halo_cols, arena));
+    if (res == RC_OK)
+        res = prv_dist_plan_halo(dm, &halo_cols, arena);
+    if (res != RC_OK)
+        return res;
+
+    res = vec_init(&dm->halo_vec, GET_MAX(dm->halo, 1), dm->is_real, arena);
+    if (res == RC_OK)
+        res = vec_init(&dm->remote_result, dm->row_end - dm->row_begin, dm->is_real, arena);
+    if (res != RC_OK)
+        return res;
+    dm->halo_vec.n = dm->halo;
+
+    SLOG_INFO("Rank %d/%d: rows [%d, %d), %d local and %d remote non-zeros, halo of %d items from %d ranks, %d items sent to %d ranks",
+              dm->rank,
+              dm->ranks,
+              dm->row_begin,
+              dm->row_end,
+              dm->local.nz,
+              dm->halo > 0 ? dm->remote.nz : 0,
+              dm->halo,
+              dm->recv_peers,
+              dm->sends,
+              dm->send_peers);
+    return RC_OK;
+}
+
+int dist_matrix_mul_vec(struct DistMatrix *dm, const struct Vec *vec, struct Vec *result) {
+    if (!dm || !vec || !result) {
+        rc_set_err_msg("Invalid NULL argument(s) provided to dist_matrix_mul_vec");
+        return RC_INVALID_ARG_ERR;
+    }
+
+    const int rows = dm->row_end - dm->row_begin;
+    if (vec->n != dm->col_end - dm->col_begin || vec_size(result) != rows || vec->is_real != dm->is_real || result->is_real != dm->is_real) {
+        rc_set_err_msg("Incompatible matrix and vector dimensions or types in dist_matrix_mul_vec");
+        return RC_INVALID_ARG_ERR;
+    }
+
+    const MPI_Datatype type = dm->is_real ? MPI_DOUBLE : MPI_INT;
+    const size_t val_size = dm->is_real ? sizeof(double) : sizeof(int);
+    MPI_Request *requests = arena_get_ptr(&dm->requests);
+    const int *recv_rank = arena_get_ptr(&dm->recv_rank);
+    const int *recv_offset = arena_get_ptr(&dm->recv_offset);
+    const int *send_rank = arena_get_ptr(&dm->send_rank);
+    const int *send_offset = arena_get_ptr(&dm->send_offset);
+    const int *send_idx = arena_get_ptr(&dm->send_idx);
+    char *halo = arena_get_ptr(&dm->halo_vec.val);
+    char *send_buf = arena_get_ptr(&dm->send_buf);
+    int ok = MPI_SUCCESS;
+
+    /*! Receives first, so that the messages of the other ranks land in place */
+    for (int p = 0; p < dm->recv_peers; ++p)
+        ok |= MPI_Irecv(halo + (size_t)recv_offset[p] * val_size, recv_offset[p + 1] - recv_offset[p], type, recv_rank[p], PRV_DIST_TAG, MPI_COMM_WORLD, &requests[p]);
+
+    if (dm->is_real) {
+        const double *x = arena_get_ptr(&vec->val);
+        for (int k = 0; k < dm->sends; ++k)
+            ((double *)send_buf)[k] = x[send_idx[k]];
+    } else {
+        const int *x = arena_get_ptr(&vec->val);
+        for (int k = 0; k < dm->sends; ++k)
+            ((int *)send_buf)[k] = x[send_idx[k]];
+    }
+    for (int q = 0; q < dm->send_peers; ++q)
+        ok |= MPI_Isend(send_buf + (size_t)send_offset[q] * val_size, send_offset[q + 1] - send_offset[q], type, send_rank[q], PRV_DIST_TAG, MPI_COMM_WORLD, &requests[dm->recv_peers + q]);
+
+    /*! The local block hides the exchange */
+    int res = csr_matrix_mul_vec(&dm->local, vec, result);
+
+    uint64_t start = utils_get_ns();
+    ok |= MPI_Waitall(dm->recv_peers, requests, MPI_STATUSES_IGNORE);
+    dm->wait_us += (double)(utils_get_ns() - start) / 1e3;
+
+    if (res == RC_OK && dm->halo > 0)
+        res = csr_matrix_mul_vec(&dm->remote, &dm->halo_vec, &dm->remote_result);
+    if (res == RC_OK && dm->halo > 0) {
+        if (dm->is_real) {
+            double *y = arena_get_ptr(&result->val);
+            const double *z = arena_get_ptr(&dm->remote_result.val);
+#pragma omp parallel for simd schedule(static)
+            for (int i = 0; i < rows; ++i)
+                y[i] += z[i];
+        } else {
+            int *y = arena_get_ptr(&result->val);
+            const int *z = arena_get_ptr(&dm->remote_result.val);
+#pragma omp parallel for schedule(static)
+            for (int i = 0; i < rows; ++i)
+                y[i] = (int)GET_MAX(GET_MIN((long long)y[i] + z[i], (long long)INT_MAX), (long long)INT_MIN);
+        }
+    }
+
+    ok |= MPI_Waitall(dm->send_peers, requests + dm->recv_peers, MPI_STATUSES_IGNORE);
+    if (ok != MPI_SUCCESS) {
+        rc_set_err_msg("Halo exchange failed in dist_matrix_mul_vec");
+        return RC_FAIL;
+    }
+
+    return res;
+}
+
+int dist_vec_gather(const struct DistMatrix *dm, const struct Vec *part, bool is_result, struct Vec *full) {
+    if (!dm || !part || (dm->rank == 0 && !full)) {
+        rc_set_err_msg("Invalid NULL argument(s) provided to dist_vec_gather");
+        return RC_INVALID_ARG_ERR;
+    }
+
+    /*! Point-to-point rather than MPI_Gatherv, whose counts would need an array per call */
+    const int *bounds = arena_get_ptr(is_result ? &dm->row_bounds : &dm->col_bounds);
+    const MPI_Datatype type = dm->is_real ? MPI_DOUBLE : MPI_INT;
+    const size_t val_size = dm->is_real ? sizeof(double) : sizeof(int);
+    int ok = MPI_SUCCESS;
+    if (dm->rank == 0) {
+        char *val = arena_get_ptr(&full->val);
+        memcpy(val, arena_get_ptr(&part->val), (size_t)part->n * val_size);
+        for (int r = 1; r < dm->ranks; ++r)
+            ok |= MPI_Recv(val + (size_t)bounds[r] * val_size, bounds[r + 1] - bounds[r], type, r, PRV_DIST_TAG, MPI_COMM_WORLD, MPI_STATUS_IGNORE);
+    } else {
+        ok |= MPI_Send(arena_get_ptr(&part->val), part->n, type, 0, PRV_DIST_TAG, MPI_COMM_WORLD);
+    }
+
+    if (ok != MPI_SUCCESS) {
+        rc_set_err_msg("Vector gather failed in dist_vec_gather");
+        return RC_FAIL;
+    }
+
+    return RC_OK;
+}
+
+#else
+
+int dist_rank(void) {
+    return 0;
+}
+
+int dist_ranks(void) {
+    return 1;
+}
+
+double dist_max(double val) {
+    return val;
+}
+
+int dist_matrix_load(struct DistMatrix *dm, const char *filename, struct ArenaHandler *arena) {
+    UNUSED(dm);
+    UNUSED(filename);
+    UNUSED(arena);
+    rc_set_err_msg("MPI support not compiled, rebuild with make MPI=1");
+    return RC_INVALID_ARG_ERR;
+}
+
+int dist_matrix_mul_vec(struct DistMatrix *dm, const struct Vec *vec, struct Vec *result) {
+    UNUSED(dm);
+    UNUSED(vec);
+    UNUSED(result);
+    rc_set_err_msg("MPI support not compiled, rebuild with make MPI=1");
+    return RC_INVALID_ARG_ERR;
+}
+
+int dist_vec_gather(const struct DistMatrix *dm, const struct Vec *part, bool is_result, struct Vec *full) {
+    UNUSED(dm);
+    UNUSED(part);
+    UNUSED(is_result);
+    UNUSED(full);
+    rc_set_err_msg("MPI support not compiled, rebuild with make MPI=1");
+    return RC_INVALID_ARG_ERR;
+}
+
+#endif /*! CONFIG_ENABLE_MPI */
@@ -0,0 +1,335 @@
+/*!
+ * \file            fpc.c
+ * \date            2026-10-18
+ * \author          Mirko Lana [lana.mirko@icloud.com]
+ *
+ * \brief           Lossless compression of CSR values decoded inside the SpMV.
+ */
+
+#include "config.h"
+#include "fpc.h"
+#include "rc.h"
+#include "arena.h"
+#include "csr.h"
+#include "vec.h"
+#include "partition.h"
+#include "pool.h"
+#include "slog.h"
+#include "utils.h"
+
+#include <stdint.h>
+#include <string.h>
+
+#ifdef CONFIG_ENABLE_OMP_PARALLELISM
+#include <omp.h>
+#endif /*! CONFIG_ENABLE_OMP_PARALLELISM */
+
+#if defined(__BYTE_ORDER__) && __BYTE_ORDER__ != __ORDER_LITTLE_ENDIAN__
+#error "The FPC decoder loads the stored bytes as little-endian words"
+#endif
+
+#define PRV_FPC_HDR_SIZE (CONFIG_FPC_BLOCK_NNZ / 2) /*!< Bytes of codes at the start of a block (two per byte) */
+#define PRV_FPC_PAD sizeof(uint64_t)                /*!< Slack after the stream: the decoder loads whole words */
+
+/*!
+ * \brief           Number of bytes stored for each code.
+ */
+static const uint8_t g_fpc_len[16] = { 0, 1, 2, 3, 4, 5, 6, 7, 8, 7, 6, 5, 4, 3, 2, 1 };
+
+/*!
+ * \brief           Left shift (in bits) placing the stored bytes of each code.
+ */
+static const uint8_t g_fpc_shift[16] = { 0, 0, 0, 0, 0, 0, 0, 0, 0, 8, 16, 24, 32, 40, 48, 56 };
+
+/*!
+ * \brief           Mask keeping the stored bytes of each code from a loaded word.
+ */
+static const uint64_t g_fpc_mask[16] = {
+    0x0ULL,
+    0xFFULL,
+    0xFFFFULL,
+    0xFFFFFFULL,
+    0xFFFFFFFFULL,
+    0xFFFFFFFFFFULL,
+    0xFFFFFFFFFFFFULL,
+    0xFFFFFFFFFFFFFFULL,
+    0xFFFFFFFFFFFFFFFFULL,
+    0xFFFFFFFFFFFFFFULL,
+    0xFFFFFFFFFFFFULL,
+    0xFFFFFFFFFFULL,
+    0xFFFFFFFFULL,
+    0xFFFFFFULL,
+    0xFFFFULL,
+    0xFFULL,
+};
+
+/*!
+ * \brief           Structure containing the state of a value decoder.
+ */
+struct FpcDecoder {
+    const uint8_t *codes; /*< Codes of the current block */
+    const uint8_t *pos;   /*< Next stored byte */
+    uint64_t prev;        /*< Previous value (bits) */
+    int idx;              /*< Index of the next value in the block */
+};
+
+/*!
+ * \brief           Structure containing the arguments of a Pthreads compressed SpMV.
+ */
+struct FpcPoolTask {
+    const struct FpcMatrix *fm; /*< Input matrix */
+    const struct Vec *vec;      /*< Input vector */
+    struct Vec *result;         /*< Result vector */
+};
+
+/*!
+ * \brief           Pick the code of a XORed value.
+ *
+ * \param[in]       xor: The value XORed with the previous one.
+ * \return          The code storing the fewest bytes.
+ */
+static int prv_fpc_code(uint64_t xor) {
+    if (xor == 0)
+        return 0;
+
+    int lead = 8 - __builtin_clzll(xor) / 8;  /*! Bytes kept dropping the leading zeros */
+    int trail = 8 - __builtin_ctzll(xor) / 8; /*! Bytes kept dropping the trailing zeros */
+    return trail < lead ? 16 - trail : lead;
+}
+
+/*!
+ * \brief           Compress the values of a matrix, or measure their compressed size.
+ *
+ * \param[in]       val: Values to compress.
+ * \param[in]       nz: Number of values.
+ * \param[out]      data: Compressed stream (zero-filled), NULL to only measure it.
+ * \param[out]      offsets: Offset of each block in the stream, NULL to only measure it.
+ * \return          The size of the compressed stream.
+ */
+static size_t prv_fpc_encode(const double *val, int nz, uint8_t *data, size_t *offsets) {
+    size_t pos = 0;
+    size_t block = 0;
+    uint64_t prev = 0;
+
+    for (int k = 0; k < nz; ++k) {
+        int idx = k % CONFIG_FPC_BLOCK_NNZ;
+        if (idx == 0) {
+            block = pos;
+            if (offsets)
+                offsets[k / CONFIG_FPC_BLOCK_NNZ] = pos;
+            pos += PRV_FPC_HDR_SIZE;
+            prev = 0; /*! Blocks are decoded independently */
+        }
+
+        uint64_t bits;
+        memcpy(&bits, &val[k], sizeof(bits));
+        uint64_t xor = bits ^ prev;
+        prev = bits;
+
+        int code = prv_fpc_code(xor);
+        if (data) {
+            data[block + idx / 2] |= (uint8_t)(code << ((idx & 1) * 4));
+            uint64_t stored = xor >> g_fpc_shift[code];
+            for (int b = 0; b < g_fpc_len[code]; ++b)
+                data[pos + b] = (uint8_t)(stored >> (8 * b));
+        }
+        pos += g_fpc_len[code];
+    }
+
+    return pos;
+}
+
+/*!
+ * \brief           Decode the next value of the current block.
+ *
+ * \param[in,out]   dec: Pointer to the decoder (not at the end of the block).
+ * \return          The value.
+ */
+static inline __attribute__((always_inline)) double prv_fpc_next(struct FpcDecoder *dec) {
+    int code = (dec->codes[dec->idx / 2] >> ((dec->idx & 1) * 4)) & 0xF;
+    uint64_t word;
+    memcpy(&word, dec->pos, sizeof(word));
+    dec->prev ^= (word & g_fpc_mask[code]) << g_fpc_shift[code];
+    dec->pos += g_fpc_len[code];
+    dec->idx++;
+
+    double v;
+    memcpy(&v, &dec->prev, sizeof(v));
+    return v;
+}
+
+/*!
+ * \brief           Move a decoder at the end of a block to the next one.
+ *
+ * \param[in,out]   dec: Pointer to the decoder.
+ */
+static inline void prv_fpc_next_block(struct FpcDecoder *dec) {
+    /*! Blocks are contiguous: the next one starts right after the stored bytes */
+    dec->codes = dec->pos;
+    dec->pos += PRV_FPC_HDR_SIZE;
+    dec->prev = 0;
+    dec->idx = 0;
+}
+
+/*!
+ * \brief           Position a decoder on a value.
+ *
+ * \param[out]      dec: Pointer to the decoder.
+ * \param[in]       fm: Pointer to the compressed matrix.
+ * \param[in]       k: Index of the value.
+ */
+static inline void prv_fpc_seek(struct FpcDecoder *dec, const struct FpcMatrix *fm, int k) {
+    const uint8_t *data = arena_get_ptr(&fm->data);
+    const size_t *offsets = arena_get_ptr(&fm->offsets);
+
+    dec->codes = data + offsets[k / CONFIG_FPC_BLOCK_NNZ];
+    dec->pos = dec->codes + PRV_FPC_HDR_SIZE;
+    dec->prev = 0;
+    dec->idx = 0;
+    for (int skip = k % CONFIG_FPC_BLOCK_NNZ; skip > 0; --skip)
+        prv_fpc_next(dec);
+}
+
+/*!
+ * \brief           Multiply a range of rows of a compressed matrix with a vector.
+ *
+ * \details         A row is walked in segments ending at the row or block end,
+ *                  so the inner loop has no block check, and with two
+ *                  accumulators to halve the dependency chain of the sums.
+ *
+ * \param[in]       fm: Pointer to the compressed matrix.
+ * \param[in]       vec: Pointer to the vector.
+ * \param[out]      result: Pointer to the result vector.
+ * \param[in]       row_begin: First row of the range.
+ * \param[in]       row_end: One past the last row of the range.
+ */
+static void prv_fpc_rows(const struct FpcMatrix *fm, const struct Vec *vec, struct Vec *result, int row_begin, int row_end) {
+    const int *row = csr_matrix_row_ptr(&fm->pattern);
+    const int *col = csr_matrix_col_idx(&fm->pattern);
+    const double *x = arena_get_ptr(&vec->val);
+    double *y = arena_get_ptr(&result->val);
+
+    if (row_begin >= row_end)
+        return;
+
+    struct FpcDecoder dec;
+    prv_fpc_seek(&dec, fm, row[row_begin]);
+
+    for (int i = row_begin; i < row_end; ++i) {
+        double sum0 = 0.0;
+        double sum1 = 0.0;
+        int k = row[i];
+
+        while (k < row[i + 1]) {
+            if (dec.idx == CONFIG_FPC_BLOCK_NNZ)
+                prv_fpc_next_block(&dec);
+
+            int end = GET_MIN(row[i + 1], k + CONFIG_FPC_BLOCK_NNZ - dec.idx);
+            for (; k + 1 < end; k += 2) {
+                sum0 += prv_fpc_next(&dec) * x[col[k]];
+                sum1 += prv_fpc_next(&dec) * x[col[k + 1]];
+            }
+            if (k < end) {
+                sum0 += prv_fpc_next(&dec) * x[col[k]];
+                ++k;
+            }
+        }
+
+        y[i] = sum0 + sum1;
+    }
+}
+
+#ifdef CONFIG_ENABLE_PTHREADS_PARALLELISM
+/*!
+ * \brief           Pool task computing the nnz-balanced share of rows of one thread.
+ *
+ * \param[in,out]   arg: Pointer to the FpcPoolTask.
+ * \param[in]       tid: Index of the calling thread.
+ * \param[in]       threads: Number of threads of the pool.
+ */
+static void prv_fpc_pool_task(void *arg, int tid, int threads) {
+    struct FpcPoolTask *task = arg;
+    int row_begin = partition_nnz_bound(&task->fm->pattern, tid, threads);
+    int row_end = partition_nnz_bound(&task->fm->pattern, tid + 1, threads);
+
+    prv_fpc_rows(task->fm, task->vec, task->result, row_begin, row_end);
+}
+#endif /*! CONFIG_ENABLE_PTHREADS_PARALLELISM */
+
+int fpc_matrix_init(struct FpcMatrix *fm, const struct CsrMatrix *mtx, struct ArenaHandler *arena) {
+    SLOG_DEBUG("Entering fpc_matrix_init");
+    if (!fm || !mtx || !arena) {
+        rc_set_err_msg("Invalid NULL argument(s) provided to fpc_matrix_init");
+        return RC_INVALID_ARG_ERR;
+    }
+
+    if (!mtx->is_real) {
+        rc_set_err_msg("Only real matrices can be compressed");
+        return RC_INVALID_ARG_ERR;
+    }
+
+    fm->pattern = *mtx;
+    fm->blocks = (mtx->nz + CONFIG_FPC_BLOCK_NNZ - 1) / CONFIG_FPC_BLOCK_NNZ;
+    fm->bytes = prv_fpc_encode(csr_matrix_values(mtx), mtx->nz, NULL, NULL);
+
+    enum ArenaReturnCode res = arena_calloc(arena, 1, fm->bytes + PRV_FPC_PAD, &fm->data);
+    if (res == ARENA_RC_OK)
+        res = arena_calloc(arena, sizeof(size_t), (size_t)fm->blocks + 1, &fm->offsets);
+    if (res != ARENA_RC_OK) {
+        rc_set_err_msg("Memory array allocation failed in fpc_matrix_init");
+        return RC_MEM_ALLOC_ERR;
+    }
+
+    size_t *offsets = arena_get_ptr(&fm->offsets);
+    prv_fpc_encode(csr_matrix_values(mtx), mtx->nz, arena_get_ptr(&fm->data), offsets);
+    offsets[fm->blocks] = fm->bytes;
+
+    SLOG_DEBUG("Compressed %d values in %d blocks: %zu bytes (ratio %.2f)", mtx->nz, fm->blocks, fm->bytes, fpc_matrix_ratio(fm));
+    return RC_OK;
+}
+
+double fpc_matrix_ratio(const struct FpcMatrix *fm) {
+    return fm->bytes > 0 ? (double)fm->pattern.nz * sizeof(double) / (double)fm->bytes : 1.0;
+}
+
+int fpc_matrix_mul_vec_rows(const struct FpcMatrix *fm, const struct Vec *vec, struct Vec *result, int row_begin, int row_end) {
+    if (row_begin < 0 || row_end > fm->pattern.m || row_begin > row_end)
+        return RC_IDX_OUT_OF_BOUNDS_ERR;
+
+    prv_fpc_rows(fm, vec, result, row_begin, row_end);
+    return RC_OK;
+}
+
+int fpc_matrix_mul_vec(const struct FpcMatrix *fm, const struct Vec *vec, struct Vec *result) {
+    if (!fm || !vec || !result) {
+        rc_set_err_msg("Invalid NULL argument(s) provided to fpc_matrix_mul_vec");
+        return RC_INVALID_ARG_ERR;
+    }
+
+    if (fm->pattern.n != vec->n || !vec->is_real || !result->is_real || vec_size(result) != fm->pattern.m) {
+        rc_set_err_msg("Incompatible matrix and vector dimensions or types in fpc_matrix_mul_vec");
+        return RC_INVALID_ARG_ERR;
+    }
+
+#ifdef CONFIG_ENABLE_OMP_PARALLELISM
+    if (omp_get_max_threads() > 1) {
+        /*! One nnz-balanced range per thread: a single seek each */
+#pragma omp parallel
+        {
+            const int tid = omp_get_thread_num();
+            const int threads = omp_get_num_threads();
+            prv_fpc_rows(fm, vec, result, partition_nnz_bound(&fm->pattern, tid, threads), partition_nnz_bound(&fm->pattern, tid + 1, threads));
+        }
+        return RC_OK;
+    }
+#elif defined(CONFIG_ENABLE_PTHREADS_PARALLELISM)
+    struct ThreadPool *pool = pool_get_default();
+    if (pool && pool->threads > 1) {
+        struct FpcPoolTask task = { .fm = fm, .vec = vec, .result = result };
+        return pool_run(pool, prv_fpc_pool_task, &task);
+    }
+#endif /*! CONFIG_ENABLE_OMP_PARALLELISM */
+
+    prv_fpc_rows(fm, vec, result, 0, fm->pattern.m);
+    return RC_OK;
+}
@@ -0,0 +1,1128 @@
+/*!
+ * \file            gpart.c
+ * \date            2026-10-18
+ * \author          Mirko Lana [lana.mirko@icloud.com]
+ *
+ * \brief           Multilevel graph partitioning of square CSR matrices.
+ */
+
+#include "config.h"
+#include "gpart.h"
+#include "rc.h"
+#include "arena.h"
+#include "csr.h"
+#include "partition.h"
+#include "slog.h"
+#include "utils.h"
+
+#include <math.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <string.h>
+
+/*!
+ * \brief           Structure representing an undirected graph with weighted vertices and edges.
+ *
+ * \details         Every edge is stored twice, once per endpoint.
+ */
+struct GpartGraph {
+    int n;                /*< Number of vertices */
+    int edges;            /*< Number of adjacency entries (twice the number of edges) */
+    long long weight;     /*< Sum of the vertex weights */
+    int max_vwgt;         /*< Largest vertex weight */
+    struct ArenaObj xadj; /*< First adjacency entry of each vertex (n + 1 items) */
+    struct ArenaObj adj;  /*< Neighbor of each adjacency entry */
+    struct ArenaObj ewgt; /*< Edge weight of each adjacency entry */
+    struct ArenaObj vwgt; /*< Weight of each vertex (n items) */
+};
+
+/*!
+ * \brief           Structure representing the balance constraint of a bisection.
+ */
+struct GpartBalance {
+    long long target[2]; /*< Target weight of each side */
+    long long max[2];    /*< Largest allowed weight of each side */
+};
+
+/*!
+ * \brief           Structure containing the scratch arrays of the Fiduccia-Mattheyses refinement.
+ *
+ * \details         The gain of a vertex is the weight of its edges to the
+ *                  other side minus that of its edges to its side: the decrease
+ *                  of the cut if it moves. Each side keeps its candidate
+ *                  vertices in a max-heap of gains.
+ */
+struct GpartFm {
+    int *ed;      /*< External degree of each vertex (weight of its edges to the other side) */
+    int *id;      /*< Internal degree of each vertex (weight of its edges to its side) */
+    int *pos;     /*< Position of each vertex in the heap of its side, -1 if absent */
+    int *heap[2]; /*< Candidate vertices of each side, by decreasing gain */
+    int size[2];  /*< Number of candidates of each side */
+    int *moves;   /*< Moved vertices of the current pass, in order */
+    bool *locked; /*< Whether each vertex already moved in the current pass */
+};
+
+/*!
+ * \brief           Draw a pseudo-random number (xorshift64).
+ *
+ * \param[in,out]   state: Pointer to the non-zero state of the generator.
+ * \return          The next number.
+ */
+static uint64_t prv_gpart_rand(uint64_t *state) {
+    uint64_t x = *state;
+    x ^= x << 13;
+    x ^= x >> 7;
+    x ^= x << 17;
+    return *state = x;
+}
+
+/*!
+ * \brief           Allocate the arrays of a graph.
+ *
+ * \param[out]      g: Pointer to the graph.
+ * \param[in]       n: Number of vertices.
+ * \param[in]       edges: Capacity in adjacency entries.
+ * \param[out]      arena: Pointer to the arena handler for memory allocation.
+ * \return          RC_OK on success, RC_MEM_ALLOC_ERR otherwise.
+ */
+static int prv_gpart_graph_alloc(struct GpartGraph *g, int n, int edges, struct ArenaHandler *arena) {
+    *g = (struct GpartGraph){ .n = n };
+
+    enum ArenaReturnCode res = arena_calloc(arena, sizeof(int), (size_t)n + 1, &g->xadj);
+    if (res == ARENA_RC_OK)
+        res = arena_calloc(arena, sizeof(int), (size_t)GET_MAX(edges, 1), &g->adj);
+    if (res == ARENA_RC_OK)
+        res = arena_calloc(arena, sizeof(int), (size_t)GET_MAX(edges, 1), &g->ewgt);
+    if (res == ARENA_RC_OK)
+        res = arena_calloc(arena, sizeof(int), (size_t)GET_MAX(n, 1), &g->vwgt);
+    if (res != ARENA_RC_OK) {
+        rc_set_err_msg("Memory array allocation failed in the graph partitioner");
+        return RC_MEM_ALLOC_ERR;
+    }
+
+    return RC_OK;
+}
+
+/*!
+ * \brief           Allocate a scratch array of integers.
+ *
+ * \param[out]      obj: Pointer to the arena object.
+ * \param[in]       n: Number of items.
+ * \param[out]      arena: Pointer to the arena handler for memory allocation.
+ * \return          RC_OK on success, RC_MEM_ALLOC_ERR otherwise.
+ */
+static int prv_gpart_alloc(struct ArenaObj *obj, int n, struct ArenaHandler *arena) {
+    if (arena_calloc(arena, sizeof(int), (size_t)GET_MAX(n, 1), obj) != ARENA_RC_OK) {
+        rc_set_err_msg("Memory array allocation failed in the graph partitioner");
+        return RC_MEM_ALLOC_ERR;
+    }
+
+    return RC_OK;
+}
+
+/*!
+ * \brief           Sum the vertex weights of a graph and find the largest one.
+ *
+ * \param[in,out]   g: Pointer to the graph.
+ */
+static void prv_gpart_graph_weigh(struct GpartGraph *g) {
+    const int *vwgt = arena_get_ptr(&g->vwgt);
+
+    g->weight = 0;
+    g->max_vwgt = 0;
+    for (int v = 0; v < g->n; ++v) {
+        g->weight += vwgt[v];
+        g->max_vwgt = GET_MAX(g->max_vwgt, vwgt[v]);
+    }
+}
+
+/*!
+ * \brief           Build the graph of the symmetrized pattern of a square matrix.
+ *
+ * \details         Rows i and j are adjacent if a_ij or a_ji is stored, the
+ *                  edge weighing the number of such entries (1 or 2); the
+ *                  diagonal is dropped. A vertex weighs the non-zeros of its row
+ *                  (at least 1), the work of its part of the SpMV.
+ *
+ * \param[out]      g: Pointer to the graph.
+ * \param[in]       mtx: Pointer to the square CSR matrix.
+ * \param[out]      arena: Pointer to the arena handler for memory allocation.
+ * \return          RC_OK on success, RC_MEM_ALLOC_ERR otherwise.
+ */
+static int prv_gpart_graph_from_csr(struct GpartGraph *g, const struct CsrMatrix *mtx, struct ArenaHandler *arena) {
+    const int m = mtx->m;
+    const int *row = csr_matrix_row_ptr(mtx);
+    const int *col = csr_matrix_col_idx(mtx);
+
+    int diag = 0;
+    for (int i = 0; i < m; ++i)
+        for (int k = row[i]; k < row[i + 1]; ++k)
+            diag += col[k] == i;
+
+    struct ArenaObj pos_obj;
+    int res = prv_gpart_graph_alloc(g, m, 2 * (mtx->nz - diag), arena);
+    if (res == RC_OK)
+        res = prv_gpart_alloc(&pos_obj, m, arena);
+    if (res != RC_OK)
+        return res;
+
+    row = csr_matrix_row_ptr(mtx);
+    col = csr_matrix_col_idx(mtx);
+    int *xadj = arena_get_ptr(&g->xadj);
+    int *adj = arena_get_ptr(&g->adj);
+    int *ewgt = arena_get_ptr(&g->ewgt);
+    int *vwgt = arena_get_ptr(&g->vwgt);
+    int *pos = arena_get_ptr(&pos_obj);
+
+    /*! Both directions of every entry, duplicates included: xadj[i] is the start of row i, vwgt[i] its insertion point */
+    for (int i = 0; i < m; ++i)
+        for (int k = row[i]; k < row[i + 1]; ++k)
+            if (col[k] != i) {
+                xadj[i + 1]++;
+                xadj[col[k] + 1]++;
+            }
+    for (int i = 0; i < m; ++i) {
+        xadj[i + 1] += xadj[i];
+        vwgt[i] = xadj[i];
+    }
+    for (int i = 0; i < m; ++i)
+        for (int k = row[i]; k < row[i + 1]; ++k)
+            if (col[k] != i) {
+                adj[vwgt[i]++] = col[k];
+                adj[vwgt[col[k]]++] = i;
+            }
+
+    /*! Merge the duplicates in place: the merged row starts before the raw one, pos[j] marks where j was stored last */
+    int e = 0;
+    int begin = 0;
+    for (int j = 0; j < m; ++j)
+        pos[j] = -1;
+    for (int i = 0; i < m; ++i) {
+        const int end = xadj[i + 1];
+        xadj[i] = e;
+        for (int k = begin; k < end; ++k) {
+            const int j = adj[k];
+            if (pos[j] >= xadj[i]) {
+                ewgt[pos[j]]++;
+            } else {
+                pos[j] = e;
+                adj[e] = j;
+                ewgt[e++] = 1;
+            }
+        }
+        begin = end;
+        vwgt[i] = GET_MAX(row[i + 1] - row[i], 1);
+    }
+    xadj[m] = e;
+    g->edges = e;
+
+    prv_gpart_graph_weigh(g);
+    return RC_OK;
+}
+
+/*!
+ * \brief           Coarsen a graph by heavy-edge matching.
+ *
+ * \details         The vertices are visited in random order and each one not
+ *                  matched yet is merged with its unmatched neighbor of
+ *                  heaviest edge, unless the merged vertex would be heavier
+ *                  than 1.5 times the mean weight of the coarsest graph. Merged
+ *                  edges add their weights, so the cut of a bisection of the
+ *                  coarse graph is the cut of its projection.
+ *
+ * \param[in]       fine: Pointer to the graph to coarsen.
+ * \param[out]      coarse: Pointer to the coarse graph.
+ * \param[out]      cmap_obj: Pointer to the coarse vertex of each fine vertex (fine->n items).
+ * \param[in,out]   rng: Pointer to the state of the random generator.
+ * \param[out]      arena: Pointer to the arena handler for memory allocation.
+ * \return          RC_OK on success, RC_MEM_ALLOC_ERR otherwise.
+ */
+static int prv_gpart_coarsen(const struct GpartGraph *fine, struct GpartGraph *coarse, struct ArenaObj *cmap_obj, uint64_t *rng, struct ArenaHandler *arena) {
+    const int n = fine->n;
+    const long long max_vwgt = GET_MAX(3 * fine->weight / (2 * CONFIG_GPART_COARSEN_TO), 1);
+
+    struct ArenaObj match_obj;
+    struct ArenaObj perm_obj;
+    int res = prv_gpart_alloc(cmap_obj, n, arena);
+    if (res == RC_OK)
+        res = prv_gpart_alloc(&match_obj, n, arena);
+    if (res == RC_OK)
+        res = prv_gpart_alloc(&perm_obj, n, arena);
+    if (res != RC_OK)
+        return res;
+
+    const int *xadj = arena_get_ptr(&fine->xadj);
+    const int *adj = arena_get_ptr(&fine->adj);
+    const int *ewgt = arena_get_ptr(&fine->ewgt);
+    const int *vwgt = arena_get_ptr(&fine->vwgt);
+    int *cmap = arena_get_ptr(cmap_obj);
+    int *match = arena_get_ptr(&match_obj);
+    int *perm = arena_get_ptr(&perm_obj);
+
+    for (int v = 0; v < n; ++v) {
+        match[v] = -1;
+        perm[v] = v;
+    }
+    for (int v = n - 1; v > 0; --v) {
+        const int r = (int)(prv_gpart_rand(rng) % (uint64_t)(v + 1));
+        const int tmp = perm[v];
+        perm[v] = perm[r];
+        perm[r] = tmp;
+    }
+
+    for (int p = 0; p < n; ++p) {
+        const int v = perm[p];
+        if (match[v] != -1)
+            continue;
+
+        int best = v;
+        int best_w = 0;
+        for (int k = xadj[v]; k < xadj[v + 1]; ++k) {
+            const int u = adj[k];
+            if (match[u] == -1 && u != v && ewgt[k] > best_w && (long long)vwgt[v] + vwgt[u] <= max_vwgt) {
+                best = u;
+                best_w = ewgt[k];
+            }
+        }
+        match[v] = best;
+        match[best] = v;
+    }
+
+    /*! A pair is numbered at its lowest vertex */
+    int nc = 0;
+    for (int v = 0; v < n; ++v)
+        if (v <= match[v])
+            cmap[v] = cmap[match[v]] = nc++;
+
+    struct ArenaObj pos_obj;
+    res = prv_gpart_graph_alloc(coarse, nc, fine->edges, arena);
+    if (res == RC_OK)
+        res = prv_gpart_alloc(&pos_obj, nc, arena);
+    if (res != RC_OK)
+        return res;
+
+    xadj = arena_get_ptr(&fine->xadj);
+    adj = arena_get_ptr(&fine->adj);
+    ewgt = arena_get_ptr(&fine->ewgt);
+    vwgt = arena_get_ptr(&fine->vwgt);
+    cmap = arena_get_ptr(cmap_obj);
+    match = arena_get_ptr(&match_obj);
+    int *c_xadj = arena_get_ptr(&coarse->xadj);
+    int *c_adj = arena_get_ptr(&coarse->adj);
+    int *c_ewgt = arena_get_ptr(&coarse->ewgt);
+    int *c_vwgt = arena_get_ptr(&coarse->vwgt);
+    int *pos = arena_get_ptr(&pos_obj);
+
+    for (int c = 0; c < nc; ++c)
+        pos[c] = -1;
+
+    int e = 0;
+    for (int v = 0; v < n; ++v) {
+        if (v > match[v])
+            continue;
+
+        const int c = cmap[v];
+        const int pair[2] = { v, match[v] };
+        c_xadj[c] = e;
+        c_vwgt[c] = vwgt[v] + (pair[1] != v ? vwgt[pair[1]] : 0);
+        for (int h = 0; h < (pair[1] != v ? 2 : 1); ++h) {
+            for (int k = xadj[pair[h]]; k < xadj[pair[h] + 1]; ++k) {
+                const int cu = cmap[adj[k]];
+                if (cu == c)
+                    continue;
+                if (pos[cu] >= c_xadj[c]) {
+                    c_ewgt[pos[cu]] += ewgt[k];
+                } else {
+                    pos[cu] = e;
+                    c_adj[e] = cu;
+                    c_ewgt[e++] = ewgt[k];
+                }
+            }
+        }
+    }
+    c_xadj[nc] = e;
+    coarse->edges = e;
+
+    prv_gpart_graph_weigh(coarse);
+    return RC_OK;
+}
+
+/*!
+ * \brief           Compute the balance constraint of a bisection of a graph.
+ *
+ * \details         A side may exceed its target by a factor of tol, and at
+ *                  least by the heaviest vertex: on coarse graphs the vertices
+ *                  are too heavy for a tighter balance, the finer levels restore
+ *                  it.
+ *
+ * \param[in]       g: Pointer to the graph.
+ * \param[in]       weight: Weight of the graph being bisected.
+ * \param[in]       frac: Share of the weight targeted by side 0.
+ * \param[in]       tol: Largest allowed weight of a side over its target.
+ * \param[out]      bal: Pointer to the balance constraint.
+ */
+static void prv_gpart_balance(const struct GpartGraph *g, long long weight, double frac, double tol, struct GpartBalance *bal) {
+    bal->target[0] = llround((double)weight * frac);
+    bal->target[1] = weight - bal->target[0];
+    for (int s = 0; s < 2; ++s)
+        bal->max[s] = GET_MAX((long long)((double)bal->target[s] * tol), bal->target[s] + g->max_vwgt);
+}
+
+/*!
+ * \brief           Get how much the sides of a bisection exceed their largest allowed weight.
+ *
+ * \param[in]       pw: Weight of each side.
+ * \param[in]       bal: Pointer to the balance constraint.
+ * \return          The sum of the excesses, 0 if balanced.
+ */
+static inline long long prv_gpart_overweight(const long long *pw, const struct GpartBalance *bal) {
+    return GET_MAX(pw[0] - bal->max[0], 0) + GET_MAX(pw[1] - bal->max[1], 0);
+}
+
+/*!
+ * \brief           Compute the weight of the edges cut by a bisection.
+ *
+ * \param[in]       g: Pointer to the graph.
+ * \param[in]       side: Side of each vertex.
+ * \return          The cut.
+ */
+static long long prv_gpart_cut(const struct GpartGraph *g, const int *side) {
+    const int *xadj = arena_get_ptr(&g->xadj);
+    const int *adj = arena_get_ptr(&g->adj);
+    const int *ewgt = arena_get_ptr(&g->ewgt);
+    long long cut = 0;
+
+    for (int v = 0; v < g->n; ++v)
+        for (int k = xadj[v]; k < xadj[v + 1]; ++k)
+            if (side[adj[k]] != side[v])
+                cut += ewgt[k];
+
+    return cut / 2;
+}
+
+/*!
+ * \brief           Compute the weight of each side of a bisection.
+ *
+ * \param[in]       g: Pointer to the graph.
+ * \param[in]       side: Side of each vertex.
+ * \param[out]      pw: Weight of each side.
+ */
+static void prv_gpart_side_weights(const struct GpartGraph *g, const int *side, long long *pw) {
+    const int *vwgt = arena_get_ptr(&g->vwgt);
+
+    pw[0] = pw[1] = 0;
+    for (int v = 0; v < g->n; ++v)
+        pw[side[v]] += vwgt[v];
+}
+
+/*!
+ * \brief           Get the gain of a vertex.
+ *
+ * \param[in]       fm: Pointer to the refinement state.
+ * \param[in]       v: Vertex.
+ * \return          The decrease of the cut if v changes side.
+ */
+static inline int prv_gpart_gain(const struct GpartFm *fm, int v) {
+    return fm->ed[v] - fm->id[v];
+}
+
+/*!
+ * \brief           Move a vertex of a heap up to its place.
+ *
+ * \param[in,out]   fm: Pointer to the refinement state.
+ * \param[in]       s: Side of the heap.
+ * \param[in]       i: Position of the vertex.
+ */
+static void prv_gpart_heap_up(struct GpartFm *fm, int s, int i) {
+    int *heap = fm->heap[s];
+    const int v = heap[i];
+    const int gain = prv_gpart_gain(fm, v);
+
+    while (i > 0 && prv_gpart_gain(fm, heap[(i - 1) / 2]) < gain) {
+        heap[i] = heap[(i - 1) / 2];
+        fm->pos[heap[i]] = i;
+        i = (i - 1) / 2;
+    }
+    heap[i] = v;
+    fm->pos[v] = i;
+}
+
+/*!
+ * \brief           Move a vertex of a heap down to its place.
+ *
+ * \param[in,out]   fm: Pointer to the refinement state.
+ * \param[in]       s: Side of the heap.
+ * \param[in]       i: Position of the vertex.
+ */
+static void prv_gpart_heap_down(struct GpartFm *fm, int s, int i) {
+    int *heap = fm->heap[s];
+    const int v = heap[i];
+    const int gain = prv_gpart_gain(fm, v);
+
+    for (;;) {
+        int child = 2 * i + 1;
+        if (child >= fm->size[s])
+            break;
+        if (child + 1 < fm->size[s] && prv_gpart_gain(fm, heap[child + 1]) > prv_gpart_gain(fm, heap[child]))
+            child++;
+        if (prv_gpart_gain(fm, heap[child]) <= gain)
+            break;
+        heap[i] = heap[child];
+        fm->pos[heap[i]] = i;
+        i = child;
+    }
+    heap[i] = v;
+    fm->pos[v] = i;
+}
+
+/*!
+ * \brief           Remove the vertex of highest gain of a heap.
+ *
+ * \param[in,out]   fm: Pointer to the refinement state.
+ * \param[in]       s: Side of the heap (not empty).
+ * \return          The removed vertex.
+ */
+static int prv_gpart_heap_pop(struct GpartFm *fm, int s) {
+    int *heap = fm->heap[s];
+    const int v = heap[0];
+
+    fm->pos[v] = -1;
+    if (--fm->size[s] > 0) {
+        heap[0] = heap[fm->size[s]];
+        prv_gpart_heap_down(fm, s, 0);
+    }
+
+    return v;
+}
+
+/*!
+ * \brief           Refine a bisection with Fiduccia-Mattheyses passes.
+ *
+ * \details         A pass moves the candidate of highest gain of either side
+ *                  (the boundary vertices, then those reaching it) as long as
+ *                  the other side stays within its largest weight, each vertex
+ *                  once, even when the cut grows: climbing out of local minima.
+ *                  Only the moves up to the best bisection seen are kept, the
+ *                  first criterion being the balance, so an overweight side
+ *                  gives its vertices whatever their gains. A pass stops after
+ *                  a few moves without improvement, the refinement after a
+ *                  pass without any.
+ *
+ * \param[in]       g: Pointer to the graph.
+ * \param[in,out]   side: Side of each vertex.
+ * \param[in]       bal: Pointer to the balance constraint.
+ * \param[in,out]   fm: Pointer to the refinement state (arrays of g->n items at least, 2 * g->n for the heaps).
+ * \param[in]       cut: Cut of the bisection.
+ * \return          The cut of the refined bisection.
+ */
+static long long prv_gpart_fm(const struct GpartGraph *g, int *side, const struct GpartBalance *bal, struct GpartFm *fm, long long cut) {
+    const int *xadj = arena_get_ptr(&g->xadj);
+    const int *adj = arena_get_ptr(&g->adj);
+    const int *ewgt = arena_get_ptr(&g->ewgt);
+    const int *vwgt = arena_get_ptr(&g->vwgt);
+    const int max_stall = GET_MIN(GET_MAX(g->n / 100, 15), CONFIG_GPART_FM_MAX_STALL);
+
+    long long pw[2];
+    prv_gpart_side_weights(g, side, pw);
+
+    for (int pass = 0; pass < CONFIG_GPART_FM_PASSES; ++pass) {
+        fm->size[0] = fm->size[1] = 0;
+        for (int v = 0; v < g->n; ++v) {
+            fm->ed[v] = fm->id[v] = 0;
+            for (int k = xadj[v]; k < xadj[v + 1]; ++k) {
+                if (side[adj[k]] != side[v])
+                    fm->ed[v] += ewgt[k];
+                else
+                    fm->id[v] += ewgt[k];
+            }
+            fm->pos[v] = -1;
+            fm->locked[v] = false;
+            if (fm->ed[v] > 0) {
+                fm->heap[side[v]][fm->size[side[v]]++] = v;
+                prv_gpart_heap_up(fm, side[v], fm->size[side[v]] - 1);
+            }
+        }
+
+        long long best_over = prv_gpart_overweight(pw, bal);
+        long long best_cut = cut;
+        int best = 0;
+        int moves = 0;
+
+        for (;;) {
+            int from = -1;
+            if (pw[0] > bal->max[0]) {
+                from = 0;
+            } else if (pw[1] > bal->max[1]) {
+                from = 1;
+            } else {
+                for (int s = 0; s < 2; ++s) {
+                    if (fm->size[s] == 0 || pw[1 - s] + vwgt[fm->heap[s][0]] > bal->max[1 - s])
+                        continue;
+                    if (from < 0 || prv_gpart_gain(fm, fm->heap[s][0]) > prv_gpart_gain(fm, fm->heap[from][0]))
+                        from = s;
+                }
+            }
+            if (from < 0 || fm->size[from] == 0)
+                break;
+
+            const int v = prv_gpart_heap_pop(fm, from);
+            const int to = 1 - from;
+            cut -= prv_gpart_gain(fm, v);
+            side[v] = to;
+            pw[from] -= vwgt[v];
+            pw[to] += vwgt[v];
+            fm->locked[v] = true;
+            fm->moves[moves++] = v;
+
+            const int tmp = fm->ed[v];
+            fm->ed[v] = fm->id[v];
+            fm->id[v] = tmp;
+            for (int k = xadj[v]; k < xadj[v + 1]; ++k) {
+                const int u = adj[k];
+                if (side[u] == to) {
+                    fm->id[u] += ewgt[k];
+                    fm->ed[u] -= ewgt[k];
+                } else {
+                    fm->id[u] -= ewgt[k];
+                    fm->ed[u] += ewgt[k];
+                }
+                if (fm->locked[u])
+                    continue;
+                if (fm->pos[u] >= 0) {
+                    prv_gpart_heap_up(fm, side[u], fm->pos[u]);
+                    prv_gpart_heap_down(fm, side[u], fm->pos[u]);
+                } else if (fm->ed[u] > 0) {
+                    fm->heap[side[u]][fm->size[side[u]]++] = u;
+                    prv_gpart_heap_up(fm, side[u], fm->size[side[u]] - 1);
+                }
+            }
+
+            const long long over = prv_gpart_overweight(pw, bal);
+            if (over < best_over || (over == best_over && cut < best_cut)) {
+                best_over = over;
+                best_cut = cut;
+                best = moves;
+            } else if (moves - best >= max_stall) {
+                break;
+            }
+        }
+
+        /*! Roll back the moves after the best bisection */
+        for (int i = moves - 1; i >= best; --i) {
+            const int v = fm->moves[i];
+            pw[side[v]] -= vwgt[v];
+            side[v] = 1 - side[v];
+            pw[side[v]] += vwgt[v];
+        }
+        cut = best_cut;
+
+        if (best == 0)
+            break;
+    }
+
+    return cut;
+}
+
+/*!
+ * \brief           Bisect a small graph by greedy growth from random seeds.
+ *
+ * \details         Side 0 grows breadth-first from a random vertex (restarting
+ *                  from another one when a connected component is exhausted)
+ *                  until it reaches its target weight, then the bisection is
+ *                  refined. The best of CONFIG_GPART_INIT_TRIES tries is kept.
+ *
+ * \param[in]       g: Pointer to the graph.
+ * \param[out]      side: Side of each vertex.
+ * \param[in]       bal: Pointer to the balance constraint.
+ * \param[in,out]   fm: Pointer to the refinement state.
+ * \param[out]      best_side: Scratch array (g->n items).
+ * \param[out]      queue: Scratch array (g->n items).
+ * \param[in,out]   rng: Pointer to the state of the random generator.
+ * \return          The cut of the bisection.
+ */
+static long long prv_gpart_initial(const struct GpartGraph *g, int *side, const struct GpartBalance *bal, struct GpartFm *fm, int *best_side, int *queue, uint64_t *rng) {
+    const int *xadj = arena_get_ptr(&g->xadj);
+    const int *adj = arena_get_ptr(&g->adj);
+    const int *vwgt = arena_get_ptr(&g->vwgt);
+    long long best_over = -1;
+    long long best_cut = 0;
+
+    for (int t = 0; t < CONFIG_GPART_INIT_TRIES && g->n > 0; ++t) {
+        /*! fm->locked marks the queued vertices */
+        for (int v = 0; v < g->n; ++v) {
+            side[v] = 1;
+            fm->locked[v] = false;
+        }
+
+        int next = (int)(prv_gpart_rand(rng) % (uint64_t)g->n);
+        int head = 0;
+        int tail = 0;
+        long long pw0 = 0;
+        while (pw0 < bal->target[0]) {
+            if (head == tail) {
+                for (int i = 0; i < g->n && fm->locked[next]; ++i)
+                    next = (next + 1) % g->n;
+                if (fm->locked[next])
+                    break;
+                fm->locked[next] = true;
+                queue[tail++] = next;
+            }
+
+            const int v = queue[head++];
+            side[v] = 0;
+            pw0 += vwgt[v];
+            for (int k = xadj[v]; k < xadj[v + 1]; ++k) {
+                if (!fm->locked[adj[k]]) {
+                    fm->locked[adj[k]] = true;
+                    queue[tail++] = adj[k];
+                }
+            }
+        }
+
+        long long pw[2];
+        const long long cut = prv_gpart_fm(g, side, bal, fm, prv_gpart_cut(g, side));
+        prv_gpart_side_weights(g, side, pw);
+        const long long over = prv_gpart_overweight(pw, bal);
+        if (best_over < 0 || over < best_over || (over == best_over && cut < best_cut)) {
+            best_over = over;
+            best_cut = cut;
+            memcpy(best_side, side, sizeof(int) * (size_t)g->n);
+        }
+    }
+
+    memcpy(side, best_side, sizeof(int) * (size_t)g->n);
+    return best_cut;
+}
+
+/*!
+ * \brief           Bisect a graph with the multilevel scheme.
+ *
+ * \param[in]       g: Pointer to the graph.
+ * \param[in]       frac: Share of the weight targeted by side 0.
+ * \param[in]       tol: Largest allowed weight of a side over its target.
+ * \param[out]      side_obj: Pointer to the side of each vertex (g->n items, allocated by the caller).
+ * \param[in,out]   rng: Pointer to the state of the random generator.
+ * \param[out]      arena: Pointer to the arena handler for memory allocation.
+ * \return          RC_OK on success, RC_MEM_ALLOC_ERR otherwise.
+ */
+static int prv_gpart_bisect(const struct GpartGraph *g, double frac, double tol, struct ArenaObj *side_obj, uint64_t *rng, struct ArenaHandler *arena) {
+    struct GpartGraph levels[CONFIG_GPART_MAX_LEVELS + 1];
+    struct ArenaObj cmaps[CONFIG_GPART_MAX_LEVELS];
+    struct ArenaObj sides[CONFIG_GPART_MAX_LEVELS + 1];
+    int res = RC_OK;
+    int l = 0;
+
+    /*! Stop once matching no longer shrinks the graph (stars, dense rows) */
+    levels[0] = *g;
+    while (l < CONFIG_GPART_MAX_LEVELS && levels[l].n > CONFIG_GPART_COARSEN_TO) {
+        res = prv_gpart_coarsen(&levels[l], &levels[l + 1], &cmaps[l], rng, arena);
+        if (res != RC_OK)
+            return res;
+        l++;
+        if (levels[l].n > levels[l - 1].n * 0.9)
+            break;
+    }
+    const int coarsest = l;
+
+    struct ArenaObj ed_obj, id_obj, pos_obj, heap_obj, moves_obj, locked_obj, best_obj, queue_obj;
+    sides[0] = *side_obj;
+    for (l = 1; l <= coarsest && res == RC_OK; ++l)
+        res = prv_gpart_alloc(&sides[l], levels[l].n, arena);
+    if (res == RC_OK)
+        res = prv_gpart_alloc(&ed_obj, g->n, arena);
+    if (res == RC_OK)
+        res = prv_gpart_alloc(&id_obj, g->n, arena);
+    if (res == RC_OK)
+        res = prv_gpart_alloc(&pos_obj, g->n, arena);
+    if (res == RC_OK)
+        res = prv_gpart_alloc(&heap_obj, 2 * g->n, arena);
+    if (res == RC_OK)
+        res = prv_gpart_alloc(&moves_obj, g->n, arena);
+    if (res == RC_OK)
+        res = prv_gpart_alloc(&best_obj, levels[coarsest].n, arena);
+    if (res == RC_OK)
+        res = prv_gpart_alloc(&queue_obj, levels[coarsest].n, arena);
+    if (res == RC_OK && arena_calloc(arena, sizeof(bool), (size_t)GET_MAX(g->n, 1), &locked_obj) != ARENA_RC_OK) {
+        rc_set_err_msg("Memory array allocation failed in the graph partitioner");
+        res = RC_MEM_ALLOC_ERR;
+    }
+    if (res != RC_OK)
+        return res;
+
+    struct GpartFm fm = {
+        .ed = arena_get_ptr(&ed_obj),
+        .id = arena_get_ptr(&id_obj),
+        .pos = arena_get_ptr(&pos_obj),
+        .heap = { arena_get_ptr(&heap_obj), (int *)arena_get_ptr(&heap_obj) + g->n },
+        .moves = arena_get_ptr(&moves_obj),
+        .locked = arena_get_ptr(&locked_obj),
+    };
+
+    struct GpartBalance bal;
+    prv_gpart_balance(&levels[coarsest], g->weight, frac, tol, &bal);
+    long long cut = prv_gpart_initial(&levels[coarsest], arena_get_ptr(&sides[coarsest]), &bal, &fm, arena_get_ptr(&best_obj), arena_get_ptr(&queue_obj), rng);
+
+    /*! Edge weights add up when coarsening: a projected bisection keeps its cut */
+    for (l = coarsest - 1; l >= 0; --l) {
+        const int *cmap = arena_get_ptr(&cmaps[l]);
+        const int *coarse_side = arena_get_ptr(&sides[l + 1]);
+        int *side = arena_get_ptr(&sides[l]);
+
+        for (int v = 0; v < levels[l].n; ++v)
+            side[v] = coarse_side[cmap[v]];
+
+        prv_gpart_balance(&levels[l], g->weight, frac, tol, &bal);
+        cut = prv_gpart_fm(&levels[l], side, &bal, &fm, cut);
+    }
+
+    SLOG_DEBUG("Bisection of %d vertices: %d levels, coarsest %d vertices, cut %lld", g->n, coarsest, levels[coarsest].n, cut);
+    return RC_OK;
+}
+
+/*!
+ * \brief           Extract the subgraph induced by one side of a bisection.
+ *
+ * \param[in]       g: Pointer to the graph.
+ * \param[in]       label_obj: Pointer to the row of the matrix of each vertex of g.
+ * \param[in]       side_obj: Pointer to the side of each vertex of g.
+ * \param[in]       s: Side to extract.
+ * \param[out]      sub: Pointer to the subgraph.
+ * \param[out]      sub_label_obj: Pointer to the row of the matrix of each vertex of sub.
+ * \param[out]      arena: Pointer to the arena handler for memory allocation.
+ * \return          RC_OK on success, RC_MEM_ALLOC_ERR otherwise.
+ */
+static int prv_gpart_extract(const struct GpartGraph *g, const struct ArenaObj *label_obj, const struct ArenaObj *side_obj, int s, struct GpartGraph *sub, struct ArenaObj *sub_label_obj, struct ArenaHandler *arena) {
+    struct ArenaObj loc_obj;
+    int res = prv_gpart_alloc(&loc_obj, g->n, arena);
+    if (res != RC_OK)
+        return res;
+
+    const int *xadj = arena_get_ptr(&g->xadj);
+    const int *adj = arena_get_ptr(&g->adj);
+    const int *side = arena_get_ptr(side_obj);
+    int *loc = arena_get_ptr(&loc_obj);
+
+    int n = 0;
+    int edges = 0;
+    for (int v = 0; v < g->n; ++v) {
+        if (side[v] != s)
+            continue;
+        loc[v] = n++;
+        for (int k = xadj[v]; k < xadj[v + 1]; ++k)
+            edges += side[adj[k]] == s;
+    }
+
+    res = prv_gpart_graph_alloc(sub, n, edges, arena);
+    if (res == RC_OK)
+        res = prv_gpart_alloc(sub_label_obj, n, arena);
+    if (res != RC_OK)
+        return res;
+
+    xadj = arena_get_ptr(&g->xadj);
+    adj = arena_get_ptr(&g->adj);
+    side = arena_get_ptr(side_obj);
+    loc = arena_get_ptr(&loc_obj);
+    const int *ewgt = arena_get_ptr(&g->ewgt);
+    const int *vwgt = arena_get_ptr(&g->vwgt);
+    const int *label = arena_get_ptr(label_obj);
+    int *s_xadj = arena_get_ptr(&sub->xadj);
+    int *s_adj = arena_get_ptr(&sub->adj);
+    int *s_ewgt = arena_get_ptr(&sub->ewgt);
+    int *s_vwgt = arena_get_ptr(&sub->vwgt);
+    int *s_label = arena_get_ptr(sub_label_obj);
+
+    int e = 0;
+    for (int v = 0; v < g->n; ++v) {
+        if (side[v] != s)
+            continue;
+        s_xadj[loc[v]] = e;
+        s_vwgt[loc[v]] = vwgt[v];
+        s_label[loc[v]] = label[v];
+        for (int k = xadj[v]; k < xadj[v + 1]; ++k) {
+            if (side[adj[k]] == s) {
+                s_adj[e] = loc[adj[k]];
+                s_ewgt[e++] = ewgt[k];
+            }
+        }
+    }
+    s_xadj[n] = e;
+    sub->edges = e;
+
+    prv_gpart_graph_weigh(sub);
+    return RC_OK;
+}
+
+/*!
+ * \brief           Split a graph in parts by recursive bisection.
+ *
+ * \param[in]       g: Pointer to the graph.
+ * \param[in]       label_obj: Pointer to the row of the matrix of each vertex.
+ * \param[in]       parts: Number of parts.
+ * \param[in]       first: Index of the first part.
+ * \param[in]       tol: Largest allowed weight of a side over its target, per bisection.
+ * \param[out]      part_obj: Pointer to the part of each row of the matrix.
+ * \param[in,out]   rng: Pointer to the state of the random generator.
+ * \param[out]      arena: Pointer to the arena handler for memory allocation.
+ * \return          RC_OK on success, RC_MEM_ALLOC_ERR otherwise.
+ */
+static int prv_gpart_recurse(const struct GpartGraph *g, const struct ArenaObj *label_obj, int parts, int first, double tol, struct ArenaObj *part_obj, uint64_t *rng, struct ArenaHandler *arena) {
+    if (parts == 1 || g->n == 0) {
+        const int *label = arena_get_ptr(label_obj);
+        int *part = arena_get_ptr(part_obj);
+        for (int v = 0; v < g->n; ++v)
+            part[label[v]] = first;
+        return RC_OK;
+    }
+
+    /*! Side 0 gets parts / 2 parts, and the matching share of the weight */
+    const int left = parts / 2;
+    struct ArenaObj side_obj;
+    int res = prv_gpart_alloc(&side_obj, g->n, arena);
+    if (res == RC_OK)
+        res = prv_gpart_bisect(g, (double)left / parts, tol, &side_obj, rng, arena);
+
+    for (int s = 0; s < 2 && res == RC_OK; ++s) {
+        struct GpartGraph sub;
+        struct ArenaObj sub_label_obj;
+        res = prv_gpart_extract(g, label_obj, &side_obj, s, &sub, &sub_label_obj, arena);
+        if (res == RC_OK)
+            res = prv_gpart_recurse(&sub, &sub_label_obj, s == 0 ? left : parts - left, s == 0 ? first : first + left, tol, part_obj, rng, arena);
+    }
+
+    return res;
+}
+
+/*!
+ * \brief           Sort the rows of a matrix by part (counting sort, stable).
+ *
+ * \param[in]       part: Part of each row.
+ * \param[in]       m: Number of rows.
+ * \param[in]       parts: Number of parts.
+ * \param[out]      start: First position of each part in order (parts + 1 items).
+ * \param[out]      order: Rows, part by part (m items).
+ */
+static void prv_gpart_order(const int *part, int m, int parts, int *start, int *order) {
+    memset(start, 0, sizeof(int) * ((size_t)parts + 1));
+    for (int i = 0; i < m; ++i)
+        start[part[i] + 1]++;
+    for (int p = 0; p < parts; ++p)
+        start[p + 1] += start[p];
+
+    /*! start[p] is used as the insertion point of part p, then shifted back */
+    for (int i = 0; i < m; ++i)
+        order[start[part[i]]++] = i;
+    memmove(start + 1, start, sizeof(int) * (size_t)parts);
+    start[0] = 0;
+}
+
+/*!
+ * \brief           Compute the cost of a partition.
+ *
+ * \param[in,out]   gp: Pointer to the partition, with its parts set.
+ * \param[in]       mtx: Pointer to the partitioned CSR matrix.
+ * \param[out]      arena: Pointer to the arena handler for memory allocation.
+ * \return          RC_OK on success, RC_MEM_ALLOC_ERR otherwise.
+ */
+static int prv_gpart_evaluate(struct Gpart *gp, const struct CsrMatrix *mtx, struct ArenaHandler *arena) {
+    struct ArenaObj start_obj;
+    struct ArenaObj order_obj;
+    struct ArenaObj mark_obj;
+    int res = prv_gpart_alloc(&gp->part_nnz, gp->parts, arena);
+    if (res == RC_OK)
+        res = prv_gpart_alloc(&gp->part_cut, gp->parts, arena);
+    if (res == RC_OK)
+        res = prv_gpart_alloc(&gp->part_halo, gp->parts, arena);
+    if (res == RC_OK)
+        res = prv_gpart_alloc(&gp->perm, mtx->m, arena);
+    if (res == RC_OK)
+        res = prv_gpart_alloc(&start_obj, gp->parts + 1, arena);
+    if (res == RC_OK)
+        res = prv_gpart_alloc(&order_obj, mtx->m, arena);
+    if (res == RC_OK)
+        res = prv_gpart_alloc(&mark_obj, mtx->n, arena);
+    if (res != RC_OK)
+        return res;
+
+    const int *row = csr_matrix_row_ptr(mtx);
+    const int *col = csr_matrix_col_idx(mtx);
+    const int *part = arena_get_ptr(&gp->part);
+    int *part_nnz = arena_get_ptr(&gp->part_nnz);
+    int *part_cut = arena_get_ptr(&gp->part_cut);
+    int *part_halo = arena_get_ptr(&gp->part_halo);
+    int *perm = arena_get_ptr(&gp->perm);
+    int *start = arena_get_ptr(&start_obj);
+    int *order = arena_get_ptr(&order_obj);
+    int *mark = arena_get_ptr(&mark_obj);
+
+    prv_gpart_order(part, mtx->m, gp->parts, start, order);
+    for (int r = 0; r < mtx->m; ++r)
+        perm[order[r]] = r;
+    for (int j = 0; j < mtx->n; ++j)
+        mark[j] = -1;
+
+    /*! The rows of a part are visited together: mark[j] == p once part p counted column j in its halo */
+    gp->edge_cut = 0;
+    gp->volume = 0;
+    gp->max_halo = 0;
+    int max_nnz = 0;
+    for (int p = 0; p < gp->parts; ++p) {
+        for (int r = start[p]; r < start[p + 1]; ++r) {
+            const int i = order[r];
+            part_nnz[p] += row[i + 1] - row[i];
+            for (int k = row[i]; k < row[i + 1]; ++k) {
+                const int j = col[k];
+                if (part[j] == p)
+                    continue;
+                part_cut[p]++;
+                if (mark[j] != p) {
+                    mark[j] = p;
+                    part_halo[p]++;
+                }
+            }
+        }
+        gp->edge_cut += part_cut[p];
+        gp->volume += part_halo[p];
+        gp->max_halo = GET_MAX(gp->max_halo, part_halo[p]);
+        max_nnz = GET_MAX(max_nnz, part_nnz[p]);
+    }
+    gp->imbalance = mtx->nz > 0 ? (double)max_nnz * gp->parts / mtx->nz : 1.0;
+
+    return RC_OK;
+}
+
+/*!
+ * \brief           Check the arguments of a partitioning and reset the partition.
+ *
+ * \param[out]      gp: Pointer to the partition.
+ * \param[in]       mtx: Pointer to the CSR matrix.
+ * \param[in]       parts: Number of parts.
+ * \param[out]      arena: Pointer to the arena handler for memory allocation.
+ * \return          RC_OK on success, an error code otherwise.
+ */
+static int prv_gpart_prepare(struct Gpart *gp, const struct CsrMatrix *mtx, int parts, struct ArenaHandler *arena) {
+    if (!gp || !mtx || !arena || parts < 1 || parts > CONFIG_GPART_MAX_PARTS) {
+        rc_set_err_msg("Invalid argument(s) provided to the graph partitioner");
+        return RC_INVALID_ARG_ERR;
+    }
+
+    if (mtx->m != mtx->n) {
+        rc_set_err_msg("Only square matrices have a graph to partition (%dx%d given)", mtx->m, mtx->n);
+        return RC_INVALID_ARG_ERR;
+    }
+
+    *gp = (struct Gpart){ .parts = parts };
+    return prv_gpart_alloc(&gp->part, mtx->m, arena);
+}
+
+int gpart_init(struct Gpart *gp, const struct CsrMatrix *mtx, int parts, struct ArenaHandler *arena) {
+    SLOG_DEBUG("Entering gpart_init");
+    int res = prv_gpart_prepare(gp, mtx, parts, arena);
+    if (res != RC_OK)
+        return res;
+
+    struct GpartGraph g;
+    struct ArenaObj label_obj;
+    res = prv_gpart_graph_from_csr(&g, mtx, arena);
+    if (res == RC_OK)
+        res = prv_gpart_alloc(&label_obj, mtx->m, arena);
+    if (res != RC_OK)
+        return res;
+
+    int *label = arena_get_ptr(&label_obj);
+    for (int v = 0; v < g.n; ++v)
+        label[v] = v;
+
+    /*! The tolerance compounds over the bisections from the whole graph to a part */
+    const double tol = parts > 1 ? pow(CONFIG_GPART_IMBALANCE, 1.0 / ceil(log2(parts))) : CONFIG_GPART_IMBALANCE;
+    uint64_t rng = CONFIG_GPART_SEED;
+    res = prv_gpart_recurse(&g, &label_obj, parts, 0, tol, &gp->part, &rng, arena);
+    if (res != RC_OK)
+        return res;
+
+    return prv_gpart_evaluate(gp, mtx, arena);
+}
+
+int gpart_init_contiguous(struct Gpart *gp, const struct CsrMatrix *mtx, int parts, struct ArenaHandler *arena) {
+    SLOG_DEBUG("Entering gpart_init_contiguous");
+    int res = prv_gpart_prepare(gp, mtx, parts, arena);
+    if (res != RC_OK)
+        return res;
+
+    int *part = arena_get_ptr(&gp->part);
+    for (int p = 0; p < parts; ++p)
+        for (int i = partition_nnz_bound(mtx, p, parts); i < partition_nnz_bound(mtx, p + 1, parts); ++i)
+            part[i] = p;
+
+    return prv_gpart_evaluate(gp, mtx, arena);
+}
+
+int gpart_permute(struct CsrMatrix *dest, const struct CsrMatrix *src, const struct Gpart *gp, struct ArenaHandler *arena) {
+    SLOG_DEBUG("Entering gpart_permute");
+    if (!dest || !src || !gp || !arena || dest == src || src->m != src->n) {
+        rc_set_err_msg("Invalid argument(s) provided to gpart_permute");
+        return RC_INVALID_ARG_ERR;
+    }
+
+    const size_t val_size = csr_matrix_val_size(src);
+
+    /*! Scanning the columns of the transpose in their new order keeps the permuted rows sorted */
+    struct CsrMatrix t;
+    int res = csr_matrix_transpose(&t, src, arena);
+    if (res != RC_OK)
+        return res;
+
+    *dest = (struct CsrMatrix){
+        .m = src->m,
+        .n = src->n,
+        .nz = src->nz,
+        .is_real = src->is_real,
+        .val_type = src->val_type,
+        .max_abs_val = src->max_abs_val,
+        .max_row_nnz = src->max_row_nnz,
+    };
+
+    struct ArenaObj order_obj;
+    enum ArenaReturnCode arena_res = arena_calloc(arena, sizeof(int), (size_t)dest->m + 1, &dest->row);
+    if (arena_res == ARENA_RC_OK)
+        arena_res = arena_calloc(arena, sizeof(int), GET_MAX(dest->nz, 1), &dest->col);
+    if (arena_res == ARENA_RC_OK)
+        arena_res = arena_calloc(arena, val_size, GET_MAX(dest->nz, 1), &dest->val);
+    if (arena_res == ARENA_RC_OK)
+        arena_res = arena_calloc(arena, sizeof(int), GET_MAX(dest->m, 1), &order_obj);
+    if (arena_res != ARENA_RC_OK) {
+        rc_set_err_msg("Memory array allocation failed in gpart_permute");
+        return RC_MEM_ALLOC_ERR;
+    }
+
+    const int *row = csr_matrix_row_ptr(src);
+    const int *t_row = csr_matrix_row_ptr(&t);
+    const int *t_col = csr_matrix_col_idx(&t);
+    const char *t_val = csr_matrix_values(&t);
+    const int *perm = arena_get_ptr(&gp->perm);
+    int *d_row = csr_matrix_row_ptr(dest);
+    int *d_col = csr_matrix_col_idx(dest);
+    char *d_val = csr_matrix_values(dest);
+    int *order = arena_get_ptr(&order_obj);
+
+    for (int i = 0; i < src->m; ++i)
+        order[perm[i]] = i;
+
+    for (int i = 0; i < src->m; ++i)
+        d_row[perm[i] + 1] = row[i + 1] - row[i];
+    for (int r = 0; r < dest->m; ++r)
+        d_row[r + 1] += d_row[r];
+
+    /*! d_row[r] is used as the insertion point of row r, then shifted back */
+    for (int c = 0; c < dest->n; ++c) {
+        const int j = order[c];
+        for (int k = t_row[j]; k < t_row[j + 1]; ++k) {
+            const int pos = d_row[perm[t_col[k]]]++;
+            d_col[pos] = c;
+            memcpy(d_val + (size_t)pos * val_size, t_val + (size_t)k * val_size, val_size);
+        }
+    }
+    memmove(d_row + 1, d_row, sizeof(int) * (size_t)dest->m);
+    d_row[0] = 0;
+
+    return RC_OK;
+}
@@ -0,0 +1,220 @@
+/*!
+ * \file            helper.c
+ * \date            2026-10-18
+ * \author          Mirko Lana [lana.mirko@icloud.com]
+ *
+ * \brief           SMT helper-thread prefetching for the CSR SpMV (experimental).
+ */
+
+#include "config.h"
+#include "helper.h"
+#include "rc.h"
+#include "arena.h"
+#include "barrier.h"
+#include "csr.h"
+#include "partition.h"
+#include "pool.h"
+#include "topo.h"
+#include "vec.h"
+#include "slog.h"
+#include "utils.h"
+
+#include <stdbool.h>
+
+/*!
+ * \brief           Structure containing the state shared by a compute thread and its helper.
+ *
+ * \details         Padded to a cache line, so that the pairs do not share the
+ *                  line they poll.
+ */
+struct HelperSlot {
+    atomic_int progress; /*< First non-zero not computed yet by the compute thread */
+    unsigned sink;       /*< Sum of the bytes loaded by the helper (keeps the loads alive) */
+    char pad[CONFIG_TOPO_FALLBACK_LINE_SIZE - sizeof(atomic_int) - sizeof(unsigned)];
+};
+
+/*!
+ * \brief           Pick the CPUs of the compute and helper threads.
+ *
+ * \details         Pairs go to the cores with at least two hardware threads:
+ *                  the compute thread on the first one, its helper on the first
+ *                  sibling. Pairs left without such a core stay unpinned.
+ *
+ * \param[in]       threads: Number of compute threads.
+ * \param[out]      cpus: CPU of each pool thread (2 * threads items, -1 if unpinned).
+ * \return          The number of pinned pairs.
+ */
+static int prv_helper_plan_cpus(int threads, int *cpus) {
+    const struct Topology *topo = topo_get();
+    int pairs = 0;
+
+    for (int t = 0; t < 2 * threads; ++t)
+        cpus[t] = -1;
+
+    for (int cpu = 0; cpu < CONFIG_TOPO_MAX_CPUS && pairs < threads; ++cpu) {
+        int sibling = topo->cpu_sibling[cpu];
+        if (topo->cpu_core[cpu] < 0 || sibling <= cpu)
+            continue; /*! Offline, without SMT or already paired with a lower CPU */
+
+        cpus[pairs] = cpu;
+        cpus[threads + pairs] = sibling;
+        pairs++;
+    }
+
+    return pairs;
+}
+
+/*!
+ * \brief           Compute the rows of a pair, publishing the progress to the helper.
+ *
+ * \param[in,out]   team: Pointer to the team.
+ * \param[in,out]   slot: Pointer to the slot of the pair.
+ * \param[in]       row_begin: First row of the pair.
+ * \param[in]       row_end: One past the last row of the pair.
+ */
+static void prv_helper_compute(struct HelperTeam *team, struct HelperSlot *slot, int row_begin, int row_end) {
+    const int *row = csr_matrix_row_ptr(team->mtx);
+
+    for (int i = row_begin; i < row_end;) {
+        int end = GET_MIN(i + CONFIG_HELPER_PUBLISH_ROWS, row_end);
+        csr_matrix_mul_vec_rows(team->mtx, team->vec, team->result, i, end);
+        atomic_store_explicit(&slot->progress, row[end], memory_order_relaxed);
+        i = end;
+    }
+}
+
+/*!
+ * \brief           Load the vector items gathered by the non-zeros of a pair ahead of its compute thread.
+ *
+ * \details         One byte per item is enough to bring its line into the
+ *                  caches of the core. The progress is only a hint, read
+ *                  without ordering: a stale value makes the helper wait or
+ *                  skip a little more than needed, never compute anything.
+ *
+ * \param[in,out]   team: Pointer to the team.
+ * \param[in,out]   slot: Pointer to the slot of the pair.
+ * \param[in]       nnz_begin: First non-zero of the pair.
+ * \param[in]       nnz_end: One past the last non-zero of the pair.
+ */
+static void prv_helper_run_ahead(struct HelperTeam *team, struct HelperSlot *slot, int nnz_begin, int nnz_end) {
+    const int *col = csr_matrix_col_idx(team->mtx);
+    const unsigned char *x = arena_get_ptr(&team->vec->val);
+    const size_t item = team->vec->is_real ? sizeof(double) : sizeof(int);
+    unsigned sink = 0U;
+    long throttles = 0;
+    bool waiting = false;
+
+    for (int k = nnz_begin; k < nnz_end;) {
+        int done = atomic_load_explicit(&slot->progress, memory_order_relaxed);
+        if (k < done) {
+            k = done; /*! Fell behind: the lines before done are no longer needed */
+            continue;
+        }
+
+        if (k - done >= team->max_ahead) {
+            throttles += !waiting;
+            waiting = true;
+            barrier_cpu_relax();
+            continue;
+        }
+
+        waiting = false;
+        for (int end = GET_MIN(k + CONFIG_HELPER_STEP, nnz_end); k < end; ++k)
+            sink += x[(size_t)col[k] * item];
+    }
+
+    slot->sink = sink;
+    if (throttles > 0)
+        atomic_fetch_add_explicit(&team->throttles, throttles, memory_order_relaxed);
+}
+
+/*!
+ * \brief           Pool task running a compute thread or a helper thread.
+ *
+ * \param[in,out]   arg: Pointer to the HelperTeam.
+ * \param[in]       tid: Index of the calling thread: compute threads first, then helpers.
+ * \param[in]       threads: Number of threads of the pool.
+ */
+static void prv_helper_task(void *arg, int tid, int threads) {
+    UNUSED(threads);
+    struct HelperTeam *team = arg;
+    const int pair = tid % team->threads;
+    const int *bounds = partition_get_bounds(&team->part);
+    const int *row = csr_matrix_row_ptr(team->mtx);
+    struct HelperSlot *slot = (struct HelperSlot *)arena_get_ptr(&team->slots) + pair;
+
+    if (tid < team->threads)
+        prv_helper_compute(team, slot, bounds[pair], bounds[pair + 1]);
+    else
+        prv_helper_run_ahead(team, slot, row[bounds[pair]], row[bounds[pair + 1]]);
+}
+
+int helper_init(struct HelperTeam *team, const struct CsrMatrix *mtx, int threads, struct ArenaHandler *arena) {
+    SLOG_DEBUG("Entering helper_init");
+    if (!team || !mtx || !arena || threads < 1 || threads > CONFIG_TOPO_MAX_CPUS) {
+        rc_set_err_msg("Invalid argument(s) provided to helper_init");
+        return RC_INVALID_ARG_ERR;
+    }
+
+    team->threads = threads;
+    team->max_ahead = GET_MAX(topo_get_cache_size(2) / topo_get_line_size() / CONFIG_HELPER_L2_SHARE, CONFIG_HELPER_STEP); /*! One line per gathered item at worst */
+    team->mtx = NULL;
+    team->vec = NULL;
+    team->result = NULL;
+    atomic_init(&team->throttles, 0);
+
+    int res = partition_init_nnz(&team->part, mtx, threads, arena);
+    if (res != RC_OK)
+        return res;
+
+    enum ArenaReturnCode arena_res = arena_calloc(arena, sizeof(struct HelperSlot), threads, &team->slots);
+    if (arena_res != ARENA_RC_OK) {
+        rc_set_err_msg("Memory array allocation failed in helper_init");
+        return RC_MEM_ALLOC_ERR;
+    }
+
+    /*! On the stack: pool_init allocates from the arena before pinning */
+    int cpus[2 * CONFIG_TOPO_MAX_CPUS];
+    team->pinned = prv_helper_plan_cpus(threads, cpus);
+    if (team->pinned < threads)
+        SLOG_WARN("Only %d of %d helper threads run on an SMT sibling of their compute thread", team->pinned, threads);
+
+    res = pool_init(&team->pool, 2 * threads, cpus, arena);
+    if (res != RC_OK)
+        return res;
+
+    SLOG_DEBUG("Helper team: %d compute threads, %d pinned pairs, %d non-zeros ahead at most", threads, team->pinned, team->max_ahead);
+    return RC_OK;
+}
+
+int helper_mul_vec(struct HelperTeam *team, const struct CsrMatrix *mtx, const struct Vec *vec, struct Vec *result) {
+    if (!team || !mtx || !vec || !result) {
+        rc_set_err_msg("Invalid NULL argument(s) provided to helper_mul_vec");
+        return RC_INVALID_ARG_ERR;
+    }
+
+    if (mtx->n != vec->n || mtx->is_real != vec->is_real || vec_size(result) != mtx->m) {
+        rc_set_err_msg("Incompatible matrix and vector dimensions or types in helper_mul_vec");
+        return RC_INVALID_ARG_ERR;
+    }
+
+    team->mtx = mtx;
+    team->vec = vec;
+    team->result = result;
+
+    /*! Reset before the pool starts, so no helper sees the end of the previous call */
+    const int *bounds = partition_get_bounds(&team->part);
+    const int *row = csr_matrix_row_ptr(mtx);
+    struct HelperSlot *slots = arena_get_ptr(&team->slots);
+    for (int p = 0; p < team->threads; ++p)
+        atomic_store_explicit(&slots[p].progress, row[bounds[p]], memory_order_relaxed);
+
+    return pool_run(&team->pool, prv_helper_task, team);
+}
+
+void helper_destroy(struct HelperTeam *team) {
+    if (!team)
+        return;
+
+    pool_destroy(&team->pool);
+}
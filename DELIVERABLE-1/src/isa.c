@@ -0,0 +1,69 @@
+/*!
+ * \file            isa.c
+ * \date            2026-10-18
+ * \author          Mirko Lana [lana.mirko@icloud.com]
+ *
+ * \brief           Runtime CPU feature detection for kernel dispatch.
+ */
+
+#include "isa.h"
+#include "rc.h"
+#include "slog.h"
+
+static enum IsaLevel g_isa_max = ISA_LEVEL_BASELINE; /*!< Best level supported by the CPU */
+static enum IsaLevel g_isa = ISA_LEVEL_BASELINE;     /*!< Selected level */
+
+int isa_init(void) {
+    SLOG_DEBUG("Entering isa_init");
+    g_isa_max = ISA_LEVEL_BASELINE;
+
+#ifdef ISA_ENABLE_X86_DISPATCH
+    /*! libgcc also checks that the OS saves the YMM/ZMM state (XGETBV) */
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma"))
+        g_isa_max = ISA_LEVEL_AVX2;
+    if (g_isa_max == ISA_LEVEL_AVX2 && __builtin_cpu_supports("avx512f") && __builtin_cpu_supports("avx512vl") &&
+        __builtin_cpu_supports("avx512bw") && __builtin_cpu_supports("avx512dq"))
+        g_isa_max = ISA_LEVEL_AVX512;
+#endif /*! ISA_ENABLE_X86_DISPATCH */
+
+    g_isa = g_isa_max;
+    SLOG_INFO("Kernels dispatched to: %s", isa_to_str(g_isa));
+
+    return RC_OK;
+}
+
+enum IsaLevel isa_get(void) {
+    return g_isa;
+}
+
+enum IsaLevel isa_get_max(void) {
+    return g_isa_max;
+}
+
+int isa_set(enum IsaLevel level) {
+    if (level < ISA_LEVEL_BASELINE || level > g_isa_max) {
+        rc_set_err_msg("Instruction set '%s' is not supported by this CPU", isa_to_str(level));
+        return RC_INVALID_ARG_ERR;
+    }
+
+    g_isa = level;
+    return RC_OK;
+}
+
+const char *isa_to_str(enum IsaLevel level) {
+    switch (level) {
+        case ISA_LEVEL_BASELINE:
+#ifdef __x86_64__
+            return "sse2";
+#else
+            return "generic";
+#endif /*! __x86_64__ */
+        case ISA_LEVEL_AVX2:
+            return "avx2";
+        case ISA_LEVEL_AVX512:
+            return "avx512";
+        default:
+            return "unknown";
+    }
+}
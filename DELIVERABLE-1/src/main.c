@@ -19,9 +19,21 @@
 #include "rc.h"
 #include "slog.h"
 #include "bench.h"
+#include "topo.h"
+#include "isa.h"
+#include "dist.h"
+#include "serve.h"
+#include "sweep.h"
+
+#ifdef CONFIG_ENABLE_MPI
+#include <mpi.h>
+#endif /*! CONFIG_ENABLE_MPI */
 
 static struct ArenaHandler g_arena_handler;
+static struct BenchHandler g_bench_handler;
 static char g_bench_results_filename[CONFIG_BENCH_FILENAME_MAX_LEN];
+static bool g_serving;  /*!< Whether the program serves SpMVs (--serve) instead of benchmarking */
+static bool g_sweeping; /*!< Whether the program benchmarks a list of matrices (--batch) */
 #ifdef CONFIG_ENABLE_OMP_PARALLELISM
 static omp_lock_t g_omp_lock;
 #endif /*! CONFIG_ENABLE_OMP_PARALLELISM */
@@ -29,27 +41,66 @@ static omp_lock_t g_omp_lock;
 static void enter_cs(void);
 static void exit_cs(void);
 static int init(int argc, char *argv[]);
+static int fini(int res);
 
 int main(int argc, char *argv[]) {
+#ifdef CONFIG_ENABLE_MPI
+    int provided;
+    MPI_Init_thread(&argc, &argv, MPI_THREAD_FUNNELED, &provided); /*! Only the master thread of a rank calls MPI */
+#endif /*! CONFIG_ENABLE_MPI */
+
     assert(!init(argc, argv)); /*! Terminate if initialization fails. */
 
-    int res = bench_warmup();
+    if (g_serving) {
+        int res = serve_run();
+        if (res != RC_OK)
+            SLOG_ERROR("%s", rc_get_err_msg());
+        return fini(res == RC_OK ? EXIT_SUCCESS : EXIT_FAILURE);
+    }
+
+    if (g_sweeping) {
+        int res = sweep_run();
+        if (res != RC_OK)
+            SLOG_ERROR("%s", rc_get_err_msg());
+        return fini(res == RC_OK ? EXIT_SUCCESS : EXIT_FAILURE);
+    }
+
+    int res = bench_warmup(&g_bench_handler);
     if (res != RC_OK) {
-        SLOG_ERROR("%s", rc_get_err_msg);
-        return res;
+        SLOG_ERROR("%s", rc_get_err_msg());
+        return fini(res);
     }
 
     struct BenchResults bench_results;
 
-    res = bench_run(&bench_results, &g_arena_handler);
+    res = bench_run(&g_bench_handler, &bench_results, &g_arena_handler);
     if (res != RC_OK) {
         SLOG_ERROR("%s", rc_get_err_msg());
-        return res;
+        return fini(res);
     }
 
-    bench_save_result(&bench_results, g_bench_results_filename);
+    if (dist_rank() == 0)
+        bench_save_result(&bench_results, g_bench_results_filename);
 
-    return EXIT_SUCCESS;
+    return fini(EXIT_SUCCESS);
+}
+
+/*!
+ * \brief           Release the benchmark or the server and shut down MPI, aborting the other ranks on failure.
+ *
+ * \param[in]       res: Exit code of the calling rank.
+ * \return          res.
+ */
+static int fini(int res) {
+    bench_fini(&g_bench_handler);
+    serve_fini();
+    sweep_fini();
+#ifdef CONFIG_ENABLE_MPI
+    if (res != EXIT_SUCCESS)
+        MPI_Abort(MPI_COMM_WORLD, res);
+    MPI_Finalize();
+#endif /*! CONFIG_ENABLE_MPI */
+    return res;
 }
 
 static void enter_cs(void) {
@@ -68,7 +119,7 @@ static int init(int argc, char *argv[]) {
     const struct CliArguments *cli_args = cli_parse_args(argc, argv);
 
     struct Slogger logger = SLOG_INIT_DEFAULT_LOGGER;
-    logger.lv = cli_args->log_lv;
+    logger.lv = dist_rank() == 0 ? cli_args->log_lv : SLOG_LEVEL_ERROR; /*! Other MPI ranks only report errors */
 
     const struct SlogConfig slog_cfg = {
         .default_logger = logger,
@@ -78,9 +129,6 @@ static int init(int argc, char *argv[]) {
 
 #ifdef CONFIG_ENABLE_OMP_PARALLELISM
     omp_init_lock(&g_omp_lock);
-
-    SLOG_INFO("Set OpenMP threads count to: %d", cli_args->num_threads);
-    omp_set_num_threads(cli_args->num_threads);
 #endif /*! CONFIG_ENABLE_OMP_PARALLELISM */
 
     slog_init(&slog_cfg);
@@ -92,31 +140,90 @@ static int init(int argc, char *argv[]) {
         return RC_FAIL;
     }
 
+    int res = topo_init();
+    if (res != RC_OK) {
+        SLOG_ERROR("Failed to discover the machine topology - %s", rc_get_err_msg());
+        return RC_FAIL;
+    }
+
+    res = isa_init();
+    if (res != RC_OK) {
+        SLOG_ERROR("Failed to detect the CPU instruction sets - %s", rc_get_err_msg());
+        return RC_FAIL;
+    }
+
+    if (cli_args->serve_path) {
+        const struct ServeConfig serve_cfg = {
+            .path = cli_args->serve_path,
+            .filenames = cli_args->input_files,
+            .matrices = cli_args->input_count,
+            .thread_count = cli_args->num_threads,
+            .kernel = cli_args->kernel,
+            .coalesce = cli_args->coalesce,
+            .window_us = cli_args->window_us,
+            .shared = cli_args->shared,
+            .arena = &g_arena_handler,
+        };
+
+        res = serve_init(&serve_cfg);
+        if (res != RC_OK) {
+            SLOG_ERROR("Failed to initialize the server - %s", rc_get_err_msg());
+            return RC_FAIL;
+        }
+        g_serving = true;
+        SLOG_INFO("Initialization completed successfully.");
+        return RC_OK;
+    }
+
     const struct BenchConfig bench_cfg = {
         .filename = cli_args->input_file,
+        .filenames = cli_args->input_files,
+        .matrices = cli_args->input_count,
+        .groups = cli_args->tp_groups,
+        .batch_count = cli_args->batch_count,
+        .chunk_rows = cli_args->chunk_rows,
+        .chunk_order = cli_args->chunk_order,
+        .thread_count = cli_args->num_threads,
         .warmup_iters = cli_args->warmup_iters,
         .runs = cli_args->runs,
+        .mode = cli_args->mode,
+        .kernel = cli_args->kernel,
+        .quant_bits = cli_args->quant_bits,
+        .compress = cli_args->compress,
+        .mpk_steps = cli_args->mpk_steps,
+        .poly_degree = cli_args->poly_degree,
+        .gpart_parts = cli_args->gpart_parts,
+        .shared = cli_args->shared,
+        .x_file = cli_args->x_file,
+        .y_file = cli_args->y_file,
         .arena = &g_arena_handler,
     };
 
     srand(time(NULL));
-    int res = bench_init(&bench_cfg);
+    if (cli_args->batch_list) {
+        const struct SweepConfig sweep_cfg = {
+            .list = cli_args->batch_list,
+            .bench = bench_cfg,
+            .arena = &g_arena_handler,
+        };
+
+        res = sweep_init(&sweep_cfg);
+        if (res != RC_OK) {
+            SLOG_ERROR("Failed to initialize the sweep - %s", rc_get_err_msg());
+            return RC_FAIL;
+        }
+        g_sweeping = true;
+        SLOG_INFO("Initialization completed successfully.");
+        return RC_OK;
+    }
+
+    res = bench_init(&g_bench_handler, &bench_cfg);
     if (res != RC_OK) {
         SLOG_ERROR("Failed to initialize the benchmark module - %s", rc_get_err_msg());
         return RC_FAIL;
     }
 
-    /*! Get the filename only (removing path/to/file and extension) */
-    const char *last_slash = strrchr(cli_args->input_file, '/');
-    if (last_slash)
-        strncpy(g_bench_results_filename, last_slash + 1, CONFIG_BENCH_FILENAME_MAX_LEN - 1);
-    else
-        strncpy(g_bench_results_filename, cli_args->input_file, CONFIG_BENCH_FILENAME_MAX_LEN - 1);
-    char *dot = strrchr(g_bench_results_filename, '.');
-    if (dot)
-        *dot = '\0';
-    strncat(g_bench_results_filename, ".json", CONFIG_BENCH_FILENAME_MAX_LEN - strlen(g_bench_results_filename) - 1);
-
+    bench_result_filename(cli_args->input_file, g_bench_results_filename);
     SLOG_INFO("Benchmark results will be saved to '%s'", g_bench_results_filename);
     SLOG_INFO("Initialization completed successfully.");
 
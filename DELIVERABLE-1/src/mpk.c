@@ -0,0 +1,375 @@
+/*!
+ * \file            mpk.c
+ * \date            2026-10-18
+ * \author          Mirko Lana [lana.mirko@icloud.com]
+ *
+ * \brief           Matrix-powers kernel [A x, A^2 x, ..., A^s x] for s-step Krylov methods.
+ */
+
+#include "config.h"
+#include "mpk.h"
+#include "rc.h"
+#include "arena.h"
+#include "barrier.h"
+#include "csr.h"
+#include "partition.h"
+#include "pool.h"
+#include "topo.h"
+#include "vec.h"
+#include "slog.h"
+#include "utils.h"
+
+#include <sched.h>
+#include <stdbool.h>
+
+#ifdef CONFIG_ENABLE_OMP_PARALLELISM
+#include <omp.h>
+#endif /*! CONFIG_ENABLE_OMP_PARALLELISM */
+
+/*!
+ * \brief           Structure containing the progress of a thread, one power per item.
+ *
+ * \details         Padded to a cache line: only its thread writes it, the
+ *                  others poll it.
+ */
+struct MpkProgress {
+    atomic_int done[CONFIG_MPK_MAX_STEPS]; /*< Per power: first row not computed yet, last computed one if descending */
+    char pad[CONFIG_TOPO_FALLBACK_LINE_SIZE - sizeof(atomic_int) * CONFIG_MPK_MAX_STEPS % CONFIG_TOPO_FALLBACK_LINE_SIZE];
+};
+
+/*!
+ * \brief           Structure containing the arguments of a Pthreads matrix-powers kernel.
+ */
+struct MpkPoolTask {
+    struct MpkPlan *plan;  /*< Plan */
+    const struct Vec *vec; /*< Input vector */
+    struct Vec *powers;    /*< Result vectors */
+};
+
+/*!
+ * \brief           Get the number of threads of the parallel backend.
+ *
+ * \return          The number of threads.
+ */
+static int prv_mpk_threads(void) {
+#ifdef CONFIG_ENABLE_PTHREADS_PARALLELISM
+    struct ThreadPool *pool = pool_get_default();
+    return pool ? pool->threads : 1;
+#elif defined(CONFIG_ENABLE_OMP_PARALLELISM)
+    return omp_get_max_threads();
+#else
+    return 1;
+#endif /*! CONFIG_ENABLE_PTHREADS_PARALLELISM */
+}
+
+/*!
+ * \brief           Get the direction of the wavefront of a thread.
+ *
+ * \details         Even threads go down the rows and odd ones up, so two
+ *                  neighbors either start from their common boundary or reach
+ *                  it together: the rows one reads from the other are ready
+ *                  when needed. With all threads going down, a thread would
+ *                  wait for the last rows of the previous one, computed last.
+ *
+ * \param[in]       tid: Index of the thread.
+ * \return          True if the thread computes its blocks from the last one.
+ */
+static inline bool prv_mpk_descending(int tid) {
+    return tid % 2 == 1;
+}
+
+/*!
+ * \brief           Find the block holding a row.
+ *
+ * \param[in]       block_row: First row of each block (blocks + 1 items).
+ * \param[in]       blocks: Number of blocks.
+ * \param[in]       i: Row.
+ * \return          The index of the block.
+ */
+static int prv_mpk_block_of(const int *block_row, int blocks, int i) {
+    int lo = 0;
+    int hi = blocks - 1;
+
+    while (lo < hi) {
+        int mid = lo + (hi - lo + 1) / 2;
+        if (block_row[mid] <= i)
+            lo = mid;
+        else
+            hi = mid - 1;
+    }
+
+    return lo;
+}
+
+/*!
+ * \brief           Split the rows of each thread in blocks.
+ *
+ * \param[in,out]   plan: Pointer to the plan.
+ * \param[out]      first_block: First block of each thread (threads + 1 items).
+ * \param[out]      block_row: First row of each block (blocks + 1 items), NULL to count the blocks only.
+ * \return          The number of blocks.
+ */
+static int prv_mpk_split(const struct MpkPlan *plan, int *first_block, int *block_row) {
+    const struct CsrMatrix *mtx = plan->mtx;
+    const int *row = csr_matrix_row_ptr(mtx);
+    int blocks = 0;
+
+    for (int t = 0; t < plan->threads; ++t) {
+        const int row_end = partition_nnz_bound(mtx, t + 1, plan->threads);
+        int i = partition_nnz_bound(mtx, t, plan->threads);
+
+        first_block[t] = blocks;
+        while (i < row_end) {
+            if (block_row)
+                block_row[blocks] = i;
+            blocks++;
+
+            const int nnz_begin = row[i];
+            do
+                ++i;
+            while (i < row_end && row[i + 1] - nnz_begin <= plan->block_nnz);
+        }
+    }
+
+    first_block[plan->threads] = blocks;
+    if (block_row)
+        block_row[blocks] = mtx->m;
+    return blocks;
+}
+
+/*!
+ * \brief           Check that the rows of a power read by a block are done.
+ *
+ * \param[in]       plan: Pointer to the plan.
+ * \param[in]       power: Index of the power read.
+ * \param[in]       lo: Lowest row read.
+ * \param[in]       hi: Highest row read (lo > hi for none).
+ * \return          True if every thread owning some of the rows computed them.
+ */
+static bool prv_mpk_ready(const struct MpkPlan *plan, int power, int lo, int hi) {
+    const int *first_block = arena_get_ptr(&plan->first_block);
+    const int *block_row = arena_get_ptr(&plan->block_row);
+    struct MpkProgress *progress = arena_get_ptr(&plan->progress);
+
+    for (int t = 0; t < plan->threads && lo <= hi; ++t) {
+        const int row_begin = block_row[first_block[t]];
+        const int row_end = block_row[first_block[t + 1]];
+        if (row_end <= lo || row_begin > hi)
+            continue;
+
+        const int done = atomic_load_explicit(&progress[t].done[power], memory_order_acquire);
+        if (prv_mpk_descending(t) ? done > GET_MAX(lo, row_begin) : done < GET_MIN(hi + 1, row_end))
+            return false;
+    }
+
+    return true;
+}
+
+/*!
+ * \brief           Run the wavefront over the blocks of one thread.
+ *
+ * \details         Deeper powers go first, so a block is reused while cached;
+ *                  the first power, which only reads the input vector, advances
+ *                  by one block per round. A round without progress is a stall.
+ *
+ * \param[in,out]   plan: Pointer to the plan.
+ * \param[in]       tid: Index of the calling thread.
+ * \param[in]       vec: Pointer to the input vector.
+ * \param[out]      powers: Result vectors.
+ */
+static void prv_mpk_wavefront(struct MpkPlan *plan, int tid, const struct Vec *vec, struct Vec *powers) {
+    const int *first_block = arena_get_ptr(&plan->first_block);
+    const int *block_row = arena_get_ptr(&plan->block_row);
+    const int *block_lo = arena_get_ptr(&plan->block_lo);
+    const int *block_hi = arena_get_ptr(&plan->block_hi);
+    struct MpkProgress *progress = (struct MpkProgress *)arena_get_ptr(&plan->progress) + tid;
+    const bool descending = prv_mpk_descending(tid);
+    const int count = first_block[tid + 1] - first_block[tid];
+    int done[CONFIG_MPK_MAX_STEPS] = { 0 }; /*! Blocks computed per power, in the order of the thread */
+    long stalls = 0;
+    int spins = 0;
+
+    while (done[plan->steps - 1] < count) {
+        bool progressed = false;
+
+        for (int l = plan->steps - 1; l >= 0; --l) {
+            while (done[l] < (l > 0 ? done[l - 1] : GET_MIN(done[0] + 1, count))) {
+                const int b = descending ? first_block[tid + 1] - 1 - done[l] : first_block[tid] + done[l];
+                if (l > 0 && !prv_mpk_ready(plan, l - 1, block_lo[b], block_hi[b]))
+                    break;
+
+                csr_matrix_mul_vec_rows(plan->mtx, l > 0 ? &powers[l - 1] : vec, &powers[l], block_row[b], block_row[b + 1]);
+                atomic_store_explicit(&progress->done[l], descending ? block_row[b] : block_row[b + 1], memory_order_release);
+                done[l]++;
+                progressed = true;
+            }
+        }
+
+        if (progressed) {
+            spins = 0;
+        } else if (spins++ == 0) {
+            stalls++;
+        } else if (spins < CONFIG_BARRIER_SPINS) {
+            barrier_cpu_relax();
+        } else {
+            sched_yield(); /*! Oversubscribed: let the thread computing the rows run */
+            spins = 1;
+        }
+    }
+
+    if (stalls > 0)
+        atomic_fetch_add_explicit(&plan->stalls, stalls, memory_order_relaxed);
+}
+
+/*!
+ * \brief           Compute the powers one after the other (fallback without the planned threads).
+ *
+ * \param[in]       plan: Pointer to the plan.
+ * \param[in]       vec: Pointer to the input vector.
+ * \param[out]      powers: Result vectors.
+ */
+static void prv_mpk_levels(const struct MpkPlan *plan, const struct Vec *vec, struct Vec *powers) {
+    for (int l = 0; l < plan->steps; ++l)
+        csr_matrix_mul_vec_rows(plan->mtx, l > 0 ? &powers[l - 1] : vec, &powers[l], 0, plan->mtx->m);
+}
+
+/*!
+ * \brief           Pool task running the wavefront of one thread.
+ *
+ * \param[in,out]   arg: Pointer to the MpkPoolTask.
+ * \param[in]       tid: Index of the calling thread.
+ * \param[in]       threads: Number of threads of the pool.
+ */
+static void __attribute__((unused)) prv_mpk_pool_task(void *arg, int tid, int threads) {
+    UNUSED(threads);
+    struct MpkPoolTask *task = arg;
+    prv_mpk_wavefront(task->plan, tid, task->vec, task->powers);
+}
+
+int mpk_init(struct MpkPlan *plan, const struct CsrMatrix *mtx, int steps, struct ArenaHandler *arena) {
+    SLOG_DEBUG("Entering mpk_init");
+    if (!plan || !mtx || !arena || steps < 1 || steps > CONFIG_MPK_MAX_STEPS) {
+        rc_set_err_msg("Invalid argument(s) provided to mpk_init");
+        return RC_INVALID_ARG_ERR;
+    }
+
+    if (mtx->m != mtx->n) {
+        rc_set_err_msg("Only square matrices have powers (%dx%d given)", mtx->m, mtx->n);
+        return RC_INVALID_ARG_ERR;
+    }
+
+    *plan = (struct MpkPlan){ .mtx = mtx, .steps = steps, .threads = prv_mpk_threads() };
+    atomic_init(&plan->stalls, 0);
+
+    /*! A block trails the one it reads by up to the reach: those blocks, and the next one, must stay in L2 */
+    const size_t nnz_bytes = csr_matrix_val_size(mtx) + sizeof(int);
+    const size_t l2_nnz = (size_t)topo_get_cache_size(2) / nnz_bytes / (CONFIG_MPK_MAX_REACH + 2);
+    plan->block_nnz = (int)GET_MAX(l2_nnz, (size_t)CONFIG_MPK_MIN_BLOCK_NNZ);
+
+    enum ArenaReturnCode res = arena_calloc(arena, sizeof(int), (size_t)plan->threads + 1, &plan->first_block);
+    if (res != ARENA_RC_OK) {
+        rc_set_err_msg("Memory array allocation failed in mpk_init");
+        return RC_MEM_ALLOC_ERR;
+    }
+
+    plan->blocks = prv_mpk_split(plan, arena_get_ptr(&plan->first_block), NULL);
+
+    res = arena_calloc(arena, sizeof(int), (size_t)plan->blocks + 1, &plan->block_row);
+    if (res == ARENA_RC_OK)
+        res = arena_calloc(arena, sizeof(int), (size_t)GET_MAX(plan->blocks, 1), &plan->block_lo);
+    if (res == ARENA_RC_OK)
+        res = arena_calloc(arena, sizeof(int), (size_t)GET_MAX(plan->blocks, 1), &plan->block_hi);
+    if (res == ARENA_RC_OK)
+        res = arena_calloc(arena, sizeof(struct MpkProgress), plan->threads, &plan->progress);
+    if (res != ARENA_RC_OK) {
+        rc_set_err_msg("Memory array allocation failed in mpk_init");
+        return RC_MEM_ALLOC_ERR;
+    }
+
+    int *block_row = arena_get_ptr(&plan->block_row);
+    int *block_lo = arena_get_ptr(&plan->block_lo);
+    int *block_hi = arena_get_ptr(&plan->block_hi);
+    const int *row = csr_matrix_row_ptr(mtx);
+    const int *col = csr_matrix_col_idx(mtx);
+
+    prv_mpk_split(plan, arena_get_ptr(&plan->first_block), block_row);
+    for (int b = 0; b < plan->blocks; ++b) {
+        int lo = mtx->n;
+        int hi = -1;
+        for (int k = row[block_row[b]]; k < row[block_row[b + 1]]; ++k) {
+            lo = GET_MIN(lo, col[k]);
+            hi = GET_MAX(hi, col[k]);
+        }
+        block_lo[b] = lo;
+        block_hi[b] = hi;
+
+        if (lo <= hi) {
+            plan->reach = GET_MAX(plan->reach, b - prv_mpk_block_of(block_row, plan->blocks, lo));
+            plan->reach = GET_MAX(plan->reach, prv_mpk_block_of(block_row, plan->blocks, hi) - b);
+        }
+    }
+
+    /*! Each power trails the previous one by the reach: beyond a few blocks, the rows are evicted before reuse */
+    plan->wavefront = plan->reach <= CONFIG_MPK_MAX_REACH;
+    SLOG_DEBUG("Matrix powers: %d steps, %d threads, %d blocks of up to %d non-zeros, reach of %d blocks", steps, plan->threads, plan->blocks, plan->block_nnz, plan->reach);
+    return RC_OK;
+}
+
+int mpk_powers(struct MpkPlan *plan, const struct Vec *vec, struct Vec *powers) {
+    if (!plan || !vec || !powers) {
+        rc_set_err_msg("Invalid NULL argument(s) provided to mpk_powers");
+        return RC_INVALID_ARG_ERR;
+    }
+
+    const struct CsrMatrix *mtx = plan->mtx;
+    bool compatible = vec->n == mtx->n && vec->is_real == mtx->is_real;
+    for (int l = 0; l < plan->steps && compatible; ++l)
+        compatible = vec_size(&powers[l]) == mtx->m && powers[l].is_real == mtx->is_real;
+    if (!compatible) {
+        rc_set_err_msg("Incompatible matrix and vector dimensions or types in mpk_powers");
+        return RC_INVALID_ARG_ERR;
+    }
+
+    /*! Reset before the threads start, so no thread sees the end of the previous call */
+    const int *first_block = arena_get_ptr(&plan->first_block);
+    const int *block_row = arena_get_ptr(&plan->block_row);
+    struct MpkProgress *progress = arena_get_ptr(&plan->progress);
+    for (int t = 0; t < plan->threads; ++t)
+        for (int l = 0; l < plan->steps; ++l)
+            atomic_store_explicit(&progress[t].done[l], block_row[first_block[prv_mpk_descending(t) ? t + 1 : t]], memory_order_relaxed);
+
+    if (!plan->wavefront) {
+        int res = RC_OK;
+        for (int l = 0; l < plan->steps && res == RC_OK; ++l)
+            res = csr_matrix_mul_vec(mtx, l > 0 ? &powers[l - 1] : vec, &powers[l]);
+        return res;
+    }
+
+    if (plan->threads == 1) {
+        prv_mpk_wavefront(plan, 0, vec, powers);
+        return RC_OK;
+    }
+
+    /*! The wavefronts wait for each other: they need all the planned threads */
+#ifdef CONFIG_ENABLE_PTHREADS_PARALLELISM
+    struct ThreadPool *pool = pool_get_default();
+    if (pool && pool->threads == plan->threads) {
+        struct MpkPoolTask task = { .plan = plan, .vec = vec, .powers = powers };
+        return pool_run(pool, prv_mpk_pool_task, &task);
+    }
+#elif defined(CONFIG_ENABLE_OMP_PARALLELISM)
+#pragma omp parallel num_threads(plan->threads)
+    {
+        if (omp_get_num_threads() == plan->threads) {
+            prv_mpk_wavefront(plan, omp_get_thread_num(), vec, powers);
+        } else {
+#pragma omp single
+            prv_mpk_levels(plan, vec, powers);
+        }
+    }
+    return RC_OK;
+#endif /*! CONFIG_ENABLE_PTHREADS_PARALLELISM */
+
+    prv_mpk_levels(plan, vec, powers);
+    return RC_OK;
+}
@@ -0,0 +1,122 @@
+/*!
+ * \file            partition.c
+ * \date            2026-10-18
+ * \author          Mirko Lana [lana.mirko@icloud.com]
+ *
+ * \brief           Static row partitioning of CSR matrices.
+ */
+
+#include "config.h"
+#include "partition.h"
+#include "rc.h"
+#include "arena.h"
+#include "csr.h"
+#include "slog.h"
+
+/*!
+ * \brief           Find the first row whose starting offset is >= target.
+ *
+ * \param[in]       row: CSR row pointer array (m + 1 items).
+ * \param[in]       lo: Lower bound of the search.
+ * \param[in]       hi: Upper bound of the search.
+ * \param[in]       target: Non-zero offset to look for.
+ * \return          The row index.
+ */
+static int prv_partition_lower_bound(const int *row, int lo, int hi, long target) {
+    while (lo < hi) {
+        int mid = lo + (hi - lo) / 2;
+        if (row[mid] < target)
+            lo = mid + 1;
+        else
+            hi = mid;
+    }
+    return lo;
+}
+
+int partition_init_nnz(struct Partition *part, const struct CsrMatrix *mtx, int parts, struct ArenaHandler *arena) {
+    SLOG_DEBUG("Entering partition_init_nnz");
+    if (!part || !mtx || !arena || parts < 1) {
+        rc_set_err_msg("Invalid argument(s) provided to partition_init_nnz");
+        return RC_INVALID_ARG_ERR;
+    }
+
+    part->parts = parts;
+    enum ArenaReturnCode res = arena_calloc(arena, sizeof(int), parts + 1, &part->bounds);
+    if (res != ARENA_RC_OK) {
+        rc_set_err_msg("Memory array allocation failed in partition_init_nnz");
+        return RC_MEM_ALLOC_ERR;
+    }
+
+    const int *row = csr_matrix_row_ptr(mtx);
+    int *bounds = arena_get_ptr(&part->bounds);
+
+    bounds[0] = 0;
+    for (int p = 1; p < parts; ++p) {
+        long target = (long)mtx->nz * p / parts;
+        bounds[p] = prv_partition_lower_bound(row, bounds[p - 1], mtx->m, target);
+    }
+    bounds[parts] = mtx->m;
+
+    return RC_OK;
+}
+
+int partition_nnz_bound(const struct CsrMatrix *mtx, int p, int parts) {
+    if (p <= 0)
+        return 0;
+    if (p >= parts)
+        return mtx->m;
+
+    const int *row = csr_matrix_row_ptr(mtx);
+    return prv_partition_lower_bound(row, 0, mtx->m, (long)mtx->nz * p / parts);
+}
+
+int partition_rebalance(struct Partition *part, const struct CsrMatrix *mtx, const double *part_ns) {
+    SLOG_DEBUG("Entering partition_rebalance");
+    if (!part || !mtx || !part_ns) {
+        rc_set_err_msg("Invalid NULL argument(s) provided to partition_rebalance");
+        return RC_INVALID_ARG_ERR;
+    }
+
+    if (part->parts < 2 || mtx->nz == 0)
+        return RC_OK;
+
+    const int *row = csr_matrix_row_ptr(mtx);
+    int *bounds = arena_get_ptr(&part->bounds);
+
+    /*! Parts without non-zeros or time carry no information: give them the mean rate */
+    double total_rate = 0.0;
+    int measured = 0;
+    for (int p = 0; p < part->parts; ++p) {
+        int nnz = row[bounds[p + 1]] - row[bounds[p]];
+        if (nnz > 0 && part_ns[p] > 0.0) {
+            total_rate += nnz / part_ns[p];
+            measured++;
+        }
+    }
+    if (measured == 0)
+        return RC_OK;
+
+    double mean_rate = total_rate / measured;
+    total_rate += mean_rate * (part->parts - measured);
+
+    double acc = 0.0;
+    int old_lo = bounds[0];
+    for (int p = 0; p < part->parts - 1; ++p) {
+        int old_hi = bounds[p + 1];
+        int nnz = row[old_hi] - row[old_lo];
+        double rate = (nnz > 0 && part_ns[p] > 0.0) ? nnz / part_ns[p] : mean_rate;
+
+        double old_share = (double)nnz / mtx->nz;
+        double new_share = rate / total_rate;
+        acc += old_share + CONFIG_PARTITION_REBALANCE_DAMPING * (new_share - old_share);
+
+        bounds[p + 1] = prv_partition_lower_bound(row, bounds[p], mtx->m, (long)(acc * mtx->nz));
+        old_lo = old_hi;
+    }
+
+    return RC_OK;
+}
+
+int *partition_get_bounds(const struct Partition *part) {
+    return part ? arena_get_ptr(&part->bounds) : NULL;
+}
@@ -0,0 +1,142 @@
+/*!
+ * \file            policy.c
+ * \date            2026-10-18
+ * \author          Mirko Lana [lana.mirko@icloud.com]
+ *
+ * \brief           Thread count selection policy.
+ */
+
+#include "config.h"
+#include "policy.h"
+#include "csr.h"
+#include "rc.h"
+#include "slog.h"
+#include "utils.h"
+
+#include <stdint.h>
+
+#ifdef CONFIG_ENABLE_OMP_PARALLELISM
+#include <omp.h>
+#endif /*! CONFIG_ENABLE_OMP_PARALLELISM */
+
+#ifdef CONFIG_ENABLE_OMP_PARALLELISM
+/*!
+ * \brief           Measure the average cost of an empty parallel region.
+ *
+ * \param[in]       threads: Number of threads of the region.
+ * \return          The average cost in nanoseconds.
+ */
+static double prv_policy_region_ns(int threads) {
+    /*! The first region may create the thread pool, keep it out of the measure */
+#pragma omp parallel num_threads(threads)
+    {
+    }
+
+    uint64_t start = utils_get_ns();
+    for (int i = 0; i < CONFIG_POLICY_PROBE_REGIONS; ++i) {
+#pragma omp parallel num_threads(threads)
+        {
+        }
+    }
+    return (double)(utils_get_ns() - start) / CONFIG_POLICY_PROBE_REGIONS;
+}
+
+/*!
+ * \brief           Measure the time of a single SpMV with the given thread count.
+ *
+ * \param[in]       mtx: Pointer to the CSR matrix.
+ * \param[in]       vec: Pointer to the input vector.
+ * \param[out]      result: Pointer to the output vector.
+ * \param[in]       threads: Number of threads.
+ * \param[out]      ns: Pointer to store the best time of the probes in nanoseconds.
+ * \return          RC_OK on success, an error code otherwise.
+ */
+static int prv_policy_spmv_ns(const struct CsrMatrix *mtx, const struct Vec *vec, struct Vec *result, int threads, double *ns) {
+    omp_set_num_threads(threads);
+
+    *ns = 0.0;
+    for (int i = 0; i < CONFIG_POLICY_PROBE_SPMVS; ++i) {
+        uint64_t start = utils_get_ns();
+        int res = csr_matrix_mul_vec(mtx, vec, result);
+        if (res != RC_OK)
+            return res;
+        double t = (double)(utils_get_ns() - start);
+        *ns = i == 0 ? t : GET_MIN(*ns, t);
+    }
+
+    return RC_OK;
+}
+#endif /*! CONFIG_ENABLE_OMP_PARALLELISM */
+
+int policy_select_threads(struct ThreadPolicy *policy, const struct CsrMatrix *mtx, const struct Vec *vec, struct Vec *result, int max_threads) {
+    SLOG_DEBUG("Entering policy_select_threads");
+    if (!policy || !mtx || !vec || !result || max_threads < 1) {
+        rc_set_err_msg("Invalid argument(s) provided to policy_select_threads");
+        return RC_INVALID_ARG_ERR;
+    }
+
+    *policy = (struct ThreadPolicy){
+        .threads = max_threads,
+        .max_threads = max_threads,
+        .serial_ns = 0.0,
+        .overhead_ns = 0.0,
+        .saturation = (double)max_threads,
+        .reason = "upper bound",
+    };
+
+#ifndef CONFIG_ENABLE_OMP_PARALLELISM
+    UNUSED(vec);
+    UNUSED(result);
+    return RC_OK;
+#else
+    if (max_threads == 1 || mtx->nz < CONFIG_POLICY_SERIAL_NNZ) {
+        policy->threads = 1;
+        policy->reason = "serial fast path";
+        return RC_OK;
+    }
+
+    if (mtx->nz > CONFIG_POLICY_PROBE_MAX_NNZ) {
+        policy->reason = "large matrix, runtime overhead negligible";
+        return RC_OK;
+    }
+
+    /*! Fork/join cost model: region(p) = base + overhead * p */
+    double base_ns = prv_policy_region_ns(1);
+    double full_ns = prv_policy_region_ns(max_threads);
+    policy->overhead_ns = GET_MAX((full_ns - base_ns) / (max_threads - 1), 0.0);
+
+    double full_spmv_ns;
+    int res = prv_policy_spmv_ns(mtx, vec, result, 1, &policy->serial_ns);
+    if (res == RC_OK)
+        res = prv_policy_spmv_ns(mtx, vec, result, max_threads, &full_spmv_ns);
+    omp_set_num_threads(max_threads);
+    if (res != RC_OK)
+        return res;
+
+    /*! Whatever is left of the full-thread time after the overhead is the
+     *  bandwidth-bound part: work / min(p, saturation) */
+    double work_ns = full_spmv_ns - (base_ns + policy->overhead_ns * max_threads);
+    if (work_ns > policy->serial_ns / max_threads)
+        policy->saturation = GET_MAX(policy->serial_ns / work_ns, 1.0);
+
+    double best_ns = policy->serial_ns;
+    policy->threads = 1;
+    policy->reason = "serial is fastest";
+    for (int p = 2; p <= max_threads; ++p) {
+        double predicted_ns = policy->serial_ns / GET_MIN((double)p, policy->saturation) + base_ns + policy->overhead_ns * p;
+        if (predicted_ns < best_ns) {
+            best_ns = predicted_ns;
+            policy->threads = p;
+            policy->reason = "cost model";
+        }
+    }
+
+    SLOG_DEBUG("Thread policy: serial=%.0f ns, overhead=%.0f ns/thread, saturation=%.1f threads, predicted=%.0f ns",
+               policy->serial_ns,
+               policy->overhead_ns,
+               policy->saturation,
+               best_ns);
+
+    return RC_OK;
+#endif /*! CONFIG_ENABLE_OMP_PARALLELISM */
+}
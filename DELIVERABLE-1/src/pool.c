@@ -0,0 +1,222 @@
+/*!
+ * \file            pool.c
+ * \date            2026-10-18
+ * \author          Mirko Lana [lana.mirko@icloud.com]
+ *
+ * \brief           Persistent Pthreads thread pool.
+ */
+
+#ifdef __linux__
+#define _GNU_SOURCE /*! pthread_setaffinity_np, CPU_SET */
+#endif /*! __linux__ */
+
+#include "config.h"
+#include "pool.h"
+#include "rc.h"
+#include "arena.h"
+#include "barrier.h"
+#include "slog.h"
+
+#include <pthread.h>
+#include <sched.h>
+
+/*!
+ * \brief           Structure containing the argument of a worker.
+ */
+struct PoolWorker {
+    struct ThreadPool *pool; /*< Owning pool */
+    int tid;                 /*< Index of the worker, the one of its CPU in pool_init */
+};
+
+static struct ThreadPool g_default_pool; /*!< Pool used by the Pthreads backend. */
+static bool g_default_pool_ready;        /*!< Flag set once the default pool is running. */
+
+/*!
+ * \brief           Pin a thread to a CPU.
+ *
+ * \param[in]       thread: Handle of the thread.
+ * \param[in]       cpu: Index of the CPU.
+ * \return          RC_OK on success, RC_FAIL otherwise.
+ */
+static int prv_pool_pin(pthread_t thread, int cpu) {
+#ifdef __linux__
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    CPU_SET(cpu, &set);
+    return pthread_setaffinity_np(thread, sizeof(set), &set) == 0 ? RC_OK : RC_FAIL;
+#else
+    (void)thread;
+    (void)cpu;
+    return RC_OK;
+#endif /*! __linux__ */
+}
+
+/*!
+ * \brief           Main loop of a worker: wait for a task, run it, repeat.
+ *
+ * \param[in]       arg: Pointer to the PoolWorker of the thread.
+ * \return          NULL.
+ */
+static void *prv_pool_worker(void *arg) {
+    /*! Copied before signalling the start: the arena holding the arguments may move afterwards */
+    const struct PoolWorker self = *(const struct PoolWorker *)arg;
+    struct ThreadPool *pool = self.pool;
+    const int tid = self.tid;
+    unsigned seen = 0U;
+    atomic_fetch_sub_explicit(&pool->pending, 1, memory_order_release);
+
+    for (;;) {
+        unsigned gen = atomic_load_explicit(&pool->generation, memory_order_acquire);
+        for (int spins = 0; gen == seen && spins < CONFIG_POOL_SPINS; ++spins) {
+            if (atomic_load_explicit(&pool->stop, memory_order_relaxed))
+                return NULL;
+            barrier_cpu_relax();
+            gen = atomic_load_explicit(&pool->generation, memory_order_acquire);
+        }
+
+        if (gen == seen) {
+            pthread_mutex_lock(&pool->lock);
+            while ((gen = atomic_load_explicit(&pool->generation, memory_order_acquire)) == seen &&
+                   !atomic_load_explicit(&pool->stop, memory_order_relaxed))
+                pthread_cond_wait(&pool->wake, &pool->lock);
+            pthread_mutex_unlock(&pool->lock);
+        }
+
+        if (atomic_load_explicit(&pool->stop, memory_order_relaxed))
+            return NULL;
+
+        seen = gen;
+        pool->fn(pool->arg, tid, pool->threads);
+        atomic_fetch_sub_explicit(&pool->pending, 1, memory_order_release);
+    }
+}
+
+int pool_pin_self(int cpu) {
+    return prv_pool_pin(pthread_self(), cpu);
+}
+
+int pool_init(struct ThreadPool *pool, int threads, const int *cpus, struct ArenaHandler *arena) {
+    SLOG_DEBUG("Entering pool_init");
+    if (!pool || !arena || threads < 1) {
+        rc_set_err_msg("Invalid argument(s) provided to pool_init");
+        return RC_INVALID_ARG_ERR;
+    }
+
+    pool->threads = threads;
+    pool->fn = NULL;
+    pool->arg = NULL;
+    atomic_init(&pool->generation, 0U);
+    atomic_init(&pool->pending, 0);
+    atomic_init(&pool->stop, false);
+    pthread_mutex_init(&pool->lock, NULL);
+    pthread_cond_init(&pool->wake, NULL);
+
+    int workers = threads - 1;
+    enum ArenaReturnCode res = arena_calloc(arena, sizeof(pthread_t), workers > 0 ? workers : 1, &pool->workers);
+    if (res == ARENA_RC_OK)
+        res = arena_calloc(arena, sizeof(struct PoolWorker), workers > 0 ? workers : 1, &pool->args);
+    if (res != ARENA_RC_OK) {
+        rc_set_err_msg("Memory array allocation failed in pool_init");
+        return RC_MEM_ALLOC_ERR;
+    }
+
+    if (cpus && cpus[0] >= 0 && pool_pin_self(cpus[0]) != RC_OK)
+        SLOG_WARN("Could not pin the pool caller to CPU %d", cpus[0]);
+
+    /*! Worker i + 1 is pinned to cpus[i + 1] and runs tasks as tid i + 1, whatever the order the threads start in */
+    pthread_t *handles = arena_get_ptr(&pool->workers);
+    struct PoolWorker *args = arena_get_ptr(&pool->args);
+    atomic_store_explicit(&pool->pending, workers, memory_order_relaxed);
+    for (int i = 0; i < workers; ++i) {
+        args[i] = (struct PoolWorker){ .pool = pool, .tid = i + 1 };
+        if (pthread_create(&handles[i], NULL, prv_pool_worker, &args[i]) != 0) {
+            pool->threads = i + 1; /*! Only join the workers that were started */
+            pool_destroy(pool);
+            rc_set_err_msg("Could not create pool worker %d", i + 1);
+            return RC_FAIL;
+        }
+        if (cpus && cpus[i + 1] >= 0 && prv_pool_pin(handles[i], cpus[i + 1]) != RC_OK)
+            SLOG_WARN("Could not pin pool worker %d to CPU %d", i + 1, cpus[i + 1]);
+    }
+
+    /*! The arguments must stay in place until every worker has copied its own */
+    for (int spins = 0; atomic_load_explicit(&pool->pending, memory_order_acquire) > 0; ++spins) {
+        if (spins < CONFIG_POOL_SPINS) {
+            barrier_cpu_relax();
+        } else {
+            sched_yield();
+            spins = 0;
+        }
+    }
+
+    return RC_OK;
+}
+
+int pool_run(struct ThreadPool *pool, PoolTaskFn fn, void *arg) {
+    if (!pool || !fn) {
+        rc_set_err_msg("Invalid NULL argument(s) provided to pool_run");
+        return RC_INVALID_ARG_ERR;
+    }
+
+    pool->fn = fn;
+    pool->arg = arg;
+    atomic_store_explicit(&pool->pending, pool->threads - 1, memory_order_relaxed);
+
+    pthread_mutex_lock(&pool->lock);
+    atomic_fetch_add_explicit(&pool->generation, 1U, memory_order_release);
+    pthread_cond_broadcast(&pool->wake);
+    pthread_mutex_unlock(&pool->lock);
+
+    fn(arg, 0, pool->threads);
+
+    for (int spins = 0; atomic_load_explicit(&pool->pending, memory_order_acquire) > 0; ++spins) {
+        if (spins < CONFIG_POOL_SPINS) {
+            barrier_cpu_relax();
+        } else {
+            sched_yield();
+            spins = 0;
+        }
+    }
+
+    return RC_OK;
+}
+
+void pool_destroy(struct ThreadPool *pool) {
+    if (!pool)
+        return;
+
+    pthread_mutex_lock(&pool->lock);
+    atomic_store_explicit(&pool->stop, true, memory_order_relaxed);
+    pthread_cond_broadcast(&pool->wake);
+    pthread_mutex_unlock(&pool->lock);
+
+    pthread_t *handles = arena_get_ptr(&pool->workers);
+    for (int i = 0; i < pool->threads - 1; ++i)
+        pthread_join(handles[i], NULL);
+
+    pthread_mutex_destroy(&pool->lock);
+    pthread_cond_destroy(&pool->wake);
+    pool->threads = 1;
+}
+
+int pool_init_default(int threads, const int *cpus, struct ArenaHandler *arena) {
+    pool_fini_default();
+
+    int res = pool_init(&g_default_pool, threads, cpus, arena);
+    if (res != RC_OK)
+        return res;
+
+    g_default_pool_ready = true;
+    return RC_OK;
+}
+
+void pool_fini_default(void) {
+    if (g_default_pool_ready) {
+        pool_destroy(&g_default_pool);
+        g_default_pool_ready = false;
+    }
+}
+
+struct ThreadPool *pool_get_default(void) {
+    return g_default_pool_ready ? &g_default_pool : NULL;
+}
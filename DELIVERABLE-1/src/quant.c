@@ -0,0 +1,345 @@
+/*!
+ * \file            quant.c
+ * \date            2026-10-18
+ * \author          Mirko Lana [lana.mirko@icloud.com]
+ *
+ * \brief           Lossy per-row quantized CSR values for approximate SpMV.
+ */
+
+#include "config.h"
+#include "quant.h"
+#include "rc.h"
+#include "arena.h"
+#include "csr.h"
+#include "vec.h"
+#include "isa.h"
+#include "simd.h"
+#include "partition.h"
+#include "pool.h"
+#include "utils.h"
+#include "slog.h"
+
+#include <stdint.h>
+#include <math.h>
+
+#ifdef CONFIG_ENABLE_OMP_PARALLELISM
+#include <omp.h>
+#endif /*! CONFIG_ENABLE_OMP_PARALLELISM */
+
+/*!
+ * \brief           Structure containing the arguments of a Pthreads quantized SpMV.
+ */
+struct QuantPoolTask {
+    const struct QuantMatrix *qm; /*< Input matrix */
+    const struct Vec *vec;        /*< Input vector */
+    struct Vec *result;           /*< Result vector */
+};
+
+/*!
+ * \brief           Multiply a range of rows of a quantized matrix with the vector.
+ *
+ * \param[in]       T: Type of the codes.
+ */
+#define PRV_QUANT_ROWS(T)                                        \
+    do {                                                         \
+        const T *q = codes;                                      \
+        for (int i = row_begin; i < row_end; ++i) {              \
+            double sum_x = 0.0;                                  \
+            double sum_qx = 0.0;                                 \
+            _Pragma("omp simd reduction(+ : sum_x, sum_qx)")     \
+            for (int k = row[i]; k < row[i + 1]; ++k) {          \
+                double xk = x[col[k]];                           \
+                sum_x += xk;                                     \
+                sum_qx += q[k] * xk;                             \
+            }                                                    \
+            y[i] = offset[i] * sum_x + scale[i] * sum_qx;        \
+        }                                                        \
+    } while (0)
+
+/*!
+ * \brief           Multiply a range of rows of a quantized matrix with a vector.
+ *
+ * \details         Body shared by all the instruction set variants, see
+ *                  prv_csr_matrix_mul_vec_rows_body in csr.c.
+ *
+ * \param[in]       qm: Pointer to the quantized matrix.
+ * \param[in]       vec: Pointer to the vector.
+ * \param[out]      result: Pointer to the result vector.
+ * \param[in]       row_begin: First row of the range.
+ * \param[in]       row_end: One past the last row of the range.
+ */
+static inline __attribute__((always_inline)) void prv_quant_rows_body(const struct QuantMatrix *qm, const struct Vec *vec, struct Vec *result, int row_begin, int row_end) {
+    const int *row = csr_matrix_row_ptr(&qm->pattern);
+    const int *col = csr_matrix_col_idx(&qm->pattern);
+    const void *codes = arena_get_ptr(&qm->codes);
+    const double *scale = arena_get_ptr(&qm->scale);
+    const double *offset = arena_get_ptr(&qm->offset);
+    const double *x = arena_get_ptr(&vec->val);
+    double *y = arena_get_ptr(&result->val);
+
+    if (qm->bits == 8)
+        PRV_QUANT_ROWS(int8_t);
+    else
+        PRV_QUANT_ROWS(int16_t);
+}
+
+/*!
+ * \brief           Share the rows of a quantized matrix among the threads of the enclosing parallel region.
+ *
+ * \param[in]       qm: Pointer to the quantized matrix.
+ * \param[in]       vec: Pointer to the vector.
+ * \param[out]      result: Pointer to the result vector.
+ */
+static inline __attribute__((always_inline)) void prv_quant_omp_body(const struct QuantMatrix *qm, const struct Vec *vec, struct Vec *result) {
+#pragma omp for schedule(CONFIG_OMP_SCHEDULE)
+    for (int i = 0; i < qm->pattern.m; i += CONFIG_SIMD_ROW_GROUP)
+        prv_quant_rows_body(qm, vec, result, i, GET_MIN(i + CONFIG_SIMD_ROW_GROUP, qm->pattern.m));
+}
+
+/*!
+ * \brief           Define the kernel variants of an instruction set level.
+ *
+ * \param[in]       isa: Suffix of the variants.
+ * \param[in]       attr: Target attribute of the variants (empty for the baseline).
+ */
+#define PRV_QUANT_DEFINE_KERNELS(isa, attr)                                                                                                  \
+    attr static void prv_quant_rows_##isa(const struct QuantMatrix *qm, const struct Vec *vec, struct Vec *result, int row_begin, int row_end) { \
+        prv_quant_rows_body(qm, vec, result, row_begin, row_end);                                                                            \
+    }                                                                                                                                        \
+    attr static void prv_quant_omp_##isa(const struct QuantMatrix *qm, const struct Vec *vec, struct Vec *result) {                          \
+        _Pragma("omp parallel") prv_quant_omp_body(qm, vec, result);                                                                         \
+    }
+
+PRV_QUANT_DEFINE_KERNELS(baseline, )
+#ifdef ISA_ENABLE_X86_DISPATCH
+PRV_QUANT_DEFINE_KERNELS(avx2, __attribute__((target(ISA_TARGET_AVX2))))
+PRV_QUANT_DEFINE_KERNELS(avx512, __attribute__((target(ISA_TARGET_AVX512))))
+#endif /*! ISA_ENABLE_X86_DISPATCH */
+
+/*!
+ * \brief           Structure containing the kernel variants of an instruction set level.
+ */
+struct QuantKernels {
+    void (*rows)(const struct QuantMatrix *, const struct Vec *, struct Vec *, int, int); /*< Range of rows */
+    void (*omp)(const struct QuantMatrix *, const struct Vec *, struct Vec *);            /*< OpenMP parallel region */
+};
+
+/*!
+ * \brief           Kernel variants indexed by instruction set level (see isa_get).
+ */
+static const struct QuantKernels g_quant_kernels[ISA_LEVEL_COUNT] = {
+    [ISA_LEVEL_BASELINE] = { prv_quant_rows_baseline, prv_quant_omp_baseline },
+#ifdef ISA_ENABLE_X86_DISPATCH
+    [ISA_LEVEL_AVX2] = { prv_quant_rows_avx2, prv_quant_omp_avx2 },
+    [ISA_LEVEL_AVX512] = { prv_quant_rows_avx512, prv_quant_omp_avx512 },
+#else
+    [ISA_LEVEL_AVX2] = { prv_quant_rows_baseline, prv_quant_omp_baseline },
+    [ISA_LEVEL_AVX512] = { prv_quant_rows_baseline, prv_quant_omp_baseline },
+#endif /*! ISA_ENABLE_X86_DISPATCH */
+};
+
+/*!
+ * \brief           Explicit kernels indexed by instruction set level and code width (0: int8, 1: int16).
+ */
+static const SimdQuantRowsFn g_quant_simd_kernels[ISA_LEVEL_COUNT][2] = {
+#ifdef ISA_ENABLE_X86_DISPATCH
+    [ISA_LEVEL_AVX2] = { simd_quant8_avx2, simd_quant16_avx2 },
+    [ISA_LEVEL_AVX512] = { simd_quant8_avx512, simd_quant16_avx512 },
+#endif /*! ISA_ENABLE_X86_DISPATCH */
+};
+
+/*!
+ * \brief           Get the explicit kernel selected for a quantized matrix.
+ *
+ * \details         Follows the kernel selected for the CSR SpMV (see
+ *                  csr_set_kernel): "gather" and "lanes" both use the gather one.
+ *
+ * \param[in]       qm: Pointer to the quantized matrix.
+ * \return          The kernel, NULL to use the auto-vectorized one.
+ */
+static inline SimdQuantRowsFn prv_quant_get_simd_kernel(const struct QuantMatrix *qm) {
+    enum CsrKernel kernel = csr_get_kernel();
+    return (kernel == CSR_KERNEL_GATHER || kernel == CSR_KERNEL_LANES) ? g_quant_simd_kernels[isa_get()][qm->bits == 16] : NULL;
+}
+
+/*!
+ * \brief           Multiply a range of rows of a quantized matrix with a vector.
+ *
+ * \param[in]       qm: Pointer to the quantized matrix.
+ * \param[in]       vec: Pointer to the vector.
+ * \param[out]      result: Pointer to the result vector.
+ * \param[in]       row_begin: First row of the range.
+ * \param[in]       row_end: One past the last row of the range.
+ */
+static inline void prv_quant_rows(const struct QuantMatrix *qm, const struct Vec *vec, struct Vec *result, int row_begin, int row_end) {
+    SimdQuantRowsFn simd = prv_quant_get_simd_kernel(qm);
+    if (simd)
+        simd(csr_matrix_row_ptr(&qm->pattern), csr_matrix_col_idx(&qm->pattern), arena_get_ptr(&qm->codes), arena_get_ptr(&qm->scale),
+             arena_get_ptr(&qm->offset), arena_get_ptr(&vec->val), arena_get_ptr(&result->val), row_begin, row_end);
+    else
+        g_quant_kernels[isa_get()].rows(qm, vec, result, row_begin, row_end);
+}
+
+#ifdef CONFIG_ENABLE_PTHREADS_PARALLELISM
+/*!
+ * \brief           Pool task computing the nnz-balanced share of rows of one thread.
+ *
+ * \param[in,out]   arg: Pointer to the QuantPoolTask.
+ * \param[in]       tid: Index of the calling thread.
+ * \param[in]       threads: Number of threads of the pool.
+ */
+static void prv_quant_pool_task(void *arg, int tid, int threads) {
+    struct QuantPoolTask *task = arg;
+    int row_begin = partition_nnz_bound(&task->qm->pattern, tid, threads);
+    int row_end = partition_nnz_bound(&task->qm->pattern, tid + 1, threads);
+
+    prv_quant_rows(task->qm, task->vec, task->result, row_begin, row_end);
+}
+#endif /*! CONFIG_ENABLE_PTHREADS_PARALLELISM */
+
+int quant_matrix_init(struct QuantMatrix *qm, const struct CsrMatrix *mtx, int bits, struct ArenaHandler *arena) {
+    SLOG_DEBUG("Entering quant_matrix_init");
+    if (!qm || !mtx || !arena || (bits != 8 && bits != 16)) {
+        rc_set_err_msg("Invalid argument(s) provided to quant_matrix_init");
+        return RC_INVALID_ARG_ERR;
+    }
+
+    if (!mtx->is_real) {
+        rc_set_err_msg("Only real matrices can be quantized");
+        return RC_INVALID_ARG_ERR;
+    }
+
+    qm->pattern = *mtx;
+    qm->bits = bits;
+
+    enum ArenaReturnCode res = arena_calloc(arena, bits / 8, mtx->nz, &qm->codes);
+    if (res == ARENA_RC_OK)
+        res = arena_calloc(arena, sizeof(double), mtx->m, &qm->scale);
+    if (res == ARENA_RC_OK)
+        res = arena_calloc(arena, sizeof(double), mtx->m, &qm->offset);
+    if (res != ARENA_RC_OK) {
+        rc_set_err_msg("Memory array allocation failed in quant_matrix_init");
+        return RC_MEM_ALLOC_ERR;
+    }
+
+    const int *row = csr_matrix_row_ptr(mtx);
+    const double *val = csr_matrix_values(mtx);
+    void *codes = arena_get_ptr(&qm->codes);
+    double *scale = arena_get_ptr(&qm->scale);
+    double *offset = arena_get_ptr(&qm->offset);
+    const int qmax = (1 << (bits - 1)) - 1; /*! Symmetric range: -qmax is the lowest code */
+
+    for (int i = 0; i < mtx->m; ++i) {
+        if (row[i] == row[i + 1])
+            continue;
+
+        double lo = val[row[i]];
+        double hi = lo;
+        for (int k = row[i] + 1; k < row[i + 1]; ++k) {
+            lo = GET_MIN(lo, val[k]);
+            hi = GET_MAX(hi, val[k]);
+        }
+
+        offset[i] = lo + (hi - lo) / 2.0;
+        scale[i] = (hi - lo) / (2.0 * qmax);
+        for (int k = row[i]; k < row[i + 1]; ++k) {
+            long q = scale[i] > 0.0 ? lround((val[k] - offset[i]) / scale[i]) : 0L;
+            q = GET_MAX(GET_MIN(q, (long)qmax), (long)-qmax);
+            if (bits == 8)
+                ((int8_t *)codes)[k] = (int8_t)q;
+            else
+                ((int16_t *)codes)[k] = (int16_t)q;
+        }
+    }
+
+    SLOG_DEBUG("Quantized %d values to int%d: %zu bytes", mtx->nz, bits, quant_matrix_bytes(qm));
+    return RC_OK;
+}
+
+int quant_matrix_mul_vec_rows(const struct QuantMatrix *qm, const struct Vec *vec, struct Vec *result, int row_begin, int row_end) {
+    if (row_begin < 0 || row_end > qm->pattern.m || row_begin > row_end)
+        return RC_IDX_OUT_OF_BOUNDS_ERR;
+
+    prv_quant_rows(qm, vec, result, row_begin, row_end);
+    return RC_OK;
+}
+
+int quant_matrix_mul_vec(const struct QuantMatrix *qm, const struct Vec *vec, struct Vec *result) {
+    if (!qm || !vec || !result) {
+        rc_set_err_msg("Invalid NULL argument(s) provided to quant_matrix_mul_vec");
+        return RC_INVALID_ARG_ERR;
+    }
+
+    if (qm->pattern.n != vec->n || !vec->is_real || !result->is_real || vec_size(result) != qm->pattern.m) {
+        rc_set_err_msg("Incompatible matrix and vector dimensions or types in quant_matrix_mul_vec");
+        return RC_INVALID_ARG_ERR;
+    }
+
+#ifdef CONFIG_ENABLE_OMP_PARALLELISM
+    if (omp_get_max_threads() > 1) {
+        SimdQuantRowsFn simd = prv_quant_get_simd_kernel(qm);
+        if (!simd) {
+            g_quant_kernels[isa_get()].omp(qm, vec, result);
+            return RC_OK;
+        }
+
+        const int *row = csr_matrix_row_ptr(&qm->pattern);
+        const int *col = csr_matrix_col_idx(&qm->pattern);
+        const void *codes = arena_get_ptr(&qm->codes);
+        const double *scale = arena_get_ptr(&qm->scale);
+        const double *offset = arena_get_ptr(&qm->offset);
+        const double *x = arena_get_ptr(&vec->val);
+        double *y = arena_get_ptr(&result->val);
+
+#pragma omp parallel for schedule(CONFIG_OMP_SCHEDULE)
+        for (int i = 0; i < qm->pattern.m; i += CONFIG_SIMD_ROW_GROUP)
+            simd(row, col, codes, scale, offset, x, y, i, GET_MIN(i + CONFIG_SIMD_ROW_GROUP, qm->pattern.m));
+        return RC_OK;
+    }
+#elif defined(CONFIG_ENABLE_PTHREADS_PARALLELISM)
+    struct ThreadPool *pool = pool_get_default();
+    if (pool && pool->threads > 1) {
+        struct QuantPoolTask task = { .qm = qm, .vec = vec, .result = result };
+        return pool_run(pool, prv_quant_pool_task, &task);
+    }
+#endif /*! CONFIG_ENABLE_OMP_PARALLELISM */
+
+    prv_quant_rows(qm, vec, result, 0, qm->pattern.m);
+    return RC_OK;
+}
+
+size_t quant_matrix_bytes(const struct QuantMatrix *qm) {
+    return (size_t)qm->pattern.nz * ((size_t)qm->bits / 8 + sizeof(int)) + (size_t)qm->pattern.m * 2 * sizeof(double) +
+           ((size_t)qm->pattern.m + 1) * sizeof(int);
+}
+
+int quant_error(const struct Vec *exact, const struct Vec *approx, struct QuantError *err) {
+    if (!exact || !approx || !err) {
+        rc_set_err_msg("Invalid NULL argument(s) provided to quant_error");
+        return RC_INVALID_ARG_ERR;
+    }
+
+    if (exact->n != approx->n || !exact->is_real || !approx->is_real) {
+        rc_set_err_msg("Incompatible vector sizes or types in quant_error");
+        return RC_INVALID_ARG_ERR;
+    }
+
+    const double *y = arena_get_ptr(&exact->val);
+    const double *y_hat = arena_get_ptr(&approx->val);
+    double max_y = 0.0;
+    double norm_y = 0.0;
+    double norm_e = 0.0;
+
+    err->max_abs = 0.0;
+    for (int i = 0; i < exact->n; ++i) {
+        double e = fabs(y_hat[i] - y[i]);
+        err->max_abs = GET_MAX(err->max_abs, e);
+        max_y = GET_MAX(max_y, fabs(y[i]));
+        norm_e += e * e;
+        norm_y += y[i] * y[i];
+    }
+
+    err->rel_max = max_y > 0.0 ? err->max_abs / max_y : 0.0;
+    err->rel_l2 = norm_y > 0.0 ? sqrt(norm_e / norm_y) : 0.0;
+    return RC_OK;
+}
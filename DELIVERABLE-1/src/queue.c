@@ -0,0 +1,91 @@
+/*!
+ * \file            queue.c
+ * \date            2026-10-18
+ * \author          Mirko Lana [lana.mirko@icloud.com]
+ *
+ * \brief           Lock-free bounded multi-producer multi-consumer queue.
+ */
+
+#include "queue.h"
+#include "rc.h"
+#include "arena.h"
+
+/*!
+ * \brief           Structure representing a cell of the ring.
+ *
+ * \details         The cell at position p is free for the push of position p
+ *                  when seq == p, and full for its pop when seq == p + 1; the
+ *                  pop frees it for position p + capacity.
+ */
+struct MpmcCell {
+    atomic_long seq; /*< Sequence number of the cell */
+    int item;        /*< Item stored in the cell */
+};
+
+int queue_init(struct MpmcQueue *q, int capacity, struct ArenaHandler *arena) {
+    if (!q || !arena || capacity < 2 || (capacity & (capacity - 1)) != 0) {
+        rc_set_err_msg("Invalid argument(s) provided to queue_init");
+        return RC_INVALID_ARG_ERR;
+    }
+
+    q->capacity = capacity;
+    enum ArenaReturnCode res = arena_calloc(arena, sizeof(struct MpmcCell), capacity, &q->cells);
+    if (res != ARENA_RC_OK) {
+        rc_set_err_msg("Memory array allocation failed in queue_init");
+        return RC_MEM_ALLOC_ERR;
+    }
+
+    struct MpmcCell *cells = arena_get_ptr(&q->cells);
+    for (int i = 0; i < capacity; ++i)
+        atomic_init(&cells[i].seq, i);
+    atomic_init(&q->head, 0);
+    atomic_init(&q->tail, 0);
+
+    return RC_OK;
+}
+
+bool queue_push(struct MpmcQueue *q, int item) {
+    struct MpmcCell *cells = arena_get_ptr(&q->cells);
+    long pos = atomic_load_explicit(&q->tail, memory_order_relaxed);
+
+    for (;;) {
+        struct MpmcCell *cell = &cells[pos & (q->capacity - 1)];
+        long seq = atomic_load_explicit(&cell->seq, memory_order_acquire);
+        long diff = seq - pos;
+        if (diff == 0) {
+            if (atomic_compare_exchange_weak_explicit(&q->tail, &pos, pos + 1, memory_order_relaxed, memory_order_relaxed)) {
+                cell->item = item;
+                atomic_store_explicit(&cell->seq, pos + 1, memory_order_release);
+                return true;
+            }
+        } else if (diff < 0) {
+            /*! Not yet freed by the pop of the previous lap: full */
+            return false;
+        } else {
+            pos = atomic_load_explicit(&q->tail, memory_order_relaxed);
+        }
+    }
+}
+
+bool queue_pop(struct MpmcQueue *q, int *item) {
+    struct MpmcCell *cells = arena_get_ptr(&q->cells);
+    long pos = atomic_load_explicit(&q->head, memory_order_relaxed);
+
+    for (;;) {
+        struct MpmcCell *cell = &cells[pos & (q->capacity - 1)];
+        long seq = atomic_load_explicit(&cell->seq, memory_order_acquire);
+        long diff = seq - (pos + 1);
+        if (diff == 0) {
+            if (atomic_compare_exchange_weak_explicit(&q->head, &pos, pos + 1, memory_order_relaxed, memory_order_relaxed)) {
+                *item = cell->item;
+                atomic_store_explicit(&cell->seq, pos + q->capacity, memory_order_release);
+                return true;
+            }
+        } else if (diff < 0) {
+            /*! Not yet filled by its push: empty */
+            return false;
+        } else {
+            pos = atomic_load_explicit(&q->head, memory_order_relaxed);
+        }
+    }
+}
@@ -11,7 +11,7 @@
 #include <stdarg.h>
 #include <string.h>
 
-static char rc_err_msg[RC_ERR_MSG_LEN] = { 0 }; /*!< The error message buffer */
+static _Thread_local char rc_err_msg[RC_ERR_MSG_LEN] = { 0 }; /*!< The error message buffer, one per thread */
 
 int rc_set_err_msg(const char *fmt, ...) {
     if (!fmt)
@@ -0,0 +1,838 @@
+/*!
+ * \file            serve.c
+ * \date            2026-10-18
+ * \author          Mirko Lana [lana.mirko@icloud.com]
+ *
+ * \brief           Long-running SpMV server over a UNIX domain socket.
+ */
+
+#include "config.h"
+#include "serve.h"
+#include "rc.h"
+#include "arena.h"
+#include "csr.h"
+#include "vec.h"
+#include "policy.h"
+#include "pool.h"
+#include "queue.h"
+#include "shm.h"
+#include "slog.h"
+#include "topo.h"
+#include "utils.h"
+
+#include <errno.h>
+#include <fcntl.h>
+#include <limits.h>
+#include <poll.h>
+#include <pthread.h>
+#include <sched.h>
+#include <signal.h>
+#include <stdatomic.h>
+#include <stdio.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+#ifdef CONFIG_ENABLE_OMP_PARALLELISM
+#include <omp.h>
+#endif /*! CONFIG_ENABLE_OMP_PARALLELISM */
+
+_Static_assert(sizeof(struct ServeRequest) == 96, "The layout of a request is part of the protocol");
+_Static_assert(sizeof(struct ServeReply) == 48, "The layout of a reply is part of the protocol");
+_Static_assert(CONFIG_SERVE_QUEUE_LEN >= CONFIG_SERVE_MAX_CLIENTS, "Each client may have one request in the queue");
+
+/*!
+ * \brief           Structure representing a matrix served and its plan.
+ */
+struct ServeMatrix {
+    struct CsrMatrix mtx;              /*< The matrix */
+    struct ShmStore shm;               /*< Attachment to the shared-memory store (shared set) */
+    struct Vec x;                      /*< Staging input block, n * coalesce items */
+    struct Vec y;                      /*< Staging result block, m * coalesce items */
+    int threads;                       /*< Number of threads of its SpMV */
+    const char *policy;                /*< Reason of the thread count choice */
+    int pending[CONFIG_CSR_BLOCK_MAX]; /*< Client slots of the products waiting for the next pass */
+    int pending_count;                 /*< Number of products waiting for the next pass */
+    uint64_t oldest_ns;                /*< Receipt time of the oldest of them */
+    long requests;                     /*< Number of products computed */
+    long passes;                       /*< Number of passes computing them */
+    uint64_t kernel_ns;                /*< Accumulated time of the passes */
+    uint64_t wait_ns;                  /*< Accumulated time from receipt to the start of the pass */
+    uint64_t total_ns;                 /*< Accumulated time from receipt to reply */
+};
+
+/*!
+ * \brief           Structure representing a connected client.
+ */
+struct ServeClient {
+    int fd;                  /*< Socket of the connection, -1 if the slot is free */
+    int buf_fd;              /*< Shared-memory object of the buffer, kept to check its size, -1 if none */
+    char *buf;               /*< Attached shared-memory buffer, NULL if none */
+    size_t buf_size;         /*< Size of the buffer in bytes when mapped */
+    atomic_bool busy;        /*< Whether a product of the client is queued or being computed */
+    struct ServeRequest req; /*< Product being served (busy set) */
+    uint64_t received_ns;    /*< Receipt time of the product being served */
+};
+
+/*!
+ * \brief           Structure containing the state of the server.
+ */
+struct ServeHandler {
+    bool initialized;                                     /*!< Whether serve_init succeeded. */
+    const char *path;                                     /*!< Path of the socket. */
+    int listen_fd;                                        /*!< Listening socket. */
+    int matrices;                                         /*!< Number of matrices served. */
+    struct ServeMatrix mats[CONFIG_SERVE_MAX_MATRICES];   /*!< Matrices served. */
+    struct ServeClient clients[CONFIG_SERVE_MAX_CLIENTS]; /*!< Client slots. */
+    struct MpmcQueue queue;                               /*!< Products waiting for the SpMV thread (client slots). */
+    atomic_bool stop;                                     /*!< Flag asking both threads to exit. */
+    atomic_bool sleeping;                                 /*!< Whether the SpMV thread waits on wake. */
+    pthread_mutex_t lock;                                 /*!< Lock protecting the sleep/wake-up of the SpMV thread. */
+    pthread_cond_t wake;                                  /*!< Condition signalled when a product is queued or on stop. */
+    int threads;                                          /*!< Thread count currently set. */
+    int spins;                                            /*!< Polls of the empty queue before sleeping. */
+    int coalesce;                                         /*!< Maximum number of products of a pass. */
+    uint64_t window_ns;                                   /*!< Time a product may wait for others. */
+};
+
+static struct ServeHandler g_serve_handler; /*!< Global server handler. */
+
+static volatile sig_atomic_t g_serve_signal; /*!< Set by SIGINT and SIGTERM. */
+
+/*!
+ * \brief           Ask the server to stop (signal handler).
+ *
+ * \param[in]       sig: The signal received.
+ */
+static void prv_serve_on_signal(int sig) {
+    UNUSED(sig);
+    g_serve_signal = 1;
+}
+
+/*!
+ * \brief           Wake up the SpMV thread if it sleeps.
+ *
+ * \param[in]       always: Signal even if it does not sleep (stop request).
+ */
+static void prv_serve_wake(bool always) {
+    /*! Pairs with the fence of the SpMV thread between its flag and its last pop */
+    atomic_thread_fence(memory_order_seq_cst);
+    if (!always && !atomic_load_explicit(&g_serve_handler.sleeping, memory_order_relaxed))
+        return;
+    pthread_mutex_lock(&g_serve_handler.lock);
+    pthread_cond_signal(&g_serve_handler.wake);
+    pthread_mutex_unlock(&g_serve_handler.lock);
+}
+
+/*!
+ * \brief           Send a reply to a client.
+ *
+ * \param[in]       client: Pointer to the client.
+ * \param[in]       reply: Pointer to the reply.
+ */
+static void prv_serve_reply(const struct ServeClient *client, const struct ServeReply *reply) {
+    if (send(client->fd, reply, sizeof(*reply), 0) != (ssize_t)sizeof(*reply))
+        SLOG_DEBUG("Could not reply to client on socket %d - %s", client->fd, strerror(errno));
+}
+
+/*!
+ * \brief           Build the reply to a request on a matrix.
+ *
+ * \param[in]       matrix: Index of the matrix, or out of range for none.
+ * \param[in]       status: Status of the request.
+ * \return          The reply.
+ */
+static struct ServeReply prv_serve_make_reply(int matrix, int status) {
+    struct ServeReply reply = {
+        .magic = SERVE_MAGIC,
+        .status = status,
+        .matrices = g_serve_handler.matrices,
+    };
+    if (matrix >= 0 && matrix < g_serve_handler.matrices) {
+        const struct CsrMatrix *mtx = &g_serve_handler.mats[matrix].mtx;
+        reply.m = mtx->m;
+        reply.n = mtx->n;
+        reply.is_real = mtx->is_real;
+    }
+    return reply;
+}
+
+/*!
+ * \brief           Unmap the buffer attached by a client.
+ *
+ * \param[in,out]   client: Pointer to the client.
+ */
+static void prv_serve_client_unmap(struct ServeClient *client) {
+    if (client->buf)
+        munmap(client->buf, client->buf_size);
+    if (client->buf_fd >= 0)
+        close(client->buf_fd);
+    client->buf_fd = -1;
+    client->buf = NULL;
+    client->buf_size = 0;
+}
+
+/*!
+ * \brief           Close the connection of a client and free its slot.
+ *
+ * \param[in,out]   client: Pointer to the client.
+ */
+static void prv_serve_client_close(struct ServeClient *client) {
+    SLOG_DEBUG("Closing client on socket %d", client->fd);
+    prv_serve_client_unmap(client);
+    close(client->fd);
+    client->fd = -1;
+}
+
+/*!
+ * \brief           Map the shared-memory buffer named by a client.
+ *
+ * \details         The object stays open, so that its size can be checked
+ *                  again before each pass (prv_serve_still_fits).
+ *
+ * \param[in,out]   client: Pointer to the client.
+ * \param[in]       name: Name of the buffer.
+ * \return          RC_OK on success, RC_FILE_IO_ERR if the buffer could not be opened or mapped.
+ */
+static int prv_serve_client_attach(struct ServeClient *client, const char *name) {
+    prv_serve_client_unmap(client);
+
+    int fd = shm_open(name, O_RDWR, 0);
+    if (fd < 0)
+        return RC_FILE_IO_ERR;
+
+    struct stat st;
+    void *buf = MAP_FAILED;
+    if (fstat(fd, &st) == 0 && st.st_size > 0)
+        buf = mmap(NULL, (size_t)st.st_size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    if (buf == MAP_FAILED) {
+        close(fd);
+        return RC_FILE_IO_ERR;
+    }
+
+    client->buf_fd = fd;
+    client->buf = buf;
+    client->buf_size = (size_t)st.st_size;
+    SLOG_DEBUG("Client on socket %d attached buffer %s (%zu bytes)", client->fd, name, client->buf_size);
+    return RC_OK;
+}
+
+/*!
+ * \brief           Check that the vectors of a product lie in the first bytes of a buffer.
+ *
+ * \param[in]       req: Pointer to the product request (valid matrix).
+ * \param[in]       size: Number of bytes of the buffer.
+ * \return          true if they do, false otherwise.
+ */
+static bool prv_serve_fits(const struct ServeRequest *req, size_t size) {
+    const struct CsrMatrix *mtx = &g_serve_handler.mats[req->matrix].mtx;
+    const size_t item = mtx->is_real ? sizeof(double) : sizeof(int);
+    const size_t x_size = (size_t)mtx->n * item;
+    const size_t y_size = (size_t)mtx->m * item;
+
+    return req->x_off <= size && x_size <= size - req->x_off && req->y_off <= size && y_size <= size - req->y_off;
+}
+
+/*!
+ * \brief           Check that the vectors of the product of a client still lie in its buffer (SpMV thread).
+ *
+ * \details         A client may shrink its buffer (ftruncate) after attaching
+ *                  it: touching the mapping past the new end of the object
+ *                  raises SIGBUS, which would kill the server. Its current
+ *                  size is read again, right before x or y is copied.
+ *
+ * \param[in]       client: Pointer to the client (busy, buffer attached).
+ * \return          true if they do, false otherwise.
+ */
+static bool prv_serve_still_fits(const struct ServeClient *client) {
+    struct stat st;
+    if (fstat(client->buf_fd, &st) != 0 || st.st_size <= 0)
+        return false;
+    return prv_serve_fits(&client->req, GET_MIN((size_t)st.st_size, client->buf_size));
+}
+
+/*!
+ * \brief           Reject the product of a client whose buffer shrank, and release it (SpMV thread).
+ *
+ * \param[in]       client: Pointer to the client.
+ * \param[in]       matrix: Index of the matrix.
+ */
+static void prv_serve_reject(struct ServeClient *client, int matrix) {
+    SLOG_WARN("Buffer of client on socket %d no longer holds its vectors, product rejected", client->fd);
+    struct ServeReply reply = prv_serve_make_reply(matrix, RC_INVALID_ARG_ERR);
+    prv_serve_reply(client, &reply);
+    atomic_store_explicit(&client->busy, false, memory_order_release);
+}
+
+/*!
+ * \brief           Read and handle a request of a client (connection thread).
+ *
+ * \details         Products are queued for the SpMV thread, the other
+ *                  requests are answered here.
+ *
+ * \param[in]       slot: Index of the client.
+ */
+static void prv_serve_client_read(int slot) {
+    struct ServeClient *client = &g_serve_handler.clients[slot];
+    struct ServeRequest req;
+
+    ssize_t got = recv(client->fd, &req, sizeof(req), MSG_WAITALL);
+    if (got != (ssize_t)sizeof(req) || req.magic != SERVE_MAGIC) {
+        /*! Disconnected, or not speaking the protocol */
+        prv_serve_client_close(client);
+        return;
+    }
+
+    const bool valid_matrix = req.matrix >= 0 && req.matrix < g_serve_handler.matrices;
+    struct ServeReply reply;
+    switch (req.op) {
+        case SERVE_OP_INFO:
+            reply = prv_serve_make_reply(req.matrix, valid_matrix ? RC_OK : RC_IDX_OUT_OF_BOUNDS_ERR);
+            break;
+
+        case SERVE_OP_ATTACH:
+            req.shm_name[CONFIG_SHM_NAME_MAX_LEN - 1] = '\0';
+            reply = prv_serve_make_reply(-1, prv_serve_client_attach(client, req.shm_name));
+            break;
+
+        case SERVE_OP_SPMV:
+            if (!valid_matrix) {
+                reply = prv_serve_make_reply(-1, RC_IDX_OUT_OF_BOUNDS_ERR);
+                break;
+            }
+            if (!client->buf || !prv_serve_fits(&req, client->buf_size)) {
+                reply = prv_serve_make_reply(req.matrix, RC_INVALID_ARG_ERR);
+                break;
+            }
+            client->req = req;
+            client->received_ns = utils_get_ns();
+            atomic_store_explicit(&client->busy, true, memory_order_relaxed);
+            if (queue_push(&g_serve_handler.queue, slot)) {
+                prv_serve_wake(false);
+                return;
+            }
+            atomic_store_explicit(&client->busy, false, memory_order_relaxed);
+            reply = prv_serve_make_reply(req.matrix, RC_FAIL);
+            break;
+
+        case SERVE_OP_SHUTDOWN:
+            SLOG_INFO("Shutdown requested by client on socket %d", client->fd);
+            atomic_store(&g_serve_handler.stop, true);
+            reply = prv_serve_make_reply(-1, RC_OK);
+            break;
+
+        default:
+            reply = prv_serve_make_reply(-1, RC_INVALID_ARG_ERR);
+            break;
+    }
+    prv_serve_reply(client, &reply);
+}
+
+/*!
+ * \brief           Accept a pending connection (connection thread).
+ */
+static void prv_serve_accept(void) {
+    int fd = accept(g_serve_handler.listen_fd, NULL, NULL);
+    if (fd < 0)
+        return;
+
+    for (int i = 0; i < CONFIG_SERVE_MAX_CLIENTS; ++i) {
+        struct ServeClient *client = &g_serve_handler.clients[i];
+        if (client->fd < 0) {
+            client->fd = fd;
+            client->buf_fd = -1;
+            client->buf = NULL;
+            client->buf_size = 0;
+            atomic_store_explicit(&client->busy, false, memory_order_relaxed);
+            SLOG_DEBUG("Accepted client on socket %d", fd);
+            return;
+        }
+    }
+
+    SLOG_WARN("Too many clients (%d), connection refused", CONFIG_SERVE_MAX_CLIENTS);
+    close(fd);
+}
+
+/*!
+ * \brief           Read the requests of the clients until asked to stop (connection thread).
+ *
+ * \details         The socket of a client whose product is being computed may
+ *                  be readable only if it did not wait for the reply: it is
+ *                  read once the product is done.
+ *
+ * \param[in]       arg: Unused.
+ * \return          NULL.
+ */
+static void *prv_serve_connections(void *arg) {
+    UNUSED(arg);
+    struct pollfd fds[CONFIG_SERVE_MAX_CLIENTS + 1];
+    int slots[CONFIG_SERVE_MAX_CLIENTS + 1];
+
+    while (!atomic_load(&g_serve_handler.stop)) {
+        int count = 0;
+        fds[count++] = (struct pollfd){ .fd = g_serve_handler.listen_fd, .events = POLLIN };
+        for (int i = 0; i < CONFIG_SERVE_MAX_CLIENTS; ++i) {
+            if (g_serve_handler.clients[i].fd >= 0) {
+                slots[count] = i;
+                fds[count++] = (struct pollfd){ .fd = g_serve_handler.clients[i].fd, .events = POLLIN };
+            }
+        }
+
+        int ready = poll(fds, (nfds_t)count, CONFIG_SERVE_POLL_MS);
+        if (g_serve_signal) {
+            SLOG_INFO("Signal received, stopping the server");
+            atomic_store(&g_serve_handler.stop, true);
+        }
+        if (ready <= 0)
+            continue;
+
+        if (fds[0].revents & POLLIN)
+            prv_serve_accept();
+        bool deferred = false;
+        for (int k = 1; k < count; ++k) {
+            if (!fds[k].revents)
+                continue;
+            if (atomic_load_explicit(&g_serve_handler.clients[slots[k]].busy, memory_order_acquire)) {
+                deferred = true;
+                continue;
+            }
+            prv_serve_client_read(slots[k]);
+        }
+        if (deferred)
+            sched_yield(); /*! Let the SpMV thread finish the product instead of polling again at once */
+    }
+
+    prv_serve_wake(true);
+    return NULL;
+}
+
+/*!
+ * \brief           Get a view of the first items of a staging block.
+ *
+ * \details         A block of k interleaved vectors fills the first n * k
+ *                  items of a block allocated for coalesce of them; a block of
+ *                  a single vector is a plain vector.
+ *
+ * \param[in]       block: Pointer to the staging block.
+ * \param[in]       n: Number of items of the view.
+ * \return          The view, sharing the values of the block.
+ */
+static inline struct Vec prv_serve_view(const struct Vec *block, int n) {
+    struct Vec view = *block;
+    view.n = n;
+    return view;
+}
+
+/*!
+ * \brief           Copy items between two strided arrays.
+ *
+ * \details         Inlined with a constant item size, so that each copy is a
+ *                  single load and store: the offsets of the clients do not
+ *                  guarantee the alignment of their vectors.
+ *
+ * \param[out]      dst: Destination array.
+ * \param[in]       dst_stride: Stride of the destination in bytes.
+ * \param[in]       src: Source array.
+ * \param[in]       src_stride: Stride of the source in bytes.
+ * \param[in]       count: Number of items.
+ * \param[in]       item: Size of an item in bytes.
+ */
+static inline __attribute__((always_inline)) void prv_serve_copy_strided(char *dst, size_t dst_stride, const char *src, size_t src_stride, int count, size_t item) {
+    for (int i = 0; i < count; ++i)
+        memcpy(dst + (size_t)i * dst_stride, src + (size_t)i * src_stride, item);
+}
+
+/*!
+ * \brief           Copy a vector of a client into a staging block, or back.
+ *
+ * \param[in]       sm: Pointer to the matrix.
+ * \param[in,out]   block: Staging block.
+ * \param[in,out]   vec: Vector in the buffer of the client.
+ * \param[in]       count: Number of items of the vector.
+ * \param[in]       j: Index of the vector in the block.
+ * \param[in]       k: Number of vectors of the block.
+ * \param[in]       to_block: Copy from the client to the block (true) or back (false).
+ */
+static void prv_serve_stage(const struct ServeMatrix *sm, char *block, char *vec, int count, int j, int k, bool to_block) {
+    const size_t item = sm->mtx.is_real ? sizeof(double) : sizeof(int);
+    char *slot = block + (size_t)j * item;
+    if (k == 1) {
+        memcpy(to_block ? slot : vec, to_block ? vec : slot, (size_t)count * item);
+    } else if (sm->mtx.is_real) {
+        if (to_block)
+            prv_serve_copy_strided(slot, k * sizeof(double), vec, sizeof(double), count, sizeof(double));
+        else
+            prv_serve_copy_strided(vec, sizeof(double), slot, k * sizeof(double), count, sizeof(double));
+    } else {
+        if (to_block)
+            prv_serve_copy_strided(slot, k * sizeof(int), vec, sizeof(int), count, sizeof(int));
+        else
+            prv_serve_copy_strided(vec, sizeof(int), slot, k * sizeof(int), count, sizeof(int));
+    }
+}
+
+/*!
+ * \brief           Compute the pending products of a matrix in one pass and reply (SpMV thread).
+ *
+ * \details         A single product runs the SpMV kernel selected with -k,
+ *                  several are interleaved in the staging blocks and run one
+ *                  SpMM. The products whose buffer shrank since it was
+ *                  attached are rejected instead of staged.
+ *
+ * \param[in]       matrix: Index of the matrix.
+ */
+static void prv_serve_pass(int matrix) {
+    struct ServeMatrix *sm = &g_serve_handler.mats[matrix];
+    int k = 0;
+    for (int j = 0; j < sm->pending_count; ++j) {
+        struct ServeClient *client = &g_serve_handler.clients[sm->pending[j]];
+        if (prv_serve_still_fits(client))
+            sm->pending[k++] = sm->pending[j];
+        else
+            prv_serve_reject(client, matrix);
+    }
+    sm->pending_count = k;
+    if (k == 0)
+        return;
+
+    const int m = sm->mtx.m;
+    const int n = sm->mtx.n;
+
+#ifdef CONFIG_ENABLE_OMP_PARALLELISM
+    if (sm->threads != g_serve_handler.threads) {
+        omp_set_num_threads(sm->threads);
+        g_serve_handler.threads = sm->threads;
+    }
+#endif /*! CONFIG_ENABLE_OMP_PARALLELISM */
+
+    const uint64_t start = utils_get_ns();
+    for (int j = 0; j < k; ++j) {
+        struct ServeClient *client = &g_serve_handler.clients[sm->pending[j]];
+        prv_serve_stage(sm, arena_get_ptr(&sm->x.val), client->buf + client->req.x_off, n, j, k, true);
+    }
+
+    struct Vec x = prv_serve_view(&sm->x, n * k);
+    struct Vec y = prv_serve_view(&sm->y, m * k);
+    const uint64_t kernel_start = utils_get_ns();
+    int res = k == 1 ? csr_matrix_mul_vec(&sm->mtx, &x, &y) : csr_matrix_mul_block(&sm->mtx, &x, &y, k);
+    const uint64_t kernel_ns = utils_get_ns() - kernel_start;
+
+    for (int j = 0; j < k; ++j) {
+        struct ServeClient *client = &g_serve_handler.clients[sm->pending[j]];
+        if (!prv_serve_still_fits(client)) {
+            prv_serve_reject(client, matrix);
+            continue;
+        }
+        prv_serve_stage(sm, arena_get_ptr(&sm->y.val), client->buf + client->req.y_off, m, j, k, false);
+
+        struct ServeReply reply = prv_serve_make_reply(matrix, res);
+        reply.batch = k;
+        reply.kernel_ns = kernel_ns;
+        reply.total_ns = utils_get_ns() - client->received_ns;
+        sm->wait_ns += start - client->received_ns;
+        sm->total_ns += reply.total_ns;
+
+        /*! Replied first: the connection thread does not touch the client while busy */
+        prv_serve_reply(client, &reply);
+        atomic_store_explicit(&client->busy, false, memory_order_release);
+    }
+
+    sm->requests += k;
+    sm->passes++;
+    sm->kernel_ns += kernel_ns;
+    sm->pending_count = 0;
+}
+
+/*!
+ * \brief           Add a queued product to the pending ones of its matrix (SpMV thread).
+ *
+ * \param[in]       slot: Index of the client.
+ */
+static void prv_serve_add(int slot) {
+    const struct ServeClient *client = &g_serve_handler.clients[slot];
+    struct ServeMatrix *sm = &g_serve_handler.mats[client->req.matrix];
+
+    if (sm->pending_count == 0)
+        sm->oldest_ns = client->received_ns;
+    sm->pending[sm->pending_count++] = slot;
+    if (sm->pending_count == g_serve_handler.coalesce)
+        prv_serve_pass(client->req.matrix);
+}
+
+/*!
+ * \brief           Run the passes whose oldest product waited the whole window (SpMV thread).
+ *
+ * \param[in]       all: Run all the pending passes, whatever their wait.
+ * \return          The number of products still pending.
+ */
+static int prv_serve_flush(bool all) {
+    const uint64_t now = utils_get_ns();
+    int left = 0;
+    for (int i = 0; i < g_serve_handler.matrices; ++i) {
+        const struct ServeMatrix *sm = &g_serve_handler.mats[i];
+        if (sm->pending_count == 0)
+            continue;
+        if (all || now - sm->oldest_ns >= g_serve_handler.window_ns)
+            prv_serve_pass(i);
+        else
+            left += sm->pending_count;
+    }
+    return left;
+}
+
+/*!
+ * \brief           Open the socket of the server.
+ *
+ * \details         A socket left by a server that exited is replaced, a
+ *                  socket accepting connections is not.
+ *
+ * \param[in]       path: Path of the socket.
+ * \return          RC_OK on success, an error code otherwise (see serve_init).
+ */
+static int prv_serve_listen(const char *path) {
+    struct sockaddr_un addr = { .sun_family = AF_UNIX };
+    if (strlen(path) >= sizeof(addr.sun_path)) {
+        rc_set_err_msg("Socket path too long - %s", path);
+        return RC_INVALID_ARG_ERR;
+    }
+    strncpy(addr.sun_path, path, sizeof(addr.sun_path) - 1);
+
+    struct stat st;
+    if (stat(path, &st) == 0) {
+        if (!S_ISSOCK(st.st_mode)) {
+            rc_set_err_msg("%s exists and is not a socket", path);
+            return RC_INVALID_ARG_ERR;
+        }
+        int probe = socket(AF_UNIX, SOCK_STREAM, 0);
+        bool served = probe >= 0 && connect(probe, (struct sockaddr *)&addr, sizeof(addr)) == 0;
+        if (probe >= 0)
+            close(probe);
+        if (served) {
+            rc_set_err_msg("Socket %s is served by another process", path);
+            return RC_INVALID_ARG_ERR;
+        }
+        unlink(path);
+    }
+
+    int fd = socket(AF_UNIX, SOCK_STREAM, 0);
+    if (fd < 0) {
+        rc_set_err_msg("Could not create socket - %s", strerror(errno));
+        return RC_FILE_IO_ERR;
+    }
+    if (bind(fd, (struct sockaddr *)&addr, sizeof(addr)) != 0 || listen(fd, CONFIG_SERVE_BACKLOG) != 0) {
+        rc_set_err_msg("Could not listen on socket %s - %s", path, strerror(errno));
+        close(fd);
+        return RC_FILE_IO_ERR;
+    }
+
+    g_serve_handler.listen_fd = fd;
+    return RC_OK;
+}
+
+/*!
+ * \brief           Load a matrix and plan its SpMV.
+ *
+ * \param[out]      sm: Pointer to the matrix to initialize.
+ * \param[in]       filename: Path to the Matrix Market file.
+ * \param[in]       cfg: Pointer to the server configuration.
+ * \return          RC_OK on success, an error code otherwise (see serve_init).
+ */
+static int prv_serve_plan(struct ServeMatrix *sm, const char *filename, const struct ServeConfig *cfg) {
+    SLOG_DEBUG("Loading input matrix from file: %s", filename);
+    *sm = (struct ServeMatrix){ 0 };
+    int res;
+    if (cfg->shared)
+        res = shm_store_load(&sm->shm, &sm->mtx, filename, cfg->arena);
+    else
+        res = csr_matrix_load_from_file(&sm->mtx, filename, cfg->arena);
+    if (res != RC_OK)
+        return res;
+
+    if ((long long)GET_MAX(sm->mtx.m, sm->mtx.n) * cfg->coalesce > INT_MAX) {
+        rc_set_err_msg("Matrix %s too large to coalesce %d products", filename, cfg->coalesce);
+        return RC_INVALID_ARG_ERR;
+    }
+    res = vec_init(&sm->x, sm->mtx.n * cfg->coalesce, sm->mtx.is_real, cfg->arena);
+    if (res == RC_OK)
+        res = vec_init(&sm->y, sm->mtx.m * cfg->coalesce, sm->mtx.is_real, cfg->arena);
+    if (res == RC_OK)
+        res = vec_rand_fill(&sm->x);
+    if (res != RC_OK)
+        return res;
+
+    sm->threads = cfg->thread_count;
+    sm->policy = "fixed";
+    if (cfg->thread_count == CONFIG_THREADS_AUTO) {
+        struct ThreadPolicy policy;
+        struct Vec x = prv_serve_view(&sm->x, sm->mtx.n);
+        struct Vec y = prv_serve_view(&sm->y, sm->mtx.m);
+        res = policy_select_threads(&policy, &sm->mtx, &x, &y, topo_get()->num_cpus);
+        if (res != RC_OK)
+            return res;
+        sm->threads = policy.threads;
+        sm->policy = policy.reason;
+    }
+
+    SLOG_INFO("Matrix %s: rows=%d, cols=%d, non-zero=%d, %d threads (%s)", filename, sm->mtx.m, sm->mtx.n, sm->mtx.nz, sm->threads, sm->policy);
+    return RC_OK;
+}
+
+int serve_init(const struct ServeConfig *cfg) {
+    SLOG_DEBUG("Entering serve_init");
+    if (!cfg || !cfg->path || !cfg->filenames || !cfg->arena || cfg->matrices < 1 || cfg->matrices > CONFIG_SERVE_MAX_MATRICES || cfg->coalesce < 1 ||
+        cfg->coalesce > CONFIG_CSR_BLOCK_MAX || cfg->window_us < 0 || cfg->window_us > CONFIG_SERVE_MAX_WINDOW_US) {
+        rc_set_err_msg("Invalid argument(s) provided to serve_init");
+        return RC_INVALID_ARG_ERR;
+    }
+
+    csr_set_kernel(cfg->kernel);
+    g_serve_handler.path = cfg->path;
+    g_serve_handler.listen_fd = -1;
+    for (int i = 0; i < CONFIG_SERVE_MAX_CLIENTS; ++i) {
+        g_serve_handler.clients[i].fd = -1;
+        g_serve_handler.clients[i].buf_fd = -1;
+        atomic_init(&g_serve_handler.clients[i].busy, false);
+    }
+
+    int max_threads = 1;
+    for (int i = 0; i < cfg->matrices; ++i) {
+        int res = prv_serve_plan(&g_serve_handler.mats[i], cfg->filenames[i], cfg);
+        g_serve_handler.matrices = i + 1; /*! Released by serve_fini even if not planned */
+        if (res != RC_OK)
+            return res;
+        max_threads = GET_MAX(max_threads, g_serve_handler.mats[i].threads);
+    }
+
+#ifdef CONFIG_ENABLE_OMP_PARALLELISM
+    omp_set_num_threads(g_serve_handler.mats[0].threads);
+    g_serve_handler.threads = g_serve_handler.mats[0].threads;
+#endif /*! CONFIG_ENABLE_OMP_PARALLELISM */
+
+#ifdef CONFIG_ENABLE_PTHREADS_PARALLELISM
+    /*! A single pool: a kernel runs with all its threads */
+    int res = pool_init_default(max_threads, NULL, cfg->arena);
+    if (res != RC_OK)
+        return res;
+    g_serve_handler.threads = max_threads;
+#else
+    UNUSED(max_threads);
+#endif /*! CONFIG_ENABLE_PTHREADS_PARALLELISM */
+
+    int rc = queue_init(&g_serve_handler.queue, CONFIG_SERVE_QUEUE_LEN, cfg->arena);
+    if (rc != RC_OK)
+        return rc;
+    /*! Spinning on a single CPU would only delay the thread pushing the requests */
+    g_serve_handler.spins = topo_get()->num_cpus > 1 ? CONFIG_SERVE_SPINS : 0;
+    g_serve_handler.coalesce = cfg->coalesce;
+    g_serve_handler.window_ns = (uint64_t)cfg->window_us * 1000U;
+    atomic_init(&g_serve_handler.stop, false);
+    atomic_init(&g_serve_handler.sleeping, false);
+    pthread_mutex_init(&g_serve_handler.lock, NULL);
+    pthread_cond_init(&g_serve_handler.wake, NULL);
+    g_serve_handler.initialized = true;
+
+    rc = prv_serve_listen(cfg->path);
+    if (rc != RC_OK)
+        return rc;
+
+    struct sigaction sa = { .sa_handler = prv_serve_on_signal };
+    sigemptyset(&sa.sa_mask);
+    sigaction(SIGINT, &sa, NULL);
+    sigaction(SIGTERM, &sa, NULL);
+    sa.sa_handler = SIG_IGN;
+    sigaction(SIGPIPE, &sa, NULL); /*! A client leaving before its reply must not kill the server */
+
+    SLOG_INFO("Serving %d matrices on %s, up to %d products per pass, %d us window", g_serve_handler.matrices, cfg->path, cfg->coalesce, cfg->window_us);
+    return RC_OK;
+}
+
+int serve_run(void) {
+    SLOG_DEBUG("Entering serve_run");
+    pthread_t conn;
+    if (pthread_create(&conn, NULL, prv_serve_connections, NULL) != 0) {
+        rc_set_err_msg("Could not start the connection thread of the server");
+        return RC_FAIL;
+    }
+
+    int spins = 0;
+    for (;;) {
+        int slot;
+        if (queue_pop(&g_serve_handler.queue, &slot)) {
+            prv_serve_add(slot);
+            spins = 0;
+            continue;
+        }
+
+        /*! Queue drained: run the passes whose window is over, wait for the others */
+        const bool stop = atomic_load(&g_serve_handler.stop);
+        if (prv_serve_flush(stop) > 0) {
+            if (g_serve_handler.spins == 0)
+                sched_yield(); /*! Single CPU: the products would come from the connection thread */
+            continue;
+        }
+        if (stop)
+            break;
+        if (++spins < g_serve_handler.spins)
+            continue;
+
+        /*! The flag is raised before the last pop: a push either is seen here or sees the flag */
+        spins = 0;
+        pthread_mutex_lock(&g_serve_handler.lock);
+        atomic_store(&g_serve_handler.sleeping, true);
+        atomic_thread_fence(memory_order_seq_cst);
+        bool queued = queue_pop(&g_serve_handler.queue, &slot);
+        if (!queued && !atomic_load(&g_serve_handler.stop))
+            pthread_cond_wait(&g_serve_handler.wake, &g_serve_handler.lock);
+        atomic_store(&g_serve_handler.sleeping, false);
+        pthread_mutex_unlock(&g_serve_handler.lock);
+        if (queued)
+            prv_serve_add(slot);
+    }
+
+    pthread_join(conn, NULL);
+
+    for (int i = 0; i < g_serve_handler.matrices; ++i) {
+        const struct ServeMatrix *sm = &g_serve_handler.mats[i];
+        if (sm->requests > 0)
+            SLOG_INFO("Matrix %d: %ld products in %ld passes (%.2f per pass), mean kernel %lu ns per product, mean wait %lu ns, mean service %lu ns",
+                      i,
+                      sm->requests,
+                      sm->passes,
+                      (double)sm->requests / (double)sm->passes,
+                      sm->kernel_ns / (uint64_t)sm->requests,
+                      sm->wait_ns / (uint64_t)sm->requests,
+                      sm->total_ns / (uint64_t)sm->requests);
+    }
+
+    return RC_OK;
+}
+
+int serve_fini(void) {
+    SLOG_DEBUG("Entering serve_fini");
+    if (!g_serve_handler.initialized && g_serve_handler.matrices == 0)
+        return RC_OK;
+
+    for (int i = 0; i < CONFIG_SERVE_MAX_CLIENTS; ++i) {
+        if (g_serve_handler.clients[i].fd >= 0)
+            prv_serve_client_close(&g_serve_handler.clients[i]);
+    }
+    if (g_serve_handler.listen_fd >= 0) {
+        close(g_serve_handler.listen_fd);
+        unlink(g_serve_handler.path);
+        g_serve_handler.listen_fd = -1;
+    }
+    for (int i = 0; i < g_serve_handler.matrices; ++i)
+        shm_store_detach(&g_serve_handler.mats[i].shm);
+    g_serve_handler.matrices = 0;
+
+    if (g_serve_handler.initialized) {
+        pthread_mutex_destroy(&g_serve_handler.lock);
+        pthread_cond_destroy(&g_serve_handler.wake);
+        g_serve_handler.initialized = false;
+    }
+
+    return RC_OK;
+}
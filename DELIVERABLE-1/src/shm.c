@@ -0,0 +1,401 @@
+/*!
+ * \file            shm.c
+ * \date            2026-10-18
+ * \author          Mirko Lana [lana.mirko@icloud.com]
+ *
+ * \brief           Matrix store shared by the processes of a node (POSIX shared memory).
+ */
+
+#include "config.h"
+#include "shm.h"
+#include "rc.h"
+#include "arena.h"
+#include "csr.h"
+#include "slog.h"
+
+#include <errno.h>
+#include <fcntl.h>
+#include <stdatomic.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <time.h>
+#include <unistd.h>
+
+#define PRV_SHM_MAGIC 0x5350564d53484d31ULL /*!< Magic number of a segment ("SPVMSHM1"). */
+#define PRV_SHM_ALIGN 64                    /*!< Alignment of the arrays in a segment (cache line). */
+
+/*!
+ * \brief           Publication states of a segment.
+ */
+enum ShmState {
+    SHM_STATE_BUILDING, /*!< The publisher is loading the matrix (zero, the state of a new segment) */
+    SHM_STATE_READY,    /*!< The arrays are published and read-only */
+    SHM_STATE_FAILED,   /*!< The publisher failed, the segment is being unlinked */
+};
+
+/*!
+ * \brief           Structure representing the header of a segment (first page).
+ */
+struct ShmHeader {
+    uint64_t magic;     /*< PRV_SHM_MAGIC once ready */
+    atomic_int state;   /*< Publication state (enum ShmState) */
+    atomic_int refs;    /*< Processes attached, 0 once the segment is being unlinked */
+    uint64_t dev;       /*< Device of the file */
+    uint64_t ino;       /*< Inode of the file */
+    int64_t file_size;  /*< Size of the file */
+    int64_t mtime_sec;  /*< Modification time of the file (seconds) */
+    int64_t mtime_nsec; /*< Modification time of the file (nanoseconds) */
+    int m;              /*< Number of rows */
+    int n;              /*< Number of columns */
+    int nz;             /*< Number of non-zeros */
+    bool is_real;       /*< Real (true) or integer (false) values */
+    int val_type;       /*< Storage type of the values (enum CsrValType) */
+    int max_abs_val;    /*< Largest absolute value (integer matrices) */
+    int max_row_nnz;    /*< Non-zeros of the longest row */
+    size_t row_off;     /*< Offset of the row pointers */
+    size_t col_off;     /*< Offset of the column indices */
+    size_t val_off;     /*< Offset of the values */
+    size_t size;        /*< Size of the segment */
+};
+
+/*!
+ * \brief           Outcomes of an attempt to publish or attach.
+ */
+enum ShmTry {
+    SHM_TRY_DONE,    /*!< Published or attached */
+    SHM_TRY_AGAIN,   /*!< The segment went away meanwhile, try again */
+    SHM_TRY_PRIVATE, /*!< The store cannot be used, load the matrix privately */
+};
+
+/*!
+ * \brief           Round a size up to a multiple of an alignment.
+ *
+ * \param[in]       size: Size to round.
+ * \param[in]       align: Alignment (power of two).
+ * \return          The rounded size.
+ */
+static size_t prv_shm_align(size_t size, size_t align) {
+    return (size + align - 1) & ~(align - 1);
+}
+
+/*!
+ * \brief           Get the milliseconds elapsed on the monotonic clock.
+ *
+ * \return          The current time in milliseconds.
+ */
+static long long prv_shm_now_ms(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (long long)ts.tv_sec * 1000 + ts.tv_nsec / 1000000;
+}
+
+/*!
+ * \brief           Sleep for CONFIG_SHM_POLL_US microseconds.
+ */
+static void prv_shm_poll_sleep(void) {
+    const struct timespec ts = {
+        .tv_sec = CONFIG_SHM_POLL_US / 1000000,
+        .tv_nsec = (CONFIG_SHM_POLL_US % 1000000) * 1000L,
+    };
+    nanosleep(&ts, NULL);
+}
+
+/*!
+ * \brief           Check whether a header describes the file.
+ *
+ * \param[in]       hdr: Pointer to the header.
+ * \param[in]       st: Status of the file.
+ * \return          true if the segment holds the file, false otherwise.
+ */
+static bool prv_shm_same_file(const struct ShmHeader *hdr, const struct stat *st) {
+    return hdr->magic == PRV_SHM_MAGIC && hdr->dev == (uint64_t)st->st_dev && hdr->ino == (uint64_t)st->st_ino &&
+           hdr->file_size == (int64_t)st->st_size && hdr->mtime_sec == (int64_t)st->st_mtim.tv_sec &&
+           hdr->mtime_nsec == (int64_t)st->st_mtim.tv_nsec;
+}
+
+/*!
+ * \brief           Name the segment of a file after its identity.
+ *
+ * \details         FNV-1a hash of the device, inode, size and modification
+ *                  time of the file.
+ *
+ * \param[out]      name: Buffer of CONFIG_SHM_NAME_MAX_LEN characters.
+ * \param[in]       st: Status of the file.
+ */
+static void prv_shm_name(char *name, const struct stat *st) {
+    const uint64_t ids[] = {
+        (uint64_t)st->st_dev,
+        (uint64_t)st->st_ino,
+        (uint64_t)st->st_size,
+        (uint64_t)st->st_mtim.tv_sec,
+        (uint64_t)st->st_mtim.tv_nsec,
+    };
+    uint64_t hash = 0xcbf29ce484222325ULL;
+    const unsigned char *bytes = (const unsigned char *)ids;
+    for (size_t i = 0; i < sizeof(ids); ++i) {
+        hash ^= bytes[i];
+        hash *= 0x100000001b3ULL;
+    }
+    snprintf(name, CONFIG_SHM_NAME_MAX_LEN, "%s%016llx", CONFIG_SHM_NAME_PREFIX, (unsigned long long)hash);
+}
+
+/*!
+ * \brief           Point a matrix at the arrays of a segment.
+ *
+ * \param[out]      mtx: Pointer to the CSR matrix.
+ * \param[in]       base: Mapped segment.
+ */
+static void prv_shm_map_matrix(struct CsrMatrix *mtx, char *base) {
+    const struct ShmHeader *hdr = (const struct ShmHeader *)base;
+    *mtx = (struct CsrMatrix){
+        .m = hdr->m,
+        .n = hdr->n,
+        .nz = hdr->nz,
+        .is_real = hdr->is_real,
+        .val_type = (enum CsrValType)hdr->val_type,
+        .max_abs_val = hdr->max_abs_val,
+        .max_row_nnz = hdr->max_row_nnz,
+        .mapped_row = (int *)(base + hdr->row_off),
+        .mapped_col = (int *)(base + hdr->col_off),
+        .mapped_val = base + hdr->val_off,
+    };
+}
+
+/*!
+ * \brief           Create the segment of a file, load the matrix and publish it.
+ *
+ * \param[in,out]   store: Pointer to the attachment (name set).
+ * \param[out]      mtx: Pointer to the CSR matrix.
+ * \param[in]       fd: Descriptor of the segment, just created (empty).
+ * \param[in]       filename: Path to the Matrix Market file.
+ * \param[in]       st: Status of the file.
+ * \param[out]      arena: Pointer to the arena handler for memory allocation.
+ * \return          RC_OK on success, an error code otherwise (see shm_store_load).
+ */
+static int prv_shm_publish(struct ShmStore *store, struct CsrMatrix *mtx, int fd, const char *filename, const struct stat *st,
+                           struct ArenaHandler *arena) {
+    const size_t page = (size_t)sysconf(_SC_PAGESIZE);
+
+    /*! The header page first: attaching processes wait on its state while the file is parsed */
+    if (ftruncate(fd, (off_t)page) != 0) {
+        rc_set_err_msg("Could not size the shared-memory segment %s - %s", store->name, strerror(errno));
+        shm_unlink(store->name);
+        return RC_FILE_IO_ERR;
+    }
+    struct ShmHeader *hdr = mmap(NULL, page, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    if (hdr == MAP_FAILED) {
+        rc_set_err_msg("Could not map the shared-memory segment %s - %s", store->name, strerror(errno));
+        shm_unlink(store->name);
+        return RC_FILE_IO_ERR;
+    }
+
+    int res = csr_matrix_load_from_file(mtx, filename, arena);
+    if (res == RC_OK) {
+        const size_t val_size = csr_matrix_val_size(mtx);
+        hdr->row_off = page;
+        hdr->col_off = prv_shm_align(hdr->row_off + (size_t)(mtx->m + 1) * sizeof(int), PRV_SHM_ALIGN);
+        hdr->val_off = prv_shm_align(hdr->col_off + (size_t)mtx->nz * sizeof(int), PRV_SHM_ALIGN);
+        hdr->size = hdr->val_off + (size_t)mtx->nz * val_size;
+        if (ftruncate(fd, (off_t)hdr->size) != 0) {
+            rc_set_err_msg("Could not size the shared-memory segment %s - %s", store->name, strerror(errno));
+            res = RC_FILE_IO_ERR;
+        }
+    }
+    if (res == RC_OK) {
+        store->base = mmap(NULL, hdr->size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+        if (store->base == MAP_FAILED) {
+            rc_set_err_msg("Could not map the shared-memory segment %s - %s", store->name, strerror(errno));
+            store->base = NULL;
+            res = RC_FILE_IO_ERR;
+        }
+    }
+    if (res != RC_OK) {
+        /*! Wake up the waiting processes, which load the file on their own */
+        atomic_store_explicit(&hdr->state, SHM_STATE_FAILED, memory_order_release);
+        shm_unlink(store->name);
+        munmap(hdr, page);
+        return res;
+    }
+    munmap(hdr, page);
+    store->size = ((struct ShmHeader *)store->base)->size;
+
+    char *base = store->base;
+    hdr = store->base;
+    memcpy(base + hdr->row_off, csr_matrix_row_ptr(mtx), (size_t)(mtx->m + 1) * sizeof(int));
+    memcpy(base + hdr->col_off, csr_matrix_col_idx(mtx), (size_t)mtx->nz * sizeof(int));
+    memcpy(base + hdr->val_off, csr_matrix_values(mtx), (size_t)mtx->nz * csr_matrix_val_size(mtx));
+
+    hdr->dev = (uint64_t)st->st_dev;
+    hdr->ino = (uint64_t)st->st_ino;
+    hdr->file_size = (int64_t)st->st_size;
+    hdr->mtime_sec = (int64_t)st->st_mtim.tv_sec;
+    hdr->mtime_nsec = (int64_t)st->st_mtim.tv_nsec;
+    hdr->m = mtx->m;
+    hdr->n = mtx->n;
+    hdr->nz = mtx->nz;
+    hdr->is_real = mtx->is_real;
+    hdr->val_type = (int)mtx->val_type;
+    hdr->max_abs_val = mtx->max_abs_val;
+    hdr->max_row_nnz = mtx->max_row_nnz;
+    hdr->magic = PRV_SHM_MAGIC;
+    atomic_store_explicit(&hdr->refs, 1, memory_order_relaxed);
+
+    if (mprotect(base + page, store->size - page, PROT_READ) != 0)
+        SLOG_WARN("Could not make the shared-memory segment %s read-only - %s", store->name, strerror(errno));
+    atomic_store_explicit(&hdr->state, SHM_STATE_READY, memory_order_release);
+
+    prv_shm_map_matrix(mtx, base);
+    store->published = true;
+    SLOG_INFO("Published matrix %s in shared-memory segment %s (%zu bytes)", filename, store->name, store->size);
+    return RC_OK;
+}
+
+/*!
+ * \brief           Attach to the segment of a file published by another process.
+ *
+ * \param[in,out]   store: Pointer to the attachment (name set).
+ * \param[out]      mtx: Pointer to the CSR matrix.
+ * \param[in]       fd: Descriptor of the segment.
+ * \param[in]       st: Status of the file.
+ * \param[in]       deadline: Time (see prv_shm_now_ms) after which the wait is abandoned.
+ * \return          The outcome of the attempt.
+ */
+static enum ShmTry prv_shm_attach(struct ShmStore *store, struct CsrMatrix *mtx, int fd, const struct stat *st, long long deadline) {
+    const size_t page = (size_t)sysconf(_SC_PAGESIZE);
+
+    /*! The publisher may not have sized the header page yet */
+    struct stat seg;
+    while (fstat(fd, &seg) == 0 && (size_t)seg.st_size < page) {
+        if (prv_shm_now_ms() > deadline)
+            return SHM_TRY_PRIVATE;
+        prv_shm_poll_sleep();
+    }
+    if ((size_t)seg.st_size < page)
+        return SHM_TRY_PRIVATE;
+
+    struct ShmHeader *hdr = mmap(NULL, page, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    if (hdr == MAP_FAILED)
+        return SHM_TRY_PRIVATE;
+
+    int state;
+    while ((state = atomic_load_explicit(&hdr->state, memory_order_acquire)) == SHM_STATE_BUILDING) {
+        if (prv_shm_now_ms() > deadline) {
+            SLOG_WARN("Shared-memory segment %s still being published after %d ms", store->name, CONFIG_SHM_READY_TIMEOUT_MS);
+            munmap(hdr, page);
+            return SHM_TRY_PRIVATE;
+        }
+        prv_shm_poll_sleep();
+    }
+    if (state == SHM_STATE_FAILED) {
+        munmap(hdr, page);
+        prv_shm_poll_sleep();
+        return SHM_TRY_AGAIN;
+    }
+    if (!prv_shm_same_file(hdr, st)) {
+        SLOG_WARN("Shared-memory segment %s holds another matrix", store->name);
+        munmap(hdr, page);
+        return SHM_TRY_PRIVATE;
+    }
+
+    /*! A segment without references is being unlinked by its last process */
+    int refs = atomic_load_explicit(&hdr->refs, memory_order_relaxed);
+    do {
+        if (refs <= 0) {
+            munmap(hdr, page);
+            prv_shm_poll_sleep();
+            return SHM_TRY_AGAIN;
+        }
+    } while (!atomic_compare_exchange_weak_explicit(&hdr->refs, &refs, refs + 1, memory_order_acq_rel, memory_order_relaxed));
+
+    const size_t size = hdr->size;
+    munmap(hdr, page);
+    char *base = mmap(NULL, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    if (base == MAP_FAILED) {
+        /*! Give the reference back through the header alone */
+        hdr = mmap(NULL, page, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+        if (hdr != MAP_FAILED) {
+            if (atomic_fetch_sub_explicit(&hdr->refs, 1, memory_order_acq_rel) == 1)
+                shm_unlink(store->name);
+            munmap(hdr, page);
+        }
+        return SHM_TRY_PRIVATE;
+    }
+    /*! The header stays writable for the reference count, the arrays do not */
+    mprotect(base + page, size - page, PROT_READ);
+
+    store->base = base;
+    store->size = size;
+    store->published = false;
+    prv_shm_map_matrix(mtx, base);
+    SLOG_INFO("Attached to shared-memory segment %s (%zu bytes)", store->name, size);
+    return SHM_TRY_DONE;
+}
+
+int shm_store_load(struct ShmStore *store, struct CsrMatrix *mtx, const char *filename, struct ArenaHandler *arena) {
+    SLOG_DEBUG("Entering shm_store_load");
+    if (!store || !mtx || !filename || !arena)
+        return RC_INVALID_ARG_ERR;
+
+    *store = (struct ShmStore){0};
+
+    struct stat st;
+    if (stat(filename, &st) != 0) {
+        rc_set_err_msg("Could not stat matrix file %s - %s", filename, strerror(errno));
+        return RC_FILE_IO_ERR;
+    }
+    prv_shm_name(store->name, &st);
+
+    const long long deadline = prv_shm_now_ms() + CONFIG_SHM_READY_TIMEOUT_MS;
+    for (;;) {
+        int fd = shm_open(store->name, O_CREAT | O_EXCL | O_RDWR, 0600);
+        if (fd >= 0) {
+            int res = prv_shm_publish(store, mtx, fd, filename, &st, arena);
+            close(fd);
+            return res;
+        }
+        if (errno != EEXIST) {
+            SLOG_WARN("Could not create shared-memory segment %s - %s", store->name, strerror(errno));
+            break;
+        }
+
+        fd = shm_open(store->name, O_RDWR, 0);
+        if (fd < 0) {
+            /*! Unlinked between the two calls */
+            if (errno == ENOENT && prv_shm_now_ms() <= deadline)
+                continue;
+            SLOG_WARN("Could not open shared-memory segment %s - %s", store->name, strerror(errno));
+            break;
+        }
+        enum ShmTry outcome = prv_shm_attach(store, mtx, fd, &st, deadline);
+        close(fd);
+        if (outcome == SHM_TRY_DONE)
+            return RC_OK;
+        if (outcome == SHM_TRY_PRIVATE || prv_shm_now_ms() > deadline)
+            break;
+    }
+
+    SLOG_WARN("Loading matrix %s privately", filename);
+    *store = (struct ShmStore){0};
+    return csr_matrix_load_from_file(mtx, filename, arena);
+}
+
+int shm_store_detach(struct ShmStore *store) {
+    SLOG_DEBUG("Entering shm_store_detach");
+    if (!store)
+        return RC_INVALID_ARG_ERR;
+    if (!store->base)
+        return RC_OK;
+
+    struct ShmHeader *hdr = store->base;
+    if (atomic_fetch_sub_explicit(&hdr->refs, 1, memory_order_acq_rel) == 1) {
+        shm_unlink(store->name);
+        SLOG_DEBUG("Unlinked shared-memory segment %s", store->name);
+    }
+    munmap(store->base, store->size);
+    store->base = NULL;
+    store->size = 0;
+    return RC_OK;
+}
@@ -0,0 +1,447 @@
+/*!
+ * \file            simd.c
+ * \date            2026-10-18
+ * \author          Mirko Lana [lana.mirko@icloud.com]
+ *
+ * \brief           Hand-written AVX2 and AVX-512 CSR SpMV kernels.
+ */
+
+#include "config.h"
+#include "simd.h"
+
+#ifdef ISA_ENABLE_X86_DISPATCH
+#include <immintrin.h>
+#include <string.h>
+
+#define PRV_SIMD_AVX2 __attribute__((target(ISA_TARGET_AVX2)))     /*!< Compile a function for AVX2 */
+#define PRV_SIMD_AVX512 __attribute__((target(ISA_TARGET_AVX512))) /*!< Compile a function for AVX-512 */
+
+/*!
+ * \brief           Horizontal maximum of four integers.
+ *
+ * \param[in]       v: The integers.
+ * \return          The maximum.
+ */
+PRV_SIMD_AVX2 static inline int prv_simd_hmax_epi32(__m128i v) {
+    v = _mm_max_epi32(v, _mm_shuffle_epi32(v, _MM_SHUFFLE(1, 0, 3, 2)));
+    v = _mm_max_epi32(v, _mm_shuffle_epi32(v, _MM_SHUFFLE(2, 3, 0, 1)));
+    return _mm_cvtsi128_si32(v);
+}
+
+/*!
+ * \brief           Dot product of one CSR row with a vector (AVX2).
+ *
+ * \param[in]       col: CSR column index array.
+ * \param[in]       val: CSR value array.
+ * \param[in]       x: Input vector values.
+ * \param[in]       k: Offset of the first non-zero of the row.
+ * \param[in]       end: Offset one past the last non-zero of the row.
+ * \return          The dot product.
+ */
+PRV_SIMD_AVX2 static inline double prv_simd_row_avx2(const int *col, const double *val, const double *x, int k, int end) {
+    __m256d acc0 = _mm256_setzero_pd();
+    __m256d acc1 = _mm256_setzero_pd();
+    __m256d acc2 = _mm256_setzero_pd();
+    __m256d acc3 = _mm256_setzero_pd();
+
+    /*! Four independent chains: one FMA per chain every four gathers */
+    for (; k + 16 <= end; k += 16) {
+        acc0 = _mm256_fmadd_pd(_mm256_loadu_pd(val + k), _mm256_i32gather_pd(x, _mm_loadu_si128((const __m128i *)(col + k)), 8), acc0);
+        acc1 = _mm256_fmadd_pd(_mm256_loadu_pd(val + k + 4), _mm256_i32gather_pd(x, _mm_loadu_si128((const __m128i *)(col + k + 4)), 8), acc1);
+        acc2 = _mm256_fmadd_pd(_mm256_loadu_pd(val + k + 8), _mm256_i32gather_pd(x, _mm_loadu_si128((const __m128i *)(col + k + 8)), 8), acc2);
+        acc3 = _mm256_fmadd_pd(_mm256_loadu_pd(val + k + 12), _mm256_i32gather_pd(x, _mm_loadu_si128((const __m128i *)(col + k + 12)), 8), acc3);
+    }
+    for (; k + 4 <= end; k += 4)
+        acc0 = _mm256_fmadd_pd(_mm256_loadu_pd(val + k), _mm256_i32gather_pd(x, _mm_loadu_si128((const __m128i *)(col + k)), 8), acc0);
+
+    if (k < end) {
+        /*! Masked tail: the loads do not touch memory past the row */
+        __m128i mask = _mm_cmplt_epi32(_mm_setr_epi32(0, 1, 2, 3), _mm_set1_epi32(end - k));
+        __m256i mask64 = _mm256_cvtepi32_epi64(mask);
+        __m128i idx = _mm_maskload_epi32(col + k, mask);
+        __m256d v = _mm256_maskload_pd(val + k, mask64);
+        __m256d xv = _mm256_mask_i32gather_pd(_mm256_setzero_pd(), x, idx, _mm256_castsi256_pd(mask64), 8);
+        acc1 = _mm256_fmadd_pd(v, xv, acc1);
+    }
+
+    acc0 = _mm256_add_pd(_mm256_add_pd(acc0, acc1), _mm256_add_pd(acc2, acc3));
+    __m128d sum = _mm_add_pd(_mm256_castpd256_pd128(acc0), _mm256_extractf128_pd(acc0, 1));
+    sum = _mm_add_sd(sum, _mm_unpackhi_pd(sum, sum));
+    return _mm_cvtsd_f64(sum);
+}
+
+/*!
+ * \brief           Dot product of one CSR row with a vector (AVX-512).
+ *
+ * \param[in]       col: CSR column index array.
+ * \param[in]       val: CSR value array.
+ * \param[in]       x: Input vector values.
+ * \param[in]       k: Offset of the first non-zero of the row.
+ * \param[in]       end: Offset one past the last non-zero of the row.
+ * \return          The dot product.
+ */
+PRV_SIMD_AVX512 static inline double prv_simd_row_avx512(const int *col, const double *val, const double *x, int k, int end) {
+    __m512d acc0 = _mm512_setzero_pd();
+    __m512d acc1 = _mm512_setzero_pd();
+    __m512d acc2 = _mm512_setzero_pd();
+    __m512d acc3 = _mm512_setzero_pd();
+
+    for (; k + 32 <= end; k += 32) {
+        acc0 = _mm512_fmadd_pd(_mm512_loadu_pd(val + k), _mm512_i32gather_pd(_mm256_loadu_si256((const __m256i *)(col + k)), x, 8), acc0);
+        acc1 = _mm512_fmadd_pd(_mm512_loadu_pd(val + k + 8), _mm512_i32gather_pd(_mm256_loadu_si256((const __m256i *)(col + k + 8)), x, 8), acc1);
+        acc2 = _mm512_fmadd_pd(_mm512_loadu_pd(val + k + 16), _mm512_i32gather_pd(_mm256_loadu_si256((const __m256i *)(col + k + 16)), x, 8), acc2);
+        acc3 = _mm512_fmadd_pd(_mm512_loadu_pd(val + k + 24), _mm512_i32gather_pd(_mm256_loadu_si256((const __m256i *)(col + k + 24)), x, 8), acc3);
+    }
+    for (; k + 8 <= end; k += 8)
+        acc0 = _mm512_fmadd_pd(_mm512_loadu_pd(val + k), _mm512_i32gather_pd(_mm256_loadu_si256((const __m256i *)(col + k)), x, 8), acc0);
+
+    if (k < end) {
+        __mmask8 mask = (__mmask8)((1U << (end - k)) - 1U);
+        __m256i idx = _mm256_maskz_loadu_epi32(mask, col + k);
+        __m512d v = _mm512_maskz_loadu_pd(mask, val + k);
+        __m512d xv = _mm512_mask_i32gather_pd(_mm512_setzero_pd(), mask, idx, x, 8);
+        acc1 = _mm512_fmadd_pd(v, xv, acc1);
+    }
+
+    return _mm512_reduce_add_pd(_mm512_add_pd(_mm512_add_pd(acc0, acc1), _mm512_add_pd(acc2, acc3)));
+}
+
+PRV_SIMD_AVX2 void simd_csr_gather_avx2(const int *row, const int *col, const double *val, const double *x, double *y, int row_begin, int row_end) {
+    for (int i = row_begin; i < row_end; ++i)
+        y[i] = prv_simd_row_avx2(col, val, x, row[i], row[i + 1]);
+}
+
+PRV_SIMD_AVX512 void simd_csr_gather_avx512(const int *row, const int *col, const double *val, const double *x, double *y, int row_begin, int row_end) {
+    for (int i = row_begin; i < row_end; ++i)
+        y[i] = prv_simd_row_avx512(col, val, x, row[i], row[i + 1]);
+}
+
+PRV_SIMD_AVX2 void simd_csr_lanes_avx2(const int *row, const int *col, const double *val, const double *x, double *y, int row_begin, int row_end) {
+    int i = row_begin;
+    for (; i + 4 <= row_end; i += 4) {
+        __m128i start = _mm_loadu_si128((const __m128i *)(row + i));
+        __m128i len = _mm_sub_epi32(_mm_loadu_si128((const __m128i *)(row + i + 1)), start);
+        int max_len = prv_simd_hmax_epi32(len);
+
+        if (max_len > CONFIG_SIMD_LANES_MAX_NNZ) {
+            for (int r = i; r < i + 4; ++r)
+                y[r] = prv_simd_row_avx2(col, val, x, row[r], row[r + 1]);
+            continue;
+        }
+
+        /*! Lane r walks row i + r: step j gathers the j-th non-zero of every row still active */
+        __m256d acc = _mm256_setzero_pd();
+        for (int j = 0; j < max_len; ++j) {
+            __m128i step = _mm_set1_epi32(j);
+            __m128i active = _mm_cmpgt_epi32(len, step);
+            __m256d active64 = _mm256_castsi256_pd(_mm256_cvtepi32_epi64(active));
+            __m128i pos = _mm_add_epi32(start, step);
+            __m128i idx = _mm_mask_i32gather_epi32(_mm_setzero_si128(), col, pos, active, 4);
+            __m256d v = _mm256_mask_i32gather_pd(_mm256_setzero_pd(), val, pos, active64, 8);
+            __m256d xv = _mm256_mask_i32gather_pd(_mm256_setzero_pd(), x, idx, active64, 8);
+            acc = _mm256_fmadd_pd(v, xv, acc);
+        }
+        _mm256_storeu_pd(y + i, acc);
+    }
+
+    for (; i < row_end; ++i)
+        y[i] = prv_simd_row_avx2(col, val, x, row[i], row[i + 1]);
+}
+
+PRV_SIMD_AVX512 void simd_csr_lanes_avx512(const int *row, const int *col, const double *val, const double *x, double *y, int row_begin, int row_end) {
+    int i = row_begin;
+    for (; i + 8 <= row_end; i += 8) {
+        __m256i start = _mm256_loadu_si256((const __m256i *)(row + i));
+        __m256i len = _mm256_sub_epi32(_mm256_loadu_si256((const __m256i *)(row + i + 1)), start);
+        int max_len = prv_simd_hmax_epi32(_mm_max_epi32(_mm256_castsi256_si128(len), _mm256_extracti128_si256(len, 1)));
+
+        if (max_len > CONFIG_SIMD_LANES_MAX_NNZ) {
+            for (int r = i; r < i + 8; ++r)
+                y[r] = prv_simd_row_avx512(col, val, x, row[r], row[r + 1]);
+            continue;
+        }
+
+        __m512d acc = _mm512_setzero_pd();
+        for (int j = 0; j < max_len; ++j) {
+            __m256i step = _mm256_set1_epi32(j);
+            __mmask8 active = _mm256_cmpgt_epi32_mask(len, step);
+            __m256i pos = _mm256_add_epi32(start, step);
+            __m256i idx = _mm256_mmask_i32gather_epi32(_mm256_setzero_si256(), active, pos, col, 4);
+            __m512d v = _mm512_mask_i32gather_pd(_mm512_setzero_pd(), active, pos, val, 8);
+            __m512d xv = _mm512_mask_i32gather_pd(_mm512_setzero_pd(), active, idx, x, 8);
+            acc = _mm512_fmadd_pd(v, xv, acc);
+        }
+        _mm512_storeu_pd(y + i, acc);
+    }
+
+    for (; i < row_end; ++i)
+        y[i] = prv_simd_row_avx512(col, val, x, row[i], row[i + 1]);
+}
+/*!
+ * \brief           Load eight values and sign-extend them to int32.
+ *
+ * \param[in]       val: CSR value array.
+ * \param[in]       k: Offset of the first value.
+ * \param[in]       width: Size of a value in bytes (1, 2 or 4).
+ * \return          The eight values.
+ */
+PRV_SIMD_AVX2 static inline __m256i prv_simd_load_int_avx2(const void *val, int k, int width) {
+    if (width == 1)
+        return _mm256_cvtepi8_epi32(_mm_loadl_epi64((const __m128i *)((const int8_t *)val + k)));
+    if (width == 2)
+        return _mm256_cvtepi16_epi32(_mm_loadu_si128((const __m128i *)((const int16_t *)val + k)));
+    return _mm256_loadu_si256((const __m256i *)((const int32_t *)val + k));
+}
+
+/*!
+ * \brief           Read one value.
+ *
+ * \param[in]       val: CSR value array.
+ * \param[in]       k: Offset of the value.
+ * \param[in]       width: Size of a value in bytes (1, 2 or 4).
+ * \return          The value.
+ */
+static inline int prv_simd_get_int(const void *val, int k, int width) {
+    if (width == 1)
+        return ((const int8_t *)val)[k];
+    if (width == 2)
+        return ((const int16_t *)val)[k];
+    return ((const int32_t *)val)[k];
+}
+
+/*!
+ * \brief           Multiply a range of rows of an integer CSR matrix with a vector (AVX2).
+ *
+ * \details         Inlined with constant width and flags in each exported kernel,
+ *                  so that every combination gets its own loop.
+ *
+ * \param[in]       row: CSR row pointer array.
+ * \param[in]       col: CSR column index array.
+ * \param[in]       val: CSR value array.
+ * \param[in]       width: Size of a value in bytes (1, 2 or 4).
+ * \param[in]       x: Input vector values.
+ * \param[out]      y: Result vector values.
+ * \param[in]       row_begin: First row of the range.
+ * \param[in]       row_end: One past the last row of the range.
+ * \param[in]       flags: SIMD_INT_* flags.
+ */
+PRV_SIMD_AVX2 static inline __attribute__((always_inline)) void prv_simd_int_rows_avx2(const int *row, const int *col, const void *val, int width, const int *x, int *y,
+                                                                                    int row_begin, int row_end, int flags) {
+    const __m256i zero = _mm256_setzero_si256();
+
+    for (int i = row_begin; i < row_end; ++i) {
+        int k = row[i];
+        const int end = row[i + 1];
+
+        if (flags & SIMD_INT_ACC32) {
+            __m256i acc0 = zero;
+            __m256i acc1 = zero;
+            for (; k + 16 <= end; k += 16) {
+                __m256i x0 = _mm256_i32gather_epi32(x, _mm256_loadu_si256((const __m256i *)(col + k)), 4);
+                __m256i x1 = _mm256_i32gather_epi32(x, _mm256_loadu_si256((const __m256i *)(col + k + 8)), 4);
+                __m256i v0 = prv_simd_load_int_avx2(val, k, width);
+                __m256i v1 = prv_simd_load_int_avx2(val, k + 8, width);
+                if (flags & SIMD_INT_MADD) {
+                    /*! Zeroing the high halves of the values leaves lo(v) * lo(x) in each lane */
+                    acc0 = _mm256_add_epi32(acc0, _mm256_madd_epi16(_mm256_blend_epi16(v0, zero, 0xAA), x0));
+                    acc1 = _mm256_add_epi32(acc1, _mm256_madd_epi16(_mm256_blend_epi16(v1, zero, 0xAA), x1));
+                } else {
+                    acc0 = _mm256_add_epi32(acc0, _mm256_mullo_epi32(v0, x0));
+                    acc1 = _mm256_add_epi32(acc1, _mm256_mullo_epi32(v1, x1));
+                }
+            }
+            for (; k + 8 <= end; k += 8) {
+                __m256i x0 = _mm256_i32gather_epi32(x, _mm256_loadu_si256((const __m256i *)(col + k)), 4);
+                __m256i v0 = prv_simd_load_int_avx2(val, k, width);
+                if (flags & SIMD_INT_MADD)
+                    acc0 = _mm256_add_epi32(acc0, _mm256_madd_epi16(_mm256_blend_epi16(v0, zero, 0xAA), x0));
+                else
+                    acc0 = _mm256_add_epi32(acc0, _mm256_mullo_epi32(v0, x0));
+            }
+
+            acc0 = _mm256_add_epi32(acc0, acc1);
+            __m128i sum = _mm_add_epi32(_mm256_castsi256_si128(acc0), _mm256_extracti128_si256(acc0, 1));
+            sum = _mm_add_epi32(sum, _mm_shuffle_epi32(sum, _MM_SHUFFLE(1, 0, 3, 2)));
+            sum = _mm_add_epi32(sum, _mm_shuffle_epi32(sum, _MM_SHUFFLE(2, 3, 0, 1)));
+            int total = _mm_cvtsi128_si32(sum);
+            for (; k < end; ++k)
+                total += prv_simd_get_int(val, k, width) * x[col[k]];
+            y[i] = total;
+        } else {
+            /*! vpmuldq multiplies the low (even) int32 of each int64 lane: shift the odd ones down */
+            __m256i even = zero;
+            __m256i odd = zero;
+            for (; k + 8 <= end; k += 8) {
+                __m256i xv = _mm256_i32gather_epi32(x, _mm256_loadu_si256((const __m256i *)(col + k)), 4);
+                __m256i v = prv_simd_load_int_avx2(val, k, width);
+                even = _mm256_add_epi64(even, _mm256_mul_epi32(v, xv));
+                odd = _mm256_add_epi64(odd, _mm256_mul_epi32(_mm256_srli_epi64(v, 32), _mm256_srli_epi64(xv, 32)));
+            }
+
+            even = _mm256_add_epi64(even, odd);
+            __m128i sum = _mm_add_epi64(_mm256_castsi256_si128(even), _mm256_extracti128_si256(even, 1));
+            long long total = _mm_cvtsi128_si64(sum) + _mm_extract_epi64(sum, 1);
+            for (; k < end; ++k)
+                total += (long long)prv_simd_get_int(val, k, width) * x[col[k]];
+            y[i] = simd_saturate_int32(total);
+        }
+    }
+}
+
+/*!
+ * \brief           Specialize the integer kernel for each set of flags.
+ */
+#define PRV_SIMD_INT_DISPATCH_AVX2(row, col, val, width, x, y, row_begin, row_end, flags)                           \
+    do {                                                                                                            \
+        if ((flags) == (SIMD_INT_ACC32 | SIMD_INT_MADD))                                                            \
+            prv_simd_int_rows_avx2(row, col, val, width, x, y, row_begin, row_end, SIMD_INT_ACC32 | SIMD_INT_MADD); \
+        else if ((flags) & SIMD_INT_ACC32)                                                                          \
+            prv_simd_int_rows_avx2(row, col, val, width, x, y, row_begin, row_end, SIMD_INT_ACC32);                 \
+        else                                                                                                        \
+            prv_simd_int_rows_avx2(row, col, val, width, x, y, row_begin, row_end, 0);                              \
+    } while (0)
+
+PRV_SIMD_AVX2 void simd_csr_int8_avx2(const int *row, const int *col, const void *val, const int *x, int *y, int row_begin, int row_end, int flags) {
+    PRV_SIMD_INT_DISPATCH_AVX2(row, col, val, 1, x, y, row_begin, row_end, flags);
+}
+
+PRV_SIMD_AVX2 void simd_csr_int16_avx2(const int *row, const int *col, const void *val, const int *x, int *y, int row_begin, int row_end, int flags) {
+    PRV_SIMD_INT_DISPATCH_AVX2(row, col, val, 2, x, y, row_begin, row_end, flags);
+}
+
+PRV_SIMD_AVX2 void simd_csr_int32_avx2(const int *row, const int *col, const void *val, const int *x, int *y, int row_begin, int row_end, int flags) {
+    /*! vpmaddwd would need int16 values: never set for int32 storage */
+    PRV_SIMD_INT_DISPATCH_AVX2(row, col, val, 4, x, y, row_begin, row_end, flags & ~SIMD_INT_MADD);
+}
+
+/*!
+ * \brief           Load four quantized codes as doubles (AVX2).
+ *
+ * \param[in]       codes: Quantized values.
+ * \param[in]       width: Size of a code in bytes (1 or 2).
+ * \param[in]       k: Offset of the first code.
+ * \return          The codes.
+ */
+PRV_SIMD_AVX2 static inline __attribute__((always_inline)) __m256d prv_simd_load_codes_avx2(const void *codes, int width, int k) {
+    if (width == 1) {
+        int32_t raw;
+        memcpy(&raw, (const int8_t *)codes + k, sizeof(raw));
+        return _mm256_cvtepi32_pd(_mm_cvtepi8_epi32(_mm_cvtsi32_si128(raw)));
+    }
+    return _mm256_cvtepi32_pd(_mm_cvtepi16_epi32(_mm_loadl_epi64((const __m128i *)((const int16_t *)codes + k))));
+}
+
+/*!
+ * \brief           Load up to eight quantized codes as doubles (AVX-512).
+ *
+ * \param[in]       codes: Quantized values.
+ * \param[in]       width: Size of a code in bytes (1 or 2).
+ * \param[in]       k: Offset of the first code.
+ * \param[in]       mask: Codes to load, the others are zero.
+ * \return          The codes.
+ */
+PRV_SIMD_AVX512 static inline __attribute__((always_inline)) __m512d prv_simd_load_codes_avx512(const void *codes, int width, int k, __mmask8 mask) {
+    if (width == 1)
+        return _mm512_cvtepi32_pd(_mm256_cvtepi8_epi32(_mm_maskz_loadu_epi8(mask, (const int8_t *)codes + k)));
+    return _mm512_cvtepi32_pd(_mm256_cvtepi16_epi32(_mm_maskz_loadu_epi16(mask, (const int16_t *)codes + k)));
+}
+
+/*!
+ * \brief           Multiply a range of rows of a quantized CSR matrix with a vector (AVX2).
+ *
+ * \param[in]       width: Size of a code in bytes (1 or 2).
+ * \see             SimdQuantRowsFn for the other parameters.
+ */
+PRV_SIMD_AVX2 static inline __attribute__((always_inline)) void prv_simd_quant_rows_avx2(const int *row, const int *col, const void *codes, int width, const double *scale,
+                                                                                        const double *offset, const double *x, double *y, int row_begin, int row_end) {
+    for (int i = row_begin; i < row_end; ++i) {
+        __m256d sx0 = _mm256_setzero_pd();
+        __m256d sx1 = _mm256_setzero_pd();
+        __m256d sq0 = _mm256_setzero_pd();
+        __m256d sq1 = _mm256_setzero_pd();
+        int k = row[i];
+        const int end = row[i + 1];
+
+        for (; k + 8 <= end; k += 8) {
+            __m256d x0 = _mm256_i32gather_pd(x, _mm_loadu_si128((const __m128i *)(col + k)), 8);
+            __m256d x1 = _mm256_i32gather_pd(x, _mm_loadu_si128((const __m128i *)(col + k + 4)), 8);
+            sx0 = _mm256_add_pd(sx0, x0);
+            sx1 = _mm256_add_pd(sx1, x1);
+            sq0 = _mm256_fmadd_pd(prv_simd_load_codes_avx2(codes, width, k), x0, sq0);
+            sq1 = _mm256_fmadd_pd(prv_simd_load_codes_avx2(codes, width, k + 4), x1, sq1);
+        }
+        if (k + 4 <= end) {
+            __m256d x0 = _mm256_i32gather_pd(x, _mm_loadu_si128((const __m128i *)(col + k)), 8);
+            sx0 = _mm256_add_pd(sx0, x0);
+            sq0 = _mm256_fmadd_pd(prv_simd_load_codes_avx2(codes, width, k), x0, sq0);
+            k += 4;
+        }
+
+        sx0 = _mm256_add_pd(sx0, sx1);
+        sq0 = _mm256_add_pd(sq0, sq1);
+        __m128d sx = _mm_add_pd(_mm256_castpd256_pd128(sx0), _mm256_extractf128_pd(sx0, 1));
+        __m128d sq = _mm_add_pd(_mm256_castpd256_pd128(sq0), _mm256_extractf128_pd(sq0, 1));
+        double sum_x = _mm_cvtsd_f64(_mm_add_sd(sx, _mm_unpackhi_pd(sx, sx)));
+        double sum_qx = _mm_cvtsd_f64(_mm_add_sd(sq, _mm_unpackhi_pd(sq, sq)));
+        for (; k < end; ++k) {
+            double q = width == 1 ? ((const int8_t *)codes)[k] : ((const int16_t *)codes)[k];
+            sum_x += x[col[k]];
+            sum_qx += q * x[col[k]];
+        }
+
+        y[i] = offset[i] * sum_x + scale[i] * sum_qx;
+    }
+}
+
+/*!
+ * \brief           Multiply a range of rows of a quantized CSR matrix with a vector (AVX-512).
+ *
+ * \param[in]       width: Size of a code in bytes (1 or 2).
+ * \see             SimdQuantRowsFn for the other parameters.
+ */
+PRV_SIMD_AVX512 static inline __attribute__((always_inline)) void prv_simd_quant_rows_avx512(const int *row, const int *col, const void *codes, int width, const double *scale,
+                                                                                            const double *offset, const double *x, double *y, int row_begin, int row_end) {
+    for (int i = row_begin; i < row_end; ++i) {
+        __m512d sx0 = _mm512_setzero_pd();
+        __m512d sx1 = _mm512_setzero_pd();
+        __m512d sq0 = _mm512_setzero_pd();
+        __m512d sq1 = _mm512_setzero_pd();
+        int k = row[i];
+        const int end = row[i + 1];
+
+        for (; k + 16 <= end; k += 16) {
+            __m512d x0 = _mm512_i32gather_pd(_mm256_loadu_si256((const __m256i *)(col + k)), x, 8);
+            __m512d x1 = _mm512_i32gather_pd(_mm256_loadu_si256((const __m256i *)(col + k + 8)), x, 8);
+            sx0 = _mm512_add_pd(sx0, x0);
+            sx1 = _mm512_add_pd(sx1, x1);
+            sq0 = _mm512_fmadd_pd(prv_simd_load_codes_avx512(codes, width, k, 0xFF), x0, sq0);
+            sq1 = _mm512_fmadd_pd(prv_simd_load_codes_avx512(codes, width, k + 8, 0xFF), x1, sq1);
+        }
+        for (; k < end; k += 8) {
+            __mmask8 mask = end - k >= 8 ? 0xFF : (__mmask8)((1U << (end - k)) - 1U);
+            __m256i idx = _mm256_maskz_loadu_epi32(mask, col + k);
+            __m512d x0 = _mm512_mask_i32gather_pd(_mm512_setzero_pd(), mask, idx, x, 8);
+            sx0 = _mm512_add_pd(sx0, x0);
+            sq0 = _mm512_fmadd_pd(prv_simd_load_codes_avx512(codes, width, k, mask), x0, sq0);
+        }
+
+        y[i] = offset[i] * _mm512_reduce_add_pd(_mm512_add_pd(sx0, sx1)) + scale[i] * _mm512_reduce_add_pd(_mm512_add_pd(sq0, sq1));
+    }
+}
+
+PRV_SIMD_AVX2 void simd_quant8_avx2(const int *row, const int *col, const void *codes, const double *scale, const double *offset, const double *x, double *y, int row_begin, int row_end) {
+    prv_simd_quant_rows_avx2(row, col, codes, 1, scale, offset, x, y, row_begin, row_end);
+}
+
+PRV_SIMD_AVX2 void simd_quant16_avx2(const int *row, const int *col, const void *codes, const double *scale, const double *offset, const double *x, double *y, int row_begin, int row_end) {
+    prv_simd_quant_rows_avx2(row, col, codes, 2, scale, offset, x, y, row_begin, row_end);
+}
+
+PRV_SIMD_AVX512 void simd_quant8_avx512(const int *row, const int *col, const void *codes, const double *scale, const double *offset, const double *x, double *y, int row_begin, int row_end) {
+    prv_simd_quant_rows_avx512(row, col, codes, 1, scale, offset, x, y, row_begin, row_end);
+}
+
+PRV_SIMD_AVX512 void simd_quant16_avx512(const int *row, const int *col, const void *codes, const double *scale, const double *offset, const double *x, double *y, int row_begin, int row_end) {
+    prv_simd_quant_rows_avx512(row, col, codes, 2, scale, offset, x, y, row_begin, row_end);
+}
+#endif /*! ISA_ENABLE_X86_DISPATCH */
@@ -0,0 +1,444 @@
+/*!
+ * \file            spgemm.c
+ * \date            2026-10-18
+ * \author          Mirko Lana [lana.mirko@icloud.com]
+ *
+ * \brief           Sparse matrix-sparse matrix multiply (SpGEMM) of CSR matrices.
+ */
+
+#include "config.h"
+#include "spgemm.h"
+#include "rc.h"
+#include "arena.h"
+#include "csr.h"
+#include "pool.h"
+#include "slog.h"
+#include "utils.h"
+
+#include <limits.h>
+#include <stdatomic.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <string.h>
+
+#ifdef CONFIG_ENABLE_OMP_PARALLELISM
+#include <omp.h>
+#endif /*! CONFIG_ENABLE_OMP_PARALLELISM */
+
+#define PRV_SPGEMM_HASH_MUL 2654435761U /*!< Knuth multiplicative hash constant */
+#define PRV_SPGEMM_HASH_MIN 16          /*!< Smallest hash table of a row */
+
+/*!
+ * \brief           Function computing a range of rows of a SpGEMM phase.
+ *
+ * \param[in,out]   plan: Pointer to the plan.
+ * \param[in]       tid: Index of the calling thread (selects its scratch area).
+ * \param[in]       row_begin: First row of the range.
+ * \param[in]       row_end: One past the last row of the range.
+ */
+typedef void (*PrvSpgemmRowsFn)(struct SpgemmPlan *plan, int tid, int row_begin, int row_end);
+
+/*!
+ * \brief           Structure containing the arguments of a Pthreads SpGEMM phase.
+ */
+struct SpgemmPoolTask {
+    struct SpgemmPlan *plan; /*< Plan */
+    PrvSpgemmRowsFn fn;      /*< Phase */
+    atomic_int next;         /*< First row of the next chunk to compute */
+};
+
+/*!
+ * \brief           Get the number of threads of the parallel backend.
+ *
+ * \return          The number of threads.
+ */
+static int prv_spgemm_threads(void) {
+#ifdef CONFIG_ENABLE_PTHREADS_PARALLELISM
+    struct ThreadPool *pool = pool_get_default();
+    return pool ? pool->threads : 1;
+#elif defined(CONFIG_ENABLE_OMP_PARALLELISM)
+    return omp_get_max_threads();
+#else
+    return 1;
+#endif /*! CONFIG_ENABLE_PTHREADS_PARALLELISM */
+}
+
+/*!
+ * \brief           Pool task computing chunks of rows until none is left.
+ *
+ * \param[in,out]   arg: Pointer to the SpgemmPoolTask.
+ * \param[in]       tid: Index of the calling thread.
+ * \param[in]       threads: Number of threads of the pool.
+ */
+static void __attribute__((unused)) prv_spgemm_pool_task(void *arg, int tid, int threads) {
+    UNUSED(threads);
+    struct SpgemmPoolTask *task = arg;
+    const int m = task->plan->a->m;
+
+    for (;;) {
+        int begin = atomic_fetch_add_explicit(&task->next, CONFIG_SPGEMM_CHUNK_ROWS, memory_order_relaxed);
+        if (begin >= m)
+            return;
+        task->fn(task->plan, tid, begin, GET_MIN(begin + CONFIG_SPGEMM_CHUNK_ROWS, m));
+    }
+}
+
+/*!
+ * \brief           Run a phase over all the rows, in dynamically scheduled chunks.
+ *
+ * \details         The cost of a row of the product is hard to predict from the
+ *                  operands, hence the dynamic schedule.
+ *
+ * \param[in,out]   plan: Pointer to the plan.
+ * \param[in]       fn: Phase to run.
+ */
+static void prv_spgemm_run(struct SpgemmPlan *plan, PrvSpgemmRowsFn fn) {
+    const int m = plan->a->m;
+
+#ifdef CONFIG_ENABLE_PTHREADS_PARALLELISM
+    struct ThreadPool *pool = pool_get_default();
+    if (pool && pool->threads == plan->threads && plan->threads > 1) {
+        struct SpgemmPoolTask task = { .plan = plan, .fn = fn };
+        atomic_init(&task.next, 0);
+        pool_run(pool, prv_spgemm_pool_task, &task);
+        return;
+    }
+#elif defined(CONFIG_ENABLE_OMP_PARALLELISM)
+    if (plan->threads > 1) {
+#pragma omp parallel for schedule(dynamic) num_threads(plan->threads)
+        for (int i = 0; i < m; i += CONFIG_SPGEMM_CHUNK_ROWS)
+            fn(plan, omp_get_thread_num(), i, GET_MIN(i + CONFIG_SPGEMM_CHUNK_ROWS, m));
+        return;
+    }
+#endif /*! CONFIG_ENABLE_PTHREADS_PARALLELISM */
+
+    fn(plan, 0, 0, m);
+}
+
+/*!
+ * \brief           Get the hash table mask of a row.
+ *
+ * \param[in]       bound: Upper bound of the non-zeros of the row.
+ * \return          The table size minus one: a power of two at least twice the bound.
+ */
+static inline int prv_spgemm_hash_mask(long long bound) {
+    int size = PRV_SPGEMM_HASH_MIN;
+    while (size < 2 * bound)
+        size <<= 1;
+    return size - 1;
+}
+
+/*!
+ * \brief           Find the slot of a column in a hash accumulator, inserting it if missing.
+ *
+ * \param[in,out]   keys: Keys of the table (-1 for free slots).
+ * \param[in]       mask: Mask of the table.
+ * \param[in]       c: Column.
+ * \param[out]      fresh: Set to true if the column was inserted.
+ * \return          The slot of the column.
+ */
+static inline int prv_spgemm_hash_find(int *keys, int mask, int c, bool *fresh) {
+    int h = (int)(((unsigned)c * PRV_SPGEMM_HASH_MUL) & (unsigned)mask);
+    while (keys[h] != c) {
+        if (keys[h] == -1) {
+            keys[h] = c;
+            *fresh = true;
+            return h;
+        }
+        h = (h + 1) & mask;
+    }
+    *fresh = false;
+    return h;
+}
+
+/*!
+ * \brief           Read an integer value of a CSR matrix.
+ *
+ * \param[in]       val: Values of the matrix.
+ * \param[in]       type: Storage type of the values.
+ * \param[in]       k: Index of the value.
+ * \return          The value.
+ */
+static inline long long prv_spgemm_int_at(const void *val, enum CsrValType type, int k) {
+    switch (type) {
+        case CSR_VAL_INT8:
+            return ((const int8_t *)val)[k];
+        case CSR_VAL_INT16:
+            return ((const int16_t *)val)[k];
+        default:
+            return ((const int32_t *)val)[k];
+    }
+}
+
+/*!
+ * \brief           Symbolic phase: bound the non-zeros of a range of rows of the product.
+ *
+ * \details         Stores the number of multiply-adds of row i in ub[i + 1];
+ *                  spgemm_plan_init caps and accumulates them.
+ *
+ * \param[in,out]   plan: Pointer to the plan.
+ * \param[in]       tid: Index of the calling thread (unused).
+ * \param[in]       row_begin: First row of the range.
+ * \param[in]       row_end: One past the last row of the range.
+ */
+static void prv_spgemm_symbolic_rows(struct SpgemmPlan *plan, int tid, int row_begin, int row_end) {
+    UNUSED(tid);
+    const int *a_row = csr_matrix_row_ptr(plan->a);
+    const int *a_col = csr_matrix_col_idx(plan->a);
+    const int *b_row = csr_matrix_row_ptr(plan->b);
+    long long *ub = arena_get_ptr(&plan->ub);
+
+    for (int i = row_begin; i < row_end; ++i) {
+        long long products = 0;
+        for (int k = a_row[i]; k < a_row[i + 1]; ++k)
+            products += b_row[a_col[k] + 1] - b_row[a_col[k]];
+        ub[i + 1] = products;
+    }
+}
+
+/*!
+ * \brief           Define the numeric phase of a value kind.
+ *
+ * \details         Each row is accumulated in the dense accumulator when its
+ *                  bound exceeds CONFIG_SPGEMM_HASH_MAX_NNZ, in a hash table of
+ *                  at least twice its bound otherwise. The columns are written
+ *                  in the order they were first touched and the accumulator is
+ *                  left clean (keys and marks reset) for the next row.
+ *
+ * \param[in]       name: Name of the function.
+ * \param[in]       ACC: Type of the sums.
+ * \param[in]       A_AT: Expression reading the value k of A (a_val, a->val_type in scope).
+ * \param[in]       B_AT: Expression reading the value k of B (b_val, b->val_type in scope).
+ * \param[in]       STORE: Statement storing a sum v at position pos of the product.
+ */
+#define PRV_SPGEMM_NUMERIC_ROWS(name, ACC, A_AT, B_AT, STORE)                                         \
+    static void name(struct SpgemmPlan *plan, int tid, int row_begin, int row_end) {                  \
+        const struct CsrMatrix *a = plan->a;                                                          \
+        const struct CsrMatrix *b = plan->b;                                                          \
+        const int *a_row = csr_matrix_row_ptr(a);                                                     \
+        const int *a_col = csr_matrix_col_idx(a);                                                     \
+        const void *a_val = csr_matrix_values(a);                                                     \
+        const int *b_row = csr_matrix_row_ptr(b);                                                     \
+        const int *b_col = csr_matrix_col_idx(b);                                                     \
+        const void *b_val = csr_matrix_values(b);                                                     \
+        const long long *ub = arena_get_ptr(&plan->ub);                                               \
+        int *counts = arena_get_ptr(&plan->counts);                                                   \
+        int *c_col = arena_get_ptr(&plan->col);                                                       \
+        void *c_val = arena_get_ptr(&plan->val);                                                      \
+        const size_t dense_cap = plan->dense_rows ? (size_t)b->n : 0U;                                \
+        int *touched = (int *)arena_get_ptr(&plan->touched) + (size_t)tid * plan->max_row_ub;         \
+        int *keys = (int *)arena_get_ptr(&plan->keys) + (size_t)tid * plan->hash_cap;                 \
+        ACC *acc = (ACC *)arena_get_ptr(&plan->acc) + (size_t)tid * plan->hash_cap;                   \
+        int *mark = (int *)arena_get_ptr(&plan->mark) + (size_t)tid * dense_cap;                      \
+        ACC *dense = (ACC *)arena_get_ptr(&plan->dense) + (size_t)tid * dense_cap;                    \
+                                                                                                      \
+        for (int i = row_begin; i < row_end; ++i) {                                                   \
+            const long long off = ub[i];                                                              \
+            int n = 0;                                                                                \
+                                                                                                      \
+            if (ub[i + 1] - off > CONFIG_SPGEMM_HASH_MAX_NNZ) {                                       \
+                for (int ka = a_row[i]; ka < a_row[i + 1]; ++ka) {                                    \
+                    const int j = a_col[ka];                                                          \
+                    const ACC av = (A_AT);                                                            \
+                    for (int k = b_row[j]; k < b_row[j + 1]; ++k) {                                   \
+                        const int c = b_col[k];                                                       \
+                        if (mark[c] != i) {                                                           \
+                            mark[c] = i;                                                              \
+                            dense[c] = 0;                                                             \
+                            touched[n++] = c;                                                         \
+                        }                                                                             \
+                        dense[c] += av * (B_AT);                                                      \
+                    }                                                                                 \
+                }                                                                                     \
+                                                                                                      \
+                for (int t = 0; t < n; ++t) {                                                         \
+                    const long long pos = off + t;                                                    \
+                    const ACC v = dense[touched[t]];                                                  \
+                    c_col[pos] = touched[t];                                                          \
+                    STORE;                                                                            \
+                    mark[touched[t]] = -1;                                                            \
+                }                                                                                     \
+            } else {                                                                                  \
+                const int mask = prv_spgemm_hash_mask(ub[i + 1] - off);                               \
+                bool fresh;                                                                           \
+                for (int ka = a_row[i]; ka < a_row[i + 1]; ++ka) {                                    \
+                    const int j = a_col[ka];                                                          \
+                    const ACC av = (A_AT);                                                            \
+                    for (int k = b_row[j]; k < b_row[j + 1]; ++k) {                                   \
+                        const int h = prv_spgemm_hash_find(keys, mask, b_col[k], &fresh);             \
+                        if (fresh) {                                                                  \
+                            acc[h] = 0;                                                               \
+                            touched[n++] = h;                                                         \
+                        }                                                                             \
+                        acc[h] += av * (B_AT);                                                        \
+                    }                                                                                 \
+                }                                                                                     \
+                                                                                                      \
+                for (int t = 0; t < n; ++t) {                                                         \
+                    const long long pos = off + t;                                                    \
+                    const ACC v = acc[touched[t]];                                                    \
+                    c_col[pos] = keys[touched[t]];                                                    \
+                    STORE;                                                                            \
+                    keys[touched[t]] = -1;                                                            \
+                }                                                                                     \
+            }                                                                                         \
+                                                                                                      \
+            counts[i] = n;                                                                            \
+        }                                                                                             \
+    }
+
+PRV_SPGEMM_NUMERIC_ROWS(prv_spgemm_numeric_rows_real, double,
+                        ((const double *)a_val)[ka],
+                        ((const double *)b_val)[k],
+                        ((double *)c_val)[pos] = v)
+PRV_SPGEMM_NUMERIC_ROWS(prv_spgemm_numeric_rows_int, long long,
+                        prv_spgemm_int_at(a_val, a->val_type, ka),
+                        prv_spgemm_int_at(b_val, b->val_type, k),
+                        ((int *)c_val)[pos] = (int)GET_MAX(GET_MIN(v, INT32_MAX), INT32_MIN))
+
+/*!
+ * \brief           Allocate an array of the plan and account for its size.
+ *
+ * \param[in,out]   plan: Pointer to the plan.
+ * \param[out]      arena: Pointer to the arena handler for memory allocation.
+ * \param[in]       size: Size of an item.
+ * \param[in]       n: Number of items (at least one is allocated).
+ * \param[out]      obj: Pointer to the arena object to initialize.
+ * \return          true on success, false if the allocation failed.
+ */
+static bool prv_spgemm_alloc(struct SpgemmPlan *plan, struct ArenaHandler *arena, size_t size, size_t n, struct ArenaObj *obj) {
+    n = GET_MAX(n, 1U);
+    plan->bytes += size * n;
+    return arena_calloc(arena, size, n, obj) == ARENA_RC_OK;
+}
+
+int spgemm_plan_init(struct SpgemmPlan *plan, const struct CsrMatrix *a, const struct CsrMatrix *b, struct ArenaHandler *arena) {
+    SLOG_DEBUG("Entering spgemm_plan_init");
+    if (!plan || !a || !b || !arena) {
+        rc_set_err_msg("Invalid NULL argument(s) provided to spgemm_plan_init");
+        return RC_INVALID_ARG_ERR;
+    }
+
+    if (a->n != b->m || a->is_real != b->is_real) {
+        rc_set_err_msg("Incompatible operand dimensions or types in spgemm_plan_init");
+        return RC_INVALID_ARG_ERR;
+    }
+
+    *plan = (struct SpgemmPlan){ .a = a, .b = b, .threads = prv_spgemm_threads() };
+    if (!prv_spgemm_alloc(plan, arena, sizeof(long long), (size_t)a->m + 1, &plan->ub)) {
+        rc_set_err_msg("Memory array allocation failed in spgemm_plan_init");
+        return RC_MEM_ALLOC_ERR;
+    }
+
+    prv_spgemm_run(plan, prv_spgemm_symbolic_rows);
+
+    /*! A row of the product cannot hold more than b->n non-zeros */
+    long long *ub = arena_get_ptr(&plan->ub);
+    for (int i = 0; i < a->m; ++i) {
+        long long bound = GET_MIN(ub[i + 1], (long long)b->n);
+        plan->flops += 2 * ub[i + 1];
+        plan->max_row_ub = (int)GET_MAX(plan->max_row_ub, bound);
+        if (bound > CONFIG_SPGEMM_HASH_MAX_NNZ)
+            plan->dense_rows++;
+        else
+            plan->hash_rows++;
+        ub[i + 1] = ub[i] + bound;
+    }
+
+    if (ub[a->m] > INT_MAX) {
+        rc_set_err_msg("The product may have %lld non-zeros, more than a CSR matrix holds", ub[a->m]);
+        return RC_MEM_ALLOC_ERR;
+    }
+    plan->ub_nnz = (int)ub[a->m];
+
+    const size_t threads = (size_t)plan->threads;
+    const size_t acc_size = a->is_real ? sizeof(double) : sizeof(long long);
+    const size_t dense_cap = plan->dense_rows ? (size_t)b->n : 0U;
+    plan->hash_cap = plan->hash_rows ? prv_spgemm_hash_mask(GET_MIN(plan->max_row_ub, CONFIG_SPGEMM_HASH_MAX_NNZ)) + 1 : 0;
+
+    bool ok = prv_spgemm_alloc(plan, arena, sizeof(int), (size_t)a->m, &plan->counts) &&
+              prv_spgemm_alloc(plan, arena, sizeof(int), (size_t)a->m + 1, &plan->row) &&
+              prv_spgemm_alloc(plan, arena, sizeof(int), (size_t)plan->ub_nnz, &plan->col) &&
+              prv_spgemm_alloc(plan, arena, a->is_real ? sizeof(double) : sizeof(int), (size_t)plan->ub_nnz, &plan->val) &&
+              prv_spgemm_alloc(plan, arena, sizeof(int), threads * plan->max_row_ub, &plan->touched) &&
+              prv_spgemm_alloc(plan, arena, sizeof(int), threads * plan->hash_cap, &plan->keys) &&
+              prv_spgemm_alloc(plan, arena, acc_size, threads * plan->hash_cap, &plan->acc) &&
+              prv_spgemm_alloc(plan, arena, sizeof(int), threads * dense_cap, &plan->mark) &&
+              prv_spgemm_alloc(plan, arena, acc_size, threads * dense_cap, &plan->dense);
+    if (!ok) {
+        rc_set_err_msg("Memory array allocation failed in spgemm_plan_init");
+        return RC_MEM_ALLOC_ERR;
+    }
+
+    /*! Free slots and unmarked columns are -1 */
+    memset(arena_get_ptr(&plan->keys), 0xFF, sizeof(int) * threads * plan->hash_cap);
+    memset(arena_get_ptr(&plan->mark), 0xFF, sizeof(int) * threads * dense_cap);
+
+    SLOG_DEBUG("SpGEMM plan: %d threads, at most %d non-zeros, %d hash rows, %d dense rows, %zu bytes",
+               plan->threads,
+               plan->ub_nnz,
+               plan->hash_rows,
+               plan->dense_rows,
+               plan->bytes);
+    return RC_OK;
+}
+
+int spgemm_compute(struct SpgemmPlan *plan, struct CsrMatrix *c) {
+    if (!plan || !c) {
+        rc_set_err_msg("Invalid NULL argument(s) provided to spgemm_compute");
+        return RC_INVALID_ARG_ERR;
+    }
+
+    const struct CsrMatrix *a = plan->a;
+    prv_spgemm_run(plan, a->is_real ? prv_spgemm_numeric_rows_real : prv_spgemm_numeric_rows_int);
+
+    /*! Compact the slots in row order: a row never moves past its own slot */
+    const long long *ub = arena_get_ptr(&plan->ub);
+    const int *counts = arena_get_ptr(&plan->counts);
+    int *row = arena_get_ptr(&plan->row);
+    int *col = arena_get_ptr(&plan->col);
+    char *val = arena_get_ptr(&plan->val);
+    const size_t val_size = a->is_real ? sizeof(double) : sizeof(int);
+    int max_row_nnz = 0;
+
+    row[0] = 0;
+    for (int i = 0; i < a->m; ++i) {
+        if (row[i] != ub[i]) {
+            memmove(col + row[i], col + ub[i], sizeof(int) * (size_t)counts[i]);
+            memmove(val + (size_t)row[i] * val_size, val + (size_t)ub[i] * val_size, val_size * (size_t)counts[i]);
+        }
+        row[i + 1] = row[i] + counts[i];
+        max_row_nnz = GET_MAX(max_row_nnz, counts[i]);
+    }
+
+    *c = (struct CsrMatrix){
+        .m = a->m,
+        .n = plan->b->n,
+        .nz = row[a->m],
+        .is_real = a->is_real,
+        .val_type = a->is_real ? CSR_VAL_REAL : CSR_VAL_INT32,
+        .max_abs_val = 0,
+        .max_row_nnz = max_row_nnz,
+        .col = plan->col,
+        .row = plan->row,
+        .val = plan->val,
+    };
+
+    if (!a->is_real) {
+        const int *v = (const int *)val;
+        for (int k = 0; k < c->nz; ++k)
+            c->max_abs_val = GET_MAX(c->max_abs_val, v[k] == INT32_MIN ? INT32_MAX : (v[k] < 0 ? -v[k] : v[k]));
+    }
+
+    return RC_OK;
+}
+
+int spgemm_multiply(struct CsrMatrix *c, const struct CsrMatrix *a, const struct CsrMatrix *b, struct ArenaHandler *arena) {
+    struct SpgemmPlan plan;
+
+    int res = spgemm_plan_init(&plan, a, b, arena);
+    if (res != RC_OK)
+        return res;
+
+    return spgemm_compute(&plan, c);
+}
@@ -0,0 +1,357 @@
+/*!
+ * \file            sweep.c
+ * \date            2026-10-18
+ * \author          Mirko Lana [lana.mirko@icloud.com]
+ *
+ * \brief           Benchmark of a list of matrices in one process (--batch).
+ */
+
+#ifdef __linux__
+#define _GNU_SOURCE /*! pthread_setaffinity_np, CPU_SET */
+#endif /*! __linux__ */
+
+#include "config.h"
+#include "sweep.h"
+#include "rc.h"
+#include "arena.h"
+#include "bench.h"
+#include "csr.h"
+#include "pool.h"
+#include "topo.h"
+#include "slog.h"
+#include "utils.h"
+
+#include <errno.h>
+#include <pthread.h>
+#include <sched.h>
+#include <stdio.h>
+#include <string.h>
+
+/*!
+ * \brief           Structure representing a matrix held by the sweep.
+ */
+struct SweepSlot {
+    struct ArenaHandler arena; /*< Arena of the matrix and of its benchmark */
+    bool arena_ready;          /*< Whether the arena was initialized */
+    struct CsrMatrix mtx;      /*< The matrix, parsed and converted */
+    int status;                /*< RC_OK, or the error code of the load */
+    char err[RC_ERR_MSG_LEN];  /*< Error message of a failed load */
+    uint64_t load_ns;          /*< Time of the load */
+    bool loaded;               /*< Set by the loader once the matrix is in, cleared once it is released */
+};
+
+/*!
+ * \brief           Structure containing the state of the sweep.
+ */
+struct SweepHandler {
+    bool initialized;                           /*!< Whether sweep_init succeeded. */
+    struct BenchConfig bench;                   /*!< Configuration of every benchmark. */
+    struct ArenaObj files;                      /*!< Paths of the matrices, count * CONFIG_SWEEP_PATH_MAX_LEN chars. */
+    int count;                                  /*!< Number of matrices of the list. */
+    int loader_cpu;                             /*!< CPU of the loader thread, -1 if it shares those of the benchmarks. */
+    int bench_cpus;                             /*!< Number of CPUs left to the benchmarks. */
+    struct SweepSlot slots[CONFIG_SWEEP_SLOTS]; /*!< Matrices held, matrix k in slot k % CONFIG_SWEEP_SLOTS. */
+    pthread_mutex_t lock;                       /*!< Lock protecting the loaded flags of the slots. */
+    pthread_cond_t changed;                     /*!< Condition signalled when a slot is loaded or released. */
+    struct BenchHandler bh;                     /*!< Benchmark of the current matrix. */
+};
+
+static struct SweepHandler g_sweep_handler; /*!< Global sweep handler. */
+
+/*!
+ * \brief           Get the path of a matrix of the list.
+ *
+ * \param[in]       k: Index of the matrix.
+ * \return          The path.
+ */
+static char *prv_sweep_file(int k) {
+    return (char *)arena_get_ptr(&g_sweep_handler.files) + (size_t)k * CONFIG_SWEEP_PATH_MAX_LEN;
+}
+
+/*!
+ * \brief           Read the paths of a list, or only count them.
+ *
+ * \param[in]       fp: The list, from its start.
+ * \param[out]      files: Buffer of count * CONFIG_SWEEP_PATH_MAX_LEN chars, NULL to count the paths.
+ * \param[out]      count: Number of paths.
+ * \return          RC_OK on success, RC_FILE_INVALID_FMT_ERR if a line is too long.
+ */
+static int prv_sweep_read_list(FILE *fp, char *files, int *count) {
+    char line[CONFIG_SWEEP_PATH_MAX_LEN + 1];
+    *count = 0;
+    for (int no = 1; fgets(line, sizeof(line), fp); ++no) {
+        size_t len = strlen(line);
+        if (line[len - 1] != '\n' && !feof(fp)) {
+            rc_set_err_msg("Line %d of the list is longer than %d characters", no, CONFIG_SWEEP_PATH_MAX_LEN - 1);
+            return RC_FILE_INVALID_FMT_ERR;
+        }
+        while (len > 0 && (line[len - 1] == '\n' || line[len - 1] == '\r' || line[len - 1] == ' ' || line[len - 1] == '\t'))
+            line[--len] = '\0';
+        if (len == 0 || line[0] == '#')
+            continue;
+        if (len >= CONFIG_SWEEP_PATH_MAX_LEN) {
+            rc_set_err_msg("Line %d of the list is longer than %d characters", no, CONFIG_SWEEP_PATH_MAX_LEN - 1);
+            return RC_FILE_INVALID_FMT_ERR;
+        }
+        if (files)
+            memcpy(files + (size_t)*count * CONFIG_SWEEP_PATH_MAX_LEN, line, len + 1);
+        ++*count;
+    }
+    return RC_OK;
+}
+
+/*!
+ * \brief           Pick the CPU of the loader: the last online one, its core left to it.
+ */
+static void prv_sweep_plan_cpus(void) {
+    const struct Topology *topo = topo_get();
+    int last = -1;
+    for (int c = 0; c < CONFIG_TOPO_MAX_CPUS; ++c) {
+        if (topo->cpu_core[c] >= 0)
+            last = c;
+    }
+
+    int left = 0;
+    for (int c = 0; c < CONFIG_TOPO_MAX_CPUS && last >= 0; ++c) {
+        if (topo->cpu_core[c] >= 0 && topo->cpu_core[c] != topo->cpu_core[last])
+            left++;
+    }
+
+    g_sweep_handler.loader_cpu = left > 0 ? last : -1;
+    g_sweep_handler.bench_cpus = left > 0 ? left : topo->num_cpus;
+}
+
+/*!
+ * \brief           Restrict the calling thread, and the threads it starts, to the CPUs of the benchmarks.
+ */
+static void prv_sweep_leave_loader_core(void) {
+#ifdef __linux__
+    const struct Topology *topo = topo_get();
+    const int loader_core = topo->cpu_core[g_sweep_handler.loader_cpu];
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    for (int c = 0; c < CONFIG_TOPO_MAX_CPUS; ++c) {
+        if (topo->cpu_core[c] >= 0 && topo->cpu_core[c] != loader_core)
+            CPU_SET(c, &set);
+    }
+    if (pthread_setaffinity_np(pthread_self(), sizeof(set), &set) != 0)
+        SLOG_WARN("Could not keep the benchmarks off the core of the loader");
+#endif /*! __linux__ */
+}
+
+/*!
+ * \brief           Main loop of the loader thread: parse every matrix into its slot once it is free.
+ *
+ * \param[in]       arg: Unused.
+ * \return          NULL.
+ */
+static void *prv_sweep_loader(void *arg) {
+    UNUSED(arg);
+    if (g_sweep_handler.loader_cpu >= 0 && pool_pin_self(g_sweep_handler.loader_cpu) != RC_OK)
+        SLOG_WARN("Could not pin the loader to CPU %d", g_sweep_handler.loader_cpu);
+
+    for (int k = 0; k < g_sweep_handler.count; ++k) {
+        struct SweepSlot *slot = &g_sweep_handler.slots[k % CONFIG_SWEEP_SLOTS];
+        pthread_mutex_lock(&g_sweep_handler.lock);
+        while (slot->loaded)
+            pthread_cond_wait(&g_sweep_handler.changed, &g_sweep_handler.lock);
+        pthread_mutex_unlock(&g_sweep_handler.lock);
+
+        uint64_t start = utils_get_ns();
+        slot->arena_ready = arena_init(&slot->arena) == ARENA_RC_OK;
+        if (slot->arena_ready) {
+            slot->status = csr_matrix_load_from_file(&slot->mtx, prv_sweep_file(k), &slot->arena);
+            if (slot->status != RC_OK)
+                snprintf(slot->err, sizeof(slot->err), "%s", rc_get_err_msg());
+        } else {
+            slot->status = RC_MEM_ALLOC_ERR;
+            snprintf(slot->err, sizeof(slot->err), "Failed to initialize the arena of the matrix");
+        }
+        slot->load_ns = utils_get_ns() - start;
+        SLOG_DEBUG("Loader: matrix %d loaded in %.1f ms", k, (double)slot->load_ns / 1e6);
+
+        pthread_mutex_lock(&g_sweep_handler.lock);
+        slot->loaded = true;
+        pthread_cond_broadcast(&g_sweep_handler.changed);
+        pthread_mutex_unlock(&g_sweep_handler.lock);
+    }
+
+    return NULL;
+}
+
+/*!
+ * \brief           Benchmark a loaded matrix and save its results.
+ *
+ * \param[in]       k: Index of the matrix.
+ * \param[in,out]   slot: Pointer to the slot holding it.
+ * \param[in]       wait_ns: Time spent waiting for the loader.
+ * \return          RC_OK on success, an error code otherwise.
+ */
+static int prv_sweep_bench(int k, struct SweepSlot *slot, uint64_t wait_ns) {
+    struct BenchConfig cfg = g_sweep_handler.bench;
+    cfg.filename = prv_sweep_file(k);
+    cfg.matrix = &slot->mtx;
+    cfg.cpus = g_sweep_handler.bench_cpus;
+    cfg.arena = &slot->arena;
+
+    g_sweep_handler.bh = (struct BenchHandler){ 0 };
+    int res = bench_init(&g_sweep_handler.bh, &cfg);
+    if (res == RC_OK)
+        res = bench_warmup(&g_sweep_handler.bh);
+
+    struct BenchResults results;
+    if (res == RC_OK)
+        res = bench_run(&g_sweep_handler.bh, &results, &slot->arena);
+    if (res != RC_OK)
+        return res;
+
+    results.load_ms = (double)slot->load_ns / 1e6;
+    results.load_wait_ms = (double)wait_ns / 1e6;
+
+    char filename[CONFIG_BENCH_FILENAME_MAX_LEN];
+    bench_result_filename(cfg.filename, filename);
+    return bench_save_result(&results, filename);
+}
+
+int sweep_init(const struct SweepConfig *cfg) {
+    SLOG_DEBUG("Entering sweep_init");
+    if (!cfg || !cfg->list || !cfg->arena) {
+        rc_set_err_msg("Invalid NULL argument(s) provided to sweep_init");
+        return RC_INVALID_ARG_ERR;
+    }
+
+    const enum BenchMode mode = cfg->bench.mode;
+    if (mode == BENCH_MODE_DIST || mode == BENCH_MODE_THROUGHPUT || mode == BENCH_MODE_BATCHED) {
+        rc_set_err_msg("The %s mode cannot benchmark a list of matrices", bench_mode_to_str(mode));
+        return RC_INVALID_ARG_ERR;
+    }
+    if (cfg->bench.shared) {
+        rc_set_err_msg("The shared-memory store is not supported with a list of matrices");
+        return RC_INVALID_ARG_ERR;
+    }
+    if (cfg->bench.x_file || cfg->bench.y_file) {
+        rc_set_err_msg("Vector files are not supported with a list of matrices");
+        return RC_INVALID_ARG_ERR;
+    }
+
+    FILE *fp = fopen(cfg->list, "r");
+    if (!fp) {
+        rc_set_err_msg("Invalid file name provided to fopen - %s", strerror(errno));
+        return RC_FILE_IO_ERR;
+    }
+
+    int count;
+    int res = prv_sweep_read_list(fp, NULL, &count);
+    if (res == RC_OK && count == 0) {
+        rc_set_err_msg("The list %s holds no matrix", cfg->list);
+        res = RC_FILE_INVALID_FMT_ERR;
+    }
+    if (res == RC_OK && arena_calloc(cfg->arena, CONFIG_SWEEP_PATH_MAX_LEN, (size_t)count, &g_sweep_handler.files) != ARENA_RC_OK) {
+        rc_set_err_msg("Memory array allocation failed in sweep_init");
+        res = RC_MEM_ALLOC_ERR;
+    }
+    if (res == RC_OK) {
+        rewind(fp);
+        res = prv_sweep_read_list(fp, arena_get_ptr(&g_sweep_handler.files), &count);
+    }
+    fclose(fp);
+    if (res != RC_OK)
+        return res;
+
+    g_sweep_handler.bench = cfg->bench;
+    g_sweep_handler.count = count;
+    prv_sweep_plan_cpus();
+    pthread_mutex_init(&g_sweep_handler.lock, NULL);
+    pthread_cond_init(&g_sweep_handler.changed, NULL);
+    g_sweep_handler.initialized = true;
+
+    if (g_sweep_handler.loader_cpu >= 0)
+        SLOG_INFO("Sweep of %d matrices: loader on CPU %d, benchmarks on the %d CPUs of the other cores", count, g_sweep_handler.loader_cpu, g_sweep_handler.bench_cpus);
+    else
+        SLOG_INFO("Sweep of %d matrices: single core, the loader shares it with the benchmarks", count);
+
+    return RC_OK;
+}
+
+int sweep_run(void) {
+    SLOG_DEBUG("Entering sweep_run");
+    if (g_sweep_handler.loader_cpu >= 0)
+        prv_sweep_leave_loader_core(); /*! Before any parallel region: the team inherits the CPUs */
+
+    pthread_t loader;
+    if (pthread_create(&loader, NULL, prv_sweep_loader, NULL) != 0) {
+        rc_set_err_msg("Could not start the loader thread");
+        return RC_FAIL;
+    }
+
+    const uint64_t start = utils_get_ns();
+    uint64_t load_ns = 0U;
+    uint64_t wait_ns = 0U;
+    int failed = 0;
+    for (int k = 0; k < g_sweep_handler.count; ++k) {
+        struct SweepSlot *slot = &g_sweep_handler.slots[k % CONFIG_SWEEP_SLOTS];
+        uint64_t wait_start = utils_get_ns();
+        pthread_mutex_lock(&g_sweep_handler.lock);
+        while (!slot->loaded)
+            pthread_cond_wait(&g_sweep_handler.changed, &g_sweep_handler.lock);
+        pthread_mutex_unlock(&g_sweep_handler.lock);
+        uint64_t wait = utils_get_ns() - wait_start;
+        load_ns += slot->load_ns;
+        wait_ns += wait;
+
+        SLOG_INFO("Matrix %d of %d: %s (loaded in %.1f ms, waited %.1f ms)", k + 1, g_sweep_handler.count, prv_sweep_file(k), (double)slot->load_ns / 1e6, (double)wait / 1e6);
+        int res = slot->status;
+        if (res == RC_OK)
+            res = prv_sweep_bench(k, slot, wait);
+        else
+            rc_set_err_msg("%s", slot->err);
+        if (res != RC_OK) {
+            SLOG_ERROR("Matrix %s skipped - %s", prv_sweep_file(k), rc_get_err_msg());
+            failed++;
+        }
+
+        /*! The pool and the plans of the benchmark live in the arena of the matrix */
+        bench_fini(&g_sweep_handler.bh);
+#ifdef CONFIG_ENABLE_PTHREADS_PARALLELISM
+        pool_fini_default();
+#endif /*! CONFIG_ENABLE_PTHREADS_PARALLELISM */
+        if (slot->arena_ready)
+            arena_destroy(&slot->arena);
+        slot->arena_ready = false;
+
+        pthread_mutex_lock(&g_sweep_handler.lock);
+        slot->loaded = false;
+        pthread_cond_broadcast(&g_sweep_handler.changed);
+        pthread_mutex_unlock(&g_sweep_handler.lock);
+    }
+    pthread_join(loader, NULL);
+
+    const uint64_t total_ns = utils_get_ns() - start;
+    SLOG_INFO("Sweep done in %.1f s: loading took %.1f s, of which %.1f s hidden behind the benchmarks",
+              (double)total_ns / 1e9,
+              (double)load_ns / 1e9,
+              (double)(load_ns - GET_MIN(wait_ns, load_ns)) / 1e9);
+
+    if (failed > 0) {
+        rc_set_err_msg("%d of %d matrices skipped", failed, g_sweep_handler.count);
+        return RC_FAIL;
+    }
+    return RC_OK;
+}
+
+int sweep_fini(void) {
+    SLOG_DEBUG("Entering sweep_fini");
+    if (!g_sweep_handler.initialized)
+        return RC_OK;
+
+    for (int s = 0; s < CONFIG_SWEEP_SLOTS; ++s) {
+        if (g_sweep_handler.slots[s].arena_ready)
+            arena_destroy(&g_sweep_handler.slots[s].arena);
+        g_sweep_handler.slots[s].arena_ready = false;
+    }
+    pthread_mutex_destroy(&g_sweep_handler.lock);
+    pthread_cond_destroy(&g_sweep_handler.changed);
+    g_sweep_handler.initialized = false;
+
+    return RC_OK;
+}
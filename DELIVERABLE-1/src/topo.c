@@ -0,0 +1,339 @@
+/*!
+ * \file            topo.c
+ * \date            2026-10-18
+ * \author          Mirko Lana [lana.mirko@icloud.com]
+ *
+ * \brief           CPU cache and topology discovery module.
+ */
+
+#include "config.h"
+#include "topo.h"
+#include "rc.h"
+#include "slog.h"
+#include "utils.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+#define PRV_TOPO_PATH_LEN 256U /*!< Maximum length of a sysfs path */
+#define PRV_TOPO_LINE_LEN 256U /*!< Maximum length of a sysfs line */
+
+static struct Topology g_topology; /*!< Global topology structure */
+
+/*!
+ * \brief           Read the first line of a sysfs file.
+ *
+ * \param[in]       path: Path of the file.
+ * \param[out]      buf: Buffer receiving the line (without trailing newline).
+ * \param[in]       len: Length of the buffer.
+ * \return          true on success, false otherwise.
+ */
+static bool prv_topo_read_line(const char *path, char *buf, size_t len) {
+    FILE *fp = fopen(path, "r");
+    if (!fp)
+        return false;
+
+    bool ok = fgets(buf, (int)len, fp) != NULL;
+    fclose(fp);
+    if (ok)
+        buf[strcspn(buf, "\n")] = '\0';
+
+    return ok;
+}
+
+/*!
+ * \brief           Read an integer from a sysfs file.
+ *
+ * \param[in]       path: Path of the file.
+ * \param[out]      val: Pointer to store the value.
+ * \return          true on success, false otherwise.
+ */
+static bool prv_topo_read_int(const char *path, int *val) {
+    char buf[PRV_TOPO_LINE_LEN];
+    if (!prv_topo_read_line(path, buf, sizeof(buf)))
+        return false;
+
+    *val = atoi(buf);
+    return true;
+}
+
+/*!
+ * \brief           Parse a sysfs size string (e.g. "32K", "2048K", "16M").
+ *
+ * \param[in]       str: The string to parse.
+ * \return          The size in bytes.
+ */
+static int prv_topo_parse_size(const char *str) {
+    char *end;
+    long size = strtol(str, &end, 10);
+    switch (*end) {
+        case 'K':
+            size *= 1024L;
+            break;
+        case 'M':
+            size *= 1024L * 1024L;
+            break;
+        case 'G':
+            size *= 1024L * 1024L * 1024L;
+            break;
+    }
+    return (int)GET_MIN(size, (long)0x7fffffff);
+}
+
+/*!
+ * \brief           Count the CPUs in a sysfs CPU list (e.g. "0-3,8-11").
+ *
+ * \param[in]       str: The list to parse.
+ * \param[out]      first_other: First CPU in the list different from self (-1 if none).
+ * \param[in]       self: CPU to skip when looking for first_other.
+ * \return          The number of CPUs in the list.
+ */
+static int prv_topo_parse_cpu_list(const char *str, int *first_other, int self) {
+    int count = 0;
+    *first_other = -1;
+
+    while (*str) {
+        char *end;
+        long lo = strtol(str, &end, 10);
+        long hi = lo;
+        if (end == str)
+            break;
+        if (*end == '-')
+            hi = strtol(end + 1, &end, 10);
+
+        for (long cpu = lo; cpu <= hi; ++cpu) {
+            if (*first_other < 0 && cpu != self)
+                *first_other = (int)cpu;
+        }
+        count += (int)(hi - lo + 1);
+
+        str = (*end == ',') ? end + 1 : end;
+    }
+
+    return count;
+}
+
+/*!
+ * \brief           Fill the topology structure with the fallback values.
+ *
+ * \param[out]      topo: Pointer to the topology structure.
+ */
+static void prv_topo_set_fallback(struct Topology *topo) {
+    long cpus = sysconf(_SC_NPROCESSORS_ONLN);
+
+    topo->from_sysfs = false;
+    topo->num_cpus = cpus > 0 ? (int)cpus : 1;
+    topo->num_cores = topo->num_cpus;
+    topo->num_sockets = 1;
+    topo->smt_width = 1;
+    topo->num_caches = 3;
+    topo->cache[0] = (struct TopoCache){ 1, CONFIG_TOPO_FALLBACK_L1D_SIZE, CONFIG_TOPO_FALLBACK_LINE_SIZE, 0, 1 };
+    topo->cache[1] = (struct TopoCache){ 2, CONFIG_TOPO_FALLBACK_L2_SIZE, CONFIG_TOPO_FALLBACK_LINE_SIZE, 0, 1 };
+    topo->cache[2] = (struct TopoCache){ 3, CONFIG_TOPO_FALLBACK_L3_SIZE, CONFIG_TOPO_FALLBACK_LINE_SIZE, 0, topo->num_cpus };
+
+    for (int cpu = 0; cpu < CONFIG_TOPO_MAX_CPUS; ++cpu) {
+        bool online = cpu < topo->num_cpus;
+        topo->cpu_core[cpu] = online ? cpu : -1;
+        topo->cpu_socket[cpu] = online ? 0 : -1;
+        topo->cpu_sibling[cpu] = -1;
+    }
+}
+
+/*!
+ * \brief           Read the data/unified caches of CPU 0 from sysfs.
+ *
+ * \param[out]      topo: Pointer to the topology structure.
+ * \return          The number of caches found.
+ */
+static int prv_topo_read_caches(struct Topology *topo) {
+    char path[PRV_TOPO_PATH_LEN];
+    char buf[PRV_TOPO_LINE_LEN];
+    int count = 0;
+
+    for (int idx = 0; count < TOPO_MAX_CACHE_LEVELS; ++idx) {
+        snprintf(path, sizeof(path), "%s/cpu0/cache/index%d/type", CONFIG_TOPO_SYSFS_CPU_PATH, idx);
+        if (!prv_topo_read_line(path, buf, sizeof(buf)))
+            break;
+        if (strcmp(buf, "Instruction") == 0)
+            continue;
+
+        struct TopoCache cache = { 0 };
+        snprintf(path, sizeof(path), "%s/cpu0/cache/index%d/level", CONFIG_TOPO_SYSFS_CPU_PATH, idx);
+        prv_topo_read_int(path, &cache.level);
+
+        snprintf(path, sizeof(path), "%s/cpu0/cache/index%d/size", CONFIG_TOPO_SYSFS_CPU_PATH, idx);
+        if (prv_topo_read_line(path, buf, sizeof(buf)))
+            cache.size = prv_topo_parse_size(buf);
+
+        snprintf(path, sizeof(path), "%s/cpu0/cache/index%d/coherency_line_size", CONFIG_TOPO_SYSFS_CPU_PATH, idx);
+        prv_topo_read_int(path, &cache.line_size);
+
+        snprintf(path, sizeof(path), "%s/cpu0/cache/index%d/ways_of_associativity", CONFIG_TOPO_SYSFS_CPU_PATH, idx);
+        prv_topo_read_int(path, &cache.ways);
+
+        snprintf(path, sizeof(path), "%s/cpu0/cache/index%d/shared_cpu_list", CONFIG_TOPO_SYSFS_CPU_PATH, idx);
+        if (prv_topo_read_line(path, buf, sizeof(buf))) {
+            int unused;
+            cache.shared_cpus = prv_topo_parse_cpu_list(buf, &unused, -1);
+        }
+
+        if (cache.level <= 0 || cache.size <= 0)
+            continue;
+
+        /*! Insertion sort by level */
+        int pos = count++;
+        for (; pos > 0 && topo->cache[pos - 1].level > cache.level; --pos)
+            topo->cache[pos] = topo->cache[pos - 1];
+        topo->cache[pos] = cache;
+    }
+
+    return count;
+}
+
+/*!
+ * \brief           Read the core/socket/SMT layout of every online CPU from sysfs.
+ *
+ * \param[out]      topo: Pointer to the topology structure.
+ * \return          The number of online CPUs found.
+ */
+static int prv_topo_read_cpus(struct Topology *topo) {
+    char path[PRV_TOPO_PATH_LEN];
+    char buf[PRV_TOPO_LINE_LEN];
+    int cpus = 0;
+    int max_socket = -1;
+
+    /*! (socket, core_id) pairs are only unique per socket, so map them to machine-wide indices */
+    static int core_key_socket[CONFIG_TOPO_MAX_CPUS];
+    static int core_key_id[CONFIG_TOPO_MAX_CPUS];
+    int cores = 0;
+
+    for (int cpu = 0; cpu < CONFIG_TOPO_MAX_CPUS; ++cpu) {
+        int core_id, socket_id;
+        topo->cpu_core[cpu] = -1;
+        topo->cpu_socket[cpu] = -1;
+        topo->cpu_sibling[cpu] = -1;
+
+        snprintf(path, sizeof(path), "%s/cpu%d/topology/core_id", CONFIG_TOPO_SYSFS_CPU_PATH, cpu);
+        if (!prv_topo_read_int(path, &core_id))
+            continue; /*! Offline or non-existent CPU */
+
+        snprintf(path, sizeof(path), "%s/cpu%d/topology/physical_package_id", CONFIG_TOPO_SYSFS_CPU_PATH, cpu);
+        if (!prv_topo_read_int(path, &socket_id))
+            socket_id = 0;
+
+        int core = 0;
+        for (; core < cores; ++core) {
+            if (core_key_socket[core] == socket_id && core_key_id[core] == core_id)
+                break;
+        }
+        if (core == cores) {
+            core_key_socket[cores] = socket_id;
+            core_key_id[cores] = core_id;
+            cores++;
+        }
+
+        snprintf(path, sizeof(path), "%s/cpu%d/topology/thread_siblings_list", CONFIG_TOPO_SYSFS_CPU_PATH, cpu);
+        if (prv_topo_read_line(path, buf, sizeof(buf))) {
+            int smt = prv_topo_parse_cpu_list(buf, &topo->cpu_sibling[cpu], cpu);
+            topo->smt_width = GET_MAX(topo->smt_width, smt);
+        }
+
+        topo->cpu_core[cpu] = core;
+        topo->cpu_socket[cpu] = socket_id;
+        max_socket = GET_MAX(max_socket, socket_id);
+        cpus++;
+    }
+
+    topo->num_cores = cores;
+    topo->num_sockets = max_socket + 1;
+
+    return cpus;
+}
+
+int topo_init(void) {
+    SLOG_DEBUG("Entering topo_init");
+
+    prv_topo_set_fallback(&g_topology);
+
+    struct Topology topo = { 0 };
+    topo.smt_width = 1;
+    int cpus = prv_topo_read_cpus(&topo);
+    if (cpus <= 0) {
+        SLOG_WARN("Could not read CPU topology from %s, using fallback values", CONFIG_TOPO_SYSFS_CPU_PATH);
+        return RC_OK;
+    }
+
+    topo.from_sysfs = true;
+    topo.num_cpus = cpus;
+    topo.num_caches = prv_topo_read_caches(&topo);
+    if (topo.num_caches == 0) {
+        SLOG_WARN("Could not read cache hierarchy from %s, using fallback cache sizes", CONFIG_TOPO_SYSFS_CPU_PATH);
+        topo.num_caches = g_topology.num_caches;
+        memcpy(topo.cache, g_topology.cache, sizeof(topo.cache));
+    }
+    g_topology = topo;
+
+    SLOG_INFO("Topology: %d CPUs, %d cores, %d sockets, SMT %d",
+              g_topology.num_cpus,
+              g_topology.num_cores,
+              g_topology.num_sockets,
+              g_topology.smt_width);
+    for (int i = 0; i < g_topology.num_caches; ++i)
+        SLOG_INFO("Topology: L%d cache %d bytes, line %d bytes, shared by %d CPUs",
+                  g_topology.cache[i].level,
+                  g_topology.cache[i].size,
+                  g_topology.cache[i].line_size,
+                  g_topology.cache[i].shared_cpus);
+
+    return RC_OK;
+}
+
+const struct Topology *topo_get(void) {
+    return &g_topology;
+}
+
+int topo_get_cache_size(int level) {
+    for (int i = 0; i < g_topology.num_caches; ++i) {
+        if (g_topology.cache[i].level == level)
+            return g_topology.cache[i].size;
+    }
+
+    switch (level) {
+        case 1:
+            return CONFIG_TOPO_FALLBACK_L1D_SIZE;
+        case 2:
+            return CONFIG_TOPO_FALLBACK_L2_SIZE;
+        default:
+            return CONFIG_TOPO_FALLBACK_L3_SIZE;
+    }
+}
+
+int topo_get_line_size(void) {
+    if (g_topology.num_caches > 0 && g_topology.cache[0].line_size > 0)
+        return g_topology.cache[0].line_size;
+
+    return CONFIG_TOPO_FALLBACK_LINE_SIZE;
+}
+
+void topo_write_json(FILE *fp, const char *indent) {
+    fprintf(fp, "{\n");
+    fprintf(fp, "%s\t\"from-sysfs\": %s,\n", indent, g_topology.from_sysfs ? "true" : "false");
+    fprintf(fp, "%s\t\"cpus\": %d,\n", indent, g_topology.num_cpus);
+    fprintf(fp, "%s\t\"cores\": %d,\n", indent, g_topology.num_cores);
+    fprintf(fp, "%s\t\"sockets\": %d,\n", indent, g_topology.num_sockets);
+    fprintf(fp, "%s\t\"smt\": %d,\n", indent, g_topology.smt_width);
+    fprintf(fp, "%s\t\"caches\": [", indent);
+    for (int i = 0; i < g_topology.num_caches; ++i) {
+        const struct TopoCache *c = &g_topology.cache[i];
+        fprintf(fp, "%s{ \"level\": %d, \"size\": %d, \"line-size\": %d, \"ways\": %d, \"shared-cpus\": %d }",
+                i ? ", " : "",
+                c->level,
+                c->size,
+                c->line_size,
+                c->ways,
+                c->shared_cpus);
+    }
+    fprintf(fp, "]\n%s}", indent);
+}
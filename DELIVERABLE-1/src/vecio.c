@@ -0,0 +1,347 @@
+/*!
+ * \file            vecio.c
+ * \date            2026-10-18
+ * \author          Mirko Lana [lana.mirko@icloud.com]
+ *
+ * \brief           Reading and writing vectors from and to files.
+ */
+
+#include "config.h"
+#include "vecio.h"
+#include "rc.h"
+#include "arena.h"
+#include "vec.h"
+#include "mmio.h"
+#include "pool.h"
+#include "utils.h"
+#include "slog.h"
+
+#include <ctype.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <limits.h>
+#include <stdatomic.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#ifdef CONFIG_ENABLE_OMP_PARALLELISM
+#include <omp.h>
+#endif /*! CONFIG_ENABLE_OMP_PARALLELISM */
+
+/*!
+ * \brief           Structure containing the state of the formatting of a block of rows, shared by its threads.
+ */
+struct VecioFormatTask {
+    const struct Vec *vec;        /*< Vector being written */
+    char *buf;                    /*< CONFIG_VECIO_SLICES slices of CONFIG_VECIO_SLICE_ROWS items */
+    int begin;                    /*< First row of the block */
+    int end;                      /*< One past the last row of the block */
+    int len[CONFIG_VECIO_SLICES]; /*< Bytes formatted in each slice */
+    atomic_int next;              /*< Next slice to format */
+};
+
+/*!
+ * \brief           Parse the values of a Matrix Market array.
+ *
+ * \param[in]       buf: Mapping of the file.
+ * \param[in]       size: Size of the file.
+ * \param[in]       off: Offset of the first value (after the size line).
+ * \param[out]      vec: Pointer to the vector receiving the values.
+ * \return          RC_OK on success, RC_FILE_INVALID_FMT_ERR if a value is invalid or their count differs from the size of the vector.
+ */
+static int prv_vecio_parse_mtx(const char *buf, size_t size, size_t off, struct Vec *vec) {
+    char token[MM_MAX_TOKEN_LENGTH];
+    void *val = arena_get_ptr(&vec->val);
+    int count = 0;
+
+    /*! The mapping is not NUL-terminated: every value is copied out before strtod/strtol */
+    for (;;) {
+        while (off < size && isspace((unsigned char)buf[off]))
+            off++;
+        if (off == size)
+            break;
+
+        size_t len = 0;
+        while (off < size && !isspace((unsigned char)buf[off]) && len < sizeof(token) - 1)
+            token[len++] = buf[off++];
+        token[len] = '\0';
+        if (off < size && !isspace((unsigned char)buf[off])) {
+            rc_set_err_msg("Value %d of the vector file is too long", count + 1);
+            return RC_FILE_INVALID_FMT_ERR;
+        }
+        if (count == vec->n) {
+            rc_set_err_msg("The vector file holds more than %d values", vec->n);
+            return RC_FILE_INVALID_FMT_ERR;
+        }
+
+        char *end;
+        errno = 0;
+        if (vec->is_real) {
+            ((double *)val)[count] = strtod(token, &end);
+        } else {
+            long v = strtol(token, &end, 10);
+            if (v < INT_MIN || v > INT_MAX)
+                errno = ERANGE;
+            ((int *)val)[count] = (int)v;
+        }
+        if (*end != '\0' || end == token || errno == ERANGE) {
+            rc_set_err_msg("Invalid value '%s' at item %d of the vector file", token, count + 1);
+            return RC_FILE_INVALID_FMT_ERR;
+        }
+        count++;
+    }
+
+    if (count != vec->n) {
+        rc_set_err_msg("The vector file holds %d values instead of %d", count, vec->n);
+        return RC_FILE_INVALID_FMT_ERR;
+    }
+    return RC_OK;
+}
+
+/*!
+ * \brief           Read the banner and the size of a Matrix Market array and check them against a vector.
+ *
+ * \param[in]       filename: Path of the file.
+ * \param[in]       vec: Pointer to the vector to fill.
+ * \param[out]      off: Offset of the first value.
+ * \return          RC_OK on success, an error code otherwise.
+ */
+static int prv_vecio_read_mtx_header(const char *filename, const struct Vec *vec, size_t *off) {
+    FILE *fp = fopen(filename, "r");
+    if (!fp) {
+        rc_set_err_msg("Invalid file name provided to fopen - %s", strerror(errno));
+        return RC_FILE_IO_ERR;
+    }
+
+    MM_typecode matcode;
+    int m, n;
+    int res = mm_read_banner(fp, &matcode);
+    if (res == RC_OK && (!mm_is_matrix(matcode) || !mm_is_array(matcode) || !mm_is_general(matcode) ||
+                         !(mm_is_integer(matcode) || (vec->is_real && mm_is_real(matcode))))) {
+        rc_set_err_msg("Market Matrix type [%s] not supported for %s vector", mm_typecode_to_str(matcode), vec->is_real ? "a real" : "an integer");
+        fclose(fp);
+        return RC_FILE_INVALID_FMT_ERR;
+    }
+    if (res == RC_OK)
+        res = mm_read_mtx_array_size(fp, &m, &n);
+    if (res != RC_OK) {
+        rc_set_err_msg("Could not process the Matrix Market header of the vector file");
+        fclose(fp);
+        return RC_FILE_INVALID_FMT_ERR;
+    }
+
+    long pos = ftell(fp);
+    fclose(fp);
+    if (GET_MIN(m, n) != 1 || (long)m * n != vec->n || pos < 0) {
+        rc_set_err_msg("The vector file is a %d x %d array, expected %d x 1", m, n, vec->n);
+        return RC_FILE_INVALID_FMT_ERR;
+    }
+
+    *off = (size_t)pos;
+    return RC_OK;
+}
+
+int vecio_load(struct Vec *vec, const char *filename) {
+    SLOG_DEBUG("Entering vecio_load");
+    if (!vec || !filename) {
+        rc_set_err_msg("Invalid NULL argument(s) provided to vecio_load");
+        return RC_INVALID_ARG_ERR;
+    }
+
+    int fd = open(filename, O_RDONLY);
+    if (fd < 0) {
+        rc_set_err_msg("Invalid file name provided to open - %s", strerror(errno));
+        return RC_FILE_IO_ERR;
+    }
+
+    struct stat st;
+    if (fstat(fd, &st) != 0 || st.st_size == 0) {
+        close(fd);
+        rc_set_err_msg("The vector file '%s' is empty or cannot be read", filename);
+        return RC_FILE_INVALID_FMT_ERR;
+    }
+
+    const size_t size = (size_t)st.st_size;
+    const char *buf = mmap(NULL, size, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if (buf == MAP_FAILED) {
+        rc_set_err_msg("Could not map the vector file - %s", strerror(errno));
+        return RC_FILE_IO_ERR;
+    }
+    posix_madvise((void *)buf, size, POSIX_MADV_SEQUENTIAL);
+
+    int res;
+    const size_t banner = strlen(MatrixMarketBanner);
+    if (size >= banner && memcmp(buf, MatrixMarketBanner, banner) == 0) {
+        size_t off = 0;
+        res = prv_vecio_read_mtx_header(filename, vec, &off);
+        if (res == RC_OK)
+            res = prv_vecio_parse_mtx(buf, size, off, vec);
+    } else {
+        const size_t item = vec->is_real ? sizeof(double) : sizeof(int);
+        if (size != (size_t)vec->n * item) {
+            rc_set_err_msg("The binary vector file holds %zu bytes instead of %zu (%d %s)", size, (size_t)vec->n * item, vec->n, vec->is_real ? "doubles" : "integers");
+            res = RC_FILE_INVALID_FMT_ERR;
+        } else {
+            memcpy(arena_get_ptr(&vec->val), buf, size);
+            res = RC_OK;
+        }
+    }
+
+    munmap((void *)buf, size);
+    return res;
+}
+
+/*!
+ * \brief           Format slices of a block until none is left (run by every thread).
+ *
+ * \param[in,out]   task: Pointer to the task.
+ */
+static void prv_vecio_format_work(struct VecioFormatTask *task) {
+    const void *val = arena_get_ptr(&task->vec->val);
+
+    for (;;) {
+        const int s = atomic_fetch_add_explicit(&task->next, 1, memory_order_relaxed);
+        const long begin = task->begin + (long)s * CONFIG_VECIO_SLICE_ROWS;
+        if (s >= CONFIG_VECIO_SLICES || begin >= task->end)
+            return;
+
+        const int end = (int)GET_MIN(begin + CONFIG_VECIO_SLICE_ROWS, (long)task->end);
+        char *out = task->buf + (size_t)s * CONFIG_VECIO_SLICE_ROWS * CONFIG_VECIO_ITEM_MAX_LEN;
+        int len = 0;
+        for (int i = (int)begin; i < end; ++i) {
+            if (task->vec->is_real)
+                len += snprintf(out + len, CONFIG_VECIO_ITEM_MAX_LEN, "%.17g\n", ((const double *)val)[i]);
+            else
+                len += snprintf(out + len, CONFIG_VECIO_ITEM_MAX_LEN, "%d\n", ((const int *)val)[i]);
+        }
+        task->len[s] = len;
+    }
+}
+
+#ifdef CONFIG_ENABLE_PTHREADS_PARALLELISM
+/*!
+ * \brief           Pool task running the formatting loop of one thread.
+ *
+ * \param[in,out]   arg: Pointer to the VecioFormatTask.
+ * \param[in]       tid: Index of the calling thread.
+ * \param[in]       threads: Number of threads of the pool.
+ */
+static void prv_vecio_format_pool_task(void *arg, int tid, int threads) {
+    UNUSED(tid);
+    UNUSED(threads);
+    prv_vecio_format_work(arg);
+}
+#endif /*! CONFIG_ENABLE_PTHREADS_PARALLELISM */
+
+/*!
+ * \brief           Format the rows of a block with the threads of the parallel backend.
+ *
+ * \param[in,out]   task: Pointer to the task, begin and end set.
+ * \return          RC_OK on success, an error code otherwise.
+ */
+static int prv_vecio_format_block(struct VecioFormatTask *task) {
+    memset(task->len, 0, sizeof(task->len));
+    atomic_store_explicit(&task->next, 0, memory_order_relaxed);
+
+#ifdef CONFIG_ENABLE_OMP_PARALLELISM
+    if (omp_get_max_threads() > 1 && task->end - task->begin > CONFIG_VECIO_SLICE_ROWS) {
+#pragma omp parallel
+        prv_vecio_format_work(task);
+        return RC_OK;
+    }
+#endif /*! CONFIG_ENABLE_OMP_PARALLELISM */
+
+#ifdef CONFIG_ENABLE_PTHREADS_PARALLELISM
+    struct ThreadPool *pool = pool_get_default();
+    if (pool && pool->threads > 1 && task->end - task->begin > CONFIG_VECIO_SLICE_ROWS)
+        return pool_run(pool, prv_vecio_format_pool_task, task);
+#endif /*! CONFIG_ENABLE_PTHREADS_PARALLELISM */
+
+    prv_vecio_format_work(task);
+    return RC_OK;
+}
+
+/*!
+ * \brief           Write a vector as a Matrix Market array, formatting it in parallel.
+ *
+ * \param[in]       vec: Pointer to the vector.
+ * \param[in,out]   fp: File open for writing.
+ * \param[in,out]   arena: Pointer to the arena handler holding the formatting buffer.
+ * \return          RC_OK on success, an error code otherwise.
+ */
+static int prv_vecio_write_mtx(const struct Vec *vec, FILE *fp, struct ArenaHandler *arena) {
+    struct ArenaObj buf;
+    enum ArenaReturnCode arena_res = arena_calloc(arena, (size_t)CONFIG_VECIO_SLICE_ROWS * CONFIG_VECIO_ITEM_MAX_LEN, CONFIG_VECIO_SLICES, &buf);
+    if (arena_res != ARENA_RC_OK) {
+        rc_set_err_msg("Memory array allocation failed in vecio_save");
+        return RC_MEM_ALLOC_ERR;
+    }
+
+    MM_typecode matcode;
+    mm_initialize_typecode(&matcode);
+    mm_set_matrix(&matcode);
+    mm_set_array(&matcode);
+    mm_set_general(&matcode);
+    if (vec->is_real)
+        mm_set_real(&matcode);
+    else
+        mm_set_integer(&matcode);
+
+    /*! The return codes of the mmio writers compare the characters printed with 2: errors show in ferror */
+    mm_write_banner(fp, matcode);
+    mm_write_mtx_array_size(fp, vec->n, 1);
+
+    struct VecioFormatTask task = { .vec = vec };
+    const int block = CONFIG_VECIO_SLICES * CONFIG_VECIO_SLICE_ROWS;
+    for (int begin = 0; begin < vec->n && !ferror(fp); begin += block) {
+        task.buf = arena_get_ptr(&buf);
+        task.begin = begin;
+        task.end = (int)GET_MIN((long)begin + block, (long)vec->n);
+        int res = prv_vecio_format_block(&task);
+        if (res != RC_OK)
+            return res;
+
+        for (int s = 0; s < CONFIG_VECIO_SLICES && task.len[s] > 0; ++s)
+            fwrite(task.buf + (size_t)s * CONFIG_VECIO_SLICE_ROWS * CONFIG_VECIO_ITEM_MAX_LEN, 1, (size_t)task.len[s], fp);
+    }
+
+    return RC_OK;
+}
+
+int vecio_save(const struct Vec *vec, const char *filename, struct ArenaHandler *arena) {
+    SLOG_DEBUG("Entering vecio_save");
+    if (!vec || !filename || !arena) {
+        rc_set_err_msg("Invalid NULL argument(s) provided to vecio_save");
+        return RC_INVALID_ARG_ERR;
+    }
+
+    const size_t len = strlen(filename);
+    const bool mtx = len >= 4 && strcmp(filename + len - 4, ".mtx") == 0;
+
+    FILE *fp = fopen(filename, mtx ? "w" : "wb");
+    if (!fp) {
+        rc_set_err_msg("Invalid file name provided to fopen - %s", strerror(errno));
+        return RC_FILE_IO_ERR;
+    }
+
+    int res = RC_OK;
+    if (mtx)
+        res = prv_vecio_write_mtx(vec, fp, arena);
+    else
+        fwrite(arena_get_ptr(&vec->val), vec->is_real ? sizeof(double) : sizeof(int), (size_t)vec->n, fp);
+
+    if (res == RC_OK && ferror(fp)) {
+        rc_set_err_msg("Could not write the vector file '%s'", filename);
+        res = RC_FILE_IO_ERR;
+    }
+    if (fclose(fp) != 0 && res == RC_OK) {
+        rc_set_err_msg("Could not write the vector file '%s' - %s", filename, strerror(errno));
+        res = RC_FILE_IO_ERR;
+    }
+    return res;
+}
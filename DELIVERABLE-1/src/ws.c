@@ -0,0 +1,209 @@
+/*!
+ * \file            ws.c
+ * \date            2026-10-18
+ * \author          Mirko Lana [lana.mirko@icloud.com]
+ *
+ * \brief           Work-stealing row-block scheduler for the CSR SpMV.
+ */
+
+#include "config.h"
+#include "ws.h"
+#include "rc.h"
+#include "arena.h"
+#include "barrier.h"
+#include "csr.h"
+#include "deque.h"
+#include "partition.h"
+#include "pool.h"
+#include "vec.h"
+#include "slog.h"
+#include "utils.h"
+
+#ifdef CONFIG_ENABLE_OMP_PARALLELISM
+#include <omp.h>
+#endif /*! CONFIG_ENABLE_OMP_PARALLELISM */
+
+/*!
+ * \brief           Structure containing the arguments of one scheduled SpMV.
+ */
+struct WsTask {
+    struct WsScheduler *ws;      /*< Scheduler */
+    const struct CsrMatrix *mtx; /*< Input matrix */
+    const struct Vec *vec;       /*< Input vector */
+    struct Vec *result;          /*< Result vector */
+};
+
+/*!
+ * \brief           Get the first block owned by a thread.
+ *
+ * \param[in]       ws: Pointer to the scheduler.
+ * \param[in]       tid: Index of the thread (0 <= tid <= threads).
+ * \return          The index of the first block of the thread.
+ */
+static inline int prv_ws_first_block(const struct WsScheduler *ws, int tid) {
+    return (int)((long)ws->blocks.parts * tid / ws->threads);
+}
+
+/*!
+ * \brief           Refill the deques of a thread with the blocks it owns.
+ *
+ * \details         Blocks are pushed from the last one, so the owner pops them
+ *                  in row order while thieves take them from the far end.
+ *
+ * \param[in,out]   ws: Pointer to the scheduler.
+ * \param[in]       tid: Index of the calling thread.
+ * \param[in]       team: Number of running threads (may be lower than ws->threads).
+ */
+static void prv_ws_fill(struct WsScheduler *ws, int tid, int team) {
+    struct WsDeque *deques = arena_get_ptr(&ws->deques);
+
+    if (tid == 0)
+        atomic_store_explicit(&ws->done, 0, memory_order_relaxed);
+
+    /*! A smaller team than requested: the running threads own the missing ones' blocks */
+    for (int d = tid; d < ws->threads; d += team) {
+        deque_reset(&deques[d]);
+        for (int b = prv_ws_first_block(ws, d + 1) - 1; b >= prv_ws_first_block(ws, d); --b)
+            deque_push(&deques[d], b);
+    }
+}
+
+/*!
+ * \brief           Compute blocks until all of them are done.
+ *
+ * \param[in,out]   task: Pointer to the task.
+ * \param[in]       tid: Index of the calling thread.
+ * \param[in]       team: Number of running threads.
+ */
+static void prv_ws_work(struct WsTask *task, int tid, int team) {
+    struct WsScheduler *ws = task->ws;
+    struct WsDeque *deques = arena_get_ptr(&ws->deques);
+    const int *bounds = partition_get_bounds(&ws->blocks);
+    const int blocks = ws->blocks.parts;
+    unsigned seed = 2654435761U * (unsigned)(tid + 1); /*! xorshift32 state, never 0 */
+    int local = 0;
+
+    while (atomic_load_explicit(&ws->done, memory_order_acquire) < blocks) {
+        int b;
+        bool found = false;
+
+        for (int d = tid; !found && d < ws->threads; d += team)
+            found = deque_pop(&deques[d], &b);
+
+        if (!found && ws->threads > 1) {
+            seed ^= seed << 13;
+            seed ^= seed >> 17;
+            seed ^= seed << 5;
+            int victim = (int)(seed % (unsigned)(ws->threads - 1));
+            victim += victim >= tid; /*! Skip the own deque */
+            found = deque_steal(&deques[victim], &b);
+            local += found;
+        }
+
+        if (!found) {
+            barrier_cpu_relax();
+            continue;
+        }
+
+        csr_matrix_mul_vec_rows(task->mtx, task->vec, task->result, bounds[b], bounds[b + 1]);
+        atomic_fetch_add_explicit(&ws->done, 1, memory_order_release);
+    }
+
+    if (local > 0)
+        atomic_fetch_add_explicit(&ws->steals, local, memory_order_relaxed);
+}
+
+#ifdef CONFIG_ENABLE_PTHREADS_PARALLELISM
+/*!
+ * \brief           Pool task running the scheduler on one thread.
+ *
+ * \param[in,out]   arg: Pointer to the WsTask.
+ * \param[in]       tid: Index of the calling thread.
+ * \param[in]       threads: Number of threads of the pool.
+ */
+static void prv_ws_pool_task(void *arg, int tid, int threads) {
+    struct WsTask *task = arg;
+    int *senses = arena_get_ptr(&task->ws->senses);
+
+    prv_ws_fill(task->ws, tid, threads);
+    barrier_wait(&task->ws->barrier, &senses[tid]);
+    prv_ws_work(task, tid, threads);
+}
+#endif /*! CONFIG_ENABLE_PTHREADS_PARALLELISM */
+
+int ws_init(struct WsScheduler *ws, const struct CsrMatrix *mtx, int threads, struct ArenaHandler *arena) {
+    SLOG_DEBUG("Entering ws_init");
+    if (!ws || !mtx || !arena || threads < 1) {
+        rc_set_err_msg("Invalid argument(s) provided to ws_init");
+        return RC_INVALID_ARG_ERR;
+    }
+
+    ws->threads = threads;
+    atomic_init(&ws->done, 0);
+    atomic_init(&ws->steals, 0);
+
+    int blocks = GET_MIN(threads * CONFIG_WS_BLOCKS_PER_THREAD, GET_MAX(mtx->m, 1));
+    int res = partition_init_nnz(&ws->blocks, mtx, blocks, arena);
+    if (res == RC_OK)
+        res = barrier_init(&ws->barrier, threads);
+    if (res != RC_OK)
+        return res;
+
+    enum ArenaReturnCode arena_res = arena_calloc(arena, sizeof(struct WsDeque), threads, &ws->deques);
+    if (arena_res == ARENA_RC_OK)
+        arena_res = arena_calloc(arena, sizeof(int), threads, &ws->senses);
+    if (arena_res != ARENA_RC_OK) {
+        rc_set_err_msg("Memory array allocation failed in ws_init");
+        return RC_MEM_ALLOC_ERR;
+    }
+
+    int capacity = (blocks + threads - 1) / threads;
+    for (int t = 0; t < threads; ++t) {
+        /*! The deque allocates its buffer: look the array up again each time */
+        struct WsDeque *deques = arena_get_ptr(&ws->deques);
+        res = deque_init(&deques[t], capacity, arena);
+        if (res != RC_OK)
+            return res;
+    }
+
+    SLOG_DEBUG("Work-stealing scheduler: %d threads, %d blocks", threads, blocks);
+    return RC_OK;
+}
+
+int ws_mul_vec(struct WsScheduler *ws, const struct CsrMatrix *mtx, const struct Vec *vec, struct Vec *result) {
+    if (!ws || !mtx || !vec || !result) {
+        rc_set_err_msg("Invalid NULL argument(s) provided to ws_mul_vec");
+        return RC_INVALID_ARG_ERR;
+    }
+
+    if (mtx->n != vec->n || mtx->is_real != vec->is_real || vec_size(result) != mtx->m) {
+        rc_set_err_msg("Incompatible matrix and vector dimensions or types in ws_mul_vec");
+        return RC_INVALID_ARG_ERR;
+    }
+
+    struct WsTask task = { .ws = ws, .mtx = mtx, .vec = vec, .result = result };
+
+#ifdef CONFIG_ENABLE_PTHREADS_PARALLELISM
+    struct ThreadPool *pool = pool_get_default();
+    if (!pool || pool->threads != ws->threads) {
+        rc_set_err_msg("The default pool does not match the work-stealing scheduler size");
+        return RC_FAIL;
+    }
+    return pool_run(pool, prv_ws_pool_task, &task);
+#elif defined(CONFIG_ENABLE_OMP_PARALLELISM)
+#pragma omp parallel num_threads(ws->threads)
+    {
+        const int tid = omp_get_thread_num();
+        const int team = omp_get_num_threads();
+
+        prv_ws_fill(ws, tid, team);
+#pragma omp barrier
+        prv_ws_work(&task, tid, team);
+    }
+    return RC_OK;
+#else
+    prv_ws_fill(ws, 0, 1);
+    prv_ws_work(&task, 0, 1);
+    return RC_OK;
+#endif /*! CONFIG_ENABLE_PTHREADS_PARALLELISM */
+}
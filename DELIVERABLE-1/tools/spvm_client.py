@@ -0,0 +1,189 @@
+import argparse
+import socket
+import struct
+import time
+from multiprocessing import Pool, shared_memory
+from typing import Dict, Tuple
+
+import numpy as np
+import scipy as sp
+
+# Wire format of include/serve.h (native byte order, no padding)
+SERVE_MAGIC = 0x53505652
+SERVE_OP_INFO = 0
+SERVE_OP_ATTACH = 1
+SERVE_OP_SPMV = 2
+SERVE_OP_SHUTDOWN = 3
+REQUEST = struct.Struct("=IIiiQQ64s")
+REPLY = struct.Struct("=IiiiiiiiQQ")
+
+
+def call(
+    sock: socket.socket,
+    op: int,
+    matrix: int = 0,
+    x_off: int = 0,
+    y_off: int = 0,
+    shm_name: str = "",
+) -> Tuple[int, ...]:
+    """
+    Send a request to the server and wait for its reply.
+
+    Parameters:
+    sock (socket.socket): Connected socket.
+    op (int): Operation of the request.
+    matrix (int): Index of the matrix.
+    x_off (int): Offset of x in the attached buffer.
+    y_off (int): Offset of y in the attached buffer.
+    shm_name (str): Name of the buffer to attach.
+
+    Returns:
+    Tuple[int, ...]: Fields of the reply (magic, status, m, n, is_real, matrices, batch, reserved, kernel_ns, total_ns).
+    """
+    sock.sendall(REQUEST.pack(SERVE_MAGIC, op, matrix, 0, x_off, y_off, shm_name.encode()))
+    data = sock.recv(REPLY.size, socket.MSG_WAITALL)
+    if len(data) != REPLY.size:
+        raise ConnectionError("Server closed the connection")
+    reply = REPLY.unpack(data)
+    if reply[0] != SERVE_MAGIC:
+        raise ConnectionError("Invalid reply from the server")
+    return reply
+
+
+def make_parser() -> argparse.ArgumentParser:
+    """
+    Create an argument parser for the script.
+
+    Returns:
+    argparse.ArgumentParser: Configured argument parser.
+    """
+    parser = argparse.ArgumentParser(
+        description="Request SpMVs from a server started with spvm --serve and report their latency."
+    )
+    parser.add_argument("socket", type=str, help="Path of the socket of the server.")
+    parser.add_argument(
+        "-m", "--matrix", type=int, default=0, help="Index of the matrix (order of the -i options of the server)."
+    )
+    parser.add_argument("-n", "--calls", type=int, default=1000, help="Number of SpMVs requested per client.")
+    parser.add_argument(
+        "-p", "--clients", type=int, default=1, help="Number of concurrent clients, each with its own connection."
+    )
+    parser.add_argument(
+        "-c",
+        "--check",
+        type=str,
+        required=False,
+        help="Matrix Market file of the matrix, to check the result against scipy.",
+    )
+    parser.add_argument("--shutdown", action="store_true", help="Stop the server when done.")
+    return parser
+
+
+def run_client(args: argparse.Namespace) -> Dict[str, np.ndarray]:
+    """
+    Connect to the server, request SpMVs and time them.
+
+    Parameters:
+    args (argparse.Namespace): Parsed arguments.
+
+    Returns:
+    Dict[str, np.ndarray]: Round-trip, kernel and service times in ns and pass sizes of the calls,
+    start and end of the calls under "span", and the difference with scipy under "check" if asked.
+    """
+    sock = socket.socket(socket.AF_UNIX, socket.SOCK_STREAM)
+    sock.connect(args.socket)
+
+    reply = call(sock, SERVE_OP_INFO, args.matrix)
+    status, m, n, is_real, matrices = reply[1:6]
+    if status != 0:
+        raise SystemExit(f"Matrix {args.matrix} not served (the server has {matrices} matrices)")
+    dtype = np.float64 if is_real else np.int32
+    item = np.dtype(dtype).itemsize
+
+    # x and y share one buffer, y after x on a cache line boundary
+    y_off = (n * item + 63) // 64 * 64
+    shm = shared_memory.SharedMemory(create=True, size=y_off + m * item)
+    x = y = None
+    try:
+        x = np.ndarray((n,), dtype=dtype, buffer=shm.buf, offset=0)
+        y = np.ndarray((m,), dtype=dtype, buffer=shm.buf, offset=y_off)
+        rng = np.random.default_rng()
+        x[:] = rng.random(n) if is_real else rng.integers(0, 100, n)
+
+        if call(sock, SERVE_OP_ATTACH, shm_name="/" + shm.name.lstrip("/"))[1] != 0:
+            raise SystemExit(f"The server could not attach buffer {shm.name}")
+
+        times = {key: np.empty(args.calls) for key in ("round_trip", "kernel", "service", "batch")}
+        first = time.perf_counter_ns()
+        for i in range(args.calls):
+            start = time.perf_counter_ns()
+            reply = call(sock, SERVE_OP_SPMV, args.matrix, 0, y_off)
+            times["round_trip"][i] = time.perf_counter_ns() - start
+            if reply[1] != 0:
+                raise SystemExit(f"SpMV failed with status {reply[1]:#x}")
+            times["batch"][i] = reply[6]
+            times["kernel"][i] = reply[8]
+            times["service"][i] = reply[9]
+        times["span"] = np.array([first, time.perf_counter_ns()])
+
+        if args.check and args.calls > 0:
+            a = sp.io.mmread(args.check).tocsr()
+            y_ref = a @ x
+            if is_real:
+                diff = np.linalg.norm(y - y_ref) / max(np.linalg.norm(y_ref), np.finfo(float).tiny)
+            else:
+                diff = 0.0 if np.array_equal(y, y_ref) else np.inf
+            times["check"] = np.array([diff])
+        return times
+    finally:
+        x = y = None  # Views of the buffer, released before closing it
+        shm.close()
+        shm.unlink()
+        sock.close()
+
+
+def main() -> None:
+    """
+    Main function to run the script.
+    """
+    args = make_parser().parse_args()
+
+    sock = socket.socket(socket.AF_UNIX, socket.SOCK_STREAM)
+    sock.connect(args.socket)
+    _, status, m, n, is_real, matrices = call(sock, SERVE_OP_INFO, args.matrix)[:6]
+    if status != 0:
+        raise SystemExit(f"Matrix {args.matrix} not served (the server has {matrices} matrices)")
+    print(f"Matrix {args.matrix}: {m} x {n}, {'real' if is_real else 'integer'} values")
+
+    if args.clients > 1:
+        with Pool(args.clients) as pool:
+            results = pool.map(run_client, [args] * args.clients)
+    else:
+        results = [run_client(args)]
+
+    calls = args.clients * args.calls
+    if calls > 0:
+        merged = {key: np.concatenate([r[key] for r in results]) for key in ("round_trip", "kernel", "service", "batch")}
+        print(f"{args.clients} clients x {args.calls} SpMVs, median times in us:")
+        print(f"  kernel      {np.median(merged['kernel']) / 1e3:10.2f}  (one pass, shared by its products)")
+        print(f"  service     {np.median(merged['service']) / 1e3:10.2f}  (receipt to reply, server side)")
+        print(f"  round trip  {np.median(merged['round_trip']) / 1e3:10.2f}  (client side)")
+        print(f"Mean products per pass: {np.mean(merged['batch']):.2f}")
+        # Monotonic clock, shared by the processes of the clients
+        elapsed = max(r["span"][1] for r in results) - min(r["span"][0] for r in results)
+        print(f"Throughput: {calls / (elapsed / 1e9):.0f} SpMVs/s")
+
+    if args.check and calls > 0:
+        checks = np.concatenate([r["check"] for r in results])
+        if is_real:
+            print(f"Largest relative L2 difference with scipy: {np.max(checks):.3e}")
+        else:
+            print(f"Equal to scipy: {bool(np.all(checks == 0.0))}")
+
+    if args.shutdown:
+        call(sock, SERVE_OP_SHUTDOWN)
+    sock.close()
+
+
+if __name__ == "__main__":
+    main()